@@ -4,18 +4,210 @@
 #include "PinMap.h"
 #include "RegisterMap.h"
 #include "Logger.h"
+#include "SPIBus.h"
 
 #include <SPI.h>
+#include <esp_timer.h>
 
 // In EnergyATM90E36.h:
 //   READ  = 1
 //   WRITE = 0
 // and register symbols like UrmsA, IrmsA, Freq, SysStatus0, SysStatus1 are defined.
 
+namespace {
+
+// Slots of the register sweep, grouped by polling class (see PollGroup). Each group
+// is a contiguous slot range so it can be read as one batched sweep.
+// 32-bit values are stored as adjacent HI/LO slots so the two halves are read
+// back-to-back, and every HI word is read a second time at the end of the FAST
+// group to detect pairs torn by a register update.
+enum SweepSlot : uint8_t {
+    // FAST: RMS, power, power factor, status
+    SW_URMS_A, SW_URMS_B, SW_URMS_C,
+    SW_IRMS_A, SW_IRMS_B, SW_IRMS_C, SW_IRMS_N,
+    SW_PMEAN_A, SW_PMEAN_A_LSB, SW_PMEAN_B, SW_PMEAN_B_LSB,
+    SW_PMEAN_C, SW_PMEAN_C_LSB, SW_PMEAN_T, SW_PMEAN_T_LSB,
+    SW_QMEAN_A, SW_QMEAN_A_LSB, SW_QMEAN_B, SW_QMEAN_B_LSB,
+    SW_QMEAN_C, SW_QMEAN_C_LSB, SW_QMEAN_T, SW_QMEAN_T_LSB,
+    SW_SMEAN_A, SW_SMEAN_A_LSB, SW_SMEAN_B, SW_SMEAN_B_LSB,
+    SW_SMEAN_C, SW_SMEAN_C_LSB, SW_SAMEAN_T, SW_SAMEAN_T_LSB,
+    SW_PF_A, SW_PF_B, SW_PF_C, SW_PF_T,
+    SW_SYS_STATUS0, SW_SYS_STATUS1,
+    SW_LINK_CHECK,              // PLconstH: static, so any change is a bus error
+    SW_CHECK_FIRST,
+    SW_CHECK_LAST = SW_CHECK_FIRST + 11,
+    // MEDIUM: angles, THD, frequency
+    SW_PANGLE_A, SW_PANGLE_B, SW_PANGLE_C,
+    SW_UANGLE_A, SW_UANGLE_B, SW_UANGLE_C,
+    SW_THDN_U_A, SW_THDN_U_B, SW_THDN_U_C,
+    SW_THDN_I_A, SW_THDN_I_B, SW_THDN_I_C,
+    SW_FREQ,
+    // SLOW: temperature
+    SW_TEMP,
+    // ENERGY: clear-on-read energy counters, T/A/B/C per RawEnergy (0x80-0x93)
+    SW_AP_ENERGY_T, SW_AP_ENERGY_A, SW_AP_ENERGY_B, SW_AP_ENERGY_C,
+    SW_AN_ENERGY_T, SW_AN_ENERGY_A, SW_AN_ENERGY_B, SW_AN_ENERGY_C,
+    SW_RP_ENERGY_T, SW_RP_ENERGY_A, SW_RP_ENERGY_B, SW_RP_ENERGY_C,
+    SW_RN_ENERGY_T, SW_RN_ENERGY_A, SW_RN_ENERGY_B, SW_RN_ENERGY_C,
+    SW_SA_ENERGY_T, SW_SA_ENERGY_A, SW_SA_ENERGY_B, SW_SA_ENERGY_C,
+    SW_COUNT
+};
+
+static_assert(SW_COUNT == ATM90E36Driver::SWEEP_REG_COUNT, "Sweep slot list and SWEEP_REG_COUNT out of sync");
+
+// Register addresses in slot order (must match SweepSlot).
+const unsigned short kSweepRegs[SW_COUNT] = {
+    UrmsA, UrmsB, UrmsC,
+    IrmsA, IrmsB, IrmsC, IrmsN,
+    PmeanA, PmeanALSB, PmeanB, PmeanBLSB,
+    PmeanC, PmeanCLSB, PmeanT, PmeanTLSB,
+    QmeanA, QmeanALSB, QmeanB, QmeanBLSB,
+    QmeanC, QmeanCLSB, QmeanT, QmeanTLSB,
+    SmeanA, SmeanALSB, SmeanB, SmeanBLSB,
+    SmeanC, SmeanCLSB, SAmeanT, SAmeanTLSB,
+    PFmeanA, PFmeanB, PFmeanC, PFmeanT,
+    SysStatus0, SysStatus1,
+    PLconstH,
+    // HI re-check (same order as kSweep32HiSlots)
+    PmeanA, PmeanB, PmeanC, PmeanT,
+    QmeanA, QmeanB, QmeanC, QmeanT,
+    SmeanA, SmeanB, SmeanC, SAmeanT,
+    PAngleA, PAngleB, PAngleC,
+    UangleA, UangleB, UangleC,
+    THDNUA, THDNUB, THDNUC,
+    THDNIA, THDNIB, THDNIC,
+    Freq,
+    Temp,
+    APenergyT, APenergyA, APenergyB, APenergyC,
+    ANenergyT, ANenergyA, ANenergyB, ANenergyC,
+    RPenergyT, RPenergyA, RPenergyB, RPenergyC,
+    RNenergyT, RNenergyA, RNenergyB, RNenergyC,
+    SAenergyT, SenergyA, SenergyB, SenergyC
+};
+
+static_assert(SW_COUNT - SW_AP_ENERGY_T == RAW_EN_COUNT * 4, "Energy slots must be RawEnergy x (T, A, B, C)");
+
+// RawPhase of the n-th register in each energy block (the IC lists the total first)
+const uint8_t kEnergyBlockPhase[4] = { RAW_T, RAW_A, RAW_B, RAW_C };
+
+// HI slots of the 32-bit pairs, in the order of the SW_CHECK_* re-read slots.
+const uint8_t kSweep32HiSlots[SW_CHECK_LAST - SW_CHECK_FIRST + 1] = {
+    SW_PMEAN_A, SW_PMEAN_B, SW_PMEAN_C, SW_PMEAN_T,
+    SW_QMEAN_A, SW_QMEAN_B, SW_QMEAN_C, SW_QMEAN_T,
+    SW_SMEAN_A, SW_SMEAN_B, SW_SMEAN_C, SW_SAMEAN_T
+};
+
+// Slot range of each polling group (index = PollGroup).
+struct PollGroupRange {
+    uint8_t first;
+    uint8_t count;
+};
+
+const PollGroupRange kPollGroups[(uint8_t)PollGroup::COUNT] = {
+    { SW_URMS_A,      SW_PANGLE_A - SW_URMS_A },          // FAST
+    { SW_PANGLE_A,    SW_TEMP - SW_PANGLE_A },            // MEDIUM
+    { SW_TEMP,        SW_AP_ENERGY_T - SW_TEMP },         // SLOW
+    { SW_AP_ENERGY_T, SW_COUNT - SW_AP_ENERGY_T },        // ENERGY
+};
+
+// 32-bit signed value from an adjacent HI/LO slot pair.
+inline int32_t rawS32(const uint16_t* raw, uint8_t hiSlot) {
+    return (int32_t)(((uint32_t)raw[hiSlot] << 16) | raw[hiSlot + 1]);
+}
+
+// Static configuration registers used to verify the SPI link at a given clock.
+// Their values do not change after InitEnergy(), so any mismatch is a bus error.
+const unsigned short kLinkCheckRegs[ATM90E36Driver::LINK_CHECK_REG_COUNT] = {
+    REG_FUNC_EN0, REG_MMODE0, REG_PL_CONST_H, REG_ZX_CONFIG,
+    REG_CS_ZERO, REG_CS_ONE, REG_CS_TWO, REG_CS_THREE
+};
+
+constexpr uint8_t LINK_CHECK_PL_CONST_H = 2; // Index of PLconstH (known value, see captureLinkRef())
+constexpr uint8_t LINK_CHECK_ZXCONFIG = 3;   // Index of ZXConfig (write/readback scratch)
+constexpr uint8_t LINK_CHECK_PASSES   = 3;   // Readback passes per training step
+
+// Routes the V1 driver through SPIBus so ATM90E36 accesses share the bus mutex
+// with the W5500. The lock is held per batch (whole sweep), not per register.
+class SPIBusTransport : public ATM90E3xTransport {
+public:
+    bool Begin(unsigned long clockHz) override {
+        return SPIBus::getInstance().beginTransaction(clockHz, SPI_MODE_ATM90E36);
+    }
+
+    unsigned short Frame(int cs, unsigned short addrWord, unsigned short dataWord,
+                         unsigned int csSetupUs, unsigned int csHoldUs) override {
+        digitalWrite(cs, LOW);
+        delayMicroseconds(csSetupUs);
+        SPI.transfer16(addrWord);
+        delayMicroseconds(ATM_SWEEP_ADDR_WAIT_US);
+        const unsigned short out = SPI.transfer16(dataWord);
+        digitalWrite(cs, HIGH);
+        delayMicroseconds(csHoldUs);
+        return out;
+    }
+
+    void End() override {
+        SPIBus::getInstance().endTransaction();
+    }
+};
+
+SPIBusTransport s_spiBusTransport;
+
+// Status registers read by readPowerQuality() in one batch.
+const unsigned short kStatusRegs[] = { SysStatus0, SysStatus1, REG_EN_STATUS0, REG_EN_STATUS1 };
+constexpr uint8_t STATUS_REG_COUNT = sizeof(kStatusRegs) / sizeof(kStatusRegs[0]);
+
+constexpr uint16_t PQ_SYS0_MASK = SYS0_CS0_ERR | SYS0_CS1_ERR | SYS0_CS2_ERR | SYS0_CS3_ERR |
+                                  SYS0_U_REV_WN | SYS0_I_REV_WN | SYS0_SAG_WARN | SYS0_PHASE_LOSE_WN;
+constexpr uint16_t PQ_SYS1_MASK = SYS1_IN_OV1 | SYS1_IN_OV0 | SYS1_THDU_OV | SYS1_THDI_OV;
+
+// Per-phase EnStatus1 bits -> bit0=A, bit1=B, bit2=C
+inline uint8_t phaseBits(uint16_t reg, uint16_t a, uint16_t b, uint16_t c) {
+    return (uint8_t)(((reg & a) ? 0x01 : 0) | ((reg & b) ? 0x02 : 0) | ((reg & c) ? 0x04 : 0));
+}
+
+// Recursive lock guard for the driver mutex.
+class DriverLock {
+public:
+    explicit DriverLock(SemaphoreHandle_t m, uint32_t timeoutMs = 200)
+        : m_m(m), m_held(m != nullptr && xSemaphoreTakeRecursive(m, pdMS_TO_TICKS(timeoutMs)) == pdTRUE) {}
+    ~DriverLock() { if (m_held) xSemaphoreGiveRecursive(m_m); }
+    bool held() const { return m_held; }
+private:
+    SemaphoreHandle_t m_m;
+    bool m_held;
+};
+
+} // namespace
+
 ATM90E36Driver::ATM90E36Driver()
     : m_initialized(false)
     , m_lastError(ErrorCode::NONE)
-    , m_ic(nullptr) {
+    , m_ic(nullptr)
+    , m_mutex(nullptr)
+    , m_statusLatch0(0)
+    , m_statusLatch1(0)
+    , m_pqEvents(0)
+    , m_dmaActive(false)
+    , m_dftDone(false)
+    , m_spiFaults(0)
+    , m_energyReadsDropped(0)
+    , m_nextTrainMs(0)
+    , m_energyEpoch(0) {
+    memset(m_sweepRaw, 0, sizeof(m_sweepRaw));
+    memset(m_linkRef, 0, sizeof(m_linkRef));
+    memset(m_pollLastMs, 0, sizeof(m_pollLastMs));
+    memset(m_pollValid, 0, sizeof(m_pollValid));
+    memset(m_energyCount, 0, sizeof(m_energyCount));
+    m_pollPeriodMs[(uint8_t)PollGroup::FAST]   = POLL_FAST_MS;
+    m_pollPeriodMs[(uint8_t)PollGroup::MEDIUM] = POLL_MEDIUM_MS;
+    m_pollPeriodMs[(uint8_t)PollGroup::SLOW]   = POLL_SLOW_MS;
+    m_pollPeriodMs[(uint8_t)PollGroup::ENERGY] = POLL_ENERGY_MS;
+
+    m_mutex = xSemaphoreCreateRecursiveMutex();
+    if (m_mutex == NULL) {
+        Logger::getInstance().error("ATM90E36: Failed to create mutex");
+    }
 }
 
 bool ATM90E36Driver::init(const CalibrationConfig& config) {
@@ -27,13 +219,17 @@ bool ATM90E36Driver::init(const CalibrationConfig& config) {
     digitalWrite(PIN_SPI_CS_ATM90E36, HIGH);
     delay(5);
 
-    // Ensure SPI pins are explicitly configured for this board.
-    // (V1 driver calls SPI.begin() without pins; on ESP32 that is usually OK,
-    //  but being explicit improves portability across variants.)
-    SPI.begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, PIN_SPI_CS_ATM90E36);
+    // The shared bus is owned by SPIBus (also used by the W5500); the V1 driver
+    // only reaches it through the SPIBus transport.
+    if (!SPIBus::getInstance().init()) {
+        logger.error("ATM90E36: SPI bus init failed");
+        m_lastError = ErrorCode::SPI_INIT_FAILED;
+        return false;
+    }
 
     if (!m_ic) {
         m_ic = new ATM90E3x(PIN_SPI_CS_ATM90E36);
+        m_ic->SetTransport(&s_spiBusTransport);
     }
 
     // Map CalibrationConfig -> V1 begin() parameters.
@@ -60,25 +256,10 @@ bool ATM90E36Driver::init(const CalibrationConfig& config) {
         return rawU | rawI | rawF | sys0 | sys1;
     };
 
-    auto looksLikeNoSPI = [&](uint16_t rawU, uint16_t rawI, uint16_t rawF, uint16_t sys0, uint16_t sys1) {
-        // Common failure patterns when CS/MISO are wrong or bus is conflicted:
-        // - all zeros
-        // - all 0xFFFF
-        // - repeating 0x55xx / 0xAAxx patterns (echo / floating bus)
-        const bool all0  = (rawU == 0 && rawI == 0 && rawF == 0 && sys0 == 0 && sys1 == 0);
-        const bool allFF = (rawU == 0xFFFF && rawI == 0xFFFF && rawF == 0xFFFF);
-        const bool pat55 = ((sys0 & 0xFF00) == 0x5500) || ((rawU & 0xFF00) == 0x5500) || ((rawI & 0xFF00) == 0x5500);
-        const bool patAA = ((sys0 & 0xFF00) == 0xAA00) || ((rawU & 0xFF00) == 0xAA00) || ((rawI & 0xFF00) == 0xAA00);
-        return all0 || allFF || pat55 || patAA;
-    };
-
+    // The link is judged by the static registers InitEnergy() programmed and a
+    // ZXConfig write/readback, never by measurement values (0x55xx is a valid URMS)
     auto sanityRead = [&]() {
-        const uint16_t rawU = m_ic->CommEnergyIC(READ, UrmsA, 0x0000);
-        const uint16_t rawI = m_ic->CommEnergyIC(READ, IrmsA, 0x0000);
-        const uint16_t rawF = m_ic->CommEnergyIC(READ, Freq,  0x0000);
-        const uint16_t sys0 = m_ic->CommEnergyIC(READ, SysStatus0, 0x0000);
-        const uint16_t sys1 = m_ic->CommEnergyIC(READ, SysStatus1, 0x0000);
-        return looksLikeNoSPI(rawU, rawI, rawF, sys0, sys1);
+        return !captureLinkRef() || !verifySpiLink(true);
     };
 
     // Execute the exact V1 initialization/calibration/write-unlock sequence.
@@ -86,6 +267,10 @@ bool ATM90E36Driver::init(const CalibrationConfig& config) {
     m_ic->begin(config.lineFreq, config.pgaGain, ugain1, ugain2, ugain3, igainA, igainB, igainC, igainN);
     m_ic->InitEnergy();
 
+    // The IC's energy registers restart with the init; so do the software totals
+    memset(m_energyCount, 0, sizeof(m_energyCount));
+    m_energyEpoch++;
+
     // Proof-step 1: immediately after init
     logRawProof("RAW0");
 
@@ -97,9 +282,7 @@ bool ATM90E36Driver::init(const CalibrationConfig& config) {
     // If still looks like a bus issue, retry init once (common after brown-out or fast reboot).
     if (sanityRead()) {
         logger.warn("ATM90E36: Raw registers look invalid (possible SPI conflict). Retrying init...");
-        SPI.end();
-        delay(10);
-        SPI.begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, PIN_SPI_CS_ATM90E36);
+        SPIBus::getInstance().reinit();
         delay(10);
         m_ic->begin(config.lineFreq, config.pgaGain, ugain1, ugain2, ugain3, igainA, igainB, igainC, igainN);
         m_ic->InitEnergy();
@@ -116,10 +299,136 @@ bool ATM90E36Driver::init(const CalibrationConfig& config) {
 
     m_initialized = true;
     m_lastError = ErrorCode::NONE;
+
+    // Route sag/phase-loss/phase-sequence (IRQ0) and N-current/THD (IRQ1) to the IRQ pins.
+    // Done before training so FuncEn0 is captured in the link reference.
+    enableStatusInterrupts();
+
+    // Raise the SPI clock as far as the link verifies (falls back to 200 kHz otherwise).
+    trainSpiClock();
+    return true;
+}
+
+bool ATM90E36Driver::captureLinkRef() {
+    // PLconstH is programmed to its datasheet default by InitEnergy(); a floating,
+    // stuck or echoing bus does not return that word from that address
+    if (m_ic->ReadRegisterSweep(kLinkCheckRegs, m_linkRef, LINK_CHECK_REG_COUNT) != LINK_CHECK_REG_COUNT) {
+        return false;
+    }
+    return m_linkRef[LINK_CHECK_PL_CONST_H] == DEFAULT_PL_CONST_H;
+}
+
+bool ATM90E36Driver::verifySpiLink(bool writeCheck) {
+    uint16_t regs[LINK_CHECK_REG_COUNT];
+
+    for (uint8_t pass = 0; pass < LINK_CHECK_PASSES; ++pass) {
+        if (m_ic->ReadRegisterSweep(kLinkCheckRegs, regs, LINK_CHECK_REG_COUNT) != LINK_CHECK_REG_COUNT) {
+            return false;
+        }
+        if (memcmp(regs, m_linkRef, sizeof(regs)) != 0) {
+            return false;
+        }
+    }
+
+    if (writeCheck) {
+        // Write ZXConfig back with its own value: exercises the write path
+        // without changing the IC configuration.
+        const uint16_t zx = m_linkRef[LINK_CHECK_ZXCONFIG];
+        m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x55AA);
+        m_ic->CommEnergyIC(WRITE, REG_ZX_CONFIG, zx);
+        const uint16_t last = m_ic->CommEnergyIC(READ, REG_LAST_SPI_DATA, 0x0000);
+        const uint16_t back = m_ic->CommEnergyIC(READ, REG_ZX_CONFIG, 0x0000);
+        m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x0000);
+        if (last != zx || back != zx) {
+            return false;
+        }
+    }
+
     return true;
 }
 
+bool ATM90E36Driver::trainSpiClock() {
+    if (!m_ic) return false;
+    Logger& logger = Logger::getInstance();
+    DriverLock lock(m_mutex, 1000);
+    if (!lock.held()) return false;
+
+    // Reference values are always taken at the proven baseline clock.
+    m_ic->SetSPIClock(SPI_FREQUENCY_ATM90E36);
+    const bool refOk = captureLinkRef() && verifySpiLink(false);
+    uint32_t best = SPI_FREQUENCY_ATM90E36;
+
+    if (refOk) {
+        for (uint32_t hz : SPI_TRAINING_STEPS_ATM90E36) {
+            m_ic->SetSPIClock(hz);
+            if (!verifySpiLink(true)) {
+                logger.debug("ATM90E36: SPI %lu Hz failed verification", (unsigned long)hz);
+                break;
+            }
+            best = hz;
+        }
+    }
+
+    m_ic->SetSPIClock(best);
+    m_nextTrainMs = millis() + SPI_RETRAIN_INTERVAL_MS;
+
+    if (!refOk) {
+        logger.warn("ATM90E36: SPI link check failed at baseline, staying at %lu Hz", (unsigned long)best);
+        return false;
+    }
+    logger.info("ATM90E36: SPI link trained at %lu Hz", (unsigned long)best);
+    return true;
+}
+
+uint32_t ATM90E36Driver::getSpiClock() const {
+    return m_ic ? (uint32_t)m_ic->_spiClockHz : 0;
+}
+
 bool ATM90E36Driver::readAll(MeterData& data) {
+    RawMeterFrame frame;
+    if (!readGroups(frame, POLL_GROUPS_ALL)) return false;
+    rawFrameToMeterData(frame, data);
+    return true;
+}
+
+bool ATM90E36Driver::readScheduled(MeterData& data, uint8_t* groupsRead) {
+    RawMeterFrame frame;
+    if (!readScheduledRaw(frame, groupsRead)) return false;
+    rawFrameToMeterData(frame, data);
+    return true;
+}
+
+bool ATM90E36Driver::readScheduledRaw(RawMeterFrame& frame, uint8_t* groupsRead) {
+    const uint32_t nowMs = millis();
+    uint8_t mask = 0;
+
+    for (uint8_t g = 0; g < (uint8_t)PollGroup::COUNT; ++g) {
+        if (!m_pollValid[g] || (uint32_t)(nowMs - m_pollLastMs[g]) >= m_pollPeriodMs[g]) {
+            mask |= (uint8_t)(1U << g);
+        }
+    }
+
+    // Keep the 20-register energy block off the ticks that already carry the MEDIUM
+    // or SLOW groups; the IC keeps counting, so a deferral costs no pulses.
+    const uint8_t slowerGroups = pollGroupBit(PollGroup::MEDIUM) | pollGroupBit(PollGroup::SLOW);
+    if ((mask & slowerGroups) && m_pollValid[(uint8_t)PollGroup::ENERGY]) {
+        mask &= (uint8_t)~pollGroupBit(PollGroup::ENERGY);
+    }
+
+    return readGroups(frame, mask, groupsRead);
+}
+
+void ATM90E36Driver::setPollPeriod(PollGroup group, uint32_t periodMs) {
+    if (group >= PollGroup::COUNT) return;
+    m_pollPeriodMs[(uint8_t)group] = periodMs;
+}
+
+uint32_t ATM90E36Driver::getPollPeriod(PollGroup group) const {
+    if (group >= PollGroup::COUNT) return 0;
+    return m_pollPeriodMs[(uint8_t)group];
+}
+
+bool ATM90E36Driver::readGroups(RawMeterFrame& frame, uint8_t mask, uint8_t* groupsRead) {
     if (!m_initialized || !m_ic) {
         // V2 ErrorCode enum does not include a dedicated "not initialized" value.
         // Reuse the closest existing error so callers can surface a meaningful fault.
@@ -127,71 +436,356 @@ bool ATM90E36Driver::readAll(MeterData& data) {
         return false;
     }
 
-    // Phases (Voltage/Current)
-    data.phaseA.voltageRMS = (float)m_ic->GetLineVoltage1();
-    data.phaseB.voltageRMS = (float)m_ic->GetLineVoltage2();
-    data.phaseC.voltageRMS = (float)m_ic->GetLineVoltage3();
+    DriverLock lock(m_mutex);
+    if (!lock.held()) {
+        m_lastError = ErrorCode::SPI_MUTEX_TIMEOUT;
+        return false;
+    }
+
+    // Periodic link re-training (also brings the clock back up after a fallback).
+    if ((int32_t)(millis() - m_nextTrainMs) >= 0) {
+        trainSpiClock();
+    }
+
+    // One batched SPI pass over the requested groups. Every field below is decoded
+    // from the raw snapshot, so groups that were not due keep their last value.
+    // Note: the energy registers are clear-on-read, so each is read exactly once per ENERGY poll.
+    if (!sweepRegisters(mask)) {
+        m_lastError = ErrorCode::SPI_MUTEX_TIMEOUT;
+        return false;
+    }
+
+    // Above the baseline clock the FAST group carries one static register; if this
+    // sweep read it wrong, confirm against the full reference set and drop back to
+    // the baseline if the link is bad. Only registers read in this sweep are judged.
+    if ((mask & pollGroupBit(PollGroup::FAST)) &&
+        m_ic->_spiClockHz > SPI_FREQUENCY_ATM90E36 &&
+        m_sweepRaw[SW_LINK_CHECK] != m_linkRef[LINK_CHECK_PL_CONST_H] &&
+        !verifySpiLink(false)) {
+        m_spiFaults++;
+        Logger::getInstance().warn("ATM90E36: SPI fault at %lu Hz, falling back to %lu Hz",
+                                   (unsigned long)m_ic->_spiClockHz, (unsigned long)SPI_FREQUENCY_ATM90E36);
+        m_ic->SetSPIClock(SPI_FREQUENCY_ATM90E36);
+        m_nextTrainMs = millis() + SPI_RETRAIN_AFTER_FAULT_MS;
+        // The first pass already cleared the energy registers, so sweeping them again
+        // would only return what accrued since. Its values came over the bad link and
+        // are dropped (counted); ENERGY stays due and is read at the baseline clock next tick.
+        if (mask & pollGroupBit(PollGroup::ENERGY)) {
+            mask &= (uint8_t)~pollGroupBit(PollGroup::ENERGY);
+            m_energyReadsDropped++;
+        }
+        if (!sweepRegisters(mask)) {
+            m_lastError = ErrorCode::SPI_MUTEX_TIMEOUT;
+            return false;
+        }
+    }
 
-    data.phaseA.currentRMS = (float)m_ic->GetLineCurrentCT1();
-    data.phaseB.currentRMS = (float)m_ic->GetLineCurrentCT2();
-    data.phaseC.currentRMS = (float)m_ic->GetLineCurrentCT3();
+    if (groupsRead) *groupsRead = mask;
 
-    // Power (use mean power values for stability)
-    data.phaseA.activePower   = (float)m_ic->GetMeanActivePowerPhaA();
-    data.phaseB.activePower   = (float)m_ic->GetMeanActivePowerPhaB();
-    data.phaseC.activePower   = (float)m_ic->GetMeanActivePowerPhaC();
-    data.totalActivePower     = (float)m_ic->GetTotalActivePower();
+    // Stamped at the read, not at publish, so downstream integration sees the true spacing
+    const int64_t captureUs = esp_timer_get_time();
+    const uint32_t nowMs = millis();
+    for (uint8_t g = 0; g < (uint8_t)PollGroup::COUNT; ++g) {
+        if (mask & (1U << g)) {
+            m_pollLastMs[g] = nowMs;
+            m_pollValid[g] = true;
+        }
+    }
 
-    data.phaseA.reactivePower = (float)m_ic->GetMeanReactivePowerPhaA();
-    data.phaseB.reactivePower = (float)m_ic->GetMeanReactivePowerPhaB();
-    data.phaseC.reactivePower = (float)m_ic->GetMeanReactivePowerPhaC();
-    data.totalReactivePower   = (float)m_ic->GetTotalReactivePower();
+    // The sweep cleared the energy registers; extend them into the running totals.
+    if (mask & pollGroupBit(PollGroup::ENERGY)) {
+        for (uint8_t i = 0; i < RAW_EN_COUNT * 4; ++i) {
+            m_energyCount[i / 4][kEnergyBlockPhase[i % 4]] += m_sweepRaw[SW_AP_ENERGY_T + i];
+        }
+    }
+
+    // The sweep cleared SysStatus0/1; keep their bits for the power quality task.
+    if (mask & pollGroupBit(PollGroup::FAST)) {
+        m_statusLatch0 |= m_sweepRaw[SW_SYS_STATUS0];
+        m_statusLatch1 |= m_sweepRaw[SW_SYS_STATUS1];
+        if (m_sweepRaw[SW_SYS_STATUS1] & SYS1_DFT_DONE) m_dftDone = true;
+    }
 
-    data.phaseA.apparentPower = (float)m_ic->GetMeanApparentPowerPhaA();
-    data.phaseB.apparentPower = (float)m_ic->GetMeanApparentPowerPhaB();
-    data.phaseC.apparentPower = (float)m_ic->GetMeanApparentPowerPhaC();
-    data.totalApparentPower   = (float)m_ic->GetTotalApparentPower();
+    // Integer copy only; callers convert with rawFrameToMeterData() when they need floats.
+    const uint16_t* raw = m_sweepRaw;
+
+    frame.urms[RAW_A] = raw[SW_URMS_A];
+    frame.urms[RAW_B] = raw[SW_URMS_B];
+    frame.urms[RAW_C] = raw[SW_URMS_C];
+
+    frame.irms[RAW_A] = raw[SW_IRMS_A];
+    frame.irms[RAW_B] = raw[SW_IRMS_B];
+    frame.irms[RAW_C] = raw[SW_IRMS_C];
+    frame.irms[RAW_N] = raw[SW_IRMS_N];
+
+    // Power (mean power values for stability)
+    frame.pmean[RAW_A] = rawS32(raw, SW_PMEAN_A);
+    frame.pmean[RAW_B] = rawS32(raw, SW_PMEAN_B);
+    frame.pmean[RAW_C] = rawS32(raw, SW_PMEAN_C);
+    frame.pmean[RAW_T] = rawS32(raw, SW_PMEAN_T);
+
+    frame.qmean[RAW_A] = rawS32(raw, SW_QMEAN_A);
+    frame.qmean[RAW_B] = rawS32(raw, SW_QMEAN_B);
+    frame.qmean[RAW_C] = rawS32(raw, SW_QMEAN_C);
+    frame.qmean[RAW_T] = rawS32(raw, SW_QMEAN_T);
+
+    frame.smean[RAW_A] = rawS32(raw, SW_SMEAN_A);
+    frame.smean[RAW_B] = rawS32(raw, SW_SMEAN_B);
+    frame.smean[RAW_C] = rawS32(raw, SW_SMEAN_C);
+    frame.smean[RAW_T] = rawS32(raw, SW_SAMEAN_T);
 
     // PF / angles
-    data.phaseA.powerFactor   = (float)m_ic->GetPowerFactorCT1();
-    data.phaseB.powerFactor   = (float)m_ic->GetPowerFactorCT2();
-    data.phaseC.powerFactor   = (float)m_ic->GetPowerFactorCT3();
-    data.totalPowerFactor     = (float)m_ic->GetTotalPowerFactor();
+    frame.pf[RAW_A] = (int16_t)raw[SW_PF_A];
+    frame.pf[RAW_B] = (int16_t)raw[SW_PF_B];
+    frame.pf[RAW_C] = (int16_t)raw[SW_PF_C];
+    frame.pf[RAW_T] = (int16_t)raw[SW_PF_T];
 
-    data.phaseA.meanPhaseAngle = (float)m_ic->GetPhaseCT1();
-    data.phaseB.meanPhaseAngle = (float)m_ic->GetPhaseCT2();
-    data.phaseC.meanPhaseAngle = (float)m_ic->GetPhaseCT3();
+    frame.pangle[RAW_A] = (int16_t)raw[SW_PANGLE_A];
+    frame.pangle[RAW_B] = (int16_t)raw[SW_PANGLE_B];
+    frame.pangle[RAW_C] = (int16_t)raw[SW_PANGLE_C];
 
-    data.phaseA.voltagePhaseAngle = (float)m_ic->GetPhaseangV1();
-    data.phaseB.voltagePhaseAngle = (float)m_ic->GetPhaseangV2();
-    data.phaseC.voltagePhaseAngle = (float)m_ic->GetPhaseangV3();
+    frame.uangle[RAW_A] = (int16_t)raw[SW_UANGLE_A];
+    frame.uangle[RAW_B] = (int16_t)raw[SW_UANGLE_B];
+    frame.uangle[RAW_C] = (int16_t)raw[SW_UANGLE_C];
 
     // THD
-    data.phaseA.voltageTHDN = (float)m_ic->GetLineVoltage1THDN();
-    data.phaseB.voltageTHDN = (float)m_ic->GetLineVoltage2THDN();
-    data.phaseC.voltageTHDN = (float)m_ic->GetLineVoltage3THDN();
-
-    data.phaseA.currentTHDN = (float)m_ic->GetLineCurrentCT1THDN();
-    data.phaseB.currentTHDN = (float)m_ic->GetLineCurrentCT2THDN();
-    data.phaseC.currentTHDN = (float)m_ic->GetLineCurrentCT3THDN();
-
-    // Neutral & frequency/temperature
-    data.neutralCurrent = (float)m_ic->GetLineCurrentCTN();
-    data.frequency      = (float)m_ic->GetFrequency();
-    // V2 MeterData stores this as boardTemperature.
-    data.boardTemperature = (float)m_ic->GetTemperature();
-
-    // Energy (kWh / kVARh / kVAh)
-    data.totalFwdActiveEnergy     = (float)m_ic->GetImportEnergy();
-    data.totalRevActiveEnergy     = (float)m_ic->GetExportEnergy();
-    data.totalFwdReactiveEnergy   = (float)m_ic->GetImportReactiveEnergy();
-    data.totalRevReactiveEnergy   = (float)m_ic->GetExportReactiveEnergy();
-    data.totalApparentEnergy      = (float)m_ic->GetImportApparentEnergy();
+    frame.thdnU[RAW_A] = raw[SW_THDN_U_A];
+    frame.thdnU[RAW_B] = raw[SW_THDN_U_B];
+    frame.thdnU[RAW_C] = raw[SW_THDN_U_C];
+
+    frame.thdnI[RAW_A] = raw[SW_THDN_I_A];
+    frame.thdnI[RAW_B] = raw[SW_THDN_I_B];
+    frame.thdnI[RAW_C] = raw[SW_THDN_I_C];
+
+    // Frequency / temperature / status
+    frame.freq = raw[SW_FREQ];
+    frame.temp = (int16_t)raw[SW_TEMP];
+    frame.sysStatus0 = raw[SW_SYS_STATUS0];
+    frame.sysStatus1 = raw[SW_SYS_STATUS1];
+
+    // Energy totals (every frame carries them, so a dropped frame loses nothing)
+    memcpy(frame.energy, m_energyCount, sizeof(frame.energy));
+    frame.energyEpoch = m_energyEpoch;
+
+    frame.captureUs = captureUs;
 
     m_lastError = ErrorCode::NONE;
     return true;
 }
 
+uint32_t ATM90E36Driver::getLastSweepMicros() const {
+    return m_ic ? (uint32_t)m_ic->_lastSweepMicros : 0;
+}
+
+uint32_t ATM90E36Driver::getSweepCount() const {
+    return m_ic ? (uint32_t)m_ic->_sweepCount : 0;
+}
+
+uint32_t ATM90E36Driver::getRead32Retries() const {
+    return m_ic ? (uint32_t)m_ic->_read32Retries : 0;
+}
+
+bool ATM90E36Driver::sweepRegisters(uint8_t mask) {
+    // The bus is locked once for all due groups plus any tear re-reads, so the
+    // W5500 waits at most one sweep instead of interleaving per register.
+    if (!m_ic->BeginBatch()) {
+        return false;
+    }
+
+    bool ok = true;
+    for (uint8_t g = 0; ok && g < (uint8_t)PollGroup::COUNT; ++g) {
+        if (!(mask & (1U << g))) continue;
+        const PollGroupRange& range = kPollGroups[g];
+        ok = (m_ic->ReadRegisterSweep(&kSweepRegs[range.first], &m_sweepRaw[range.first], range.count) == range.count);
+    }
+
+    // A HI word that changed before the end of the sweep means the IC updated that
+    // pair while we were reading it; fetch it again with the coherent 32-bit read.
+    const bool fast = (mask & pollGroupBit(PollGroup::FAST)) != 0;
+    for (uint8_t i = 0; ok && fast && i < sizeof(kSweep32HiSlots); ++i) {
+        const uint8_t hi = kSweep32HiSlots[i];
+        if (m_sweepRaw[hi] != m_sweepRaw[SW_CHECK_FIRST + i]) {
+            m_ic->_read32Retries++;
+            const uint32_t val = (uint32_t)m_ic->Read32Register(kSweepRegs[hi], kSweepRegs[hi + 1]);
+            m_sweepRaw[hi]     = (uint16_t)(val >> 16);
+            m_sweepRaw[hi + 1] = (uint16_t)(val & 0xFFFF);
+        }
+    }
+
+    m_ic->EndBatch();
+    return ok;
+}
+
+bool ATM90E36Driver::enableStatusInterrupts() {
+    if (!m_ic) return false;
+    DriverLock lock(m_mutex);
+    if (!lock.held()) return false;
+
+    m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x55AA);
+    m_ic->CommEnergyIC(WRITE, REG_FUNC_EN0, STATUS_IRQ0_ENABLE);
+    m_ic->CommEnergyIC(WRITE, REG_FUNC_EN1, STATUS_IRQ1_ENABLE);
+    const uint16_t en0 = m_ic->CommEnergyIC(READ, REG_FUNC_EN0, 0x0000);
+    const uint16_t en1 = m_ic->CommEnergyIC(READ, REG_FUNC_EN1, 0x0000);
+    m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x0000);
+
+    // Discard anything latched during InitEnergy() (e.g. sag while the ADC settles).
+    m_ic->CommEnergyIC(READ, SysStatus0, 0x0000);
+    m_ic->CommEnergyIC(READ, SysStatus1, 0x0000);
+    m_statusLatch0 = 0;
+    m_statusLatch1 = 0;
+
+    if (en0 != STATUS_IRQ0_ENABLE || en1 != STATUS_IRQ1_ENABLE) {
+        Logger::getInstance().warn("ATM90E36: Status IRQ enable readback mismatch (FuncEn0=0x%04X FuncEn1=0x%04X)", en0, en1);
+        return false;
+    }
+    Logger::getInstance().info("ATM90E36: Status IRQs enabled (FuncEn0=0x%04X FuncEn1=0x%04X)", en0, en1);
+    return true;
+}
+
+bool ATM90E36Driver::readPowerQuality(PowerQualityEvent& evt) {
+    if (!m_initialized || !m_ic) return false;
+    DriverLock lock(m_mutex);
+    if (!lock.held()) return false;
+
+    uint16_t regs[STATUS_REG_COUNT];
+    if (m_ic->ReadRegisterSweep(kStatusRegs, regs, STATUS_REG_COUNT) != STATUS_REG_COUNT) {
+        return false;
+    }
+
+    evt.timestampMs = millis();
+    evt.sysStatus0  = (uint16_t)(m_statusLatch0 | regs[0]);
+    evt.sysStatus1  = (uint16_t)(m_statusLatch1 | regs[1]);
+    evt.enStatus0   = regs[2];
+    evt.enStatus1   = regs[3];
+    if (evt.sysStatus1 & SYS1_DFT_DONE) m_dftDone = true;
+    evt.sagPhases       = phaseBits(regs[3], EN1_SAG_PHASE_A, EN1_SAG_PHASE_B, EN1_SAG_PHASE_C);
+    evt.phaseLossPhases = phaseBits(regs[3], EN1_PHASE_LOSS_A, EN1_PHASE_LOSS_B, EN1_PHASE_LOSS_C);
+    m_statusLatch0 = 0;
+    m_statusLatch1 = 0;
+
+    const bool active = (evt.sysStatus0 & PQ_SYS0_MASK) || (evt.sysStatus1 & PQ_SYS1_MASK) ||
+                        evt.sagPhases || evt.phaseLossPhases;
+    if (active) m_pqEvents++;
+    return active;
+}
+
+bool ATM90E36Driver::beginWaveformCapture(uint16_t dmaCtrl) {
+    if (!m_initialized || !m_ic || m_mutex == nullptr) return false;
+
+    // Held across the capture; released by endWaveformCapture().
+    if (xSemaphoreTakeRecursive(m_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) return false;
+
+    // DMACtrl must be written while the bus is still ours (the SPIBus mutex is not recursive).
+    m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x55AA);
+    m_ic->CommEnergyIC(WRITE, REG_DMA_CTRL, dmaCtrl);
+    const uint16_t back = m_ic->CommEnergyIC(READ, REG_DMA_CTRL, 0x0000);
+    m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x0000);
+
+    if (back != dmaCtrl) {
+        Logger::getInstance().warn("ATM90E36: DMACtrl readback mismatch (wrote 0x%04X read 0x%04X)", dmaCtrl, back);
+        xSemaphoreGiveRecursive(m_mutex);
+        return false;
+    }
+
+    if (!SPIBus::getInstance().suspend()) {
+        Logger::getInstance().warn("ATM90E36: SPI bus busy, waveform capture not started");
+        xSemaphoreGiveRecursive(m_mutex);
+        return false;
+    }
+
+    m_dmaActive = true;
+    return true;
+}
+
+void ATM90E36Driver::endWaveformCapture() {
+    if (!m_dmaActive) return;
+    SPIBus::getInstance().resume();
+    m_dmaActive = false;
+    xSemaphoreGiveRecursive(m_mutex);
+}
+
+bool ATM90E36Driver::startDft(uint16_t dftScale) {
+    if (!m_initialized || !m_ic || m_dmaActive) return false;
+    DriverLock lock(m_mutex);
+    if (!lock.held()) return false;
+
+    m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x55AA);
+    m_ic->CommEnergyIC(WRITE, REG_DFT_SCALE, dftScale);
+    m_ic->CommEnergyIC(WRITE, REG_DFT_CTRL, 0x0000);   // Reset any pass still running
+    m_dftDone = false;
+    m_ic->CommEnergyIC(WRITE, REG_DFT_CTRL, DFT_CTRL_START);
+    const uint16_t ctrl = m_ic->CommEnergyIC(READ, REG_DFT_CTRL, 0x0000);
+    m_ic->CommEnergyIC(WRITE, REG_CFG_REG_ACC_EN, 0x0000);
+
+    // A pass takes 0.5 s, so DFT_START must still read back set.
+    if (!(ctrl & DFT_CTRL_START)) {
+        Logger::getInstance().warn("ATM90E36: DFT did not start (DFT_CTRL=0x%04X)", ctrl);
+        return false;
+    }
+    return true;
+}
+
+bool ATM90E36Driver::abortDft() {
+    if (!m_initialized || !m_ic || m_dmaActive) return false;
+    DriverLock lock(m_mutex);
+    if (!lock.held()) return false;
+    m_ic->CommEnergyIC(WRITE, REG_DFT_CTRL, 0x0000);
+    m_dftDone = false;
+    return true;
+}
+
+bool ATM90E36Driver::isDftDone() {
+    if (!m_initialized || !m_ic || m_dmaActive) return false;
+    DriverLock lock(m_mutex);
+    if (!lock.held()) return false;
+    if (m_dftDone) return true;
+
+    // DFTDone can be missed if IRQ1 is not wired and nothing read SysStatus1 yet.
+    const uint16_t ctrl = m_ic->CommEnergyIC(READ, REG_DFT_CTRL, 0x0000);
+    if (!(ctrl & DFT_CTRL_START)) m_dftDone = true;
+    return m_dftDone;
+}
+
+bool ATM90E36Driver::readRegisterBlock(uint16_t firstReg, uint16_t* out, uint8_t count) {
+    if (!m_initialized || !m_ic || m_dmaActive || !out || count == 0 || count > MAX_BLOCK_READ) return false;
+    DriverLock lock(m_mutex);
+    if (!lock.held()) return false;
+
+    unsigned short addrs[MAX_BLOCK_READ];
+    for (uint8_t i = 0; i < count; i++) addrs[i] = (unsigned short)(firstReg + i);
+    return m_ic->ReadRegisterSweep(addrs, out, count) == count;
+}
+
+bool ATM90E36Driver::readActivePowerRaw(int32_t pmean[4], uint32_t lockTimeoutMs) {
+    if (!m_initialized || !m_ic || m_dmaActive || !pmean) return false;
+    DriverLock lock(m_mutex, lockTimeoutMs);
+    if (!lock.held()) return false;
+
+    // HI/LO pairs in RawPhase order, then the HI words again for the tear check
+    static const unsigned short kPowerRegs[] = {
+        PmeanA, PmeanALSB, PmeanB, PmeanBLSB, PmeanC, PmeanCLSB, PmeanT, PmeanTLSB,
+        PmeanA, PmeanB, PmeanC, PmeanT
+    };
+    constexpr uint8_t PAIRS = 4;
+    constexpr uint8_t COUNT = sizeof(kPowerRegs) / sizeof(kPowerRegs[0]);
+    uint16_t raw[COUNT];
+
+    if (!m_ic->BeginBatch()) return false;
+    bool ok = (m_ic->ReadRegisterSweep(kPowerRegs, raw, COUNT) == COUNT);
+    for (uint8_t i = 0; ok && i < PAIRS; i++) {
+        const uint8_t hi = (uint8_t)(i * 2);
+        if (raw[hi] != raw[PAIRS * 2 + i]) {
+            m_ic->_read32Retries++;
+            const uint32_t val = (uint32_t)m_ic->Read32Register(kPowerRegs[hi], kPowerRegs[hi + 1]);
+            raw[hi]     = (uint16_t)(val >> 16);
+            raw[hi + 1] = (uint16_t)(val & 0xFFFF);
+        }
+        pmean[i] = rawS32(raw, hi);
+    }
+    m_ic->EndBatch();
+    return ok;
+}
+
 bool ATM90E36Driver::verifyChecksums() {
     // The V1.0 driver does not expose explicit checksum verification for all sections on ATM90E36.
     // We treat "no calibration error" + non-zero SYS status as a practical verification.
@@ -256,12 +850,20 @@ float ATM90E36Driver::getCurrentTHDC() { return m_initialized ? (float)m_ic->Get
 float ATM90E36Driver::getFrequency() { return m_initialized ? (float)m_ic->GetFrequency() : 0.0f; }
 float ATM90E36Driver::getTemperature() { return m_initialized ? (float)m_ic->GetTemperature() : 0.0f; }
 
-// Energy raw getters not used (V2 uses float kWh fields in MeterData)
-uint32_t ATM90E36Driver::getFwdActiveEnergyA() { return 0; }
-uint32_t ATM90E36Driver::getFwdActiveEnergyB() { return 0; }
-uint32_t ATM90E36Driver::getFwdActiveEnergyC() { return 0; }
-uint32_t ATM90E36Driver::getFwdActiveEnergyTotal() { return 0; }
-uint32_t ATM90E36Driver::getRevActiveEnergyA() { return 0; }
-uint32_t ATM90E36Driver::getRevActiveEnergyB() { return 0; }
-uint32_t ATM90E36Driver::getRevActiveEnergyC() { return 0; }
-uint32_t ATM90E36Driver::getRevActiveEnergyTotal() { return 0; }
\ No newline at end of file
+uint64_t ATM90E36Driver::getEnergyCount(RawEnergy type, uint8_t phase) {
+    if (type >= RAW_EN_COUNT || phase > RAW_T) return 0;
+    // 64-bit totals are not updated atomically; read them under the driver lock
+    DriverLock lock(m_mutex);
+    if (!lock.held()) return 0;
+    return m_energyCount[type][phase];
+}
+
+// Legacy 32-bit getters: low word of the pulse totals (0.01 CF)
+uint32_t ATM90E36Driver::getFwdActiveEnergyA() { return (uint32_t)getEnergyCount(RAW_EN_AP, RAW_A); }
+uint32_t ATM90E36Driver::getFwdActiveEnergyB() { return (uint32_t)getEnergyCount(RAW_EN_AP, RAW_B); }
+uint32_t ATM90E36Driver::getFwdActiveEnergyC() { return (uint32_t)getEnergyCount(RAW_EN_AP, RAW_C); }
+uint32_t ATM90E36Driver::getFwdActiveEnergyTotal() { return (uint32_t)getEnergyCount(RAW_EN_AP, RAW_T); }
+uint32_t ATM90E36Driver::getRevActiveEnergyA() { return (uint32_t)getEnergyCount(RAW_EN_AN, RAW_A); }
+uint32_t ATM90E36Driver::getRevActiveEnergyB() { return (uint32_t)getEnergyCount(RAW_EN_AN, RAW_B); }
+uint32_t ATM90E36Driver::getRevActiveEnergyC() { return (uint32_t)getEnergyCount(RAW_EN_AN, RAW_C); }
+uint32_t ATM90E36Driver::getRevActiveEnergyTotal() { return (uint32_t)getEnergyCount(RAW_EN_AN, RAW_T); }
\ No newline at end of file
@@ -8,17 +8,34 @@
  * proven V1.0 driver (EnergyATM90E36.{h,cpp}).
  *
  * Key goals:
- * - Use the original V1.0 CommEnergyIC() (200kHz, MODE3, byte-wise transfer, byte swap)
+ * - Use the original V1.0 CommEnergyIC() framing (MODE3, MSB-first 16-bit words),
+ *   routed through SPIBus so the bus mutex is shared with the W5500
  * - Use the original V1.0 begin() + InitEnergy() sequences
  * - Keep the V2 MeterData/PhaseData structures and APIs intact
  */
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "DataTypes.h"
+#include "RawMeterFrame.h"
 
 // Forward declaration (defined in EnergyATM90E36.h)
 class ATM90E3x;
 
+// Register polling classes. Each group has its own period and readScheduled()
+// only reads the groups that are due.
+enum class PollGroup : uint8_t {
+    FAST = 0,   // RMS voltage/current, active/reactive/apparent power, PF, status
+    MEDIUM,     // Phase angles, THD+N, frequency
+    SLOW,       // Die temperature
+    ENERGY,     // Clear-on-read energy counters (per phase and total), never on a MEDIUM/SLOW tick
+    COUNT
+};
+
+constexpr uint8_t pollGroupBit(PollGroup g) { return (uint8_t)(1U << (uint8_t)g); }
+constexpr uint8_t POLL_GROUPS_ALL = (uint8_t)((1U << (uint8_t)PollGroup::COUNT) - 1);
+
 class ATM90E36Driver {
 public:
     static ATM90E36Driver& getInstance() {
@@ -29,6 +46,22 @@ public:
     bool init(const CalibrationConfig& config);
     bool readAll(MeterData& data);
 
+    // Tiered polling: reads only the groups whose period has elapsed and decodes all
+    // fields (groups that were not due keep their last value). groupsRead receives
+    // the pollGroupBit() mask of groups actually read.
+    bool readScheduled(MeterData& data, uint8_t* groupsRead = nullptr);
+
+    // Same as readScheduled() without the float conversion: the frame holds the
+    // register values as read (scale with RAW_SCALE / rawFrameToMeterData()).
+    bool readScheduledRaw(RawMeterFrame& frame, uint8_t* groupsRead = nullptr);
+    void setPollPeriod(PollGroup group, uint32_t periodMs);
+    uint32_t getPollPeriod(PollGroup group) const;
+
+    static constexpr uint32_t POLL_FAST_MS   = 100;
+    static constexpr uint32_t POLL_MEDIUM_MS = 1000;
+    static constexpr uint32_t POLL_SLOW_MS   = 10000;
+    static constexpr uint32_t POLL_ENERGY_MS = 1000;
+
     bool verifyChecksums();
     bool hasCalibrationError();
     bool softReset();
@@ -76,7 +109,13 @@ public:
     float getFrequency();
     float getTemperature();
 
-    // Raw energy (not currently used by V2, kept for API completeness)
+    // Energy pulse totals since init (RawQuantity::ENERGY units). The IC registers are
+    // clear-on-read; every ENERGY poll adds them to 64-bit software counters, so no
+    // pulse is lost between reads and RawMeterFrame::energy always holds the totals.
+    // init() restarts them and RawMeterFrame::energyEpoch tells consumers it did.
+    uint64_t getEnergyCount(RawEnergy type, uint8_t phase);
+
+    // Legacy 32-bit views of getEnergyCount()
     uint32_t getFwdActiveEnergyA();
     uint32_t getFwdActiveEnergyB();
     uint32_t getFwdActiveEnergyC();
@@ -88,16 +127,104 @@ public:
 
     ErrorCode getLastError() const { return m_lastError; }
 
+    // Register sweep used by readAll(): one batched SPI pass into a raw snapshot.
+    static constexpr uint8_t SWEEP_REG_COUNT = 84;
+    const uint16_t* getRawSnapshot() const { return m_sweepRaw; }
+    uint32_t getLastSweepMicros() const;
+    uint32_t getSweepCount() const;
+    uint32_t getRead32Retries() const;   // Torn 32-bit HI/LO pairs detected and re-read
+
+    // SPI link training: steps the clock up through SPI_TRAINING_STEPS_ATM90E36 and keeps
+    // the fastest rate whose readback verifies. The link is judged only by static
+    // configuration registers (PLconstH must read its programmed default) and a
+    // ZXConfig write/readback, never by measurement values. Runs at init, periodically from readAll(),
+    // and again after a fallback to the baseline clock.
+    static constexpr uint8_t LINK_CHECK_REG_COUNT = 8;
+    bool trainSpiClock();
+    uint32_t getSpiClock() const;
+    uint32_t getSpiFaultCount() const { return m_spiFaults; }
+    uint32_t getEnergyReadsDropped() const { return m_energyReadsDropped; }   // Energy sweeps lost to an SPI fault
+
+    // Power quality status (IRQ0/IRQ1/WarnOut). SysStatus0/1 are clear-on-read and the
+    // FAST sweep also reads them, so every read latches their bits until the next
+    // readPowerQuality(). Returns true when any sag/phase-loss/warning bit is set.
+    bool enableStatusInterrupts();
+    bool readPowerQuality(PowerQualityEvent& evt);
+    uint32_t getPowerQualityEventCount() const { return m_pqEvents; }
+
+    // FuncEn0/FuncEn1 interrupt enables written by enableStatusInterrupts()
+    static constexpr uint16_t STATUS_IRQ0_ENABLE = 0x00CC;   // URevWn, IRevWn, SagWarn, PhaseLoseWn
+    static constexpr uint16_t STATUS_IRQ1_ENABLE = 0xCE00;   // INOv1, INOv0, THDUOv, THDIOv, DFTDone
+
+    // Waveform capture (DMA mode). beginWaveformCapture() programs DMACtrl and then holds
+    // the driver lock and the suspended SPI bus while the ATM90E36 masters it; register
+    // reads from other tasks fail until endWaveformCapture(), called from the same task.
+    bool beginWaveformCapture(uint16_t dmaCtrl);
+    void endWaveformCapture();
+    bool isWaveformCaptureActive() const { return m_dmaActive; }
+
+    // Hardware DFT (see HarmonicSweep). startDft() starts one 0.5 s pass and returns at
+    // once; completion is SysStatus1.DFTDone (IRQ1), latched by every status read like
+    // the PQ bits, with the self-clearing DFT_START bit as a fallback.
+    bool startDft(uint16_t dftScale);
+    bool abortDft();
+    bool isDftDone();
+
+    // Reads `count` (<= MAX_BLOCK_READ) consecutive registers in one batched sweep.
+    // Callers keep blocks short so the EnergyTask never waits long on the driver lock.
+    static constexpr uint8_t MAX_BLOCK_READ = 32;
+    bool readRegisterBlock(uint16_t firstReg, uint16_t* out, uint8_t count);
+
+    // Fast power path (see FastPowerSampler): only PmeanA/B/C/T, 32-bit HI/LO pairs
+    // with the same tear re-check as the FAST sweep, in one short bus batch.
+    // pmean receives A, B, C, T (RawPhase order) in RawQuantity::POWER units.
+    bool readActivePowerRaw(int32_t pmean[4], uint32_t lockTimeoutMs = 20);
+
 private:
     ATM90E36Driver();
     ~ATM90E36Driver() = default;
     ATM90E36Driver(const ATM90E36Driver&) = delete;
     ATM90E36Driver& operator=(const ATM90E36Driver&) = delete;
 
+    bool captureLinkRef();
+    bool verifySpiLink(bool writeCheck);
+    bool sweepRegisters(uint8_t mask);
+    bool readGroups(RawMeterFrame& frame, uint8_t mask, uint8_t* groupsRead = nullptr);
+
 private:
     bool m_initialized;
     ErrorCode m_lastError;
 
     // Underlying proven V1.0 driver
     ATM90E3x* m_ic;
+
+    // Serialises the EnergyTask sweep and the power quality task (recursive: the
+    // sweep can retrain the SPI clock while holding it)
+    SemaphoreHandle_t m_mutex;
+
+    // SysStatus bits seen since the last readPowerQuality()
+    uint16_t m_statusLatch0;
+    uint16_t m_statusLatch1;
+    uint32_t m_pqEvents;
+
+    volatile bool m_dmaActive;
+    bool m_dftDone;     // DFTDone seen in SysStatus1 since startDft()
+
+    // Raw register values from the last sweep (indexed by the slot list in the .cpp)
+    uint16_t m_sweepRaw[SWEEP_REG_COUNT];
+
+    // SPI link training state
+    uint16_t m_linkRef[LINK_CHECK_REG_COUNT];   // Reference values read at the baseline clock
+    uint32_t m_spiFaults;
+    uint32_t m_energyReadsDropped;
+    uint32_t m_nextTrainMs;
+
+    // Tiered polling state (index = PollGroup)
+    uint32_t m_pollPeriodMs[(uint8_t)PollGroup::COUNT];
+    uint32_t m_pollLastMs[(uint8_t)PollGroup::COUNT];
+    bool m_pollValid[(uint8_t)PollGroup::COUNT];
+
+    // Software extension of the clear-on-read energy registers, [RawEnergy][A, B, C, T]
+    uint64_t m_energyCount[RAW_EN_COUNT][4];
+    uint32_t m_energyEpoch;     // Bumped each time m_energyCount restarts from zero
 };
@@ -31,6 +31,7 @@ uint16_t BACnetIntegration::_refreshIntervalMs = 500;
 float BACnetIntegration::_dcDividerRatio = 11.0f; // default 100k/10k style divider
 float BACnetIntegration::_dcGain = 1.0f;
 float BACnetIntegration::_dcOffset = 0.0f;
+uint32_t BACnetIntegration::_meterDeltaSeq = 0;
 
 namespace {
 String formatMac(const uint8_t* m) {
@@ -44,6 +45,49 @@ String getIfaceMac(wifi_interface_t iface) {
     return String("00:00:00:00:00:00");
 }
 String boolStr(bool v) { return v ? "ON" : "OFF"; }
+
+struct MeterAnalogInput {
+    uint32_t instance;
+    uint8_t field;      // MeterField
+    uint16_t units;
+    const char* name;
+    const char* description;
+};
+
+// Phase voltages/currents/power/frequency/energy (subset + requested mapping)
+const MeterAnalogInput kMeterInputs[] = {
+    { 1,  FIELD_URMS_A, BACNET_UNITS_VOLTS,   "PhaseA_Voltage", "Phase A Voltage RMS" },
+    { 2,  FIELD_URMS_B, BACNET_UNITS_VOLTS,   "PhaseB_Voltage", "Phase B Voltage RMS" },
+    { 3,  FIELD_URMS_C, BACNET_UNITS_VOLTS,   "PhaseC_Voltage", "Phase C Voltage RMS" },
+
+    { 11, FIELD_IRMS_A, BACNET_UNITS_AMPERES, "PhaseA_Current", "Phase A Current RMS" },
+    { 12, FIELD_IRMS_B, BACNET_UNITS_AMPERES, "PhaseB_Current", "Phase B Current RMS" },
+    { 13, FIELD_IRMS_C, BACNET_UNITS_AMPERES, "PhaseC_Current", "Phase C Current RMS" },
+
+    { 21, FIELD_P_A, BACNET_UNITS_WATTS, "PhaseA_ActivePower", "Phase A Active Power" },
+    { 22, FIELD_P_B, BACNET_UNITS_WATTS, "PhaseB_ActivePower", "Phase B Active Power" },
+    { 23, FIELD_P_C, BACNET_UNITS_WATTS, "PhaseC_ActivePower", "Phase C Active Power" },
+
+    { 31, FIELD_PF_A, BACNET_UNITS_NO_UNITS, "PhaseA_PF", "Phase A Power Factor" },
+    { 32, FIELD_PF_B, BACNET_UNITS_NO_UNITS, "PhaseB_PF", "Phase B Power Factor" },
+    { 33, FIELD_PF_C, BACNET_UNITS_NO_UNITS, "PhaseC_PF", "Phase C Power Factor" },
+
+    { 40, FIELD_P_T, BACNET_UNITS_WATTS, "Total_ActivePower", "Total Active Power" },
+    { 41, FIELD_Q_T, BACNET_UNITS_VOLT_AMPERES_REACTIVE, "Total_ReactivePower", "Total Reactive Power" },
+    { 42, FIELD_S_T, BACNET_UNITS_VOLT_AMPERES, "Total_ApparentPower", "Total Apparent Power" },
+    { 43, FIELD_PF_T, BACNET_UNITS_NO_UNITS, "Total_PF", "Total Power Factor" },
+    { 44, FIELD_FREQ, BACNET_UNITS_HERTZ, "Frequency", "Line Frequency" },
+    { 45, FIELD_IRMS_N, BACNET_UNITS_AMPERES, "Neutral_Current", "Neutral Current" },
+
+    { 50, FIELD_BOARD_TEMP, BACNET_UNITS_DEGREES_CELSIUS, "Board_Temperature", "Board Temperature" },
+    { 51, FIELD_AMBIENT_TEMP, BACNET_UNITS_DEGREES_CELSIUS, "Ambient_Temperature", "Ambient Temperature" },
+    { 52, FIELD_AMBIENT_HUMIDITY, BACNET_UNITS_PERCENT, "Ambient_Humidity", "Ambient Humidity" },
+
+    { 60, FIELD_EP_FWD_T, BACNET_UNITS_KILOWATT_HOURS, "Energy_kWh_Fwd", "Total Forward Active Energy" },
+    { 61, FIELD_EP_REV_T, BACNET_UNITS_KILOWATT_HOURS, "Energy_kWh_Rev", "Total Reverse Active Energy" },
+    { 62, FIELD_EQ_FWD_T, BACNET_UNITS_KILOVAR_HOURS, "Energy_kVARh_Fwd", "Total Forward Reactive Energy" },
+    { 63, FIELD_EQ_REV_T, BACNET_UNITS_KILOVAR_HOURS, "Energy_kVARh_Rev", "Total Reverse Reactive Energy" },
+};
 }
 
 void BACnetIntegration::initialize() {
@@ -76,13 +120,17 @@ void BACnetIntegration::initialize() {
 #endif
     pinMode(PIN_ADC_DCV_IN, INPUT);
 
+    _meterDeltaSeq = 0;     // Objects are (re)created on the next pass
     _initialized = true;
     Logger::getInstance().info("BACnetIntegration: Initialized");
 }
 
 void BACnetIntegration::setEnabled(bool enabled) {
     _enabled = enabled;
-    if (!enabled) BACnetDriver::getInstance().end();
+    if (!enabled) {
+        BACnetDriver::getInstance().end();
+        _meterDeltaSeq = 0;
+    }
 }
 
 bool BACnetIntegration::isEnabled() { return _enabled; }
@@ -249,40 +297,16 @@ float BACnetIntegration::readScaledDCVoltage() {
 
 void BACnetIntegration::updateAnalogInputs() {
     BACnetDriver& b = BACnetDriver::getInstance();
-    MeterData m = EnergyMeter::getInstance().getSnapshot();
-
-    // Phase voltages/currents/power/frequency/energy (subset + requested mapping)
-    b.updateAnalogInput(1,  m.phaseA.voltageRMS, BACNET_UNITS_VOLTS,   "PhaseA_Voltage", "Phase A Voltage RMS");
-    b.updateAnalogInput(2,  m.phaseB.voltageRMS, BACNET_UNITS_VOLTS,   "PhaseB_Voltage", "Phase B Voltage RMS");
-    b.updateAnalogInput(3,  m.phaseC.voltageRMS, BACNET_UNITS_VOLTS,   "PhaseC_Voltage", "Phase C Voltage RMS");
-
-    b.updateAnalogInput(11, m.phaseA.currentRMS, BACNET_UNITS_AMPERES, "PhaseA_Current", "Phase A Current RMS");
-    b.updateAnalogInput(12, m.phaseB.currentRMS, BACNET_UNITS_AMPERES, "PhaseB_Current", "Phase B Current RMS");
-    b.updateAnalogInput(13, m.phaseC.currentRMS, BACNET_UNITS_AMPERES, "PhaseC_Current", "Phase C Current RMS");
-
-    b.updateAnalogInput(21, m.phaseA.activePower, BACNET_UNITS_WATTS, "PhaseA_ActivePower", "Phase A Active Power");
-    b.updateAnalogInput(22, m.phaseB.activePower, BACNET_UNITS_WATTS, "PhaseB_ActivePower", "Phase B Active Power");
-    b.updateAnalogInput(23, m.phaseC.activePower, BACNET_UNITS_WATTS, "PhaseC_ActivePower", "Phase C Active Power");
-
-    b.updateAnalogInput(31, m.phaseA.powerFactor, BACNET_UNITS_NO_UNITS, "PhaseA_PF", "Phase A Power Factor");
-    b.updateAnalogInput(32, m.phaseB.powerFactor, BACNET_UNITS_NO_UNITS, "PhaseB_PF", "Phase B Power Factor");
-    b.updateAnalogInput(33, m.phaseC.powerFactor, BACNET_UNITS_NO_UNITS, "PhaseC_PF", "Phase C Power Factor");
-
-    b.updateAnalogInput(40, m.totalActivePower, BACNET_UNITS_WATTS, "Total_ActivePower", "Total Active Power");
-    b.updateAnalogInput(41, m.totalReactivePower, BACNET_UNITS_VOLT_AMPERES_REACTIVE, "Total_ReactivePower", "Total Reactive Power");
-    b.updateAnalogInput(42, m.totalApparentPower, BACNET_UNITS_VOLT_AMPERES, "Total_ApparentPower", "Total Apparent Power");
-    b.updateAnalogInput(43, m.totalPowerFactor, BACNET_UNITS_NO_UNITS, "Total_PF", "Total Power Factor");
-    b.updateAnalogInput(44, m.frequency, BACNET_UNITS_HERTZ, "Frequency", "Line Frequency");
-    b.updateAnalogInput(45, m.neutralCurrent, BACNET_UNITS_AMPERES, "Neutral_Current", "Neutral Current");
-
-    b.updateAnalogInput(50, m.boardTemperature, BACNET_UNITS_DEGREES_CELSIUS, "Board_Temperature", "Board Temperature");
-    b.updateAnalogInput(51, m.ambientTemperature, BACNET_UNITS_DEGREES_CELSIUS, "Ambient_Temperature", "Ambient Temperature");
-    b.updateAnalogInput(52, m.ambientHumidity, BACNET_UNITS_PERCENT, "Ambient_Humidity", "Ambient Humidity");
-
-    b.updateAnalogInput(60, m.totalFwdActiveEnergy, BACNET_UNITS_KILOWATT_HOURS, "Energy_kWh_Fwd", "Total Forward Active Energy");
-    b.updateAnalogInput(61, m.totalRevActiveEnergy, BACNET_UNITS_KILOWATT_HOURS, "Energy_kWh_Rev", "Total Reverse Active Energy");
-    b.updateAnalogInput(62, m.totalFwdReactiveEnergy, BACNET_UNITS_KILOVAR_HOURS, "Energy_kVARh_Fwd", "Total Forward Reactive Energy");
-    b.updateAnalogInput(63, m.totalRevReactiveEnergy, BACNET_UNITS_KILOVAR_HOURS, "Energy_kVARh_Rev", "Total Reverse Reactive Energy");
+    MeterData m;
+    MeterFieldMask changed;
+    // Only objects whose value left its deadband are rewritten; the first pass sets them all up
+    _meterDeltaSeq = EnergyMeter::getInstance().getSnapshotDelta(_meterDeltaSeq, m, changed);
+
+    for (size_t i = 0; i < sizeof(kMeterInputs) / sizeof(kMeterInputs[0]); i++) {
+        const MeterAnalogInput& ai = kMeterInputs[i];
+        if (!changed.test(ai.field)) continue;
+        b.updateAnalogInput(ai.instance, meterFieldValue(m, ai.field), ai.units, ai.name, ai.description);
+    }
 
     // Requested GPIO36 scaled DC voltage input
     b.updateAnalogInput(70, readScaledDCVoltage(), BACNET_UNITS_VOLTS, "DC_Input_Voltage", "Scaled DC voltage @ GPIO36 ADC1_CH0");
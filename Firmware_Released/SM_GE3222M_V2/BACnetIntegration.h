@@ -32,5 +32,6 @@ private:
     static float _dcDividerRatio;
     static float _dcGain;
     static float _dcOffset;
+    static uint32_t _meterDeltaSeq;     // EnergyMeter change sequence already published
 };
 
@@ -5,6 +5,9 @@
 
 #include "ConfigManager.h"
 #include "Logger.h"
+#include "EventBus.h"
+#include "MeterFilterBank.h"
+#include "FastPowerSampler.h"
 #include <nvs_flash.h>
 
 // Preferences.begin() can fail on devices with corrupted NVS or unexpected partition state.
@@ -156,6 +159,7 @@ bool ConfigManager::loadMQTTConfig(MQTTConfig& config) {
     config.publishInterval = prefs.getUShort("publishInterval", 10);
     config.useHomeAssistant = prefs.getBool("useHA", true);
     config.useTLS = prefs.getBool("useTLS", false);
+    config.binaryPayload = prefs.getBool("binPayload", false);
     
     prefs.getString("broker", config.broker, sizeof(config.broker));
     prefs.getString("username", config.username, sizeof(config.username));
@@ -179,6 +183,7 @@ bool ConfigManager::saveMQTTConfig(const MQTTConfig& config) {
     prefs.putUShort("publishInterval", config.publishInterval);
     prefs.putBool("useHA", config.useHomeAssistant);
     prefs.putBool("useTLS", config.useTLS);
+    prefs.putBool("binPayload", config.binaryPayload);
     
     prefs.putString("broker", config.broker);
     prefs.putString("username", config.username);
@@ -277,6 +282,29 @@ bool ConfigManager::loadSystemConfig(SystemConfig& config) {
     config.dhtReadIntervalMs = prefs.getUShort("dhtIntMs", 3000);
     config.dhtDebugLogging = prefs.getBool("dhtDbg", false);
     if (config.dhtReadIntervalMs < 2000) config.dhtReadIntervalMs = 2000;
+    config.fastPowerEnabled = prefs.getBool("fpEnabled", false);
+    config.fastPowerIntervalMs = FastPowerSampler::sanitizeInterval(prefs.getUChar("fpIntMs", 20));
+    config.loadShedRelay = prefs.getUChar("shedRelay", 0);
+    if (config.loadShedRelay > 2) config.loadShedRelay = 0;
+    config.loadShedLimitW = prefs.getFloat("shedLimitW", 10000.0f);
+    config.loadShedRestoreW = prefs.getFloat("shedRestW", 8000.0f);
+    config.loadShedRestoreMs = prefs.getUShort("shedRestMs", 5000);
+    config.energySource = (prefs.getUChar("enSource", 0) == (uint8_t)EnergySource::INTEGRATED)
+                              ? EnergySource::INTEGRATED : EnergySource::COUNTERS;
+
+    // Filter table is stored whole; a size mismatch (other firmware layout) keeps the defaults
+    if (prefs.getBytesLength("mFilters") == sizeof(config.meterFilters)) {
+        prefs.getBytes("mFilters", config.meterFilters, sizeof(config.meterFilters));
+        for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+            config.meterFilters[ch] = MeterFilterBank::sanitize(config.meterFilters[ch]);
+        }
+    }
+    if (prefs.getBytesLength("mDeadband") == sizeof(config.meterDeadbands)) {
+        prefs.getBytes("mDeadband", config.meterDeadbands, sizeof(config.meterDeadbands));
+        for (uint8_t q = 0; q < MQ_COUNT; q++) {
+            if (!(config.meterDeadbands[q] >= 0.0f)) config.meterDeadbands[q] = 0.0f;   // Also catches NaN
+        }
+    }
     
     prefs.getString("otaPassword", config.otaPassword, sizeof(config.otaPassword));
     
@@ -302,11 +330,23 @@ bool ConfigManager::saveSystemConfig(const SystemConfig& config) {
     prefs.putBool("dhtEnabled", config.dhtEnabled);
     prefs.putUShort("dhtIntMs", (config.dhtReadIntervalMs < 2000 ? 2000 : config.dhtReadIntervalMs));
     prefs.putBool("dhtDbg", config.dhtDebugLogging);
+    prefs.putBool("fpEnabled", config.fastPowerEnabled);
+    prefs.putUChar("fpIntMs", FastPowerSampler::sanitizeInterval(config.fastPowerIntervalMs));
+    prefs.putUChar("shedRelay", config.loadShedRelay);
+    prefs.putFloat("shedLimitW", config.loadShedLimitW);
+    prefs.putFloat("shedRestW", config.loadShedRestoreW);
+    prefs.putUShort("shedRestMs", config.loadShedRestoreMs);
+    prefs.putUChar("enSource", static_cast<uint8_t>(config.energySource));
+    prefs.putBytes("mFilters", config.meterFilters, sizeof(config.meterFilters));
+    prefs.putBytes("mDeadband", config.meterDeadbands, sizeof(config.meterDeadbands));
     
     prefs.putString("otaPassword", config.otaPassword);
     
     prefs.end();
     Logger::getInstance().info("System config saved");
+
+    // Whoever saved it, everything that follows the config (task cadence) reloads it
+    EventBus::getInstance().publish(EventType::CONFIG_CHANGED);
     return true;
 }
 
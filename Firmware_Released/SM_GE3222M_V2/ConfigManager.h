@@ -29,7 +29,7 @@ public:
     
     // System Configuration
     bool loadSystemConfig(SystemConfig& config);
-    bool saveSystemConfig(const SystemConfig& config);
+    bool saveSystemConfig(const SystemConfig& config);    // Publishes CONFIG_CHANGED
     
     // Factory Reset
     bool factoryReset();
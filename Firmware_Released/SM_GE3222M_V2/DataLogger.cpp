@@ -89,7 +89,7 @@ void DataLogger::logReading(const MeterData& data) {
     
     // Store reading in ring buffer
     _buffer[_head].data = data;
-    _buffer[_head].timestamp = millis() / 1000; // Convert to seconds
+    _buffer[_head].timestamp = data.timestamp;  // Acquisition time (UTC s once NTP synced)
     
     // Advance head pointer
     _head = (_head + 1) % _maxEntries;
@@ -210,7 +210,7 @@ size_t DataLogger::getBufferCount() const {
 }
 
 String DataLogger::generateCSVHeader() {
-    return "Timestamp,Seq,"
+    return "Timestamp,UTC_ms,Mono_us,Seq,"
            "V_A,I_A,P_A,Q_A,S_A,PF_A,E_A_Fwd,"
            "V_B,I_B,P_B,Q_B,S_B,PF_B,E_B_Fwd,"
            "V_C,I_C,P_C,Q_C,S_C,PF_C,E_C_Fwd,"
@@ -221,14 +221,16 @@ String DataLogger::generateCSVHeader() {
 String DataLogger::generateCSVRow(const LoggedReading& reading) {
     char row[512];
     snprintf(row, sizeof(row),
-        "%lu,%lu,"
+        "%lu,%llu,%lld,%lu,"
         "%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,"
         "%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,"
         "%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,"
         "%.2f,%.2f,%.2f,%.3f,%.3f,"
         "%.2f,%.2f,%.1f,%.1f,%.1f",
-        reading.timestamp,
-        reading.data.sequenceNumber,
+        (unsigned long)reading.timestamp,
+        (unsigned long long)reading.data.utcMs,
+        (long long)reading.data.timestampUs,
+        (unsigned long)reading.data.sequenceNumber,
         // Phase A
         reading.data.phaseA.voltageRMS,
         reading.data.phaseA.currentRMS,
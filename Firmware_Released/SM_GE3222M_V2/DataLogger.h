@@ -15,7 +15,7 @@
 
 struct LoggedReading {
     MeterData data;
-    uint32_t timestamp;
+    uint32_t timestamp;     // MeterData::timestamp of the reading
     
     LoggedReading() : timestamp(0) {}
 };
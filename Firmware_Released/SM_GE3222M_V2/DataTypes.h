@@ -147,8 +147,10 @@ struct MeterData {
     // Status
     uint16_t meteringStatus0;   // ATM90E36 Status Register 0
     uint16_t meteringStatus1;   // ATM90E36 Status Register 1
-    uint32_t timestamp;         // Unix timestamp (seconds)
+    uint32_t timestamp;         // Unix timestamp (seconds); uptime seconds until NTP sync
     uint32_t sequenceNumber;    // Incrementing sequence number
+    int64_t  timestampUs;       // esp_timer time of the SPI read (us since boot, monotonic)
+    uint64_t utcMs;             // UTC epoch ms of the same read (0 until NTP sync)
     bool     valid;             // Data validity flag
     
     // Initialize with zeros
@@ -157,6 +159,78 @@ struct MeterData {
     }
 };
 
+// ============================================================================
+// POWER QUALITY EVENT (ATM90E36 IRQ0/IRQ1/WarnOut)
+// ============================================================================
+// Source of a power quality read (bitmask)
+constexpr uint8_t PQ_SOURCE_IRQ0  = 0x01;   // ATM90E36 IRQ0 (SysStatus0)
+constexpr uint8_t PQ_SOURCE_IRQ1  = 0x02;   // ATM90E36 IRQ1 (SysStatus1)
+constexpr uint8_t PQ_SOURCE_WARN  = 0x04;   // ATM90E36 WarnOut (checksum error)
+constexpr uint8_t PQ_SOURCE_POLL  = 0x08;   // Periodic fallback / bits latched by the FAST sweep
+
+struct PowerQualityEvent {
+    uint32_t timestampMs;       // millis() when the status was read
+    uint32_t irqMicros;         // micros() captured in the MCP23017 INTB ISR (0 if polled)
+    uint16_t sysStatus0;        // SysStatus0 bits (latched since the last event)
+    uint16_t sysStatus1;        // SysStatus1 bits (latched since the last event)
+    uint16_t enStatus0;         // EnStatus0 (no-load / CF direction)
+    uint16_t enStatus1;         // EnStatus1 (per-phase sag / phase loss)
+    uint8_t  source;            // PQ_SOURCE_* bits
+    uint8_t  sagPhases;         // bit0=A, bit1=B, bit2=C
+    uint8_t  phaseLossPhases;   // bit0=A, bit1=B, bit2=C
+    uint8_t  reserved;
+
+    PowerQualityEvent() {
+        memset(this, 0, sizeof(PowerQualityEvent));
+    }
+};
+
+// ============================================================================
+// HARMONIC ANALYSIS (FFT of ATM90E36 waveform captures)
+// ============================================================================
+constexpr uint8_t HARMONIC_MAX_ORDER = 31;
+
+struct HarmonicSpectrum {
+    float rms;                              // True RMS of the analysed cycles (V or A)
+    float magnitude[HARMONIC_MAX_ORDER];    // [h-1] RMS of harmonic h (V or A)
+    float phase[HARMONIC_MAX_ORDER];        // [h-1] Degrees, relative to the phase A voltage fundamental
+    float thd;                              // Orders 2..31, % of fundamental
+};
+
+struct HarmonicData {
+    uint32_t timestamp;         // millis() of the capture
+    uint32_t captureSequence;   // WaveformInfo::sequence that was analysed
+    float    lineFrequency;     // Hz used to resample the capture
+    HarmonicSpectrum voltage[3];    // A, B, C
+    HarmonicSpectrum current[3];    // A, B, C
+    float    tdd[3];            // Current TDD, % of demand current
+    float    kFactor[3];        // Transformer K-factor (sum h^2 Ih^2 / sum Ih^2)
+    bool     valid;
+
+    HarmonicData() {
+        memset(this, 0, sizeof(HarmonicData));
+    }
+};
+
+// ATM90E36 hardware DFT results (HarmonicSweep). Values are kept as read; see
+// HarmonicSweep::ratioPercent() / fundamental() for engineering units.
+constexpr uint8_t DFT_CHANNEL_COUNT = 6;    // AI, BI, CI, AV, BV, CV (register block order)
+constexpr uint8_t DFT_RATIO_COUNT   = 31;   // HR2..HR32
+
+struct HarmonicRatios {
+    uint32_t timestamp;         // millis() when the DFT pass completed
+    uint32_t sequence;          // Completed DFT passes since boot
+    uint16_t ratio[DFT_CHANNEL_COUNT][DFT_RATIO_COUNT];  // [ch][h-2] % x 163.84
+    uint16_t thd[DFT_CHANNEL_COUNT];                     // % x 163.84
+    uint16_t fundamental[DFT_CHANNEL_COUNT];             // Scaled by DFT_SCALE
+    uint16_t dftScale;          // DFT_SCALE the pass ran with
+    bool     valid;
+
+    HarmonicRatios() {
+        memset(this, 0, sizeof(HarmonicRatios));
+    }
+};
+
 // ============================================================================
 // CALIBRATION CONFIGURATION STRUCTURE
 // ============================================================================
@@ -257,6 +331,7 @@ struct MQTTConfig {
     uint16_t publishInterval;   // Publish interval (seconds)
     bool    useHomeAssistant;   // Enable Home Assistant discovery
     bool    useTLS;             // Enable TLS/SSL
+    bool    binaryPayload;      // Also publish MeterWireFormat frames to <baseTopic>/state/bin
     
     MQTTConfig() {
         enabled = false;
@@ -264,6 +339,7 @@ struct MQTTConfig {
         publishInterval = 10;
         useHomeAssistant = true;
         useTLS = false;
+        binaryPayload = false;
         strcpy(broker, "");
         strcpy(username, "");
         strcpy(password, "");
@@ -293,6 +369,68 @@ struct NetworkConfig {
     }
 };
 
+// ============================================================================
+// MEASUREMENT FILTERS (EnergyMeter filter bank)
+// ============================================================================
+enum class MeterFilterType : uint8_t {
+    NONE = 0,
+    SMA,        // Simple moving average over `window` samples
+    EMA,        // Exponential, alpha = 2 / (window + 1)
+    MEDIAN      // Median of the last `window` samples (spike rejection)
+};
+
+// Filterable measurement channels (instantaneous RawMeterFrame fields)
+enum MeterFilterChannel : uint8_t {
+    MF_URMS_A = 0, MF_URMS_B, MF_URMS_C,
+    MF_IRMS_A, MF_IRMS_B, MF_IRMS_C, MF_IRMS_N,
+    MF_P_A, MF_P_B, MF_P_C, MF_P_T,
+    MF_Q_A, MF_Q_B, MF_Q_C, MF_Q_T,
+    MF_S_A, MF_S_B, MF_S_C, MF_S_T,
+    MF_PF_A, MF_PF_B, MF_PF_C, MF_PF_T,
+    MF_PANGLE_A, MF_PANGLE_B, MF_PANGLE_C,
+    MF_UANGLE_A, MF_UANGLE_B, MF_UANGLE_C,
+    MF_THDU_A, MF_THDU_B, MF_THDU_C,
+    MF_THDI_A, MF_THDI_B, MF_THDI_C,
+    MF_FREQ,
+    MF_TEMP,
+    MF_CHANNEL_COUNT
+};
+
+constexpr uint8_t METER_FILTER_MAX_WINDOW = 32;
+constexpr uint8_t METER_FILTER_MAX_MEDIAN = 15;
+
+struct MeterFilterSpec {
+    MeterFilterType type;
+    uint8_t window;             // Samples (1..METER_FILTER_MAX_WINDOW, median up to METER_FILTER_MAX_MEDIAN)
+};
+
+// ============================================================================
+// SNAPSHOT CHANGE TRACKING (EnergyMeter::getSnapshotDelta)
+// ============================================================================
+// Quantity classes; each has one deadband in SystemConfig::meterDeadbands
+enum MeterQuantity : uint8_t {
+    MQ_VOLTAGE = 0,     // V
+    MQ_CURRENT,         // A
+    MQ_POWER,           // W / VAR / VA
+    MQ_POWER_FACTOR,
+    MQ_ANGLE,           // degrees
+    MQ_THD,             // %
+    MQ_FREQUENCY,       // Hz
+    MQ_ENERGY,          // kWh / kVARh / kVAh
+    MQ_TEMPERATURE,     // degC
+    MQ_HUMIDITY,        // %
+    MQ_STATUS,          // Status registers (any change)
+    MQ_COUNT
+};
+
+// ============================================================================
+// ENERGY ACCUMULATION SOURCE (EnergyAccumulator)
+// ============================================================================
+enum class EnergySource : uint8_t {
+    COUNTERS = 0,       // ATM90E36 energy pulse counters (64-bit, lossless)
+    INTEGRATED          // Software integration of the mean power readings
+};
+
 // ============================================================================
 // SYSTEM CONFIGURATION STRUCTURE
 // ============================================================================
@@ -312,6 +450,24 @@ struct SystemConfig {
     uint16_t dhtReadIntervalMs; // Minimum 2000ms recommended for DHT22
     bool     dhtDebugLogging;
 
+    // Per-channel measurement filters (index = MeterFilterChannel)
+    MeterFilterSpec meterFilters[MF_CHANNEL_COUNT];
+
+    // Change-tracking deadbands (index = MeterQuantity); a field is reported as
+    // changed once it moves more than this from the value last reported
+    float meterDeadbands[MQ_COUNT];
+
+    // Fast power mode (FastPowerSampler) and relay load shedding on total active power
+    bool     fastPowerEnabled;      // Start the FastPowerTask at boot
+    uint8_t  fastPowerIntervalMs;   // Sample period (20-50 ms)
+    uint8_t  loadShedRelay;         // 0 = off, 1/2 = relay energised while shedding
+    float    loadShedLimitW;        // Shed as soon as total active power exceeds this
+    float    loadShedRestoreW;      // Restore once it stays below this...
+    uint16_t loadShedRestoreMs;     // ...for this long
+
+    // Register reported by EnergyAccumulator (the other one is kept as a cross-check)
+    EnergySource energySource;
+
     SystemConfig() {
         readInterval = 500;
         publishInterval = 1;
@@ -325,6 +481,34 @@ struct SystemConfig {
         dhtEnabled = true;
         dhtReadIntervalMs = 3000;
         dhtDebugLogging = false;
+        // V/I RMS: 2.5 s moving average, the span of the V2.0 5-sample filter at the 500 ms
+        // read interval, now 25 samples of the 100 ms FAST poll; everything else unfiltered
+        for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+            meterFilters[ch].type = MeterFilterType::NONE;
+            meterFilters[ch].window = 1;
+        }
+        for (uint8_t ch = MF_URMS_A; ch <= MF_IRMS_C; ch++) {
+            meterFilters[ch].type = MeterFilterType::SMA;
+            meterFilters[ch].window = 25;
+        }
+        meterDeadbands[MQ_VOLTAGE] = 0.1f;
+        meterDeadbands[MQ_CURRENT] = 0.01f;
+        meterDeadbands[MQ_POWER] = 1.0f;
+        meterDeadbands[MQ_POWER_FACTOR] = 0.001f;
+        meterDeadbands[MQ_ANGLE] = 0.1f;
+        meterDeadbands[MQ_THD] = 0.1f;
+        meterDeadbands[MQ_FREQUENCY] = 0.01f;
+        meterDeadbands[MQ_ENERGY] = 0.001f;
+        meterDeadbands[MQ_TEMPERATURE] = 0.5f;
+        meterDeadbands[MQ_HUMIDITY] = 0.5f;
+        meterDeadbands[MQ_STATUS] = 0.0f;
+        fastPowerEnabled = false;
+        fastPowerIntervalMs = 20;
+        loadShedRelay = 0;
+        loadShedLimitW = 10000.0f;
+        loadShedRestoreW = 8000.0f;
+        loadShedRestoreMs = 5000;
+        energySource = EnergySource::COUNTERS;
     }
 };
 
@@ -342,7 +526,8 @@ enum class EventType : uint8_t {
     MQTT_EVT_DISCONNECTED,
     OTA_STARTED,
     OTA_COMPLETED,
-    SYSTEM_REBOOT
+    SYSTEM_REBOOT,
+    POWER_QUALITY_EVENT
 };
 
 // ============================================================================
@@ -396,12 +581,14 @@ struct EnergyData {
         double activeEnergyExport;      // Active Energy Export (kWh)
         double reactiveEnergyImport;    // Reactive Energy Import (kVARh)
         double reactiveEnergyExport;    // Reactive Energy Export (kVARh)
+        double apparentEnergy;          // Apparent Energy (kVAh)
         
         PhaseEnergy() {
             activeEnergyImport = 0.0;
             activeEnergyExport = 0.0;
             reactiveEnergyImport = 0.0;
             reactiveEnergyExport = 0.0;
+            apparentEnergy = 0.0;
         }
     };
     
@@ -13,6 +13,19 @@
 #define WRITE 0 // WRITE SPI
 #define READ 1	// READ SPI
 
+// SPI clock used by CommEnergyIC()/ReadRegisterSweep() until SetSPIClock() is called
+#define ATM_SPI_DEFAULT_CLOCK 200000
+
+// Register sweep timing (ReadRegisterSweep).  The bus is held for the whole sweep,
+// so only the chip-select framing is repeated per register.
+#define ATM_SWEEP_CS_SETUP_US 1  // CS low -> first SCLK edge
+#define ATM_SWEEP_ADDR_WAIT_US 4 // Address -> data valid (datasheet: 4us)
+#define ATM_SWEEP_CS_GAP_US 1    // CS high time between consecutive registers
+
+// Coherent 32-bit reads (Read32Register): extra LO/HI re-reads allowed when the
+// HI word changes between reads (register update landed mid-read).
+#define ATM_READ32_MAX_RETRIES 2
+
 // **************** VARIABLES / DEFINES / STATIC / STRUCTURES / REGISTERS ****************
 
 // **************** DEFINE Device ATM90E32 or ATM90E36 ****************
@@ -395,6 +408,24 @@
 
 // **************** CLASS ****************
 
+// **************** SPI TRANSPORT ****************
+// Optional bus backend for ATM90E3x (see SetTransport).  Lets the application share
+// the SPI bus with other devices under its own lock, or substitute a mock bus.
+class ATM90E3xTransport
+{
+public:
+	virtual ~ATM90E3xTransport() {}
+
+	/* Take the bus and open a transaction at clockHz (SPI mode 3, MSB first). false = bus busy */
+	virtual bool Begin(unsigned long clockHz) = 0;
+
+	/* One CS-framed access: address word, ATM_SWEEP_ADDR_WAIT_US pause, data word. Returns the data word read */
+	virtual unsigned short Frame(int cs, unsigned short addrWord, unsigned short dataWord, unsigned int csSetupUs, unsigned int csHoldUs) = 0;
+
+	/* Close the transaction and release the bus */
+	virtual void End() = 0;
+};
+
 class ATM90E3x
 {
 public:
@@ -412,6 +443,26 @@ public:
 	
 
 	int Read32Register(signed short regh_addr, signed short regl_addr);
+	unsigned long _read32Retries;   // Torn HI/LO pairs detected and re-read
+	unsigned long _spiClockHz;      // Current SPI clock (see SetSPIClock)
+
+	/* SPI clock for all following transfers (link training may raise it above 200kHz) */
+	void SetSPIClock(unsigned long hz);
+
+	/* Bus backend; NULL uses the global SPI object directly */
+	void SetTransport(ATM90E3xTransport *transport);
+	ATM90E3xTransport *_transport;
+
+	/* Hold the bus across several accesses (nests; CommEnergyIC/ReadRegisterSweep join an open batch) */
+	bool BeginBatch();
+	void EndBatch();
+	unsigned char _batchDepth;
+	unsigned long _busErrors;       // Transport Begin() failures (bus busy)
+
+	/* Batched read of a register list under one SPI transaction. Returns registers read. */
+	unsigned short ReadRegisterSweep(const unsigned short *addrs, unsigned short *out, unsigned short count);
+	unsigned long _lastSweepMicros; // Duration of the last ReadRegisterSweep()
+	unsigned long _sweepCount;      // Number of sweeps completed
 
 public:
 	/* Construct */
@@ -562,7 +613,9 @@ public:
 	bool calibrationError();
 #endif
 
-
+private:
+	/* One CS-framed register access on the open batch */
+	unsigned short BusFrame(unsigned short addrWord, unsigned short dataWord, unsigned int csSetupUs, unsigned int csHoldUs);
 
 };
 #endif
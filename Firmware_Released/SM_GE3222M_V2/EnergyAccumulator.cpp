@@ -1,4 +1,5 @@
 #include "EnergyAccumulator.h"
+#include "ConfigManager.h"
 #include <nvs_flash.h>
 
 // Preferences.begin() can fail on devices with corrupted NVS or unexpected partition state.
@@ -28,13 +29,52 @@ static bool beginPrefsSafe(Preferences& prefs, const char* ns, bool readOnly) {
 }
 
 
+namespace {
+
+// Lifetime pulse counters, stored whole
+constexpr const char* NVS_KEY_COUNTS = "counts";
+
+// Reported register selector per RawEnergy class
+double& phaseRegister(EnergyData::PhaseEnergy& e, uint8_t type) {
+    switch (type) {
+        case RAW_EN_AP: return e.activeEnergyImport;
+        case RAW_EN_AN: return e.activeEnergyExport;
+        case RAW_EN_RP: return e.reactiveEnergyImport;
+        case RAW_EN_RN: return e.reactiveEnergyExport;
+        default:        return e.apparentEnergy;
+    }
+}
+
+EnergyData::PhaseEnergy& phaseOf(EnergyData& e, uint8_t phase) {
+    switch (phase) {
+        case RAW_A: return e.phaseA;
+        case RAW_B: return e.phaseB;
+        case RAW_C: return e.phaseC;
+        default:    return e.total;
+    }
+}
+
+} // namespace
+
 EnergyAccumulator::EnergyAccumulator()
     : m_initialized(false)
+    , m_source(EnergySource::COUNTERS)
     , m_persistInterval(300)
     , m_lastPersistTime(0)
-    , m_lastUpdateTime(0)
+    , m_lastSampleUs(0)
+    , m_checkCounts(0)
+    , m_checkIntegratedKWh(0.0)
+    , m_counterResets(0)
+    , m_staleFrames(0)
+    , m_frameEpoch(0)
+    , m_lastFrameUs(0)
+    , m_lastJournalMs(0)
     , m_mutex(nullptr)
+    , m_journalMutex(nullptr)
 {
+    memset(m_counts, 0, sizeof(m_counts));
+    memset(m_frameCounts, 0, sizeof(m_frameCounts));
+    memset(m_journaledCounts, 0, sizeof(m_journaledCounts));
 }
 
 bool EnergyAccumulator::init(uint32_t persistIntervalSec) {
@@ -46,73 +86,175 @@ bool EnergyAccumulator::init(uint32_t persistIntervalSec) {
     m_persistInterval = persistIntervalSec;
     
     m_mutex = xSemaphoreCreateMutex();
-    if (m_mutex == nullptr) {
+    m_journalMutex = xSemaphoreCreateMutex();
+    if (m_mutex == nullptr || m_journalMutex == nullptr) {
         Logger::getInstance().error("EnergyAccumulator: Failed to create mutex");
         return false;
     }
 
+    SystemConfig sysCfg;
+    ConfigManager::getInstance().loadSystemConfig(sysCfg);
+    m_source = sysCfg.energySource;
+
+    if (!m_journal.begin(openJournalPartition(JOURNAL_PARTITION))) {
+        Logger::getInstance().warn("EnergyAccumulator: No '%s' partition, counters persist to NVS only",
+                                   JOURNAL_PARTITION);
+    }
+
     loadFromNVS();
     
     m_lastPersistTime = millis() / 1000;
-    m_lastUpdateTime = millis() / 1000;
+    m_lastJournalMs = millis();
+    m_lastSampleUs = 0;
     m_initialized = true;
     
     Logger::getInstance().info("EnergyAccumulator", "Initialized with persist interval: " + 
-                              String(m_persistInterval) + "s");
+                              String(m_persistInterval) + "s, source: " + sourceName(m_source));
     
     return true;
 }
 
+void EnergyAccumulator::applyConfig(const SystemConfig& config) {
+    if (m_source == config.energySource) return;
+
+    if (m_mutex != nullptr && xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        m_source = config.energySource;
+        publishEnergy();
+        xSemaphoreGive(m_mutex);
+    } else {
+        m_source = config.energySource;
+    }
+    Logger::getInstance().info("EnergyAccumulator: Source set to %s", sourceName(m_source));
+}
+
+void EnergyAccumulator::updateCounters(const RawMeterFrame& frame) {
+    if (!m_initialized) {
+        Logger::getInstance().error("EnergyAccumulator: Not initialized");
+        return;
+    }
+    if (frame.captureUs <= 0) {
+        return;     // No sweep yet
+    }
+
+    // Nothing is consumed until the lock is held, so a missed call only delays the pulses
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return;
+    }
+
+    // Driver totals restart only with a new epoch; everything the driver holds after
+    // that is new energy. Within an epoch they never go down, so a frame that is not
+    // newer than the last one added carries pulses already counted.
+    const bool restarted = (m_frameEpoch != 0 && frame.energyEpoch != m_frameEpoch);
+    if (frame.energyEpoch != m_frameEpoch) {
+        if (restarted) m_counterResets++;
+        memset(m_frameCounts, 0, sizeof(m_frameCounts));
+        m_frameEpoch = frame.energyEpoch;
+    } else if (frame.captureUs <= m_lastFrameUs) {
+        if (frame.captureUs < m_lastFrameUs) m_staleFrames++;     // Equal: same frame again
+        xSemaphoreGive(m_mutex);
+        return;
+    }
+    m_lastFrameUs = frame.captureUs;
+
+    for (uint8_t t = 0; t < RAW_EN_COUNT; t++) {
+        for (uint8_t ph = 0; ph < 4; ph++) {
+            m_counts[t][ph] += frame.energy[t][ph] - m_frameCounts[t][ph];
+        }
+    }
+    if (m_lastSampleUs != 0) {
+        m_checkCounts += (frame.energy[RAW_EN_AP][RAW_T] - m_frameCounts[RAW_EN_AP][RAW_T]) +
+                         (frame.energy[RAW_EN_AN][RAW_T] - m_frameCounts[RAW_EN_AN][RAW_T]);
+    }
+    memcpy(m_frameCounts, frame.energy, sizeof(m_frameCounts));
+
+    if (m_source == EnergySource::COUNTERS) {
+        publishEnergy();
+    }
+    xSemaphoreGive(m_mutex);
+
+    if (restarted) {
+        Logger::getInstance().warn("EnergyAccumulator: Driver energy counters restarted, re-baselined");
+    }
+}
+
 void EnergyAccumulator::update(const MeterData& data) {
     if (!m_initialized) {
         Logger::getInstance().error("EnergyAccumulator: Not initialized");
         return;
     }
 
-    uint32_t currentTime = millis() / 1000;
-    
-    if (m_lastUpdateTime == 0) {
-        m_lastUpdateTime = currentTime;
+    // Integrate over the spacing of the acquisitions themselves (capture stamps),
+    // not over when this task happened to run.
+    if (!data.valid || data.timestampUs <= 0) {
         return;
     }
+    const int64_t sampleUs = data.timestampUs;
+    const uint32_t currentTime = (uint32_t)(sampleUs / 1000000);
 
-    float deltaTime = (currentTime - m_lastUpdateTime) / 3600.0f;
-    
-    if (deltaTime <= 0 || deltaTime > 3600) {
-        Logger::getInstance().warn("EnergyAccumulator", "Invalid time delta: " + String(deltaTime));
-        m_lastUpdateTime = currentTime;
+    if (m_lastSampleUs == 0) {
+        m_lastSampleUs = sampleUs;
+        return;
+    }
+    if (sampleUs == m_lastSampleUs) {
+        return;     // Same acquisition as the previous call
+    }
+
+    const int64_t deltaUs = sampleUs - m_lastSampleUs;
+    if (deltaUs < 0 || deltaUs > MAX_GAP_US) {
+        Logger::getInstance().warn("EnergyAccumulator: Invalid time delta: %lld us", (long long)deltaUs);
+        m_lastSampleUs = sampleUs;
         return;
     }
+    const double deltaTime = (double)deltaUs / 3.6e9;     // Hours
 
     if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        accumulatePhase(m_energy.phaseA, data.phaseA.activePower, 
-                       data.phaseA.reactivePower, deltaTime);
-        accumulatePhase(m_energy.phaseB, data.phaseB.activePower, 
-                       data.phaseB.reactivePower, deltaTime);
-        accumulatePhase(m_energy.phaseC, data.phaseC.activePower, 
-                       data.phaseC.reactivePower, deltaTime);
+        accumulatePhase(m_integrated.phaseA, data.phaseA.activePower,
+                       data.phaseA.reactivePower, data.phaseA.apparentPower, deltaTime);
+        accumulatePhase(m_integrated.phaseB, data.phaseB.activePower,
+                       data.phaseB.reactivePower, data.phaseB.apparentPower, deltaTime);
+        accumulatePhase(m_integrated.phaseC, data.phaseC.activePower,
+                       data.phaseC.reactivePower, data.phaseC.apparentPower, deltaTime);
         
-        m_energy.total.activeEnergyImport = m_energy.phaseA.activeEnergyImport + 
-                                            m_energy.phaseB.activeEnergyImport + 
-                                            m_energy.phaseC.activeEnergyImport;
-        m_energy.total.activeEnergyExport = m_energy.phaseA.activeEnergyExport + 
-                                            m_energy.phaseB.activeEnergyExport + 
-                                            m_energy.phaseC.activeEnergyExport;
-        m_energy.total.reactiveEnergyImport = m_energy.phaseA.reactiveEnergyImport + 
-                                              m_energy.phaseB.reactiveEnergyImport + 
-                                              m_energy.phaseC.reactiveEnergyImport;
-        m_energy.total.reactiveEnergyExport = m_energy.phaseA.reactiveEnergyExport + 
-                                              m_energy.phaseB.reactiveEnergyExport + 
-                                              m_energy.phaseC.reactiveEnergyExport;
-        
-        m_energy.lastUpdateTime = currentTime;
+        EnergyData::PhaseEnergy& total = m_integrated.total;
+        total.activeEnergyImport = m_integrated.phaseA.activeEnergyImport +
+                                   m_integrated.phaseB.activeEnergyImport +
+                                   m_integrated.phaseC.activeEnergyImport;
+        total.activeEnergyExport = m_integrated.phaseA.activeEnergyExport +
+                                   m_integrated.phaseB.activeEnergyExport +
+                                   m_integrated.phaseC.activeEnergyExport;
+        total.reactiveEnergyImport = m_integrated.phaseA.reactiveEnergyImport +
+                                     m_integrated.phaseB.reactiveEnergyImport +
+                                     m_integrated.phaseC.reactiveEnergyImport;
+        total.reactiveEnergyExport = m_integrated.phaseA.reactiveEnergyExport +
+                                     m_integrated.phaseB.reactiveEnergyExport +
+                                     m_integrated.phaseC.reactiveEnergyExport;
+        total.apparentEnergy = m_integrated.phaseA.apparentEnergy +
+                               m_integrated.phaseB.apparentEnergy +
+                               m_integrated.phaseC.apparentEnergy;
+
+        m_checkIntegratedKWh += (fabsf(data.phaseA.activePower) + fabsf(data.phaseB.activePower) +
+                                 fabsf(data.phaseC.activePower)) / 1000.0 * deltaTime;
+
+        m_energy.lastUpdateTime = data.timestamp;   // UTC seconds once NTP has synced
+        if (m_source == EnergySource::INTEGRATED) {
+            publishEnergy();
+        }
         
         xSemaphoreGive(m_mutex);
     }
 
-    m_lastUpdateTime = currentTime;
-    
-    if (m_persistInterval > 0 && (currentTime - m_lastPersistTime) >= m_persistInterval) {
+    m_lastSampleUs = sampleUs;
+
+    if (m_journal.isReady() && (millis() - m_lastJournalMs) >= JOURNAL_INTERVAL_MS) {
+        writeJournal(false);
+        m_lastJournalMs = millis();
+    }
+
+    // With the counters journaled, the NVS copy only serves the integrated register
+    // and older firmware, so it is written far less often
+    const uint32_t nvsInterval = (m_journal.isReady() && m_source == EnergySource::COUNTERS)
+                                     ? NVS_JOURNALED_INTERVAL_SEC : m_persistInterval;
+    if (m_persistInterval > 0 && (currentTime - m_lastPersistTime) >= nvsInterval) {
         saveToNVS();
         m_lastPersistTime = currentTime;
     }
@@ -124,39 +266,83 @@ bool EnergyAccumulator::loadFromNVS() {
         return false;
     }
 
-    bool exists = m_preferences.isKey("phaseA_AEI");
+    const bool exists = m_preferences.isKey("phaseA_AEI");
     
-    if (!exists) {
+    EnergyData saved;
+    uint64_t counts[RAW_EN_COUNT][4];
+    memset(counts, 0, sizeof(counts));
+    bool haveCounts = false;
+
+    if (exists) {
+        saved.phaseA.activeEnergyImport = m_preferences.getDouble("phaseA_AEI", 0.0);
+        saved.phaseA.activeEnergyExport = m_preferences.getDouble("phaseA_AEE", 0.0);
+        saved.phaseA.reactiveEnergyImport = m_preferences.getDouble("phaseA_REI", 0.0);
+        saved.phaseA.reactiveEnergyExport = m_preferences.getDouble("phaseA_REE", 0.0);
+        saved.phaseA.apparentEnergy = m_preferences.getDouble("phaseA_SE", 0.0);
+
+        saved.phaseB.activeEnergyImport = m_preferences.getDouble("phaseB_AEI", 0.0);
+        saved.phaseB.activeEnergyExport = m_preferences.getDouble("phaseB_AEE", 0.0);
+        saved.phaseB.reactiveEnergyImport = m_preferences.getDouble("phaseB_REI", 0.0);
+        saved.phaseB.reactiveEnergyExport = m_preferences.getDouble("phaseB_REE", 0.0);
+        saved.phaseB.apparentEnergy = m_preferences.getDouble("phaseB_SE", 0.0);
+
+        saved.phaseC.activeEnergyImport = m_preferences.getDouble("phaseC_AEI", 0.0);
+        saved.phaseC.activeEnergyExport = m_preferences.getDouble("phaseC_AEE", 0.0);
+        saved.phaseC.reactiveEnergyImport = m_preferences.getDouble("phaseC_REI", 0.0);
+        saved.phaseC.reactiveEnergyExport = m_preferences.getDouble("phaseC_REE", 0.0);
+        saved.phaseC.apparentEnergy = m_preferences.getDouble("phaseC_SE", 0.0);
+
+        saved.total.activeEnergyImport = m_preferences.getDouble("total_AEI", 0.0);
+        saved.total.activeEnergyExport = m_preferences.getDouble("total_AEE", 0.0);
+        saved.total.reactiveEnergyImport = m_preferences.getDouble("total_REI", 0.0);
+        saved.total.reactiveEnergyExport = m_preferences.getDouble("total_REE", 0.0);
+        saved.total.apparentEnergy = m_preferences.getDouble("total_SE", 0.0);
+
+        saved.lastUpdateTime = m_preferences.getUInt("lastUpdate", 0);
+
+        haveCounts = m_preferences.getBytesLength(NVS_KEY_COUNTS) == sizeof(counts) &&
+                     m_preferences.getBytes(NVS_KEY_COUNTS, counts, sizeof(counts)) == sizeof(counts);
+        if (!haveCounts) {
+            // Data saved before the counter registers existed: carry the kWh values over
+            for (uint8_t t = 0; t < RAW_EN_COUNT; t++) {
+                for (uint8_t ph = 0; ph < 4; ph++) {
+                    const double kwh = phaseRegister(phaseOf(saved, ph), t);
+                    counts[t][ph] = (kwh > 0.0) ? (uint64_t)(kwh * ENERGY_COUNTS_PER_KWH + 0.5) : 0;
+                }
+            }
+        }
+    }
+    m_preferences.end();
+
+    // The journal is written every few seconds, so its newest record supersedes the NVS counters
+    EnergyJournalRecord rec;
+    const bool haveJournal = m_journal.latest(rec);
+    if (haveJournal) {
+        memcpy(counts, rec.counts, sizeof(counts));
+        if (rec.utc > saved.lastUpdateTime) saved.lastUpdateTime = rec.utc;
+    }
+
+    if (!exists && !haveJournal) {
         Logger::getInstance().info("EnergyAccumulator: No saved energy data in NVS");
-        m_preferences.end();
         return false;
     }
 
-    m_energy.phaseA.activeEnergyImport = m_preferences.getDouble("phaseA_AEI", 0.0);
-    m_energy.phaseA.activeEnergyExport = m_preferences.getDouble("phaseA_AEE", 0.0);
-    m_energy.phaseA.reactiveEnergyImport = m_preferences.getDouble("phaseA_REI", 0.0);
-    m_energy.phaseA.reactiveEnergyExport = m_preferences.getDouble("phaseA_REE", 0.0);
-    
-    m_energy.phaseB.activeEnergyImport = m_preferences.getDouble("phaseB_AEI", 0.0);
-    m_energy.phaseB.activeEnergyExport = m_preferences.getDouble("phaseB_AEE", 0.0);
-    m_energy.phaseB.reactiveEnergyImport = m_preferences.getDouble("phaseB_REI", 0.0);
-    m_energy.phaseB.reactiveEnergyExport = m_preferences.getDouble("phaseB_REE", 0.0);
+    if (m_mutex != nullptr) xSemaphoreTake(m_mutex, portMAX_DELAY);
+    memcpy(m_counts, counts, sizeof(m_counts));
+    memcpy(m_journaledCounts, counts, sizeof(m_journaledCounts));
+    m_energy.lastUpdateTime = saved.lastUpdateTime;
+    publishEnergy();
+    // Integrated register restarts from the last reported values
+    m_integrated = (m_source == EnergySource::COUNTERS) ? m_energy : saved;
+    if (m_mutex != nullptr) xSemaphoreGive(m_mutex);
     
-    m_energy.phaseC.activeEnergyImport = m_preferences.getDouble("phaseC_AEI", 0.0);
-    m_energy.phaseC.activeEnergyExport = m_preferences.getDouble("phaseC_AEE", 0.0);
-    m_energy.phaseC.reactiveEnergyImport = m_preferences.getDouble("phaseC_REI", 0.0);
-    m_energy.phaseC.reactiveEnergyExport = m_preferences.getDouble("phaseC_REE", 0.0);
-    
-    m_energy.total.activeEnergyImport = m_preferences.getDouble("total_AEI", 0.0);
-    m_energy.total.activeEnergyExport = m_preferences.getDouble("total_AEE", 0.0);
-    m_energy.total.reactiveEnergyImport = m_preferences.getDouble("total_REI", 0.0);
-    m_energy.total.reactiveEnergyExport = m_preferences.getDouble("total_REE", 0.0);
-    
-    m_energy.lastUpdateTime = m_preferences.getUInt("lastUpdate", 0);
-    
-    m_preferences.end();
-    
-    Logger::getInstance().info("EnergyAccumulator: Loaded energy data from NVS");
+    if (haveJournal) {
+        Logger::getInstance().info("EnergyAccumulator: Loaded energy data from journal (record %lu)",
+                                   (unsigned long)rec.sequence);
+    } else {
+        Logger::getInstance().info("EnergyAccumulator: Loaded energy data from NVS%s",
+                                   haveCounts ? "" : " (counters seeded from kWh)");
+    }
     Logger::getInstance().debug("EnergyAccumulator", "Total Import: " + 
                                String(m_energy.total.activeEnergyImport, 3) + " kWh");
     
@@ -170,27 +356,33 @@ bool EnergyAccumulator::saveToNVS() {
     }
 
     if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        // kWh keys always hold the reported register, so older firmware reads sane values
         m_preferences.putDouble("phaseA_AEI", m_energy.phaseA.activeEnergyImport);
         m_preferences.putDouble("phaseA_AEE", m_energy.phaseA.activeEnergyExport);
         m_preferences.putDouble("phaseA_REI", m_energy.phaseA.reactiveEnergyImport);
         m_preferences.putDouble("phaseA_REE", m_energy.phaseA.reactiveEnergyExport);
+        m_preferences.putDouble("phaseA_SE", m_energy.phaseA.apparentEnergy);
         
         m_preferences.putDouble("phaseB_AEI", m_energy.phaseB.activeEnergyImport);
         m_preferences.putDouble("phaseB_AEE", m_energy.phaseB.activeEnergyExport);
         m_preferences.putDouble("phaseB_REI", m_energy.phaseB.reactiveEnergyImport);
         m_preferences.putDouble("phaseB_REE", m_energy.phaseB.reactiveEnergyExport);
+        m_preferences.putDouble("phaseB_SE", m_energy.phaseB.apparentEnergy);
         
         m_preferences.putDouble("phaseC_AEI", m_energy.phaseC.activeEnergyImport);
         m_preferences.putDouble("phaseC_AEE", m_energy.phaseC.activeEnergyExport);
         m_preferences.putDouble("phaseC_REI", m_energy.phaseC.reactiveEnergyImport);
         m_preferences.putDouble("phaseC_REE", m_energy.phaseC.reactiveEnergyExport);
+        m_preferences.putDouble("phaseC_SE", m_energy.phaseC.apparentEnergy);
         
         m_preferences.putDouble("total_AEI", m_energy.total.activeEnergyImport);
         m_preferences.putDouble("total_AEE", m_energy.total.activeEnergyExport);
         m_preferences.putDouble("total_REI", m_energy.total.reactiveEnergyImport);
         m_preferences.putDouble("total_REE", m_energy.total.reactiveEnergyExport);
+        m_preferences.putDouble("total_SE", m_energy.total.apparentEnergy);
         
         m_preferences.putUInt("lastUpdate", m_energy.lastUpdateTime);
+        m_preferences.putBytes(NVS_KEY_COUNTS, m_counts, sizeof(m_counts));
         
         xSemaphoreGive(m_mutex);
     }
@@ -215,21 +407,98 @@ EnergyData EnergyAccumulator::getAccumulatedEnergy() {
     return data;
 }
 
+uint64_t EnergyAccumulator::getCount(RawEnergy type, uint8_t phase) {
+    if (type >= RAW_EN_COUNT || phase > RAW_T) return 0;
+
+    uint64_t count = 0;
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        count = m_counts[type][phase];
+        xSemaphoreGive(m_mutex);
+    }
+    return count;
+}
+
+EnergyCrossCheck EnergyAccumulator::getCrossCheck() {
+    EnergyCrossCheck check;
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        check.counterKWh = energyCountToDouble(m_checkCounts);
+        check.integratedKWh = m_checkIntegratedKWh;
+        check.counterResets = m_counterResets;
+        check.staleFrames = m_staleFrames;
+        xSemaphoreGive(m_mutex);
+    }
+
+    check.valid = check.counterKWh >= CHECK_MIN_KWH;
+    if (check.valid) {
+        check.divergencePct = (float)((check.integratedKWh - check.counterKWh) / check.counterKWh * 100.0);
+    }
+    return check;
+}
+
 void EnergyAccumulator::reset() {
     if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
         m_energy = EnergyData();
+        m_integrated = EnergyData();
+        memset(m_counts, 0, sizeof(m_counts));
+        m_checkCounts = 0;
+        m_checkIntegratedKWh = 0.0;
         xSemaphoreGive(m_mutex);
     }
     
+    writeJournal(true);     // Otherwise the newest record would restore the old counters
     saveToNVS();
     Logger::getInstance().info("EnergyAccumulator: Reset all accumulated energy");
 }
 
+const char* EnergyAccumulator::sourceName(EnergySource source) {
+    return (source == EnergySource::INTEGRATED) ? "integrated" : "counters";
+}
+
+void EnergyAccumulator::publishEnergy() {
+    const uint32_t lastUpdate = m_energy.lastUpdateTime;
+    if (m_source == EnergySource::INTEGRATED) {
+        m_energy = m_integrated;
+    } else {
+        for (uint8_t t = 0; t < RAW_EN_COUNT; t++) {
+            for (uint8_t ph = 0; ph < 4; ph++) {
+                phaseRegister(phaseOf(m_energy, ph), t) = energyCountToDouble(m_counts[t][ph]);
+            }
+        }
+    }
+    m_energy.lastUpdateTime = lastUpdate;
+}
+
+void EnergyAccumulator::writeJournal(bool force) {
+    if (!m_journal.isReady()) return;
+    if (xSemaphoreTake(m_journalMutex, pdMS_TO_TICKS(500)) != pdTRUE) return;
+
+    uint64_t counts[RAW_EN_COUNT][4];
+    uint32_t utc = 0;
+    bool copied = false;
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        memcpy(counts, m_counts, sizeof(counts));
+        utc = m_energy.lastUpdateTime;
+        copied = true;
+        xSemaphoreGive(m_mutex);
+    }
+
+    // Idle meter: nothing to record, no flash wear
+    if (copied && (force || memcmp(counts, m_journaledCounts, sizeof(counts)) != 0)) {
+        if (m_journal.append(counts, utc, (uint8_t)m_source)) {
+            memcpy(m_journaledCounts, counts, sizeof(m_journaledCounts));
+        } else {
+            Logger::getInstance().warn("EnergyAccumulator: Journal append failed");
+        }
+    }
+    xSemaphoreGive(m_journalMutex);
+}
+
 void EnergyAccumulator::accumulatePhase(EnergyData::PhaseEnergy& energy, 
                                         float activePower, float reactivePower, 
-                                        float deltaTime) {
-    float activeEnergy = (activePower / 1000.0f) * deltaTime;
-    float reactiveEnergy = (reactivePower / 1000.0f) * deltaTime;
+                                        float apparentPower, double deltaTime) {
+    const double activeEnergy = (activePower / 1000.0) * deltaTime;
+    const double reactiveEnergy = (reactivePower / 1000.0) * deltaTime;
     
     if (activePower > 0) {
         energy.activeEnergyImport += activeEnergy;
@@ -242,4 +511,8 @@ void EnergyAccumulator::accumulatePhase(EnergyData::PhaseEnergy& energy,
     } else if (reactivePower < 0) {
         energy.reactiveEnergyExport += -reactiveEnergy;
     }
-}
\ No newline at end of file
+
+    if (apparentPower > 0) {
+        energy.apparentEnergy += (apparentPower / 1000.0) * deltaTime;
+    }
+}
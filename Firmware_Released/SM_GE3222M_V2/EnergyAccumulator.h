@@ -2,23 +2,47 @@
 
 /**
  * SM-GE3222M V2.0 - Energy Accumulator
- * 
- * Accumulates energy from power readings over time
+ *
+ * Accumulates lifetime energy registers
  * Persists to NVS for recovery after power loss
- * 
+ *
  * Features:
  * - Singleton pattern
- * - Automatic periodic NVS persistence
+ * - Pulse counters journaled every few seconds to the "enjournal" partition
+ *   (EnergyJournal); NVS keeps a slower kWh snapshot
  * - Per-phase energy tracking
  * - Import/Export energy separation
  * - Thread-safe operations
+ * - Two sources (SystemConfig::energySource):
+ *   COUNTERS   sums the ATM90E36 energy pulse counters into 64-bit integers, so
+ *              scheduling gaps or a missed update never lose energy (default)
+ *   INTEGRATED integrates the mean power readings over the capture timestamps
+ *   Both run all the time; the one not reported is the cross-check.
  */
 
 #include <Arduino.h>
 #include <Preferences.h>
 #include "DataTypes.h"
+#include "RawMeterFrame.h"
+#include "EnergyJournal.h"
 #include "Logger.h"
 
+/**
+ * Counter vs integrated total active energy (import + export) since boot
+ */
+struct EnergyCrossCheck {
+    double   counterKWh;            // From the IC pulse counters
+    double   integratedKWh;         // From power x time
+    float    divergencePct;         // (integrated - counter) / counter * 100
+    bool     valid;                 // Enough energy counted for a meaningful ratio
+    uint32_t counterResets;         // Driver counter restarts seen (re-baselined)
+    uint32_t staleFrames;           // Frames older than the last one added (skipped)
+
+    EnergyCrossCheck() {
+        memset(this, 0, sizeof(EnergyCrossCheck));
+    }
+};
+
 class EnergyAccumulator {
 public:
     /**
@@ -30,22 +54,36 @@ public:
     }
 
     /**
-     * Initialize energy accumulator
-     * @param persistIntervalSec Auto-save interval in seconds (0 = disabled)
+     * Initialize energy accumulator and restore the saved registers
+     * @param persistIntervalSec NVS save interval in seconds (0 = disabled); stretched to
+     *        NVS_JOURNALED_INTERVAL_SEC while the journal holds the reported counters
      * @return true if successful
      */
     bool init(uint32_t persistIntervalSec = 300);
 
+    /**
+     * Select the reported register (SystemConfig::energySource)
+     */
+    void applyConfig(const SystemConfig& config);
+
+    /**
+     * Add the IC pulses counted since the previous frame
+     * A frame that cannot be taken now is picked up by the next call
+     * @param frame Latest raw frame (RawMeterFrame::energy holds driver totals)
+     */
+    void updateCounters(const RawMeterFrame& frame);
+
     /**
      * Update accumulator with new meter data
-     * Calculates energy delta and accumulates
+     * Integrates power over the capture interval and handles all persistence
+     * (journal and NVS); the only place saves are scheduled from
      * @param data Current meter data
      */
     void update(const MeterData& data);
 
     /**
-     * Load accumulated energy from NVS
-     * @return true if loaded successfully
+     * Load accumulated energy from NVS, then the newest journal record
+     * @return true if anything was restored
      */
     bool loadFromNVS();
 
@@ -61,11 +99,29 @@ public:
      */
     EnergyData getAccumulatedEnergy();
 
+    /**
+     * Lifetime pulse count of one register
+     * @param type Energy register class
+     * @param phase RAW_A..RAW_T
+     */
+    uint64_t getCount(RawEnergy type, uint8_t phase);
+
+    /**
+     * Counter vs power-integration comparison since boot
+     */
+    EnergyCrossCheck getCrossCheck();
+
+    EnergySource getSource() const { return m_source; }
+
+    EnergyJournalStats getJournalStats() const { return m_journal.getStats(); }
+
     /**
      * Reset all accumulated energy to zero
      */
     void reset();
 
+    static const char* sourceName(EnergySource source);
+
 private:
     // Singleton - prevent copying
     EnergyAccumulator();
@@ -76,17 +132,42 @@ private:
     /**
      * Accumulate energy for a single phase
      */
-    void accumulatePhase(EnergyData::PhaseEnergy& energy, float activePower, 
-                         float reactivePower, float deltaTime);
+    void accumulatePhase(EnergyData::PhaseEnergy& energy, float activePower,
+                         float reactivePower, float apparentPower, double deltaTime);
+
+    // Rebuild m_energy from the selected register (mutex held)
+    void publishEnergy();
+
+    // Append the counters if they moved since the last record (or always if forced)
+    void writeJournal(bool force);
 
     // State
     bool m_initialized;
+    EnergySource m_source;
     uint32_t m_persistInterval;
     uint32_t m_lastPersistTime;
-    uint32_t m_lastUpdateTime;
-    EnergyData m_energy;
+    int64_t m_lastSampleUs;         // MeterData::timestampUs of the last integrated sample
+    EnergyData m_energy;            // Reported register
+    EnergyData m_integrated;        // Power x time register
+    uint64_t m_counts[RAW_EN_COUNT][4];     // Lifetime pulses, [RawEnergy][A, B, C, T]
+    uint64_t m_frameCounts[RAW_EN_COUNT][4];// Driver totals already added
+    uint64_t m_checkCounts;         // Total active pulses since boot (cross-check)
+    double m_checkIntegratedKWh;    // Total active integrated energy since boot (cross-check)
+    uint32_t m_counterResets;
+    uint32_t m_staleFrames;
+    uint32_t m_frameEpoch;          // RawMeterFrame::energyEpoch of m_frameCounts
+    int64_t m_lastFrameUs;          // captureUs of the last frame added
+    EnergyJournal m_journal;
+    uint64_t m_journaledCounts[RAW_EN_COUNT][4];    // Contents of the last journal record
+    uint32_t m_lastJournalMs;
     SemaphoreHandle_t m_mutex;
+    SemaphoreHandle_t m_journalMutex;   // Serializes journal appends (flash ops outside m_mutex)
     Preferences m_preferences;
-    
+
     static constexpr const char* NVS_NAMESPACE = "energy_acc";
+    static constexpr int64_t MAX_GAP_US = 3600LL * 1000000LL;  // Longer gaps are not integrated
+    static constexpr double CHECK_MIN_KWH = 0.01;               // Divergence is noise below this
+    static constexpr const char* JOURNAL_PARTITION = "enjournal";
+    static constexpr uint32_t JOURNAL_INTERVAL_MS = 5000;       // 128 KB ring: ~1 h per lap at full rate
+    static constexpr uint32_t NVS_JOURNALED_INTERVAL_SEC = 3600;
 };
@@ -0,0 +1,186 @@
+/**
+ * SM-GE3222M V2.0 - Energy Journal Implementation
+ */
+
+#include "EnergyJournal.h"
+#include "MeterWireFormat.h"
+#include <esp_partition.h>
+
+namespace {
+
+class PartitionJournalFlash : public JournalFlash {
+public:
+    explicit PartitionJournalFlash(const esp_partition_t* part) : m_part(part) {}
+
+    size_t size() const override { return m_part->size; }
+
+    bool read(size_t offset, void* dst, size_t len) override {
+        return esp_partition_read(m_part, offset, dst, len) == ESP_OK;
+    }
+
+    bool write(size_t offset, const void* src, size_t len) override {
+        return esp_partition_write(m_part, offset, src, len) == ESP_OK;
+    }
+
+    bool eraseSector(size_t offset) override {
+        return esp_partition_erase_range(m_part, offset, ENERGY_JOURNAL_SECTOR_SIZE) == ESP_OK;
+    }
+
+private:
+    const esp_partition_t* m_part;
+};
+
+// Bytes covered by the record CRC
+constexpr size_t RECORD_CRC_SPAN = ENERGY_JOURNAL_RECORD_SIZE - sizeof(uint32_t);
+
+} // namespace
+
+JournalFlash* openJournalPartition(const char* label) {
+    const esp_partition_t* part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == nullptr) return nullptr;
+
+    static PartitionJournalFlash flash(part);
+    return &flash;
+}
+
+EnergyJournal::EnergyJournal()
+    : m_flash(nullptr)
+    , m_slotsPerSector(0)
+    , m_slotCount(0)
+    , m_nextSlot(0)
+    , m_haveLatest(false)
+    , m_appends(0)
+    , m_erases(0)
+    , m_skipped(0)
+    , m_errors(0)
+{
+    memset(&m_latest, 0, sizeof(m_latest));
+}
+
+bool EnergyJournal::begin(JournalFlash* flash) {
+    m_flash = nullptr;
+    m_haveLatest = false;
+    if (flash == nullptr) return false;
+
+    const uint32_t sectors = flash->size() / ENERGY_JOURNAL_SECTOR_SIZE;
+    if (sectors < 2) return false;     // The sector being erased must never hold the newest record
+
+    m_slotsPerSector = ENERGY_JOURNAL_SECTOR_SIZE / ENERGY_JOURNAL_RECORD_SIZE;
+    m_slotCount = sectors * m_slotsPerSector;
+    m_flash = flash;
+
+    uint32_t latestSlot = 0;
+    EnergyJournalRecord rec;
+    for (uint32_t slot = 0; slot < m_slotCount; slot++) {
+        if (!readRecord(slot, rec)) continue;
+        if (!m_haveLatest || rec.sequence > m_latest.sequence) {
+            m_latest = rec;
+            latestSlot = slot;
+            m_haveLatest = true;
+        }
+    }
+
+    // Empty journal: start at slot 0, which erases sector 0 first
+    m_nextSlot = m_haveLatest ? (latestSlot + 1) % m_slotCount : 0;
+    return true;
+}
+
+bool EnergyJournal::latest(EnergyJournalRecord& out) const {
+    if (!m_haveLatest) return false;
+    out = m_latest;
+    return true;
+}
+
+bool EnergyJournal::append(const uint64_t counts[RAW_EN_COUNT][4], uint32_t utc, uint8_t source) {
+    if (m_flash == nullptr) return false;
+
+    EnergyJournalRecord rec;
+    rec.magic = ENERGY_JOURNAL_MAGIC;
+    rec.version = ENERGY_JOURNAL_VERSION;
+    rec.source = source;
+    rec.sequence = m_haveLatest ? m_latest.sequence + 1 : 1;
+    rec.utc = utc;
+    rec.reserved = 0;
+    memcpy(rec.counts, counts, sizeof(rec.counts));
+    rec.crc = recordCrc(rec);
+
+    // Bounded: at worst every slot of the current sector is torn and the next one is erased
+    for (uint32_t attempt = 0; attempt <= m_slotsPerSector; attempt++) {
+        const uint32_t slot = m_nextSlot;
+        m_nextSlot = (slot + 1) % m_slotCount;
+
+        if (slot % m_slotsPerSector == 0) {
+            if (!m_flash->eraseSector(slotOffset(slot))) {
+                m_errors++;
+                return false;
+            }
+            m_erases++;
+        } else if (!slotErased(slot)) {
+            m_skipped++;
+            continue;
+        }
+
+        EnergyJournalRecord check;
+        if (!m_flash->write(slotOffset(slot), &rec, sizeof(rec)) ||
+            !m_flash->read(slotOffset(slot), &check, sizeof(check)) ||
+            memcmp(&check, &rec, sizeof(rec)) != 0) {
+            m_errors++;
+            continue;       // Slot is now dirty; the next attempt moves on
+        }
+
+        m_latest = rec;
+        m_haveLatest = true;
+        m_appends++;
+        return true;
+    }
+    return false;
+}
+
+EnergyJournalStats EnergyJournal::getStats() const {
+    EnergyJournalStats s;
+    s.ready = isReady();
+    s.sequence = m_haveLatest ? m_latest.sequence : 0;
+    s.slots = m_slotCount;
+    s.appends = m_appends;
+    s.erases = m_erases;
+    s.skipped = m_skipped;
+    s.errors = m_errors;
+    return s;
+}
+
+bool EnergyJournal::readRecord(uint32_t slot, EnergyJournalRecord& rec) {
+    // Header first: erased and foreign slots are rejected without reading the counters
+    if (!m_flash->read(slotOffset(slot), &rec, 4)) {
+        m_errors++;
+        return false;
+    }
+    if (rec.magic != ENERGY_JOURNAL_MAGIC || rec.version != ENERGY_JOURNAL_VERSION) return false;
+
+    if (!m_flash->read(slotOffset(slot), &rec, sizeof(rec))) {
+        m_errors++;
+        return false;
+    }
+    return rec.sequence != 0 && rec.sequence != UINT32_MAX && rec.crc == recordCrc(rec);
+}
+
+bool EnergyJournal::slotErased(uint32_t slot) {
+    uint8_t buf[ENERGY_JOURNAL_RECORD_SIZE];
+    if (!m_flash->read(slotOffset(slot), buf, sizeof(buf))) {
+        m_errors++;
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        if (buf[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+size_t EnergyJournal::slotOffset(uint32_t slot) const {
+    return (size_t)(slot / m_slotsPerSector) * ENERGY_JOURNAL_SECTOR_SIZE +
+           (size_t)(slot % m_slotsPerSector) * ENERGY_JOURNAL_RECORD_SIZE;
+}
+
+uint32_t EnergyJournal::recordCrc(const EnergyJournalRecord& rec) {
+    return meterWireCrc32(reinterpret_cast<const uint8_t*>(&rec), RECORD_CRC_SPAN);
+}
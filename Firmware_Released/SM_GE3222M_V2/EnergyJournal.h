@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Energy Journal
+ *
+ * Append-only record log of the EnergyAccumulator pulse counters on its own
+ * flash partition ("enjournal", see partitions.csv). Every record is a full
+ * counter state, so recovery is a scan for the newest valid record and a torn
+ * write or erase only ever costs that one record.
+ *
+ * Layout: the partition is a ring of 4 KB sectors, each holding
+ * ENERGY_JOURNAL_RECORD_SIZE slots. Records are written to the next erased
+ * slot; a sector is erased when the write position enters it, which drops the
+ * oldest records. Writes sweep the whole partition, so each sector sees one
+ * erase per lap of the ring.
+ *
+ * Features:
+ * - CRC-32 and a sequence number per record; the highest valid sequence wins
+ * - Torn records and partially erased sectors are skipped on recovery
+ * - Flash access behind JournalFlash, so the ring logic runs against any backend
+ */
+
+#include <Arduino.h>
+#include "RawMeterFrame.h"
+
+constexpr uint16_t ENERGY_JOURNAL_MAGIC = 0x4A45;       // "EJ"
+constexpr uint8_t  ENERGY_JOURNAL_VERSION = 1;
+constexpr size_t   ENERGY_JOURNAL_SECTOR_SIZE = 4096;
+
+// On-flash record (little-endian, as written by the ESP32)
+struct __attribute__((packed)) EnergyJournalRecord {
+    uint16_t magic;
+    uint8_t  version;
+    uint8_t  source;                        // EnergySource when written (informational)
+    uint32_t sequence;                      // 1, 2, ... never 0 or 0xFFFFFFFF
+    uint32_t utc;                           // EnergyData::lastUpdateTime
+    uint32_t reserved;
+    uint64_t counts[RAW_EN_COUNT][4];       // EnergyAccumulator lifetime pulses
+    uint32_t crc;                           // CRC-32 over all preceding bytes
+};
+
+constexpr size_t ENERGY_JOURNAL_RECORD_SIZE = sizeof(EnergyJournalRecord);
+static_assert(ENERGY_JOURNAL_RECORD_SIZE == 180, "EnergyJournalRecord layout changed");
+
+/**
+ * Flash backend: erased bytes read 0xFF and writes can only clear bits
+ */
+class JournalFlash {
+public:
+    virtual ~JournalFlash() = default;
+    virtual size_t size() const = 0;
+    virtual bool read(size_t offset, void* dst, size_t len) = 0;
+    virtual bool write(size_t offset, const void* src, size_t len) = 0;
+    virtual bool eraseSector(size_t offset) = 0;
+};
+
+/**
+ * Backend for a data partition, by label
+ * @return nullptr if the partition table has no such partition
+ */
+JournalFlash* openJournalPartition(const char* label);
+
+struct EnergyJournalStats {
+    bool     ready;
+    uint32_t sequence;          // Last record written or recovered
+    uint32_t slots;             // Ring capacity in records
+    uint32_t appends;           // Since boot
+    uint32_t erases;            // Since boot
+    uint32_t skipped;           // Non-erased slots stepped over (torn writes)
+    uint32_t errors;            // Failed flash operations
+};
+
+class EnergyJournal {
+public:
+    EnergyJournal();
+
+    /**
+     * Scan the ring and position the writer after the newest valid record
+     * @param flash Backend; at least two sectors
+     * @return false if the backend is missing, too small or unreadable
+     */
+    bool begin(JournalFlash* flash);
+
+    bool isReady() const { return m_flash != nullptr; }
+
+    /**
+     * Newest valid record found by begin() or written since
+     * @return false if the journal holds none
+     */
+    bool latest(EnergyJournalRecord& out) const;
+
+    /**
+     * Write one record to the next erased slot (erasing a sector when entering it)
+     * @return true once the record is on flash and reads back intact
+     */
+    bool append(const uint64_t counts[RAW_EN_COUNT][4], uint32_t utc, uint8_t source);
+
+    EnergyJournalStats getStats() const;
+
+private:
+    bool readRecord(uint32_t slot, EnergyJournalRecord& rec);
+    bool slotErased(uint32_t slot);
+    size_t slotOffset(uint32_t slot) const;
+
+    static uint32_t recordCrc(const EnergyJournalRecord& rec);
+
+    JournalFlash* m_flash;
+    uint32_t m_slotsPerSector;
+    uint32_t m_slotCount;
+    uint32_t m_nextSlot;
+    bool m_haveLatest;
+    EnergyJournalRecord m_latest;
+    uint32_t m_appends;
+    uint32_t m_erases;
+    uint32_t m_skipped;
+    uint32_t m_errors;
+};
@@ -1,151 +1,235 @@
 #include "EnergyMeter.h"
+#include "ConfigManager.h"
+#include "NTPSync.h"
+#include "PerfMonitor.h"
 
 EnergyMeter::EnergyMeter() 
     : m_initialized(false)
-    , m_filterSize(5)
-    , m_filterIndex(0)
-    , m_filterFilled(false)
     , m_mutex(nullptr)
+    , m_lastFastUs(0)
 {
-    memset(m_voltageBufferA, 0, sizeof(m_voltageBufferA));
-    memset(m_voltageBufferB, 0, sizeof(m_voltageBufferB));
-    memset(m_voltageBufferC, 0, sizeof(m_voltageBufferC));
-    memset(m_currentBufferA, 0, sizeof(m_currentBufferA));
-    memset(m_currentBufferB, 0, sizeof(m_currentBufferB));
-    memset(m_currentBufferC, 0, sizeof(m_currentBufferC));
+    memset(&m_timing, 0, sizeof(m_timing));
+    SystemConfig defaults;
+    setDeadbands(defaults.meterDeadbands);
+    memset(m_reported, 0, sizeof(m_reported));
+    memset(m_reportedAmbient, 0, sizeof(m_reportedAmbient));
 }
 
-bool EnergyMeter::init(uint8_t filterSize) {
+bool EnergyMeter::init() {
     if (m_initialized) {
         Logger::getInstance().warn("EnergyMeter: Already initialized");
         return true;
     }
 
-    if (filterSize == 0 || filterSize > 10) {
-        Logger::getInstance().error("EnergyMeter: Invalid filter size, must be 1-10");
-        return false;
-    }
-
-    m_filterSize = filterSize;
-    
     m_mutex = xSemaphoreCreateMutex();
     if (m_mutex == nullptr) {
         Logger::getInstance().error("EnergyMeter: Failed to create mutex");
         return false;
     }
 
+    SystemConfig config;
+    ConfigManager::getInstance().loadSystemConfig(config);   // Defaults when nothing is stored
+    m_filters.configure(config.meterFilters);
+    setDeadbands(config.meterDeadbands);
+
     m_initialized = true;
-    Logger::getInstance().info("EnergyMeter", "Initialized with filter size: " + String(m_filterSize));
+
+    uint8_t filtered = 0;
+    for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+        if (m_filters.getSpec(ch).type != MeterFilterType::NONE) filtered++;
+    }
+    Logger::getInstance().info("EnergyMeter: Initialized (%u of %u channels filtered)", filtered, (unsigned)MF_CHANNEL_COUNT);
     
     return true;
 }
 
+void EnergyMeter::applyFilterConfig(const SystemConfig& config) {
+    if (!m_initialized || m_mutex == nullptr) return;
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        m_filters.configure(config.meterFilters);
+        xSemaphoreGive(m_mutex);
+        Logger::getInstance().info("EnergyMeter: Filter configuration applied");
+    } else {
+        Logger::getInstance().warn("EnergyMeter: Mutex timeout during applyFilterConfig");
+    }
+}
+
+void EnergyMeter::applyDeadbandConfig(const SystemConfig& config) {
+    if (!m_initialized || m_mutex == nullptr) return;
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        setDeadbands(config.meterDeadbands);
+        xSemaphoreGive(m_mutex);
+        Logger::getInstance().info("EnergyMeter: Deadband configuration applied");
+    } else {
+        Logger::getInstance().warn("EnergyMeter: Mutex timeout during applyDeadbandConfig");
+    }
+}
+
 bool EnergyMeter::update() {
     if (!m_initialized) {
         Logger::getInstance().error("EnergyMeter: Not initialized");
         return false;
     }
 
-    MeterData rawData;
+    RawMeterFrame frame;
     ATM90E36Driver& driver = ATM90E36Driver::getInstance();
+
+    // The ATM90E36 owns the bus during a waveform capture; keep the last frame.
+    if (driver.isWaveformCaptureActive()) {
+        return false;
+    }
     
-    if (!driver.readAll(rawData)) {
+    // Writers (EnergyTask and on-demand refreshes from other tasks) hold m_mutex from
+    // the read to the commit, so frames are published in capture order;
+    // readers copy the published slot and never take this lock.
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        Logger::getInstance().warn("EnergyMeter: Mutex timeout during update");
+        return false;
+    }
+
+    // Only the register groups that are due are read; the rest keep their last value.
+    PerfMonitor& perf = PerfMonitor::getInstance();
+    const int64_t sweepStartUs = esp_timer_get_time();
+    uint8_t groupsRead = 0;
+    if (!driver.readScheduledRaw(frame, &groupsRead)) {
+        xSemaphoreGive(m_mutex);
         Logger::getInstance().error("EnergyMeter: Failed to read from ATM90E36");
         return false;
     }
 
-    applyFilter(rawData);
+    perf.record(PERF_ENERGY_SWEEP, (uint32_t)(frame.captureUs - sweepStartUs));
+    const int64_t filterStartUs = esp_timer_get_time();
+    m_filters.apply(frame, groupsRead);
+    const int64_t publishStartUs = esp_timer_get_time();
+    perf.record(PERF_ENERGY_FILTER, (uint32_t)(publishStartUs - filterStartUs));
 
-    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        // Preserve non-ATM90E36 fields that are maintained by other subsystems/tasks (e.g. DHT22).
-        const float prevAmbientTemp = m_snapshot.ambientTemperature;
-        const float prevAmbientHum  = m_snapshot.ambientHumidity;
-        const float prevBoardTemp   = m_snapshot.boardTemperature;
-        const uint32_t prevSeq      = m_snapshot.sequenceNumber;
+    MeterState& next = m_state.beginWrite();
 
-        m_snapshot = rawData;
+    // If a transient read returns 0 board temp, keep the previous board temp to avoid UI flicker.
+    const int16_t prevBoardTemp = next.frame.temp;
 
-        // ATM90E36 driver does not provide ambient humidity and DHT22 temperature. Keep last published values.
-        m_snapshot.ambientTemperature = prevAmbientTemp;
-        m_snapshot.ambientHumidity    = prevAmbientHum;
+    next.frame = frame;
+    if (next.frame.temp == 0 && prevBoardTemp != 0) {
+        next.frame.temp = prevBoardTemp;
+    }
 
-        // If a transient read returns 0 board temp, keep the previous board temp to avoid UI flicker.
-        if (m_snapshot.boardTemperature == 0.0f && prevBoardTemp != 0.0f) {
-            m_snapshot.boardTemperature = prevBoardTemp;
+    // Acquisition spacing of the FAST group (tick jitter)
+    if (groupsRead & pollGroupBit(PollGroup::FAST)) {
+        if (m_lastFastUs != 0) {
+            const uint32_t intervalUs = (uint32_t)(frame.captureUs - m_lastFastUs);
+            m_timing.lastIntervalUs = intervalUs;
+            if (m_timing.intervals == 0 || intervalUs < m_timing.minIntervalUs) m_timing.minIntervalUs = intervalUs;
+            if (intervalUs > m_timing.maxIntervalUs) m_timing.maxIntervalUs = intervalUs;
+            m_timing.intervals++;
         }
-
-        m_snapshot.sequenceNumber = prevSeq + 1;
-        m_snapshot.timestamp = millis() / 1000;
-        m_snapshot.valid = true;
-        xSemaphoreGive(m_mutex);
-    } else {
-        Logger::getInstance().warn("EnergyMeter: Mutex timeout during update");
-        return false;
+        m_lastFastUs = frame.captureUs;
     }
 
+    next.frame.utcMs = NTPSync::utcMsAt(frame.captureUs);
+    next.sequenceNumber++;
+    next.timestamp = next.frame.utcMs ? (uint32_t)(next.frame.utcMs / 1000)
+                                      : (uint32_t)(frame.captureUs / 1000000);
+    next.valid = true;
+    trackChanges(next, 0, METER_FIELD_COUNT - 1);
+    m_state.commit();
+    perf.record(PERF_ENERGY_PUBLISH, (uint32_t)(esp_timer_get_time() - publishStartUs));
+    xSemaphoreGive(m_mutex);
+
     return true;
 }
 
+void EnergyMeter::toMeterData(const MeterState& state, MeterData& data) const {
+    data.timestamp          = state.timestamp;
+    data.sequenceNumber     = state.sequenceNumber;
+    data.timestampUs        = state.frame.captureUs;
+    data.utcMs              = state.frame.utcMs;
+    data.valid              = state.valid;
+    // ATM90E36 driver does not provide ambient humidity and DHT22 temperature.
+    data.ambientTemperature = state.ambientTemperature;
+    data.ambientHumidity    = state.ambientHumidity;
+
+    // Float conversion happens here, on the reader's copy and only for consumers that ask.
+    rawFrameToMeterData(state.frame, data);
+}
+
+void EnergyMeter::setDeadbands(const float* deadbands) {
+    for (uint8_t q = 0; q < MQ_COUNT; q++) {
+        m_deadband[q] = deadbands[q] > 0.0f ? deadbands[q] : 0.0f;
+    }
+    // |raw - reported| * scale > band  <=>  |raw - reported| > floor(band / scale) for integers
+    for (uint8_t f = 0; f < METER_FIELD_COUNT; f++) {
+        const float scale = meterFieldRawScale(f);
+        const float lsb = (scale > 0.0f) ? m_deadband[meterFieldQuantity(f)] / scale : 0.0f;
+        m_rawDeadband[f] = (lsb >= (float)UINT32_MAX) ? UINT32_MAX : (uint32_t)lsb;
+    }
+}
+
+void EnergyMeter::trackChanges(MeterState& next, uint8_t firstField, uint8_t lastField) {
+    const uint32_t seq = ++next.changeSeq;
+    for (uint8_t f = firstField; f <= lastField; f++) {
+        // Measured against the last flagged value, so slow drift is still reported
+        bool moved;
+        if (f == FIELD_AMBIENT_TEMP || f == FIELD_AMBIENT_HUMIDITY) {
+            const float v = (f == FIELD_AMBIENT_TEMP) ? next.ambientTemperature : next.ambientHumidity;
+            float& reported = m_reportedAmbient[f - FIELD_AMBIENT_TEMP];
+            moved = next.fieldSeq[f] == 0 || fabsf(v - reported) > m_deadband[meterFieldQuantity(f)];
+            if (moved) reported = v;
+        } else {
+            const int64_t v = meterFieldRaw(next.frame, f);
+            const int64_t diff = v - m_reported[f];
+            moved = next.fieldSeq[f] == 0 || (uint64_t)(diff < 0 ? -diff : diff) > m_rawDeadband[f];
+            if (moved) m_reported[f] = v;
+        }
+        if (moved) {
+            next.fieldSeq[f] = seq;
+        }
+    }
+}
+
 MeterData EnergyMeter::getSnapshot() {
     MeterData data;
-    
-    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        data = m_snapshot;
-        xSemaphoreGive(m_mutex);
-    } else {
-        Logger::getInstance().warn("EnergyMeter: Mutex timeout during getSnapshot");
-        data.valid = false;
-    }
-    
+    MeterState state;
+    m_state.read(state);
+    toMeterData(state, data);
     return data;
 }
 
-void EnergyMeter::applyFilter(MeterData& data) {
-    m_voltageBufferA[m_filterIndex] = data.phaseA.voltageRMS;
-    m_voltageBufferB[m_filterIndex] = data.phaseB.voltageRMS;
-    m_voltageBufferC[m_filterIndex] = data.phaseC.voltageRMS;
-    m_currentBufferA[m_filterIndex] = data.phaseA.currentRMS;
-    m_currentBufferB[m_filterIndex] = data.phaseB.currentRMS;
-    m_currentBufferC[m_filterIndex] = data.phaseC.currentRMS;
-    
-    m_filterIndex++;
-    if (m_filterIndex >= m_filterSize) {
-        m_filterIndex = 0;
-        m_filterFilled = true;
-    }
-    
-    uint8_t count = m_filterFilled ? m_filterSize : m_filterIndex;
-    if (count == 0) count = 1;
-    
-    float sumVA = 0, sumVB = 0, sumVC = 0;
-    float sumCA = 0, sumCB = 0, sumCC = 0;
-    
-    for (uint8_t i = 0; i < count; i++) {
-        sumVA += m_voltageBufferA[i];
-        sumVB += m_voltageBufferB[i];
-        sumVC += m_voltageBufferC[i];
-        sumCA += m_currentBufferA[i];
-        sumCB += m_currentBufferB[i];
-        sumCC += m_currentBufferC[i];
+uint32_t EnergyMeter::getSnapshotDelta(uint32_t sinceSeq, MeterData& data, MeterFieldMask& changed) {
+    MeterState state;
+    m_state.read(state);
+    toMeterData(state, data);
+
+    changed.clear();
+    // sinceSeq ahead of the meter (caller state from another boot) is treated as a full refresh
+    const bool full = (sinceSeq == 0 || sinceSeq > state.changeSeq);
+    for (uint8_t f = 0; f < METER_FIELD_COUNT; f++) {
+        if (full || state.fieldSeq[f] > sinceSeq) {
+            changed.set(f);
+        }
     }
-    
-    data.phaseA.voltageRMS = sumVA / count;
-    data.phaseB.voltageRMS = sumVB / count;
-    data.phaseC.voltageRMS = sumVC / count;
-    data.phaseA.currentRMS = sumCA / count;
-    data.phaseB.currentRMS = sumCB / count;
-    data.phaseC.currentRMS = sumCC / count;
+    return state.changeSeq;
 }
 
+bool EnergyMeter::getRawFrame(RawMeterFrame& frame) {
+    MeterState state;
+    m_state.read(state);
+    frame = state.frame;
+    return state.valid;
+}
 
 void EnergyMeter::setAmbientReadings(float ambientTempC, float ambientHumidityPct, bool valid) {
     if (!m_initialized || m_mutex == nullptr) return;
 
+    if (!valid) return;
+
     if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-        if (valid) {
-            m_snapshot.ambientTemperature = ambientTempC;
-            m_snapshot.ambientHumidity = ambientHumidityPct;
-        }
+        MeterState& next = m_state.beginWrite();
+        next.ambientTemperature = ambientTempC;
+        next.ambientHumidity = ambientHumidityPct;
+        trackChanges(next, FIELD_AMBIENT_TEMP, FIELD_AMBIENT_HUMIDITY);
+        m_state.commit();
         xSemaphoreGive(m_mutex);
     } else {
         Logger::getInstance().warn("EnergyMeter: Mutex timeout during setAmbientReadings");
@@ -8,15 +8,33 @@
  * 
  * Features:
  * - Singleton pattern
- * - Moving average filter for voltage/current readings
- * - Thread-safe with mutex protection
+ * - Per-channel SMA/EMA/median filtering (MeterFilterBank, configured in SystemConfig)
+ * - Lock-free readers: the snapshot is double-buffered (SnapshotBuffer), so
+ *   getSnapshot()/getRawFrame() never wait and writers never wait for readers
  * - Complete meter data snapshot
+ * - Raw (fixed-point) frame on the acquisition path; floats are produced
+ *   only when getSnapshot() is called
+ * - Every frame carries the esp_timer stamp of its SPI read and the matching
+ *   NTP-disciplined UTC time (MeterData::timestampUs / utcMs)
+ * - Per-field change tracking with per-quantity deadbands (getSnapshotDelta), so
+ *   consumers can republish only what moved
  */
 
 #include <Arduino.h>
 #include "ATM90E36Driver.h"
 #include "DataTypes.h"
 #include "Logger.h"
+#include "SnapshotBuffer.h"
+#include "MeterFilterBank.h"
+#include "MeterFields.h"
+
+// Interval between FAST register reads, measured on the capture timestamps
+struct AcquisitionTiming {
+    uint32_t lastIntervalUs;
+    uint32_t minIntervalUs;
+    uint32_t maxIntervalUs;
+    uint32_t intervals;         // Intervals measured since boot
+};
 
 class EnergyMeter {
 public:
@@ -30,31 +48,70 @@ public:
 
     /**
      * Initialize energy meter
-     * @param filterSize Size of moving average filter (default 5)
+     * Loads the measurement filter configuration from SystemConfig
      * @return true if successful
      */
-    bool init(uint8_t filterSize = 5);
+    bool init();
+
+    /**
+     * Apply SystemConfig::meterFilters. Channels whose filter changed restart empty.
+     */
+    void applyFilterConfig(const SystemConfig& config);
+
+    /**
+     * Apply SystemConfig::meterDeadbands (negative values are treated as 0).
+     * Takes effect on the next update; fields already reported are not re-flagged.
+     */
+    void applyDeadbandConfig(const SystemConfig& config);
 
     /**
      * Update meter readings
-     * Reads from ATM90E36, applies filtering, updates snapshot
+     * Reads the due ATM90E36 register groups, applies filtering, updates snapshot
      * @return true if successful
      */
     bool update();
 
     /**
      * Get complete meter data snapshot
-     * Thread-safe access to latest filtered data
+     * Lock-free copy of the latest filtered data (valid=false before the first update)
      * @return Current meter data
      */
     MeterData getSnapshot();
 
+    /**
+     * Get the latest filtered register values without float conversion
+     * (e.g. for Modbus scaled-integer registers)
+     * @param frame Receives the raw frame
+     * @return true if the frame holds valid data
+     */
+    bool getRawFrame(RawMeterFrame& frame);
+
+    /**
+     * Get the snapshot plus the fields that changed (beyond their deadband) since
+     * a previous call. Pass 0 the first time to get every field flagged.
+     * @param sinceSeq Change sequence returned by the previous call
+     * @param data Receives the full snapshot, as getSnapshot()
+     * @param changed Receives the fields changed after sinceSeq
+     * @return Current change sequence, to pass as sinceSeq next time
+     */
+    uint32_t getSnapshotDelta(uint32_t sinceSeq, MeterData& data, MeterFieldMask& changed);
+
     /**
      * Update ambient sensor values (e.g., DHT22) in the shared meter snapshot.
      * Thread-safe; does not touch ATM90E36.
      */
     void setAmbientReadings(float ambientTempC, float ambientHumidityPct, bool valid = true);
 
+    /**
+     * Snapshot reader/writer counters (reads, torn-read retries, publishes)
+     */
+    SnapshotStats getSnapshotStats() const { return m_state.getStats(); }
+
+    /**
+     * Spacing of successive FAST acquisitions (from the frame capture stamps)
+     */
+    AcquisitionTiming getAcquisitionTiming() const { return m_timing; }
+
 private:
     // Singleton - prevent copying
     EnergyMeter();
@@ -62,24 +119,45 @@ private:
     EnergyMeter(const EnergyMeter&) = delete;
     EnergyMeter& operator=(const EnergyMeter&) = delete;
 
-    /**
-     * Apply moving average filter to voltage and current
-     */
-    void applyFilter(MeterData& data);
+    // Latest filtered frame plus the fields not produced by the ATM90E36
+    struct MeterState {
+        RawMeterFrame frame;
+        uint32_t timestamp;
+        uint32_t sequenceNumber;
+        bool valid;
+        float ambientTemperature;
+        float ambientHumidity;
+
+        uint32_t changeSeq;                     // Bumped on every publish
+        uint32_t fieldSeq[METER_FIELD_COUNT];   // changeSeq at which each field last moved (0 = never)
+
+        MeterState() : timestamp(0), sequenceNumber(0), valid(false),
+                       ambientTemperature(0.0f), ambientHumidity(0.0f), changeSeq(0) {
+            memset(fieldSeq, 0, sizeof(fieldSeq));
+        }
+    };
+
+    // Flags the fields of the state being written that left their deadband (raw units, no conversion)
+    void trackChanges(MeterState& next, uint8_t firstField, uint8_t lastField);
+    void setDeadbands(const float* deadbands);
+    void toMeterData(const MeterState& state, MeterData& data) const;
 
     // State
     bool m_initialized;
-    uint8_t m_filterSize;
-    MeterData m_snapshot;
-    SemaphoreHandle_t m_mutex;
-    
-    // Filter buffers (circular)
-    float m_voltageBufferA[10];
-    float m_voltageBufferB[10];
-    float m_voltageBufferC[10];
-    float m_currentBufferA[10];
-    float m_currentBufferB[10];
-    float m_currentBufferC[10];
-    uint8_t m_filterIndex;
-    bool m_filterFilled;
+    SemaphoreHandle_t m_mutex;      // Serialises writers (update(), setAmbientReadings()) only
+
+    SnapshotBuffer<MeterState> m_state;
+
+    // Filter state (raw register units); written under m_mutex
+    MeterFilterBank m_filters;
+
+    // Change tracking; written under m_mutex
+    float m_deadband[MQ_COUNT];
+    uint32_t m_rawDeadband[METER_FIELD_COUNT];  // m_deadband per field in register LSBs
+    int64_t m_reported[METER_FIELD_COUNT];      // Raw value as of the last flagged change
+    float m_reportedAmbient[2];                 // Ambient temperature/humidity (not in the frame)
+
+    // Acquisition timing; written under m_mutex
+    int64_t m_lastFastUs;
+    AcquisitionTiming m_timing;
 };
@@ -6,24 +6,151 @@
 #include "EventBus.h"
 #include "Logger.h"
 
+static_assert(EventPayloadPool::BLOCK_COUNT <= 32, "Free bitmap is 32 bits");
+static_assert(sizeof(MeterData) <= EventPayloadPool::BLOCK_SIZE, "MeterData must fit a pool block");
+
+namespace {
+
+const char* const kEventTypeNames[EventBus::MAX_EVENT_TYPES] = {
+    "meterData", "configChanged", "calibrationApplied", "error",
+    "wifiConnected", "wifiDisconnected", "mqttConnected", "mqttDisconnected",
+    "otaStarted", "otaCompleted", "reboot", "powerQuality"
+};
+
+} // namespace
+
+// ============================================================================
+// Payload pool
+// ============================================================================
+
+EventPayloadPool::EventPayloadPool()
+    : _freeMask((BLOCK_COUNT == 32) ? 0xFFFFFFFFUL : ((1UL << BLOCK_COUNT) - 1))
+    , _maxInUse(0) {
+    for (uint8_t i = 0; i < BLOCK_COUNT; i++) {
+        _refs[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint8_t EventPayloadPool::allocate() {
+    uint32_t mask = _freeMask.load(std::memory_order_acquire);
+    while (mask != 0) {
+        const uint8_t block = (uint8_t)__builtin_ctz(mask);
+        const uint32_t claimed = mask & ~(1UL << block);
+        if (_freeMask.compare_exchange_weak(mask, claimed, std::memory_order_acq_rel)) {
+            _refs[block].store(1, std::memory_order_relaxed);
+            const uint8_t used = BLOCK_COUNT - (uint8_t)__builtin_popcount(claimed);
+            uint8_t seen = _maxInUse.load(std::memory_order_relaxed);
+            while (used > seen && !_maxInUse.compare_exchange_weak(seen, used, std::memory_order_relaxed)) {
+            }
+            return block;
+        }
+    }
+    return NO_BLOCK;
+}
+
+void EventPayloadPool::addRef(uint8_t block) {
+    _refs[block].fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventPayloadPool::release(uint8_t block) {
+    if (_refs[block].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _freeMask.fetch_or(1UL << block, std::memory_order_release);
+    }
+}
+
+EventPoolStats EventPayloadPool::getStats() const {
+    EventPoolStats s;
+    s.blocks = BLOCK_COUNT;
+    s.inUse = BLOCK_COUNT - (uint8_t)__builtin_popcount(_freeMask.load(std::memory_order_relaxed));
+    s.maxInUse = _maxInUse.load(std::memory_order_relaxed);
+    s.blockSize = BLOCK_SIZE;
+    return s;
+}
+
+// ============================================================================
+// Payload reference
+// ============================================================================
+
+EventRef::EventRef(const EventRef& other) : _block(other._block), _size(other._size) {
+    if (_block != EventPayloadPool::NO_BLOCK) {
+        EventBus::getInstance()._pool.addRef(_block);
+    }
+}
+
+EventRef& EventRef::operator=(const EventRef& other) {
+    if (this != &other) {
+        if (other._block != EventPayloadPool::NO_BLOCK) {
+            EventBus::getInstance()._pool.addRef(other._block);
+        }
+        reset();
+        _block = other._block;
+        _size = other._size;
+    }
+    return *this;
+}
+
+void* EventRef::data() const {
+    return (_block != EventPayloadPool::NO_BLOCK) ? EventBus::getInstance()._pool.data(_block) : nullptr;
+}
+
+void EventRef::reset() {
+    if (_block != EventPayloadPool::NO_BLOCK) {
+        EventBus::getInstance()._pool.release(_block);
+        _block = EventPayloadPool::NO_BLOCK;
+    }
+    _size = 0;
+}
+
+// ============================================================================
+// Event bus
+// ============================================================================
+
 EventBus& EventBus::getInstance() {
     static EventBus instance;
     return instance;
 }
 
-EventBus::EventBus() 
-    : _eventQueue(nullptr)
+EventBus::EventBus()
+    : _table(&_tables[0])
+    , _tableInUse(nullptr)
+    , _eventQueue(nullptr)
+    , _urgentQueue(nullptr)
     , _mutex(nullptr)
-    , _initialized(false) {
+    , _dispatcher(nullptr)
+    , _initialized(false)
+    , _pendingTopics(0)
+    , _stateMutex(nullptr) {
+    memset(_tables, 0, sizeof(_tables));
+    memset(_timing, 0, sizeof(_timing));
+    for (uint8_t i = 0; i < MAX_EVENT_TYPES; i++) {
+        _policy[i] = EventPolicy::DROP_OLDEST;
+        _priority[i] = EventPriority::NORMAL;
+        _generation[i] = 0;
+    }
+    // Meter snapshots are state: only the newest one is worth delivering
+    _policy[eventTypeToIndex(EventType::METER_DATA_UPDATED)] = EventPolicy::LATEST_VALUE;
+    
+    // Faults, power quality and firmware updates must not wait behind a backlog of meter data
+    _priority[eventTypeToIndex(EventType::ERROR_OCCURRED)] = EventPriority::URGENT;
+    _priority[eventTypeToIndex(EventType::OTA_STARTED)] = EventPriority::URGENT;
+    _priority[eventTypeToIndex(EventType::OTA_COMPLETED)] = EventPriority::URGENT;
+    _priority[eventTypeToIndex(EventType::SYSTEM_REBOOT)] = EventPriority::URGENT;
+    _priority[eventTypeToIndex(EventType::POWER_QUALITY_EVENT)] = EventPriority::URGENT;
 }
 
 EventBus::~EventBus() {
     if (_eventQueue) {
         vQueueDelete(_eventQueue);
     }
+    if (_urgentQueue) {
+        vQueueDelete(_urgentQueue);
+    }
     if (_mutex) {
         vSemaphoreDelete(_mutex);
     }
+    if (_stateMutex) {
+        vSemaphoreDelete(_stateMutex);
+    }
 }
 
 bool EventBus::init() {
@@ -32,28 +159,30 @@ bool EventBus::init() {
     }
     
     _mutex = xSemaphoreCreateMutex();
-    if (!_mutex) {
+    _stateMutex = xSemaphoreCreateMutex();
+    if (!_mutex || !_stateMutex) {
         Logger::getInstance().error("EventBus: Failed to create mutex");
         return false;
     }
     
     _eventQueue = xQueueCreate(EVENT_QUEUE_SIZE, sizeof(EventMessage));
-    if (!_eventQueue) {
+    _urgentQueue = xQueueCreate(URGENT_QUEUE_SIZE, sizeof(EventMessage));
+    if (!_eventQueue || !_urgentQueue) {
         Logger::getInstance().error("EventBus: Failed to create event queue");
+        if (_eventQueue) vQueueDelete(_eventQueue);
+        if (_urgentQueue) vQueueDelete(_urgentQueue);
         vSemaphoreDelete(_mutex);
+        vSemaphoreDelete(_stateMutex);
+        _eventQueue = nullptr;
+        _urgentQueue = nullptr;
         _mutex = nullptr;
+        _stateMutex = nullptr;
         return false;
     }
     
-    for (uint8_t i = 0; i < MAX_EVENT_TYPES; i++) {
-        for (uint8_t j = 0; j < MAX_SUBSCRIBERS_PER_EVENT; j++) {
-            _subscribers[i][j].active = false;
-            _subscribers[i][j].callback = nullptr;
-        }
-    }
-    
     _initialized = true;
-    Logger::getInstance().info("EventBus: Initialized");
+    Logger::getInstance().info("EventBus: Initialized (%u x %u byte payload blocks)",
+                               (unsigned)EventPayloadPool::BLOCK_COUNT, (unsigned)EventPayloadPool::BLOCK_SIZE);
     return true;
 }
 
@@ -72,16 +201,23 @@ bool EventBus::subscribe(EventType type, EventCallback callback) {
         return false;
     }
     
+    // Edit a copy; the dispatcher keeps walking the published table meanwhile
+    SubscriberTable* next = spareTable();
+    *next = *_table.load();
+    
     bool subscribed = false;
     for (uint8_t i = 0; i < MAX_SUBSCRIBERS_PER_EVENT; i++) {
-        if (!_subscribers[idx][i].active) {
-            _subscribers[idx][i].callback = callback;
-            _subscribers[idx][i].active = true;
+        if (next->callbacks[idx][i] == nullptr) {
+            next->callbacks[idx][i] = callback;
+            memset(&_timing[idx][i], 0, sizeof(SubscriberTiming));
             subscribed = true;
             Logger::getInstance().debug("EventBus: Subscribed to event %d", (int)type);
             break;
         }
     }
+    if (subscribed) {
+        _table.store(next);
+    }
     
     xSemaphoreGive(_mutex);
     
@@ -107,77 +243,406 @@ bool EventBus::unsubscribe(EventType type, EventCallback callback) {
         return false;
     }
     
+    SubscriberTable* next = spareTable();
+    *next = *_table.load();
+    
     bool unsubscribed = false;
     for (uint8_t i = 0; i < MAX_SUBSCRIBERS_PER_EVENT; i++) {
-        if (_subscribers[idx][i].active && _subscribers[idx][i].callback == callback) {
-            _subscribers[idx][i].active = false;
-            _subscribers[idx][i].callback = nullptr;
+        if (next->callbacks[idx][i] == callback) {
+            next->callbacks[idx][i] = nullptr;
             unsubscribed = true;
             Logger::getInstance().debug("EventBus: Unsubscribed from event %d", (int)type);
             break;
         }
     }
+    if (unsubscribed) {
+        _table.store(next);
+    }
     
     xSemaphoreGive(_mutex);
     return unsubscribed;
 }
 
-bool EventBus::publish(EventType type, void* data, size_t dataSize) {
+bool EventBus::publish(EventType type, const void* data, size_t dataSize) {
     if (!_initialized) {
         return false;
     }
+    if (data == nullptr || dataSize == 0) {
+        return publish(type, EventRef());
+    }
+    
+    EventRef payload = allocate(type, dataSize);
+    if (!payload) {
+        return false;
+    }
+    memcpy(payload.data(), data, dataSize);
+    return publish(type, payload);
+}
+
+EventRef EventBus::allocate(EventType type, size_t dataSize) {
+    const uint8_t idx = eventTypeToIndex(type);
+    if (!_initialized || idx >= MAX_EVENT_TYPES || dataSize == 0) {
+        return EventRef();
+    }
     
-    if (dataSize > sizeof(EventMessage::data)) {
-        Logger::getInstance().warn("EventBus: Event data too large (%d bytes)", dataSize);
+    uint8_t block = EventPayloadPool::NO_BLOCK;
+    if (dataSize <= EventPayloadPool::BLOCK_SIZE) {
+        block = _pool.allocate();
+        // Pool empty: most blocks sit in the queues, so drop-oldest frees one
+        // (NORMAL lane first; URGENT payloads go only when nothing else is left)
+        while (block == EventPayloadPool::NO_BLOCK &&
+               (dropOldest(_eventQueue) || dropOldest(_urgentQueue))) {
+            block = _pool.allocate();
+        }
+    }
+    if (block == EventPayloadPool::NO_BLOCK) {
+        if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+            _stats[idx].rejected++;
+            xSemaphoreGive(_stateMutex);
+        }
+        if (dataSize > EventPayloadPool::BLOCK_SIZE) {
+            Logger::getInstance().warn("EventBus: Event data too large (%d bytes)", (int)dataSize);
+        } else {
+            Logger::getInstance().warn("EventBus: Payload pool exhausted, dropping event %d", (int)type);
+        }
+        return EventRef();
+    }
+    return EventRef(block, (uint16_t)dataSize);
+}
+
+bool EventBus::publish(EventType type, const EventRef& payload) {
+    const uint8_t idx = eventTypeToIndex(type);
+    if (!_initialized || idx >= MAX_EVENT_TYPES) {
+        return false;
+    }
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
         return false;
     }
     
+    if (_policy[idx] == EventPolicy::LATEST_VALUE) {
+        // Topic: replace the value and flag it; no queue slot, so it can never overflow
+        const bool pending = (_pendingTopics & (1UL << idx)) != 0;
+        _latest[idx] = payload;
+        _generation[idx]++;
+        _pendingTopics |= (1UL << idx);
+        _stats[idx].published++;
+        if (pending) {
+            _stats[idx].coalesced++;
+        }
+        xSemaphoreGive(_stateMutex);
+        
+        if (_dispatcher) {
+            xTaskNotifyGive(_dispatcher);
+        }
+        return true;
+    }
+    xSemaphoreGive(_stateMutex);
+    
+    // The queue slot holds its own reference until dispatch
     EventMessage msg;
     msg.type = type;
-    msg.dataSize = dataSize;
-    
-    if (data && dataSize > 0) {
-        memcpy(msg.data, data, dataSize);
+    msg.block = payload._block;
+    msg.dataSize = payload.size();
+    if (msg.block != EventPayloadPool::NO_BLOCK) {
+        _pool.addRef(msg.block);
+    }
+    const bool queued = enqueue(idx, msg);
+    if (!queued && msg.block != EventPayloadPool::NO_BLOCK) {
+        _pool.release(msg.block);
     }
     
-    if (xQueueSend(_eventQueue, &msg, pdMS_TO_TICKS(10)) != pdTRUE) {
-        Logger::getInstance().warn("EventBus: Event queue full, dropping event %d", (int)type);
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        if (queued) _stats[idx].published++;
+        else _stats[idx].rejected++;
+        xSemaphoreGive(_stateMutex);
+    }
+    if (!queued) {
+        Logger::getInstance().warn("EventBus: Event queue stuck, dropping event %d", (int)type);
+    }
+    return queued;
+}
+
+QueueHandle_t EventBus::laneFor(uint8_t idx) const {
+    return (_priority[idx] == EventPriority::URGENT) ? _urgentQueue : _eventQueue;
+}
+
+bool EventBus::enqueue(uint8_t idx, const EventMessage& msg) {
+    QueueHandle_t lane = laneFor(idx);
+    bool queued = xQueueSend(lane, &msg, 0) == pdTRUE;
+    if (!queued) {
+        // Full: make room by discarding the oldest message (publishers never wait)
+        dropOldest(lane);
+        queued = xQueueSend(lane, &msg, 0) == pdTRUE;
+    }
+    if (queued && _dispatcher) {
+        xTaskNotifyGive(_dispatcher);
+    }
+    return queued;
+}
+
+bool EventBus::dropOldest(QueueHandle_t lane) {
+    EventMessage oldest;
+    if (xQueueReceive(lane, &oldest, 0) != pdTRUE) {
         return false;
     }
-    
+    discard(oldest);
     return true;
 }
 
-void EventBus::handle() {
+void EventBus::discard(const EventMessage& msg) {
+    const uint8_t idx = eventTypeToIndex(msg.type);
+    if (msg.block != EventPayloadPool::NO_BLOCK) {
+        _pool.release(msg.block);
+    }
+    if (idx < MAX_EVENT_TYPES && xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        _stats[idx].dropped++;
+        xSemaphoreGive(_stateMutex);
+    }
+}
+
+void EventBus::setPolicy(EventType type, EventPolicy policy) {
+    const uint8_t idx = eventTypeToIndex(type);
+    if (idx >= MAX_EVENT_TYPES) {
+        return;
+    }
+    // Before init() there is no mutex and no publisher yet
     if (!_initialized) {
+        _policy[idx] = policy;
         return;
     }
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        if (_policy[idx] == EventPolicy::LATEST_VALUE && policy != EventPolicy::LATEST_VALUE) {
+            // No longer a topic: an undelivered value is dropped with it
+            if (_pendingTopics & (1UL << idx)) {
+                _pendingTopics &= ~(1UL << idx);
+                _stats[idx].dropped++;
+            }
+            _latest[idx].reset();
+        }
+        _policy[idx] = policy;
+        xSemaphoreGive(_stateMutex);
+    }
+}
+
+void EventBus::setPriority(EventType type, EventPriority priority) {
+    const uint8_t idx = eventTypeToIndex(type);
+    if (idx >= MAX_EVENT_TYPES) {
+        return;
+    }
+    if (!_initialized) {
+        _priority[idx] = priority;
+        return;
+    }
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        _priority[idx] = priority;
+        xSemaphoreGive(_stateMutex);
+    }
+}
+
+EventPolicy EventBus::getPolicy(EventType type) const {
+    const uint8_t idx = eventTypeToIndex(type);
+    return (idx < MAX_EVENT_TYPES) ? _policy[idx] : EventPolicy::DROP_OLDEST;
+}
+
+EventPriority EventBus::getPriority(EventType type) const {
+    const uint8_t idx = eventTypeToIndex(type);
+    return (idx < MAX_EVENT_TYPES) ? _priority[idx] : EventPriority::NORMAL;
+}
+
+EventTypeStats EventBus::getStats(EventType type) const {
+    EventTypeStats stats;
+    const uint8_t idx = eventTypeToIndex(type);
+    if (!_initialized || idx >= MAX_EVENT_TYPES) {
+        return stats;
+    }
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        stats = _stats[idx];
+        xSemaphoreGive(_stateMutex);
+    }
+    return stats;
+}
+
+uint8_t EventBus::getSubscriberStats(EventSubscriberStats* out, uint8_t maxEntries) const {
+    if (out == nullptr) {
+        return 0;
+    }
     
+    // Diagnostics only: counters may be one callback behind the dispatcher
+    const SubscriberTable* table = _table.load();
+    uint8_t n = 0;
+    for (uint8_t t = 0; t < MAX_EVENT_TYPES && n < maxEntries; t++) {
+        for (uint8_t i = 0; i < MAX_SUBSCRIBERS_PER_EVENT && n < maxEntries; i++) {
+            if (table->callbacks[t][i] == nullptr) {
+                continue;
+            }
+            const SubscriberTiming& timing = _timing[t][i];
+            EventSubscriberStats& s = out[n++];
+            s.type = static_cast<EventType>(t);
+            s.callback = table->callbacks[t][i];
+            s.calls = timing.calls;
+            s.slowCalls = timing.slowCalls;
+            s.lastUs = timing.lastUs;
+            s.maxUs = timing.maxUs;
+            s.totalUs = timing.totalUs;
+        }
+    }
+    return n;
+}
+
+uint32_t EventBus::readLatest(EventType type, EventRef& out) const {
+    const uint8_t idx = eventTypeToIndex(type);
+    out.reset();
+    if (!_initialized || idx >= MAX_EVENT_TYPES) {
+        return 0;
+    }
+    uint32_t generation = 0;
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        out = _latest[idx];
+        generation = _generation[idx];
+        xSemaphoreGive(_stateMutex);
+    }
+    return generation;
+}
+
+uint32_t EventBus::getGeneration(EventType type) const {
+    const uint8_t idx = eventTypeToIndex(type);
+    if (!_initialized || idx >= MAX_EVENT_TYPES) {
+        return 0;
+    }
+    uint32_t generation = 0;
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        generation = _generation[idx];
+        xSemaphoreGive(_stateMutex);
+    }
+    return generation;
+}
+
+void EventBus::dispatch(uint32_t waitMs) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+    if (_initialized) {
+        drain();
+    }
+}
+
+void EventBus::handle() {
+    if (!_initialized || _dispatcher) {
+        return;
+    }
+    drain();
+}
+
+void EventBus::drain() {
     EventMessage msg;
-    while (xQueueReceive(_eventQueue, &msg, 0) == pdTRUE) {
+    while (xQueueReceive(_urgentQueue, &msg, 0) == pdTRUE) {
+        processEvent(msg);
+    }
+    
+    // Topics once per wake-up, with whatever value is newest now
+    deliverTopics();
+    
+    // The URGENT lane is checked again before every NORMAL event
+    while (xQueueReceive(_urgentQueue, &msg, 0) == pdTRUE ||
+           xQueueReceive(_eventQueue, &msg, 0) == pdTRUE) {
         processEvent(msg);
     }
 }
 
+void EventBus::deliverTopics() {
+    EventRef values[MAX_EVENT_TYPES];
+    uint32_t pending = 0;
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return;
+    }
+    pending = _pendingTopics;
+    _pendingTopics = 0;
+    for (uint8_t idx = 0; idx < MAX_EVENT_TYPES; idx++) {
+        if (pending & (1UL << idx)) {
+            values[idx] = _latest[idx];
+        }
+    }
+    xSemaphoreGive(_stateMutex);
+    
+    for (uint8_t idx = 0; idx < MAX_EVENT_TYPES; idx++) {
+        if (pending & (1UL << idx)) {
+            deliver(idx, values[idx]);
+        }
+    }
+}
+
+EventBus::SubscriberTable* EventBus::spareTable() {
+    // Caller holds _mutex. Of three tables at most two are taken (published,
+    // being walked by the dispatcher), so one is always free.
+    SubscriberTable* published = _table.load();
+    SubscriberTable* reading = _tableInUse.load();
+    for (uint8_t i = 0; i < SUBSCRIBER_TABLES; i++) {
+        if (&_tables[i] != published && &_tables[i] != reading) {
+            return &_tables[i];
+        }
+    }
+    return nullptr;
+}
+
 void EventBus::processEvent(const EventMessage& msg) {
     uint8_t idx = eventTypeToIndex(msg.type);
     if (idx >= MAX_EVENT_TYPES) {
+        if (msg.block != EventPayloadPool::NO_BLOCK) {
+            _pool.release(msg.block);
+        }
         return;
     }
     
-    if (xSemaphoreTake(_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-        Logger::getInstance().warn("EventBus: Process mutex timeout");
-        return;
-    }
+    // Take over the queue's reference
+    EventRef payload = (msg.block != EventPayloadPool::NO_BLOCK) ? EventRef(msg.block, msg.dataSize) : EventRef();
+    deliver(idx, payload);
+}
+
+void EventBus::deliver(uint8_t idx, const EventRef& payload) {
+    const EventType type = static_cast<EventType>(idx);
+    
+    // Claim the published table; retry if a writer swapped it before the claim was visible
+    SubscriberTable* table;
+    do {
+        table = _table.load();
+        _tableInUse.store(table);
+    } while (table != _table.load());
     
     for (uint8_t i = 0; i < MAX_SUBSCRIBERS_PER_EVENT; i++) {
-        if (_subscribers[idx][i].active && _subscribers[idx][i].callback) {
-            void* dataPtr = (msg.dataSize > 0) ? (void*)msg.data : nullptr;
-            _subscribers[idx][i].callback(msg.type, dataPtr);
+        EventCallback callback = table->callbacks[idx][i];
+        if (callback == nullptr) {
+            continue;
+        }
+        
+        const uint32_t start = micros();
+        callback(type, payload.data());
+        const uint32_t elapsed = micros() - start;
+        
+        SubscriberTiming& timing = _timing[idx][i];
+        timing.calls++;
+        timing.lastUs = elapsed;
+        timing.totalUs += elapsed;
+        if (elapsed >= SLOW_CALLBACK_US) {
+            timing.slowCalls++;
+        }
+        if (elapsed > timing.maxUs) {
+            timing.maxUs = elapsed;
+            if (elapsed >= SLOW_CALLBACK_US) {
+                Logger::getInstance().warn("EventBus: Slow subscriber %p on event %d (%lu us)",
+                                           (void*)callback, (int)type, (unsigned long)elapsed);
+            }
         }
     }
     
-    xSemaphoreGive(_mutex);
+    _tableInUse.store(nullptr);
+    
+    if (xSemaphoreTake(_stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        _stats[idx].dispatched++;
+        xSemaphoreGive(_stateMutex);
+    }
+}
+
+const char* EventBus::eventTypeName(EventType type) {
+    const uint8_t idx = static_cast<uint8_t>(type);
+    return (idx < MAX_EVENT_TYPES) ? kEventTypeNames[idx] : "unknown";
 }
 
 uint8_t EventBus::eventTypeToIndex(EventType type) const {
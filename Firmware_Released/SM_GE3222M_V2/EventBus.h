@@ -1,9 +1,30 @@
 /**
  * @file EventBus.h
  * @brief Thread-safe event system for inter-module communication
- * 
+ *
  * Singleton pub/sub event bus using FreeRTOS queues for event delivery.
  * Supports up to 10 subscribers per event type with thread-safe access.
+ *
+ * Delivery runs on one dispatcher task (TaskManager's EventTask) that drains
+ * two lanes: URGENT events (errors, power quality, OTA, reboot) always go
+ * ahead of anything queued on the NORMAL lane. Callbacks are called from a
+ * copy-on-write subscriber table without holding a lock, so a slow callback
+ * delays only the events behind it, never subscribe() or a publisher. Every
+ * callback is timed per subscriber (getSubscriberStats()).
+ *
+ * Payloads live in a fixed-block pool and are reference counted: the queue
+ * carries a 4-byte message with a block index, and every subscriber of an
+ * event sees the same block. A publisher either hands over a buffer (one copy
+ * into the pool) or fills a block from allocate() in place (no copy at all).
+ *
+ * Delivery is chosen per event type (setPolicy()):
+ * - DROP_OLDEST: a stream; every event is queued, and a full queue or an
+ *   empty pool discards the oldest queued message to make room
+ * - LATEST_VALUE: a topic holding state (METER_DATA_UPDATED). Publishing
+ *   replaces the value and bumps its generation; nothing is queued, so a
+ *   lagging consumer never causes an overflow. Subscribers are called once
+ *   per dispatcher wake-up with the newest value, and anyone can read it
+ *   later with readLatest().
  */
 
 #ifndef EVENTBUS_H
@@ -13,11 +34,111 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <freertos/queue.h>
+#include <freertos/task.h>
+#include <atomic>
 #include "DataTypes.h"
 
-// Event callback signature
+// Event callback signature; data is shared by all subscribers (read-only) and
+// stays valid until the callback returns
 typedef void (*EventCallback)(EventType type, void* data);
 
+enum class EventPolicy : uint8_t {
+    DROP_OLDEST = 0,
+    LATEST_VALUE
+};
+
+// Dispatch lane
+enum class EventPriority : uint8_t {
+    NORMAL = 0,
+    URGENT
+};
+
+// Per-type delivery counters (since init)
+struct EventTypeStats {
+    uint32_t published;     // Accepted by publish()
+    uint32_t dispatched;    // Delivered to the subscribers
+    uint32_t dropped;       // Discarded by DROP_OLDEST
+    uint32_t coalesced;     // Topic value replaced before subscribers saw it
+    uint32_t rejected;      // Too large, pool exhausted or queue stuck
+    
+    EventTypeStats() {
+        memset(this, 0, sizeof(EventTypeStats));
+    }
+};
+
+// Callback timing of one subscriber (since it subscribed)
+struct EventSubscriberStats {
+    EventType type;
+    EventCallback callback;
+    uint32_t calls;
+    uint32_t slowCalls;     // Longer than EventBus::SLOW_CALLBACK_US
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+struct EventPoolStats {
+    uint8_t blocks;
+    uint8_t inUse;
+    uint8_t maxInUse;
+    uint16_t blockSize;
+};
+
+/**
+ * Fixed-block payload pool. Allocation is a lock-free bitmap claim, so
+ * publishers never block on it.
+ */
+class EventPayloadPool {
+public:
+    static constexpr uint8_t BLOCK_COUNT = 16;
+    static constexpr uint16_t BLOCK_SIZE = 320;     // sizeof(MeterData) + headroom
+    static constexpr uint8_t NO_BLOCK = 0xFF;
+    
+    EventPayloadPool();
+    
+    // @return Block index with one reference, or NO_BLOCK if the pool is empty
+    uint8_t allocate();
+    void addRef(uint8_t block);
+    void release(uint8_t block);
+    
+    uint8_t* data(uint8_t block) { return _blocks[block].bytes; }
+    EventPoolStats getStats() const;
+
+private:
+    struct alignas(8) Block {
+        uint8_t bytes[BLOCK_SIZE];
+    };
+    
+    Block _blocks[BLOCK_COUNT];
+    std::atomic<uint16_t> _refs[BLOCK_COUNT];
+    std::atomic<uint32_t> _freeMask;
+    std::atomic<uint8_t> _maxInUse;
+};
+
+/**
+ * Counted reference to a pool block; copies share the block, the last one
+ * returns it to the pool.
+ */
+class EventRef {
+public:
+    EventRef() : _block(EventPayloadPool::NO_BLOCK), _size(0) {}
+    EventRef(const EventRef& other);
+    EventRef& operator=(const EventRef& other);
+    ~EventRef() { reset(); }
+    
+    explicit operator bool() const { return _block != EventPayloadPool::NO_BLOCK; }
+    void* data() const;
+    uint16_t size() const { return _size; }
+    void reset();
+
+private:
+    friend class EventBus;
+    EventRef(uint8_t block, uint16_t size) : _block(block), _size(size) {}
+    
+    uint8_t _block;
+    uint16_t _size;
+};
+
 class EventBus {
 public:
     static EventBus& getInstance();
@@ -26,44 +147,131 @@ public:
     
     bool subscribe(EventType type, EventCallback callback);
     bool unsubscribe(EventType type, EventCallback callback);
-    bool publish(EventType type, void* data = nullptr, size_t dataSize = 0);
     
+    /**
+     * Publish a copy of data (copied once, into a pool block)
+     */
+    bool publish(EventType type, const void* data = nullptr, size_t dataSize = 0);
+    
+    /**
+     * Zero-copy path: get a block, fill it in place, publish it
+     * @return Empty reference if not initialized, too large or the pool is exhausted
+     */
+    EventRef allocate(EventType type, size_t dataSize);
+    bool publish(EventType type, const EventRef& payload);
+    
+    /**
+     * Newest value of a LATEST_VALUE topic (kept after delivery)
+     * @param out Shared, read-only reference to the value; empty if none
+     * @return Generation of the value: counts publishes, 0 = never published
+     */
+    uint32_t readLatest(EventType type, EventRef& out) const;
+    uint32_t getGeneration(EventType type) const;
+    
+    void setPolicy(EventType type, EventPolicy policy);
+    void setPriority(EventType type, EventPriority priority);
+    EventPolicy getPolicy(EventType type) const;
+    EventPriority getPriority(EventType type) const;
+    EventTypeStats getStats(EventType type) const;
+    EventPoolStats getPoolStats() const { return _pool.getStats(); }
+    
+    /**
+     * Copy out the timing of every current subscriber
+     * @return Number of entries written (at most maxEntries)
+     */
+    uint8_t getSubscriberStats(EventSubscriberStats* out, uint8_t maxEntries) const;
+    
+    /**
+     * Dispatcher task: publishers notify it after queueing
+     */
+    void setDispatcher(TaskHandle_t task) { _dispatcher = task; }
+    
+    /**
+     * Dispatcher loop body: wait for a publish (or the timeout), then deliver
+     * the URGENT lane, the pending topics, then the NORMAL lane
+     */
+    void dispatch(uint32_t waitMs);
+    
+    /**
+     * Deliver queued events from the caller; does nothing once a dispatcher task is set
+     */
     void handle();
     
+    // Stable short name for diagnostics ("meterData", "error", ...)
+    static const char* eventTypeName(EventType type);
+    
+    static constexpr uint8_t MAX_EVENT_TYPES = 12;
+    static constexpr uint8_t MAX_SUBSCRIBERS_PER_EVENT = 10;
+    static constexpr uint32_t SLOW_CALLBACK_US = 5000;
+
 private:
     EventBus();
     ~EventBus();
     EventBus(const EventBus&) = delete;
     EventBus& operator=(const EventBus&) = delete;
     
+    friend class EventRef;
+    
+    // Queue slot: the payload is referenced, never copied
     struct EventMessage {
         EventType type;
-        uint8_t data[256];
-        size_t dataSize;
-        
-        EventMessage() : type(EventType::METER_DATA_UPDATED), dataSize(0) {
-            memset(data, 0, sizeof(data));
-        }
+        uint8_t block;          // EventPayloadPool::NO_BLOCK for no payload
+        uint16_t dataSize;
     };
     
-    struct Subscriber {
-        EventCallback callback;
-        bool active;
-        
-        Subscriber() : callback(nullptr), active(false) {}
+    // Subscriber slots (nullptr = free); never modified while published
+    struct SubscriberTable {
+        EventCallback callbacks[MAX_EVENT_TYPES][MAX_SUBSCRIBERS_PER_EVENT];
     };
     
-    static constexpr uint8_t MAX_SUBSCRIBERS_PER_EVENT = 10;
-    static constexpr uint8_t MAX_EVENT_TYPES = 11;
-    static constexpr uint8_t EVENT_QUEUE_SIZE = 20;
+    struct SubscriberTiming {
+        uint32_t calls;
+        uint32_t slowCalls;
+        uint32_t lastUs;
+        uint32_t maxUs;
+        uint64_t totalUs;
+    };
+    
+    static constexpr uint8_t EVENT_QUEUE_SIZE = 20;         // NORMAL lane
+    static constexpr uint8_t URGENT_QUEUE_SIZE = 8;
+    static constexpr uint8_t SUBSCRIBER_TABLES = 3;         // Published + one being read + one to write
+    
+    // Copy-on-write: subscribe()/unsubscribe() edit a spare table under _mutex
+    // and publish it; the dispatcher marks the table it walks in _tableInUse
+    // so that table is not reused underneath it
+    SubscriberTable _tables[SUBSCRIBER_TABLES];
+    std::atomic<SubscriberTable*> _table;
+    std::atomic<SubscriberTable*> _tableInUse;
+    SubscriberTiming _timing[MAX_EVENT_TYPES][MAX_SUBSCRIBERS_PER_EVENT];  // Written by the dispatcher only
     
-    Subscriber _subscribers[MAX_EVENT_TYPES][MAX_SUBSCRIBERS_PER_EVENT];
     QueueHandle_t _eventQueue;
-    SemaphoreHandle_t _mutex;
+    QueueHandle_t _urgentQueue;
+    SemaphoreHandle_t _mutex;                   // Subscriber table writers
+    TaskHandle_t _dispatcher;
     bool _initialized;
     
+    EventPayloadPool _pool;
+    EventPolicy _policy[MAX_EVENT_TYPES];
+    EventPriority _priority[MAX_EVENT_TYPES];
+    EventTypeStats _stats[MAX_EVENT_TYPES];
+    
+    // LATEST_VALUE topics: value and generation per type, and the topics
+    // published since the dispatcher last delivered them (bit per type)
+    EventRef _latest[MAX_EVENT_TYPES];
+    uint32_t _generation[MAX_EVENT_TYPES];
+    uint32_t _pendingTopics;
+    SemaphoreHandle_t _stateMutex;      // Policies, stats and _latest; never held across callbacks
+    
     uint8_t eventTypeToIndex(EventType type) const;
+    QueueHandle_t laneFor(uint8_t idx) const;
+    bool enqueue(uint8_t idx, const EventMessage& msg);
+    bool dropOldest(QueueHandle_t lane);
+    void discard(const EventMessage& msg);
+    SubscriberTable* spareTable();
+    void drain();
+    void deliverTopics();
     void processEvent(const EventMessage& msg);
+    void deliver(uint8_t idx, const EventRef& payload);
 };
 
 #endif // EVENTBUS_H
@@ -0,0 +1,104 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Fast Power Sampler
+ *
+ * High-rate active power path for control loops (demand response, load shedding).
+ * Independent of the EnergyMeter pipeline: reads only PmeanA/B/C/T every
+ * 20-50 ms and hands the samples to one consumer task through a lock-free ring.
+ *
+ * Features:
+ * - One 12-word SPI batch per sample (ATM90E36Driver::readActivePowerRaw)
+ * - SpscRing between the FastPowerTask (producer) and one consumer task, which is
+ *   woken by a task notification as soon as a sample is queued
+ * - Latest sample also published through a SnapshotBuffer for status readers
+ * - Selected with SystemConfig::fastPowerEnabled / fastPowerIntervalMs
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "DataTypes.h"
+#include "RawMeterFrame.h"
+#include "SnapshotBuffer.h"
+#include "SpscRing.h"
+
+struct PowerSample {
+    uint32_t timestampUs;   // micros() when the read completed
+    uint32_t sequence;      // Incremented per sample (gaps = failed reads or overruns)
+    int32_t  pmean[4];      // A, B, C, T in RawQuantity::POWER units
+
+    float watts(uint8_t phase) const { return rawToFloat(pmean[phase], RawQuantity::POWER); }
+};
+
+struct FastPowerStats {
+    uint32_t samples;       // Successful reads
+    uint32_t failures;      // Driver busy or SPI error
+    uint32_t overruns;      // Samples dropped because the consumer fell behind
+    uint32_t lastReadUs;    // Duration of the last register read
+    uint32_t maxReadUs;
+};
+
+class FastPowerSampler {
+public:
+    static FastPowerSampler& getInstance();
+
+    /**
+     * Load the mode settings from SystemConfig
+     */
+    void applyConfig(const SystemConfig& config);
+
+    bool isEnabled() const { return m_enabled; }
+    uint32_t getIntervalMs() const { return m_intervalMs; }
+
+    /**
+     * Producer (FastPowerTask): read the power registers once, queue the sample
+     * and notify the consumer.
+     * @return true if a sample was read
+     */
+    bool sample();
+
+    /**
+     * Task notified after each queued sample (nullptr: nobody is woken)
+     */
+    void setConsumer(TaskHandle_t task) { m_consumer = task; }
+
+    /**
+     * Consumer: take the oldest queued sample
+     */
+    bool pop(PowerSample& out) { return m_ring.pop(out); }
+
+    /**
+     * Any task: latest sample, lock-free
+     * @return false before the first sample
+     */
+    bool getLatest(PowerSample& out);
+
+    FastPowerStats getStats() const;
+
+    static uint8_t sanitizeInterval(uint8_t ms);
+
+    static constexpr uint8_t INTERVAL_MIN_MS = 20;      // One 50 Hz cycle
+    static constexpr uint8_t INTERVAL_MAX_MS = 50;
+    static constexpr uint16_t RING_CAPACITY = 64;       // >1 s of samples at 20 ms
+
+private:
+    FastPowerSampler();
+    ~FastPowerSampler() = default;
+    FastPowerSampler(const FastPowerSampler&) = delete;
+    FastPowerSampler& operator=(const FastPowerSampler&) = delete;
+
+    volatile bool m_enabled;
+    volatile uint8_t m_intervalMs;
+    TaskHandle_t m_consumer;
+
+    SpscRing<PowerSample, RING_CAPACITY> m_ring;
+    SnapshotBuffer<PowerSample> m_latest;
+
+    // Written by the producer only
+    uint32_t m_sequence;
+    volatile uint32_t m_samples;
+    volatile uint32_t m_failures;
+    volatile uint32_t m_lastReadUs;
+    volatile uint32_t m_maxReadUs;
+};
@@ -6,6 +6,23 @@
 #include "I2CBus.h"
 #include "Logger.h"
 
+// ATM90E36 status interrupt state (shared with the INTB ISR)
+static TaskHandle_t s_statusTask = nullptr;
+static volatile uint32_t s_lastStatusIrqUs = 0;
+static volatile uint32_t s_statusIrqCount = 0;
+
+static void IRAM_ATTR statusIrqISR() {
+    s_lastStatusIrqUs = micros();
+    s_statusIrqCount = s_statusIrqCount + 1;
+    if (s_statusTask != nullptr) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(s_statusTask, &woken);
+        if (woken == pdTRUE) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
 GPIOManager::GPIOManager() 
     : m_initialized(false)
 {
@@ -292,3 +309,56 @@ void GPIOManager::writePortAOutput(uint8_t pin, bool state, bool activeLow) {
     m_mcp.digitalWrite(pin, (activeLow ? (state ? LED_ON : LED_OFF) : (state ? HIGH : LOW)));
     xSemaphoreGive(m_mutex);
 }
+
+bool GPIOManager::enableStatusInterrupts(TaskHandle_t notifyTask) {
+    if (!m_initialized || notifyTask == nullptr) {
+        return false;
+    }
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return false;
+    }
+
+    s_statusTask = notifyTask;
+
+    // INTA/INTB separate, push-pull, active-low. Only the IRQ/WarnOut inputs
+    // interrupt; the CF pulse inputs would fire on every energy pulse.
+    m_mcp.setupInterrupts(false, false, LOW);
+    m_mcp.setupInterruptPin(8 + MCP_PORTB_IRQ_1, CHANGE);
+    m_mcp.setupInterruptPin(8 + MCP_PORTB_IRQ_2, CHANGE);
+    m_mcp.setupInterruptPin(8 + MCP_PORTB_ATM_WARN, CHANGE);
+    m_mcp.readGPIOB();  // Clear anything captured before the ISR is attached
+
+    xSemaphoreGive(m_mutex);
+
+    pinMode(PIN_MCP_INT_B, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(PIN_MCP_INT_B), statusIrqISR, FALLING);
+
+    Logger::getInstance().info("GPIOManager: ATM90E36 IRQ/WarnOut interrupts on INTB (GPIO%d)", PIN_MCP_INT_B);
+    return true;
+}
+
+uint8_t GPIOManager::readStatusInputs() {
+    if (!m_initialized) {
+        return 0xFF;
+    }
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return 0xFF;
+    }
+
+    // Reading GPIOB releases INTB
+    uint8_t port = m_mcp.readGPIOB();
+
+    xSemaphoreGive(m_mutex);
+
+    return port;
+}
+
+uint32_t GPIOManager::getLastStatusIrqMicros() const {
+    return s_lastStatusIrqUs;
+}
+
+uint32_t GPIOManager::getStatusIrqCount() const {
+    return s_statusIrqCount;
+}
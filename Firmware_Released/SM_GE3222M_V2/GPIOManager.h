@@ -17,12 +17,14 @@
  * - Button debouncing (50ms)
  * - LED blinking with configurable timing
  * - MCP23017 address 0x20 from PinMap.h
+ * - ATM90E36 IRQ/WarnOut inputs (GPB0-2) wake a task via INTB (GPIO26)
  */
 
 #include <Arduino.h>
 #include <Adafruit_MCP23X17.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
+#include <freertos/task.h>
 #include "PinMap.h"
 
 // LED identifiers
@@ -112,6 +114,26 @@ public:
      */
     bool isInitialized() const { return m_initialized; }
 
+    /**
+     * Enable interrupt-on-change for the ATM90E36 IRQ/WarnOut inputs (GPB0-2).
+     * Each INTB edge sends a task notification to notifyTask.
+     * @param notifyTask Task woken by the ISR
+     * @return true if successful
+     */
+    bool enableStatusInterrupts(TaskHandle_t notifyTask);
+
+    /**
+     * Read Port B and clear a pending MCP23017 interrupt.
+     * @return Raw Port B levels (IRQ/WarnOut are active-low), 0xFF on failure
+     */
+    uint8_t readStatusInputs();
+
+    /**
+     * micros() captured by the INTB ISR for the most recent edge
+     */
+    uint32_t getLastStatusIrqMicros() const;
+    uint32_t getStatusIrqCount() const;
+
 private:
     // Singleton - prevent copying
     GPIOManager();
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Harmonic Analyzer
+ *
+ * Per-harmonic magnitude/phase (orders 1..31), THD, TDD and K-factor computed
+ * on-device from ATM90E36 waveform captures (WaveformCapture).
+ *
+ * Features:
+ * - Captures FFT_CYCLES line cycles of V/I A..C and resamples them synchronously
+ *   (FFT_SIZE / FFT_CYCLES points per cycle, cubic interpolation), so harmonic h
+ *   lands exactly on bin h * FFT_CYCLES and no window is needed
+ * - Single-precision radix-2 FFT with a precomputed twiddle table; the voltage and
+ *   current of a phase share one complex transform (V + jI), 3 FFTs per analysis
+ * - Engineering units by scaling each channel to the RMS measured by the ATM90E36
+ * - Runs from a low-priority Core 0 task; yields between phases
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "DataTypes.h"
+
+struct WaveformInfo;
+
+class HarmonicAnalyzer {
+public:
+    static HarmonicAnalyzer& getInstance();
+
+    /**
+     * Allocate the FFT work buffers and twiddle table.
+     * @return true if the analyzer is ready
+     */
+    bool init();
+
+    /**
+     * Capture FFT_CYCLES (+1) line cycles and analyse them. Blocking; call from
+     * the harmonic task only.
+     * @return true if a new HarmonicData was produced
+     */
+    bool update();
+
+    bool getLatest(HarmonicData& out);
+    uint32_t getSequence() const { return m_sequence; }
+    uint32_t getLastAnalysisMicros() const { return m_lastAnalysisUs; }
+
+    /**
+     * Demand current (IL) for TDD. 0 uses the largest fundamental current seen on
+     * each phase since boot.
+     */
+    void setDemandCurrent(float amps) { m_demandCurrent = amps; }
+
+    static constexpr uint16_t FFT_SIZE   = 1024;
+    static constexpr uint8_t  FFT_CYCLES = 8;   // 128 points per cycle: orders up to 63 below Nyquist
+    static constexpr uint32_t ANALYSIS_INTERVAL_MS = 60000;
+
+private:
+    HarmonicAnalyzer();
+    ~HarmonicAnalyzer() = default;
+    HarmonicAnalyzer(const HarmonicAnalyzer&) = delete;
+    HarmonicAnalyzer& operator=(const HarmonicAnalyzer&) = delete;
+
+    bool loadChannel(const WaveformInfo& info, uint8_t slot, size_t count);
+    void resample(float* dst, float step, float& rms);
+    void fft(float* re, float* im);
+    void analysePair(uint8_t phase, float uScale, float iScale, HarmonicData& out);
+    void finishSpectrum(HarmonicSpectrum& spec);
+
+    // Longest capture span at 45 Hz (lowest accepted line frequency), plus the
+    // interpolation neighbours (one sample before, two after)
+    static constexpr uint16_t MAX_SPAN = (uint16_t)(FFT_CYCLES * 8000UL / 45 + 4);
+    static constexpr uint16_t SIN_TABLE_SIZE = FFT_SIZE / 2 + FFT_SIZE / 4;
+
+    bool m_initialized;
+    float* m_span;          // One channel of the capture, MAX_SPAN samples
+    float* m_re;            // FFT_SIZE
+    float* m_im;            // FFT_SIZE
+    float* m_sin;           // Twiddles: sin(2*pi*k/N), k < 3N/4 (cosine read N/4 ahead)
+
+    HarmonicData m_latest;
+    float m_peakFundamental[3];
+    float m_demandCurrent;
+    float m_refPhase;       // Phase A voltage fundamental (radians) of the running analysis
+    volatile uint32_t m_sequence;
+    uint32_t m_lastAnalysisUs;
+    SemaphoreHandle_t m_mutex;
+};
@@ -0,0 +1,138 @@
+/**
+ * SM-GE3222M V2.0 - Hardware Harmonic Sweep Implementation
+ */
+
+#include "HarmonicSweep.h"
+#include "ATM90E36Driver.h"
+#include "RegisterMap.h"
+#include "Logger.h"
+
+namespace {
+
+// DFT_SCALE field of channel ch (AI, BI, CI: 3 bits; AV, BV, CV: 2 bits)
+inline uint8_t channelScale(uint16_t dftScale, uint8_t ch) {
+    return (ch < 3) ? (uint8_t)((dftScale >> (3 * ch)) & 0x07)
+                    : (uint8_t)((dftScale >> (9 + 2 * (ch - 3))) & 0x03);
+}
+
+// Fundamental registers are interleaved I/V per phase
+inline uint8_t fundamentalSlot(uint8_t ch) {
+    return (ch < 3) ? (uint8_t)(2 * ch) : (uint8_t)(2 * (ch - 3) + 1);
+}
+
+} // namespace
+
+HarmonicSweep& HarmonicSweep::getInstance() {
+    static HarmonicSweep instance;
+    return instance;
+}
+
+HarmonicSweep::HarmonicSweep()
+    : m_initialized(false)
+    , m_state(State::IDLE)
+    , m_startMs(0)
+    , m_intervalMs(SWEEP_INTERVAL_MS)
+    , m_timeouts(0)
+    , m_sequence(0)
+    , m_mutex(nullptr) {
+}
+
+bool HarmonicSweep::init() {
+    if (m_initialized) {
+        return true;
+    }
+    m_mutex = xSemaphoreCreateMutex();
+    if (!m_mutex) {
+        Logger::getInstance().error("HarmonicSweep: Failed to create mutex");
+        return false;
+    }
+    m_initialized = true;
+    m_startMs = millis() - m_intervalMs;   // First pass on the first service()
+    Logger::getInstance().info("HarmonicSweep: Hardware DFT every %lu ms", (unsigned long)m_intervalMs);
+    return true;
+}
+
+void HarmonicSweep::service() {
+    if (!m_initialized) return;
+    ATM90E36Driver& driver = ATM90E36Driver::getInstance();
+    if (driver.isWaveformCaptureActive()) return;
+
+    const uint32_t now = millis();
+    if (m_state == State::IDLE) {
+        if ((now - m_startMs) >= m_intervalMs && driver.startDft(DFT_SCALE_DEFAULT)) {
+            m_startMs = now;
+            m_state = State::RUNNING;
+        }
+        return;
+    }
+
+    if (driver.isDftDone()) {
+        if (readResults()) {
+            m_sequence++;
+        }
+        m_state = State::IDLE;
+    } else if ((now - m_startMs) > DFT_TIMEOUT_MS) {
+        m_timeouts++;
+        Logger::getInstance().warn("HarmonicSweep: DFT not done after %lu ms, aborted", (unsigned long)(now - m_startMs));
+        driver.abortDft();
+        m_state = State::IDLE;
+    }
+}
+
+bool HarmonicSweep::readResults() {
+    ATM90E36Driver& driver = ATM90E36Driver::getInstance();
+    uint16_t block[DFT_BLOCK_STRIDE];
+
+    // One lock per channel block; results stay put until the next startDft().
+    for (uint8_t ch = 0; ch < DFT_CHANNEL_COUNT; ch++) {
+        if (!driver.readRegisterBlock(REG_DFT_AI_HR2 + ch * DFT_BLOCK_STRIDE, block, DFT_BLOCK_STRIDE)) {
+            return false;
+        }
+        memcpy(m_work.ratio[ch], block, sizeof(m_work.ratio[ch]));
+        m_work.thd[ch] = block[DFT_THD_OFFSET];
+    }
+
+    uint16_t fund[DFT_CHANNEL_COUNT];
+    if (!driver.readRegisterBlock(REG_DFT_AI_FUND, fund, DFT_CHANNEL_COUNT)) {
+        return false;
+    }
+    for (uint8_t ch = 0; ch < DFT_CHANNEL_COUNT; ch++) {
+        m_work.fundamental[ch] = fund[fundamentalSlot(ch)];
+    }
+
+    m_work.timestamp = millis();
+    m_work.sequence = m_sequence + 1;
+    m_work.dftScale = DFT_SCALE_DEFAULT;
+    m_work.valid = true;
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return false;
+    }
+    m_latest = m_work;
+    xSemaphoreGive(m_mutex);
+    return true;
+}
+
+bool HarmonicSweep::getLatest(HarmonicRatios& out) {
+    if (!m_initialized || xSemaphoreTake(m_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return false;
+    }
+    out = m_latest;
+    xSemaphoreGive(m_mutex);
+    return out.valid;
+}
+
+uint32_t HarmonicSweep::getAgeMs() const {
+    if (m_sequence == 0) return UINT32_MAX;
+    return millis() - m_latest.timestamp;
+}
+
+float HarmonicSweep::ratioPercent(uint16_t raw) {
+    return raw / DFT_RATIO_SCALE;
+}
+
+float HarmonicSweep::fundamental(const HarmonicRatios& r, uint8_t channel) {
+    if (channel >= DFT_CHANNEL_COUNT) return 0.0f;
+    const float lsb = (channel < 3) ? DFT_FUND_I_LSB : DFT_FUND_U_LSB;
+    return r.fundamental[channel] * lsb / (float)(1U << channelScale(r.dftScale, channel));
+}
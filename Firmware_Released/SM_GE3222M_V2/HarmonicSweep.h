@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Hardware Harmonic Sweep
+ *
+ * Harmonic ratios (orders 2..32), THD and fundamentals of all six V/I channels from
+ * the ATM90E36 DFT engine. The IC does the transform; the ESP32 only starts a pass
+ * and reads back ~200 registers, so this runs continuously at almost no CPU cost
+ * (HarmonicAnalyzer remains the source for phase angles, TDD and K-factor).
+ *
+ * Features:
+ * - Non-blocking state machine: service() starts a pass, returns, and on a later call
+ *   (IRQ1 DFTDone wake-up of the PowerQualityTask, or its fallback poll) reads results
+ * - Results read one 32-register channel block per driver lock, so the EnergyTask
+ *   sweep is never held off for a whole read-out
+ * - Cached copy with a completion timestamp; isStale() for consumers
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "DataTypes.h"
+
+class HarmonicSweep {
+public:
+    static HarmonicSweep& getInstance();
+
+    bool init();
+
+    /**
+     * Advance the sweep; never waits on the DFT. Call periodically from one task.
+     */
+    void service();
+
+    bool getLatest(HarmonicRatios& out);
+    uint32_t getSequence() const { return m_sequence; }
+
+    // Age of the cached results; UINT32_MAX before the first pass completes
+    uint32_t getAgeMs() const;
+    bool isStale(uint32_t maxAgeMs = STALE_MS) const { return getAgeMs() > maxAgeMs; }
+
+    void setInterval(uint32_t ms) { m_intervalMs = ms; }
+    uint32_t getInterval() const { return m_intervalMs; }
+    uint32_t getTimeoutCount() const { return m_timeouts; }
+
+    // Engineering units for HarmonicRatios values (channel order AI, BI, CI, AV, BV, CV)
+    static float ratioPercent(uint16_t raw);
+    static float fundamental(const HarmonicRatios& r, uint8_t channel);
+
+    static constexpr uint32_t SWEEP_INTERVAL_MS = 5000;
+    static constexpr uint32_t DFT_TIMEOUT_MS    = 2000;   // One pass takes 0.5 s
+    static constexpr uint32_t STALE_MS          = 3 * SWEEP_INTERVAL_MS;
+    static constexpr uint16_t DFT_SCALE_DEFAULT = 0x0000; // Unity input gain, Hanning window on
+
+private:
+    HarmonicSweep();
+    ~HarmonicSweep() = default;
+    HarmonicSweep(const HarmonicSweep&) = delete;
+    HarmonicSweep& operator=(const HarmonicSweep&) = delete;
+
+    bool readResults();
+
+    enum class State : uint8_t { IDLE, RUNNING };
+
+    bool m_initialized;
+    State m_state;
+    uint32_t m_startMs;
+    uint32_t m_intervalMs;
+    uint32_t m_timeouts;
+    volatile uint32_t m_sequence;
+
+    HarmonicRatios m_work;      // Filled block by block by the servicing task
+    HarmonicRatios m_latest;
+    SemaphoreHandle_t m_mutex;
+};
@@ -12,6 +12,7 @@
 #include "EnergyMeter.h"
 #include "EnergyAccumulator.h"
 #include "SystemMonitor.h"
+#include "TaskMonitor.h"
 #include "DataLogger.h"
 #include "TCPDataServer.h"
 #include "SMNetworkManager.h"
@@ -88,6 +89,7 @@ LCDUI20x4::LCDUI20x4()
     , _backlightOn(true)
     , _netAltView(false)
     , _ioAltView(false)
+    , _taskIndex(0)
     , _confirmAction(ConfirmAction::NONE)
     , _confirmPrevState(UiState::RUN)
     , _confirmPrevPage(RunPage::LIVE_SUMMARY)
@@ -452,6 +454,7 @@ void LCDUI20x4::maybeRender(bool force) {
             case RunPage::IO_STATUS:      intervalMs = 1000; break;
             case RunPage::NETWORK_STATUS: intervalMs = 1500; break;
             case RunPage::SYSTEM_HEALTH:  intervalMs = 1000; break;
+            case RunPage::TASK_HEALTH:    intervalMs = 1000; break;
             default: intervalMs = 1000; break;
         }
     } else {
@@ -492,6 +495,7 @@ void LCDUI20x4::renderRunPage() {
         case RunPage::IO_STATUS:      renderPageIOStatus(); break;
         case RunPage::NETWORK_STATUS: renderPageNetwork(); break;
         case RunPage::SYSTEM_HEALTH:  renderPageSystem(); break;
+        case RunPage::TASK_HEALTH:    renderPageTasks(); break;
         default: renderPageLiveSummary(); break;
     }
 }
@@ -880,6 +884,50 @@ void LCDUI20x4::renderPageSystem() {
     writeLine(3, l4);
 }
 
+void LCDUI20x4::renderPageTasks() {
+    const CpuLoadStats load = TaskMonitor::getInstance().getCpuLoad();
+    char l1[32];
+    if (load.corePct[0] < 0.0f) {
+        snprintf(l1, sizeof(l1), "TASKS  CPU n/a");
+    } else if (load.cores > 1 && load.corePct[1] >= 0.0f) {
+        snprintf(l1, sizeof(l1), "TASKS C0:%.0f%% C1:%.0f%%", load.corePct[0], load.corePct[1]);
+    } else {
+        snprintf(l1, sizeof(l1), "TASKS C0:%.0f%%", load.corePct[0]);
+    }
+    writeLine(0, l1);
+
+    // SET steps through the tasks
+    TaskRuntimeStats tasks[TaskMonitor::MAX_TASKS];
+    const uint8_t n = TaskMonitor::getInstance().getTasks(tasks, TaskMonitor::MAX_TASKS);
+    if (n == 0) {
+        writeLine(1, "No tasks");
+        writeLine(2, "");
+        writeLine(3, "");
+        return;
+    }
+    if (_taskIndex >= n) _taskIndex = 0;
+    const TaskRuntimeStats& t = tasks[_taskIndex];
+
+    char l2[32];
+    if (t.core < 0) snprintf(l2, sizeof(l2), "%s P%u", t.name, (unsigned)t.priority);
+    else snprintf(l2, sizeof(l2), "%s P%u C%d", t.name, (unsigned)t.priority, (int)t.core);
+    writeLine(1, l2);
+
+    char l3[32];
+    if (t.cpuPct < 0.0f) snprintf(l3, sizeof(l3), "CPU n/a Stk:%luB", (unsigned long)t.stackFreeMin);
+    else snprintf(l3, sizeof(l3), "CPU %.1f%% Stk:%luB", t.cpuPct, (unsigned long)t.stackFreeMin);
+    writeLine(2, l3);
+
+    char l4[32];
+    if (t.scheduled) {
+        snprintf(l4, sizeof(l4), "WCET:%luus Miss:%lu",
+                 (unsigned long)t.schedule.maxExecUs, (unsigned long)t.schedule.deadlineMisses);
+    } else {
+        snprintf(l4, sizeof(l4), "%u/%u", (unsigned)(_taskIndex + 1), (unsigned)n);
+    }
+    writeLine(3, l4);
+}
+
 void LCDUI20x4::nextRunPage() {
     _page = (RunPage)(((uint8_t)_page + 1U) % (uint8_t)RunPage::COUNT);
     maybeRender(true);
@@ -913,6 +961,9 @@ void LCDUI20x4::toggleRunSetAction() {
             SystemMonitor::getInstance().resetErrorCount();
             showToast("Errors cleared", 900);
             break;
+        case RunPage::TASK_HEALTH:
+            _taskIndex++;
+            break;
         default:
             break;
     }
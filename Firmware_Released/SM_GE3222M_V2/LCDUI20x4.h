@@ -49,6 +49,7 @@ private:
         IO_STATUS,
         NETWORK_STATUS,
         SYSTEM_HEALTH,
+        TASK_HEALTH,
         COUNT
     };
 
@@ -131,6 +132,7 @@ private:
     void renderPageIOStatus();
     void renderPageNetwork();
     void renderPageSystem();
+    void renderPageTasks();
 
     // Actions / UI state
     void nextRunPage();
@@ -190,6 +192,7 @@ private:
     bool _backlightOn;
     bool _netAltView;
     bool _ioAltView;
+    uint8_t _taskIndex;               // Task shown on TASK_HEALTH
 
     // Confirm state
     ConfirmAction _confirmAction;
@@ -0,0 +1,96 @@
+/**
+ * SM-GE3222M V2.0 - Load Shed Controller Implementation
+ */
+
+#include "LoadShedController.h"
+#include "GPIOManager.h"
+#include "Logger.h"
+
+LoadShedController& LoadShedController::getInstance() {
+    static LoadShedController instance;
+    return instance;
+}
+
+LoadShedController::LoadShedController()
+    : m_relay(0)
+    , m_limitW(0.0f)
+    , m_restoreW(0.0f)
+    , m_restoreMs(0)
+    , m_shedding(false)
+    , m_activeRelay(0)
+    , m_below(false)
+    , m_belowSinceUs(0)
+    , m_shedCount(0)
+    , m_maxLatencyUs(0) {
+}
+
+void LoadShedController::applyConfig(const SystemConfig& config) {
+    const uint8_t relay = (config.loadShedRelay <= 2) ? config.loadShedRelay : 0;
+    m_limitW = config.loadShedLimitW;
+    // Restore threshold above the limit would chatter; clamp to the limit
+    m_restoreW = (config.loadShedRestoreW < config.loadShedLimitW) ? config.loadShedRestoreW : config.loadShedLimitW;
+    m_restoreMs = config.loadShedRestoreMs;
+    m_relay = relay;
+
+    if (m_shedding && m_activeRelay != relay) {
+        release();
+    }
+    if (relay != 0) {
+        Logger::getInstance().info("LoadShed: Relay %u, shed > %.0f W, restore < %.0f W for %u ms",
+                                   (unsigned)relay, (double)m_limitW, (double)m_restoreW, (unsigned)m_restoreMs);
+    }
+}
+
+void LoadShedController::process(const PowerSample& sample) {
+    const uint8_t relay = m_relay;
+    if (relay == 0) return;
+
+    const float totalW = sample.watts(RAW_T);
+
+    if (!m_shedding) {
+        if (totalW > m_limitW) {
+            setRelay(relay, true);
+            m_activeRelay = relay;
+            m_shedding = true;
+            m_below = false;
+            m_shedCount = m_shedCount + 1;
+
+            const uint32_t latencyUs = micros() - sample.timestampUs;
+            if (latencyUs > m_maxLatencyUs) m_maxLatencyUs = latencyUs;
+            Logger::getInstance().warn("LoadShed: %.0f W > %.0f W, relay %u on (%lu us)",
+                                       (double)totalW, (double)m_limitW, (unsigned)relay, (unsigned long)latencyUs);
+        }
+        return;
+    }
+
+    if (totalW >= m_restoreW) {
+        m_below = false;
+        return;
+    }
+    if (!m_below) {
+        m_below = true;
+        m_belowSinceUs = sample.timestampUs;
+        return;
+    }
+    if ((uint32_t)(sample.timestampUs - m_belowSinceUs) >= m_restoreMs * 1000UL) {
+        Logger::getInstance().info("LoadShed: %.0f W < %.0f W for %u ms, relay %u off",
+                                   (double)totalW, (double)m_restoreW, (unsigned)m_restoreMs, (unsigned)m_activeRelay);
+        release();
+    }
+}
+
+void LoadShedController::release() {
+    if (!m_shedding) return;
+    setRelay(m_activeRelay, false);
+    m_shedding = false;
+    m_below = false;
+    m_activeRelay = 0;
+}
+
+void LoadShedController::setRelay(uint8_t relay, bool on) {
+    if (relay == 1) {
+        GPIOManager::getInstance().setRelay(Relay::RELAY_1, on);
+    } else if (relay == 2) {
+        GPIOManager::getInstance().setRelay(Relay::RELAY_2, on);
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Load Shed Controller
+ *
+ * Consumer of the FastPowerSampler ring: energises a relay as soon as total active
+ * power exceeds a limit and releases it once power has stayed below a lower restore
+ * threshold for a hold time. Runs in the LoadShedTask, so the relay reacts within
+ * one sample period of the excursion.
+ */
+
+#include <Arduino.h>
+#include "DataTypes.h"
+#include "FastPowerSampler.h"
+
+class LoadShedController {
+public:
+    static LoadShedController& getInstance();
+
+    /**
+     * Load relay/threshold settings from SystemConfig. Releases the relay if
+     * shedding is switched off or moved to another relay while active.
+     */
+    void applyConfig(const SystemConfig& config);
+
+    /**
+     * Evaluate one sample (consumer task only)
+     */
+    void process(const PowerSample& sample);
+
+    /**
+     * Drop the relay now (e.g. fast power mode switched off while shedding)
+     */
+    void release();
+
+    bool isArmed() const { return m_relay != 0; }
+    bool isShedding() const { return m_shedding; }
+    uint32_t getShedCount() const { return m_shedCount; }
+
+    // Sample timestamp to relay command, worst case since boot
+    uint32_t getMaxLatencyUs() const { return m_maxLatencyUs; }
+
+private:
+    LoadShedController();
+    ~LoadShedController() = default;
+    LoadShedController(const LoadShedController&) = delete;
+    LoadShedController& operator=(const LoadShedController&) = delete;
+
+    void setRelay(uint8_t relay, bool on);
+
+    volatile uint8_t m_relay;           // 0 = off, 1/2
+    volatile float m_limitW;
+    volatile float m_restoreW;
+    volatile uint32_t m_restoreMs;
+
+    volatile bool m_shedding;
+    uint8_t m_activeRelay;              // Relay energised by the current shed
+    bool m_below;                       // Power is in a below-restore run...
+    uint32_t m_belowSinceUs;            // ...that started here
+    volatile uint32_t m_shedCount;
+    volatile uint32_t m_maxLatencyUs;
+};
@@ -6,6 +6,7 @@
 #include "MQTTPublisher.h"
 #include <algorithm>
 #include <ArduinoJson.h>
+#include "MeterWireFormat.h"
 
 MQTTPublisher& MQTTPublisher::getInstance() {
     static MQTTPublisher instance;
@@ -137,6 +138,7 @@ bool MQTTPublisher::publish(const MeterData& data) {
     StaticJsonDocument<2048> doc;
     
     doc["timestamp"] = data.timestamp;
+    doc["utc_ms"] = data.utcMs;
     doc["sequence"] = data.sequenceNumber;
     
     JsonObject phaseA = doc.createNestedObject("phase_a");
@@ -203,10 +205,63 @@ bool MQTTPublisher::publish(const MeterData& data) {
     } else {
         Logger::getInstance().error("MQTTPublisher: Publish failed");
     }
+
+    // The JSON state stays the primary payload (Home Assistant templates read it)
+    if (result && _config.binaryPayload) {
+        MeterFieldMask all;
+        all.setAll();
+        uint8_t frame[METER_WIRE_MAX_SIZE];
+        const size_t frameLen = encodeMeterWireFrame(data, all, frame, sizeof(frame));
+        String binTopic = stateTopic + "/bin";
+        if (!_mqttClient.publish(binTopic.c_str(), frame, frameLen)) {
+            Logger::getInstance().error("MQTTPublisher: Binary publish failed");
+            result = false;
+        }
+    }
     
     return result;
 }
 
+bool MQTTPublisher::publishHarmonics(const HarmonicData& data) {
+    if (!_mqttClient.connected() || !data.valid) {
+        return false;
+    }
+
+    // One message per phase keeps each payload under MQTT_BUFFER_SIZE
+    static const char* const kPhaseTopics[3] = { "a", "b", "c" };
+    bool result = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        DynamicJsonDocument doc(1536);   // Heap: called from the small-stack harmonic task
+        doc["timestamp"] = data.timestamp;
+        doc["sequence"] = data.captureSequence;
+        doc["frequency"] = data.lineFrequency;
+        doc["voltage_thd"] = data.voltage[i].thd;
+        doc["current_thd"] = data.current[i].thd;
+        doc["current_tdd"] = data.tdd[i];
+        doc["k_factor"] = data.kFactor[i];
+
+        // Magnitudes only (V / A RMS per order); phases are served by getHarmonics
+        JsonArray voltage = doc.createNestedArray("voltage");
+        JsonArray current = doc.createNestedArray("current");
+        for (uint8_t h = 0; h < HARMONIC_MAX_ORDER; h++) {
+            voltage.add(data.voltage[i].magnitude[h]);
+            current.add(data.current[i].magnitude[h]);
+        }
+
+        String topic = String(_config.baseTopic) + "/harmonics/" + kPhaseTopics[i];
+        String payload;
+        serializeJson(doc, payload);
+        if (!_mqttClient.publish(topic.c_str(), reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length())) {
+            result = false;
+        }
+    }
+
+    if (!result) {
+        Logger::getInstance().error("MQTTPublisher: Harmonics publish failed");
+    }
+    return result;
+}
+
 bool MQTTPublisher::publishHomeAssistantDiscovery() {
     if (!_mqttClient.connected()) {
         return false;
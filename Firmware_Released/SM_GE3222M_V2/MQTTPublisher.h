@@ -22,6 +22,7 @@ public:
     bool begin(const MQTTConfig& config);
     void handle();
     bool publish(const MeterData& data);
+    bool publishHarmonics(const HarmonicData& data);
     bool publishHomeAssistantDiscovery();
     
     bool isConnected();
@@ -0,0 +1,147 @@
+/**
+ * SM-GE3222M V2.0 - Meter Field Table Implementation
+ */
+
+#include "MeterFields.h"
+#include <stddef.h>
+
+namespace {
+
+struct FieldDesc {
+    uint16_t offset;    // Into MeterData
+    uint8_t quantity;   // MeterQuantity
+    bool isU16;         // Status register rather than float
+    const char* name;
+};
+
+#define MD_FLOAT(member, q, key) { (uint16_t)offsetof(MeterData, member), q, false, key }
+#define MD_PHASES(member, q, key) \
+    MD_FLOAT(phaseA.member, q, key "A"), MD_FLOAT(phaseB.member, q, key "B"), MD_FLOAT(phaseC.member, q, key "C")
+
+// Indexed by MeterField
+const FieldDesc kFields[METER_FIELD_COUNT] = {
+    MD_PHASES(voltageRMS, MQ_VOLTAGE, "urms"),
+    MD_PHASES(currentRMS, MQ_CURRENT, "irms"),
+    MD_FLOAT(neutralCurrent, MQ_CURRENT, "irmsN"),
+    MD_PHASES(activePower, MQ_POWER, "p"), MD_FLOAT(totalActivePower, MQ_POWER, "pT"),
+    MD_PHASES(reactivePower, MQ_POWER, "q"), MD_FLOAT(totalReactivePower, MQ_POWER, "qT"),
+    MD_PHASES(apparentPower, MQ_POWER, "s"), MD_FLOAT(totalApparentPower, MQ_POWER, "sT"),
+    MD_PHASES(powerFactor, MQ_POWER_FACTOR, "pf"), MD_FLOAT(totalPowerFactor, MQ_POWER_FACTOR, "pfT"),
+    MD_PHASES(meanPhaseAngle, MQ_ANGLE, "pangle"),
+    MD_PHASES(voltagePhaseAngle, MQ_ANGLE, "uangle"),
+    MD_PHASES(voltageTHDN, MQ_THD, "thdU"),
+    MD_PHASES(currentTHDN, MQ_THD, "thdI"),
+    MD_FLOAT(frequency, MQ_FREQUENCY, "freq"),
+    MD_PHASES(fundamentalPower, MQ_POWER, "pFund"),
+    MD_PHASES(harmonicPower, MQ_POWER, "pHarm"),
+    MD_PHASES(fwdActiveEnergy, MQ_ENERGY, "epFwd"), MD_FLOAT(totalFwdActiveEnergy, MQ_ENERGY, "epFwdT"),
+    MD_PHASES(revActiveEnergy, MQ_ENERGY, "epRev"), MD_FLOAT(totalRevActiveEnergy, MQ_ENERGY, "epRevT"),
+    MD_PHASES(fwdReactiveEnergy, MQ_ENERGY, "eqFwd"), MD_FLOAT(totalFwdReactiveEnergy, MQ_ENERGY, "eqFwdT"),
+    MD_PHASES(revReactiveEnergy, MQ_ENERGY, "eqRev"), MD_FLOAT(totalRevReactiveEnergy, MQ_ENERGY, "eqRevT"),
+    MD_PHASES(apparentEnergy, MQ_ENERGY, "es"), MD_FLOAT(totalApparentEnergy, MQ_ENERGY, "esT"),
+    MD_FLOAT(boardTemperature, MQ_TEMPERATURE, "boardTemp"),
+    MD_FLOAT(ambientTemperature, MQ_TEMPERATURE, "ambientTemp"),
+    MD_FLOAT(ambientHumidity, MQ_HUMIDITY, "ambientHumidity"),
+    { (uint16_t)offsetof(MeterData, meteringStatus0), MQ_STATUS, true, "status0" },
+    { (uint16_t)offsetof(MeterData, meteringStatus1), MQ_STATUS, true, "status1" },
+};
+
+#undef MD_PHASES
+#undef MD_FLOAT
+
+// Register width/sign of a field in RawMeterFrame
+enum RawFieldType : uint8_t { RF_NONE = 0, RF_U16, RF_S16, RF_S32, RF_U64 };
+
+struct RawFieldDesc {
+    uint16_t offset;        // Into RawMeterFrame
+    uint8_t type;           // RawFieldType
+    RawQuantity quantity;   // RawQuantity::COUNT = register as is (status)
+};
+
+#define RF(member, type, q) { (uint16_t)offsetof(RawMeterFrame, member), type, q }
+#define RF_ABC(member, type, q) RF(member[RAW_A], type, q), RF(member[RAW_B], type, q), RF(member[RAW_C], type, q)
+#define RF_ABCT(member, type, q) RF_ABC(member, type, q), RF(member[RAW_T], type, q)
+#define RF_ENERGY(e) RF_ABCT(energy[e], RF_U64, RawQuantity::ENERGY)
+#define RF_ABSENT { 0, RF_NONE, RawQuantity::COUNT }
+
+// Indexed by MeterField, same order as kFields
+const RawFieldDesc kRawFields[METER_FIELD_COUNT] = {
+    RF_ABC(urms, RF_U16, RawQuantity::VOLTAGE),
+    RF_ABC(irms, RF_U16, RawQuantity::CURRENT),
+    RF(irms[RAW_N], RF_U16, RawQuantity::CURRENT),
+    RF_ABCT(pmean, RF_S32, RawQuantity::POWER),
+    RF_ABCT(qmean, RF_S32, RawQuantity::POWER),
+    RF_ABCT(smean, RF_S32, RawQuantity::POWER),
+    RF_ABCT(pf, RF_S16, RawQuantity::POWER_FACTOR),
+    RF_ABC(pangle, RF_S16, RawQuantity::ANGLE),
+    RF_ABC(uangle, RF_S16, RawQuantity::ANGLE),
+    RF_ABC(thdnU, RF_U16, RawQuantity::VOLTAGE_THD),
+    RF_ABC(thdnI, RF_U16, RawQuantity::CURRENT_THD),
+    RF(freq, RF_U16, RawQuantity::FREQUENCY),
+    RF_ABSENT, RF_ABSENT, RF_ABSENT,    // Fundamental power
+    RF_ABSENT, RF_ABSENT, RF_ABSENT,    // Harmonic power
+    RF_ENERGY(RAW_EN_AP),
+    RF_ENERGY(RAW_EN_AN),
+    RF_ENERGY(RAW_EN_RP),
+    RF_ENERGY(RAW_EN_RN),
+    RF_ENERGY(RAW_EN_SA),
+    RF(temp, RF_S16, RawQuantity::TEMPERATURE),
+    RF_ABSENT,                          // Ambient temperature (DHT22)
+    RF_ABSENT,                          // Ambient humidity (DHT22)
+    RF(sysStatus0, RF_U16, RawQuantity::COUNT),
+    RF(sysStatus1, RF_U16, RawQuantity::COUNT),
+};
+
+#undef RF_ABSENT
+#undef RF_ENERGY
+#undef RF_ABCT
+#undef RF_ABC
+#undef RF
+
+const char* const kQuantityNames[MQ_COUNT] = {
+    "voltage", "current", "power", "powerFactor", "angle", "thd",
+    "frequency", "energy", "temperature", "humidity", "status",
+};
+
+} // namespace
+
+float meterFieldValue(const MeterData& data, uint8_t field) {
+    if (field >= METER_FIELD_COUNT) return 0.0f;
+    const FieldDesc& f = kFields[field];
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&data) + f.offset;
+    if (f.isU16) {
+        return (float)*reinterpret_cast<const uint16_t*>(p);
+    }
+    return *reinterpret_cast<const float*>(p);
+}
+
+MeterQuantity meterFieldQuantity(uint8_t field) {
+    return field < METER_FIELD_COUNT ? (MeterQuantity)kFields[field].quantity : MQ_STATUS;
+}
+
+int64_t meterFieldRaw(const RawMeterFrame& frame, uint8_t field) {
+    if (field >= METER_FIELD_COUNT) return 0;
+    const RawFieldDesc& f = kRawFields[field];
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&frame) + f.offset;
+    switch (f.type) {
+        case RF_U16: return *reinterpret_cast<const uint16_t*>(p);
+        case RF_S16: return *reinterpret_cast<const int16_t*>(p);
+        case RF_S32: return *reinterpret_cast<const int32_t*>(p);
+        case RF_U64: return (int64_t)*reinterpret_cast<const uint64_t*>(p);
+        default:     return 0;
+    }
+}
+
+float meterFieldRawScale(uint8_t field) {
+    if (field >= METER_FIELD_COUNT || kRawFields[field].type == RF_NONE) return 0.0f;
+    const RawQuantity q = kRawFields[field].quantity;
+    return q == RawQuantity::COUNT ? 1.0f : rawScale(q);
+}
+
+const char* meterFieldName(uint8_t field) {
+    return field < METER_FIELD_COUNT ? kFields[field].name : "";
+}
+
+const char* meterQuantityName(uint8_t quantity) {
+    return quantity < MQ_COUNT ? kQuantityNames[quantity] : "";
+}
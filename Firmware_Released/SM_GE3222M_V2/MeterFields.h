@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Meter Field Table
+ *
+ * Flat index over the reportable MeterData values, used for change tracking
+ * (EnergyMeter::getSnapshotDelta) and by consumers that publish field by field.
+ *
+ * Features:
+ * - One MeterField per value; MeterFieldMask is a bitmap over them
+ * - Each field maps to a MeterQuantity, which selects its deadband
+ * - Stable short names ("urmsA", "epFwdT", ...) for JSON/topic keys
+ * - Raw register view of each field, so changes can be judged before any
+ *   float conversion
+ */
+
+#include <Arduino.h>
+#include "DataTypes.h"
+#include "RawMeterFrame.h"
+
+enum MeterField : uint8_t {
+    FIELD_URMS_A = 0, FIELD_URMS_B, FIELD_URMS_C,
+    FIELD_IRMS_A, FIELD_IRMS_B, FIELD_IRMS_C, FIELD_IRMS_N,
+    FIELD_P_A, FIELD_P_B, FIELD_P_C, FIELD_P_T,
+    FIELD_Q_A, FIELD_Q_B, FIELD_Q_C, FIELD_Q_T,
+    FIELD_S_A, FIELD_S_B, FIELD_S_C, FIELD_S_T,
+    FIELD_PF_A, FIELD_PF_B, FIELD_PF_C, FIELD_PF_T,
+    FIELD_PANGLE_A, FIELD_PANGLE_B, FIELD_PANGLE_C,
+    FIELD_UANGLE_A, FIELD_UANGLE_B, FIELD_UANGLE_C,
+    FIELD_THDU_A, FIELD_THDU_B, FIELD_THDU_C,
+    FIELD_THDI_A, FIELD_THDI_B, FIELD_THDI_C,
+    FIELD_FREQ,
+    FIELD_PFUND_A, FIELD_PFUND_B, FIELD_PFUND_C,
+    FIELD_PHARM_A, FIELD_PHARM_B, FIELD_PHARM_C,
+    FIELD_EP_FWD_A, FIELD_EP_FWD_B, FIELD_EP_FWD_C, FIELD_EP_FWD_T,
+    FIELD_EP_REV_A, FIELD_EP_REV_B, FIELD_EP_REV_C, FIELD_EP_REV_T,
+    FIELD_EQ_FWD_A, FIELD_EQ_FWD_B, FIELD_EQ_FWD_C, FIELD_EQ_FWD_T,
+    FIELD_EQ_REV_A, FIELD_EQ_REV_B, FIELD_EQ_REV_C, FIELD_EQ_REV_T,
+    FIELD_ES_A, FIELD_ES_B, FIELD_ES_C, FIELD_ES_T,
+    FIELD_BOARD_TEMP,
+    FIELD_AMBIENT_TEMP,
+    FIELD_AMBIENT_HUMIDITY,
+    FIELD_STATUS0,
+    FIELD_STATUS1,
+    METER_FIELD_COUNT
+};
+
+// Bitmap over MeterField
+struct MeterFieldMask {
+    static constexpr uint8_t WORDS = (METER_FIELD_COUNT + 31) / 32;
+    uint32_t bits[WORDS];
+
+    MeterFieldMask() { clear(); }
+
+    void clear() { memset(bits, 0, sizeof(bits)); }
+    void setAll() {
+        for (uint8_t f = 0; f < METER_FIELD_COUNT; f++) set(f);
+    }
+    void set(uint8_t f) { bits[f >> 5] |= (1UL << (f & 31)); }
+    bool test(uint8_t f) const { return (bits[f >> 5] >> (f & 31)) & 1UL; }
+    bool any() const {
+        for (uint8_t w = 0; w < WORDS; w++) {
+            if (bits[w]) return true;
+        }
+        return false;
+    }
+    uint8_t count() const {
+        uint8_t n = 0;
+        for (uint8_t w = 0; w < WORDS; w++) n += (uint8_t)__builtin_popcount(bits[w]);
+        return n;
+    }
+};
+
+// Value of one field as a float (status registers are widened)
+float meterFieldValue(const MeterData& data, uint8_t field);
+
+MeterQuantity meterFieldQuantity(uint8_t field);
+
+// Register value behind a field, in RawMeterFrame units (0 for fields the frame does not carry)
+int64_t meterFieldRaw(const RawMeterFrame& frame, uint8_t field);
+
+// Engineering units per raw LSB (meterFieldValue = raw * scale), 0 for fields the frame does not carry
+float meterFieldRawScale(uint8_t field);
+
+// Short key, "" for out-of-range indices
+const char* meterFieldName(uint8_t field);
+
+// Config key of a quantity class ("voltage", "current", ...)
+const char* meterQuantityName(uint8_t quantity);
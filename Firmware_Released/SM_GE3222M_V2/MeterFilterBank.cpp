@@ -0,0 +1,236 @@
+/**
+ * SM-GE3222M V2.0 - Measurement Filter Bank Implementation
+ */
+
+#include "MeterFilterBank.h"
+#include <stddef.h>
+#include "ATM90E36Driver.h"
+
+namespace {
+
+enum FieldKind : uint8_t { FK_U16, FK_I16, FK_I32 };
+
+struct FieldRef {
+    uint16_t offset;    // Into RawMeterFrame
+    uint8_t kind;
+    uint8_t group;      // PollGroup that refreshes the register
+};
+
+#define MF_FIELD(member, kind, group) { (uint16_t)offsetof(RawMeterFrame, member), kind, (uint8_t)PollGroup::group }
+
+// Indexed by MeterFilterChannel
+const FieldRef kFields[MF_CHANNEL_COUNT] = {
+    MF_FIELD(urms[0], FK_U16, FAST), MF_FIELD(urms[1], FK_U16, FAST), MF_FIELD(urms[2], FK_U16, FAST),
+    MF_FIELD(irms[0], FK_U16, FAST), MF_FIELD(irms[1], FK_U16, FAST), MF_FIELD(irms[2], FK_U16, FAST),
+    MF_FIELD(irms[3], FK_U16, FAST),
+    MF_FIELD(pmean[0], FK_I32, FAST), MF_FIELD(pmean[1], FK_I32, FAST), MF_FIELD(pmean[2], FK_I32, FAST),
+    MF_FIELD(pmean[3], FK_I32, FAST),
+    MF_FIELD(qmean[0], FK_I32, FAST), MF_FIELD(qmean[1], FK_I32, FAST), MF_FIELD(qmean[2], FK_I32, FAST),
+    MF_FIELD(qmean[3], FK_I32, FAST),
+    MF_FIELD(smean[0], FK_I32, FAST), MF_FIELD(smean[1], FK_I32, FAST), MF_FIELD(smean[2], FK_I32, FAST),
+    MF_FIELD(smean[3], FK_I32, FAST),
+    MF_FIELD(pf[0], FK_I16, FAST), MF_FIELD(pf[1], FK_I16, FAST), MF_FIELD(pf[2], FK_I16, FAST),
+    MF_FIELD(pf[3], FK_I16, FAST),
+    MF_FIELD(pangle[0], FK_I16, MEDIUM), MF_FIELD(pangle[1], FK_I16, MEDIUM), MF_FIELD(pangle[2], FK_I16, MEDIUM),
+    MF_FIELD(uangle[0], FK_I16, MEDIUM), MF_FIELD(uangle[1], FK_I16, MEDIUM), MF_FIELD(uangle[2], FK_I16, MEDIUM),
+    MF_FIELD(thdnU[0], FK_U16, MEDIUM), MF_FIELD(thdnU[1], FK_U16, MEDIUM), MF_FIELD(thdnU[2], FK_U16, MEDIUM),
+    MF_FIELD(thdnI[0], FK_U16, MEDIUM), MF_FIELD(thdnI[1], FK_U16, MEDIUM), MF_FIELD(thdnI[2], FK_U16, MEDIUM),
+    MF_FIELD(freq, FK_U16, MEDIUM),
+    MF_FIELD(temp, FK_I16, SLOW),
+};
+
+#undef MF_FIELD
+
+const char* const kChannelNames[MF_CHANNEL_COUNT] = {
+    "urmsA", "urmsB", "urmsC",
+    "irmsA", "irmsB", "irmsC", "irmsN",
+    "pA", "pB", "pC", "pT",
+    "qA", "qB", "qC", "qT",
+    "sA", "sB", "sC", "sT",
+    "pfA", "pfB", "pfC", "pfT",
+    "pangleA", "pangleB", "pangleC",
+    "uangleA", "uangleB", "uangleC",
+    "thdUA", "thdUB", "thdUC",
+    "thdIA", "thdIB", "thdIC",
+    "freq",
+    "temp",
+};
+
+const char* const kTypeNames[] = { "none", "sma", "ema", "median" };
+
+inline int32_t loadField(const RawMeterFrame& frame, const FieldRef& f) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&frame) + f.offset;
+    switch (f.kind) {
+        case FK_U16: return *reinterpret_cast<const uint16_t*>(p);
+        case FK_I16: return *reinterpret_cast<const int16_t*>(p);
+        default:     return *reinterpret_cast<const int32_t*>(p);
+    }
+}
+
+inline void storeField(RawMeterFrame& frame, const FieldRef& f, int32_t v) {
+    uint8_t* p = reinterpret_cast<uint8_t*>(&frame) + f.offset;
+    switch (f.kind) {
+        case FK_U16: *reinterpret_cast<uint16_t*>(p) = (uint16_t)v; break;
+        case FK_I16: *reinterpret_cast<int16_t*>(p) = (int16_t)v; break;
+        default:     *reinterpret_cast<int32_t*>(p) = v; break;
+    }
+}
+
+// Rounded signed division
+inline int32_t divRound(int64_t num, int64_t den) {
+    return (int32_t)((num >= 0 ? num + den / 2 : num - den / 2) / den);
+}
+
+} // namespace
+
+MeterFilterBank::MeterFilterBank() {
+    memset(&m_s, 0, sizeof(m_s));
+    for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+        m_s.window[ch] = 1;
+    }
+}
+
+MeterFilterSpec MeterFilterBank::sanitize(MeterFilterSpec spec) {
+    if ((uint8_t)spec.type > (uint8_t)MeterFilterType::MEDIAN) {
+        spec.type = MeterFilterType::NONE;
+    }
+    const uint8_t maxWindow = (spec.type == MeterFilterType::MEDIAN) ? METER_FILTER_MAX_MEDIAN : METER_FILTER_MAX_WINDOW;
+    if (spec.window < 1) spec.window = 1;
+    if (spec.window > maxWindow) spec.window = maxWindow;
+    if (spec.type == MeterFilterType::NONE) spec.window = 1;
+    return spec;
+}
+
+void MeterFilterBank::configure(const MeterFilterSpec* specs) {
+    if (!specs) return;
+    for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+        const MeterFilterSpec spec = sanitize(specs[ch]);
+        if ((uint8_t)spec.type != m_s.type[ch] || spec.window != m_s.window[ch]) {
+            m_s.type[ch] = (uint8_t)spec.type;
+            m_s.window[ch] = spec.window;
+            resetChannel(ch);
+        }
+    }
+}
+
+MeterFilterSpec MeterFilterBank::getSpec(uint8_t channel) const {
+    MeterFilterSpec spec = { MeterFilterType::NONE, 1 };
+    if (channel < MF_CHANNEL_COUNT) {
+        spec.type = (MeterFilterType)m_s.type[channel];
+        spec.window = m_s.window[channel];
+    }
+    return spec;
+}
+
+void MeterFilterBank::reset() {
+    for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+        resetChannel(ch);
+    }
+}
+
+void MeterFilterBank::resetChannel(uint8_t ch) {
+    m_s.acc[ch] = 0;
+    m_s.output[ch] = 0;
+    m_s.head[ch] = 0;
+    m_s.count[ch] = 0;
+}
+
+void MeterFilterBank::apply(RawMeterFrame& frame, uint8_t groupsRead) {
+    for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+        if (m_s.type[ch] == (uint8_t)MeterFilterType::NONE) {
+            continue;
+        }
+        const FieldRef& f = kFields[ch];
+        if (groupsRead & (1U << f.group)) {
+            m_s.output[ch] = push(ch, loadField(frame, f));
+        }
+        if (m_s.count[ch] > 0) {
+            storeField(frame, f, m_s.output[ch]);
+        }
+    }
+}
+
+int32_t MeterFilterBank::push(uint8_t ch, int32_t x) {
+    const uint8_t window = m_s.window[ch];
+
+    if (m_s.type[ch] == (uint8_t)MeterFilterType::EMA) {
+        // alpha = 2 / (N + 1); state in Q16 so small steps are not lost to rounding
+        const int64_t target = (int64_t)x * 65536;    // Not << 16: x may be negative
+        if (m_s.count[ch] == 0) {
+            m_s.acc[ch] = target;
+            m_s.count[ch] = 1;
+        } else {
+            m_s.acc[ch] += (target - m_s.acc[ch]) * 2 / (window + 1);
+        }
+        return (int32_t)((m_s.acc[ch] + (1 << 15)) >> 16);
+    }
+
+    // SMA / MEDIAN share the history ring; the running sum costs one add and one subtract.
+    int32_t* row = m_s.history[ch];
+    uint8_t head = m_s.head[ch];
+    if (m_s.count[ch] == window) {
+        m_s.acc[ch] -= row[head];
+    } else {
+        m_s.count[ch]++;
+    }
+    row[head] = x;
+    m_s.acc[ch] += x;
+    m_s.head[ch] = (uint8_t)((head + 1 == window) ? 0 : head + 1);
+
+    if (m_s.type[ch] == (uint8_t)MeterFilterType::MEDIAN) {
+        return median(ch);
+    }
+    return divRound(m_s.acc[ch], m_s.count[ch]);
+}
+
+int32_t MeterFilterBank::median(uint8_t ch) const {
+    const uint8_t n = m_s.count[ch];
+    int32_t sorted[METER_FILTER_MAX_MEDIAN];
+    // Insertion sort: N <= 15, so this beats anything cleverer
+    for (uint8_t i = 0; i < n; i++) {
+        const int32_t v = m_s.history[ch][i];
+        int8_t j = (int8_t)i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    if (n & 1) {
+        return sorted[n / 2];
+    }
+    return divRound((int64_t)sorted[n / 2 - 1] + sorted[n / 2], 2);
+}
+
+const char* MeterFilterBank::channelName(uint8_t channel) {
+    return channel < MF_CHANNEL_COUNT ? kChannelNames[channel] : "";
+}
+
+bool MeterFilterBank::parseSpec(const char* text, MeterFilterSpec& out) {
+    if (!text) return false;
+    for (uint8_t t = 0; t < sizeof(kTypeNames) / sizeof(kTypeNames[0]); t++) {
+        const size_t len = strlen(kTypeNames[t]);
+        if (strncasecmp(text, kTypeNames[t], len) != 0) continue;
+        const char* rest = text + len;
+        MeterFilterSpec spec = { (MeterFilterType)t, 1 };
+        if (*rest == ':') {
+            const long w = strtol(rest + 1, nullptr, 10);
+            if (w < 1 || w > 255) return false;
+            spec.window = (uint8_t)w;
+        } else if (*rest != '\0') {
+            continue;
+        }
+        out = sanitize(spec);
+        return true;
+    }
+    return false;
+}
+
+void MeterFilterBank::formatSpec(const MeterFilterSpec& spec, char* buf, size_t len) {
+    const MeterFilterSpec s = sanitize(spec);
+    if (s.type == MeterFilterType::NONE) {
+        snprintf(buf, len, "%s", kTypeNames[0]);
+    } else {
+        snprintf(buf, len, "%s:%u", kTypeNames[(uint8_t)s.type], (unsigned)s.window);
+    }
+}
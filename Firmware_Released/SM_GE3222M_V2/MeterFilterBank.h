@@ -0,0 +1,66 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Measurement Filter Bank
+ *
+ * Per-channel smoothing of the instantaneous RawMeterFrame fields (RMS, power,
+ * PF, angles, THD+N, frequency, temperature) in raw register units.
+ *
+ * Features:
+ * - Independent filter type and window per channel (MeterFilterSpec, SystemConfig)
+ * - SMA with a running sum and EMA with a fixed-point state: O(1) per sample
+ * - Median-of-N (N <= METER_FILTER_MAX_MEDIAN) for spike rejection
+ * - State kept as one structure-of-arrays block (history rows back to back)
+ * - Channels are only fed when their polling group was actually read, so slow
+ *   groups are not weighted by the FAST poll rate
+ */
+
+#include <Arduino.h>
+#include "DataTypes.h"
+#include "RawMeterFrame.h"
+
+class MeterFilterBank {
+public:
+    MeterFilterBank();
+
+    /**
+     * Apply a configuration. Channels whose spec changed restart from empty;
+     * invalid specs are clamped (see sanitize()).
+     */
+    void configure(const MeterFilterSpec* specs);
+
+    /**
+     * Feed the channels whose group bit is set in groupsRead (pollGroupBit() mask)
+     * and replace every filtered field of the frame with its filter output.
+     */
+    void apply(RawMeterFrame& frame, uint8_t groupsRead);
+
+    // Drop all history (e.g. after a calibration change)
+    void reset();
+
+    MeterFilterSpec getSpec(uint8_t channel) const;
+
+    static MeterFilterSpec sanitize(MeterFilterSpec spec);
+
+    // Config text form: "none", "sma:5", "ema:8", "median:3"
+    static const char* channelName(uint8_t channel);
+    static bool parseSpec(const char* text, MeterFilterSpec& out);
+    static void formatSpec(const MeterFilterSpec& spec, char* buf, size_t len);
+
+private:
+    int32_t push(uint8_t ch, int32_t x);
+    int32_t median(uint8_t ch) const;
+    void resetChannel(uint8_t ch);
+
+    // Structure of arrays; the history rows are contiguous per channel
+    struct Storage {
+        int32_t history[MF_CHANNEL_COUNT][METER_FILTER_MAX_WINDOW];
+        int64_t acc[MF_CHANNEL_COUNT];      // SMA running sum / EMA state (Q16)
+        int32_t output[MF_CHANNEL_COUNT];   // Last filter output
+        uint8_t type[MF_CHANNEL_COUNT];     // MeterFilterType
+        uint8_t window[MF_CHANNEL_COUNT];
+        uint8_t head[MF_CHANNEL_COUNT];     // Next history slot
+        uint8_t count[MF_CHANNEL_COUNT];    // Samples held (<= window)
+    };
+    Storage m_s;
+};
@@ -0,0 +1,125 @@
+/**
+ * SM-GE3222M V2.0 - Meter Wire Format Implementation
+ */
+
+#include "MeterWireFormat.h"
+
+namespace {
+
+// CRC-32 (reflected, poly 0xEDB88320), one nibble per step: 64-byte table
+const uint32_t kCrcNibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+inline void putU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+inline void putU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+inline void putU64(uint8_t* p, uint64_t v) {
+    putU32(p, (uint32_t)v);
+    putU32(p + 4, (uint32_t)(v >> 32));
+}
+
+inline uint16_t getU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t getU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint64_t getU64(const uint8_t* p) {
+    return (uint64_t)getU32(p) | ((uint64_t)getU32(p + 4) << 32);
+}
+
+} // namespace
+
+uint32_t meterWireCrc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ kCrcNibble[crc & 0x0F];
+        crc = (crc >> 4) ^ kCrcNibble[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+size_t meterWireFrameSize(const MeterFieldMask& fields) {
+    return METER_WIRE_HEADER_SIZE + METER_WIRE_MASK_SIZE + (size_t)fields.count() * 4 + METER_WIRE_CRC_SIZE;
+}
+
+size_t encodeMeterWireFrame(const MeterData& data, const MeterFieldMask& fields, uint8_t* buf, size_t len) {
+    const size_t frameLen = meterWireFrameSize(fields);
+    if (buf == nullptr || len < frameLen) return 0;
+
+    putU16(buf + 0, METER_WIRE_MAGIC);
+    buf[2] = METER_WIRE_VERSION;
+    buf[3] = data.valid ? METER_WIRE_FLAG_VALID : 0;
+    putU16(buf + 4, (uint16_t)frameLen);
+    buf[6] = METER_FIELD_COUNT;
+    buf[7] = 0;
+    putU32(buf + 8, data.sequenceNumber);
+    putU64(buf + 12, (uint64_t)data.timestampUs);
+    putU64(buf + 20, data.utcMs);
+
+    uint8_t* mask = buf + METER_WIRE_HEADER_SIZE;
+    memset(mask, 0, METER_WIRE_MASK_SIZE);
+    uint8_t* p = mask + METER_WIRE_MASK_SIZE;
+    for (uint8_t f = 0; f < METER_FIELD_COUNT; f++) {
+        if (!fields.test(f)) continue;
+        mask[f >> 3] |= (uint8_t)(1U << (f & 7));
+        const float v = meterFieldValue(data, f);
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        putU32(p, bits);
+        p += 4;
+    }
+
+    putU32(p, meterWireCrc32(buf, (size_t)(p - buf)));
+    return frameLen;
+}
+
+bool decodeMeterWireFrame(const uint8_t* buf, size_t len, MeterWireHeader& header,
+                          MeterFieldMask& fields, float values[METER_FIELD_COUNT]) {
+    if (buf == nullptr || len < METER_WIRE_HEADER_SIZE + METER_WIRE_CRC_SIZE) return false;
+    if (getU16(buf) != METER_WIRE_MAGIC || buf[2] != METER_WIRE_VERSION) return false;
+
+    header.version = buf[2];
+    header.flags = buf[3];
+    header.length = getU16(buf + 4);
+    header.fieldCount = buf[6];
+    header.sequence = getU32(buf + 8);
+    header.timestampUs = (int64_t)getU64(buf + 12);
+    header.utcMs = getU64(buf + 20);
+
+    const size_t maskLen = ((size_t)header.fieldCount + 7) / 8;
+    if (header.length > len || header.length < METER_WIRE_HEADER_SIZE + maskLen + METER_WIRE_CRC_SIZE) {
+        return false;
+    }
+    const size_t crcAt = header.length - METER_WIRE_CRC_SIZE;
+    if (getU32(buf + crcAt) != meterWireCrc32(buf, crcAt)) return false;
+
+    const uint8_t* mask = buf + METER_WIRE_HEADER_SIZE;
+    const uint8_t* p = mask + maskLen;
+    fields.clear();
+    for (uint8_t f = 0; f < header.fieldCount; f++) {
+        if (!(mask[f >> 3] & (1U << (f & 7)))) continue;
+        if (p + 4 > buf + crcAt) return false;
+        if (f < METER_FIELD_COUNT) {
+            const uint32_t bits = getU32(p);
+            memcpy(&values[f], &bits, sizeof(bits));
+            fields.set(f);
+        }
+        p += 4;
+    }
+    return p == buf + crcAt;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Meter Wire Format
+ *
+ * Compact binary MeterData frame shared by the TCP, WebSocket and MQTT
+ * transports (opt-in next to their JSON / Tag:Value payloads).
+ *
+ * Layout (little-endian, no padding):
+ *   0  u16  magic 0x4D53 ("SM")
+ *   2  u8   version (METER_WIRE_VERSION)
+ *   3  u8   flags (METER_WIRE_FLAG_*)
+ *   4  u16  frame length in bytes, CRC included
+ *   6  u8   field count N (bits in the presence mask)
+ *   7  u8   reserved, 0
+ *   8  u32  MeterData::sequenceNumber
+ *  12  i64  MeterData::timestampUs (esp_timer at capture)
+ *  20  u64  MeterData::utcMs (0 = clock not synced)
+ *  28  u8[(N+7)/8]  presence mask, bit f = MeterField f (MeterFields.h)
+ *   .. f32  one value per set bit, in field order
+ *   .. u32  CRC-32 (IEEE 802.3, as zlib.crc32) over all preceding bytes
+ *
+ * New fields are only ever appended to MeterField, so a decoder built for
+ * fewer fields skips the values of bits it does not know.
+ */
+
+#include <Arduino.h>
+#include "DataTypes.h"
+#include "MeterFields.h"
+
+constexpr uint16_t METER_WIRE_MAGIC = 0x4D53;
+constexpr uint8_t  METER_WIRE_VERSION = 1;
+
+constexpr uint8_t  METER_WIRE_FLAG_VALID = 0x01;    // MeterData::valid
+
+constexpr size_t METER_WIRE_HEADER_SIZE = 28;
+constexpr size_t METER_WIRE_MASK_SIZE = (METER_FIELD_COUNT + 7) / 8;
+constexpr size_t METER_WIRE_CRC_SIZE = 4;
+constexpr size_t METER_WIRE_MAX_SIZE =
+    METER_WIRE_HEADER_SIZE + METER_WIRE_MASK_SIZE + METER_FIELD_COUNT * 4 + METER_WIRE_CRC_SIZE;
+
+struct MeterWireHeader {
+    uint8_t  version;
+    uint8_t  flags;
+    uint16_t length;
+    uint8_t  fieldCount;
+    uint32_t sequence;
+    int64_t  timestampUs;
+    uint64_t utcMs;
+};
+
+/**
+ * Encode the fields set in `fields` into `buf`. Does not allocate.
+ * @return Frame length, or 0 if `len` is too small
+ */
+size_t encodeMeterWireFrame(const MeterData& data, const MeterFieldMask& fields, uint8_t* buf, size_t len);
+
+// Frame length for a given presence mask
+size_t meterWireFrameSize(const MeterFieldMask& fields);
+
+/**
+ * Validate and unpack a frame. values[] is indexed by MeterField; only entries
+ * set in `fields` are written.
+ * @return false on a short buffer, wrong magic/version, bad length or CRC
+ */
+bool decodeMeterWireFrame(const uint8_t* buf, size_t len, MeterWireHeader& header,
+                          MeterFieldMask& fields, float values[METER_FIELD_COUNT]);
+
+uint32_t meterWireCrc32(const uint8_t* data, size_t len);
@@ -166,6 +166,53 @@ constexpr uint16_t MB_FREE_HEAP         = 305;    // Free Heap (uint32)
 constexpr uint16_t MB_STATUS_FLAGS      = 307;    // Status Flags (uint16)
 constexpr uint16_t MB_METERING_STATUS   = 308;    // ATM90E36 Metering Status (uint16)
 
+// ============================================================================
+// RAW SCALED INTEGERS (Input Registers 320-362, 43 registers)
+// ATM90E36 register values as read, no float conversion. Multiply by the LSB
+// given here (RAW_SCALE in RawMeterFrame.h). int32 = HI word first.
+// ============================================================================
+constexpr uint16_t MB_RAW_URMS_A        = 320;    // Voltage A..C (uint16, 0.01 V)
+constexpr uint16_t MB_RAW_IRMS_A        = 323;    // Current A..C, N (uint16, 0.001 A)
+constexpr uint16_t MB_RAW_PF_A          = 327;    // Power Factor A..C, T (int16, 0.001)
+constexpr uint16_t MB_RAW_FREQUENCY     = 331;    // Line Frequency (uint16, 0.01 Hz)
+constexpr uint16_t MB_RAW_TEMPERATURE   = 332;    // Die Temperature (int16, 1 degC)
+constexpr uint16_t MB_RAW_PMEAN_A       = 333;    // Active Power A..C, T (int32, 0.00032 W)
+constexpr uint16_t MB_RAW_QMEAN_A       = 341;    // Reactive Power A..C, T (int32, 0.00032 VAR)
+constexpr uint16_t MB_RAW_SMEAN_A       = 349;    // Apparent Power A..C, T (int32, 0.00032 VA)
+constexpr uint16_t MB_RAW_THDN_U_A      = 357;    // Voltage THD+N A..C (uint16, 0.01 %)
+constexpr uint16_t MB_RAW_THDN_I_A      = 360;    // Current THD+N A..C (uint16, 0.001 %)
+constexpr uint16_t MB_RAW_LAST          = 362;
+
+// ============================================================================
+// HARMONICS (Input Registers 400-605)
+// FFT of ATM90E36 waveform captures, refreshed every HarmonicAnalyzer interval.
+// Spectrum blocks hold 31 registers: [0] = fundamental RMS (0.01 V / 0.001 A),
+// [h-1] = harmonic h magnitude (uint16, 0.01 % of fundamental).
+// ============================================================================
+constexpr uint16_t MB_HARM_THD_U_A      = 400;    // Voltage THD A..C (uint16, 0.01 %)
+constexpr uint16_t MB_HARM_THD_I_A      = 403;    // Current THD A..C (uint16, 0.01 %)
+constexpr uint16_t MB_HARM_TDD_A        = 406;    // Current TDD A..C (uint16, 0.01 %)
+constexpr uint16_t MB_HARM_KFACTOR_A    = 409;    // K-factor A..C (uint16, 0.01)
+constexpr uint16_t MB_HARM_SEQUENCE     = 412;    // Capture sequence (uint16, wraps)
+constexpr uint16_t MB_HARM_SPECTRUM_UA  = 420;    // Voltage spectra A, B, C (3 x 31)
+constexpr uint16_t MB_HARM_SPECTRUM_IA  = 513;    // Current spectra A, B, C (3 x 31)
+constexpr uint16_t MB_HARM_LAST         = 605;
+
+// ============================================================================
+// PERF HISTOGRAMS (Input Registers 620-655)
+// One 6-register block per PerfMetric (PerfMonitor.h), in enum order:
+// sweep, filter, publish, EnergyTask wake, fast power read, FastPowerTask wake.
+// Times are uint16 microseconds, saturated at 65535; percentiles are bucket edges.
+// ============================================================================
+constexpr uint16_t MB_PERF_BASE         = 620;
+constexpr uint16_t MB_PERF_BLOCK_SIZE   = 6;
+constexpr uint16_t MB_PERF_COUNT        = 0;      // Samples since boot (uint32)
+constexpr uint16_t MB_PERF_MEAN         = 2;      // Mean (us)
+constexpr uint16_t MB_PERF_P50          = 3;      // Median (us)
+constexpr uint16_t MB_PERF_P99          = 4;      // 99th percentile (us)
+constexpr uint16_t MB_PERF_MAX          = 5;      // Worst case (us)
+constexpr uint16_t MB_PERF_LAST         = 655;
+
 // ============================================================================
 // HOLDING REGISTERS (Read/Write, Function Code 0x03/0x06/0x10)
 // ============================================================================
@@ -216,7 +263,7 @@ constexpr uint16_t STATUS_FLAG_OTA_ACTIVE       = 0x0080;
 #define MB_FLOAT_REGS   2
 
 // Calculate total input register count
-constexpr uint16_t MB_INPUT_REG_COUNT   = 400;
+constexpr uint16_t MB_INPUT_REG_COUNT   = 672;
 
 // Calculate total holding register count
 constexpr uint16_t MB_HOLDING_REG_COUNT = 100;
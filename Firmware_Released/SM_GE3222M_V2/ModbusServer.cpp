@@ -119,11 +119,17 @@ void ModbusServer::setupRegisters() {
     // 100..155 = energy + fundamental/harmonic power
     // 200..205 = board/ambient sensor values
     // 300..308 = uptime/status/system fields (some sparse inside block, contiguous kept for simplicity)
-    Logger::getInstance().info("ModbusServer: Add IR used ranges (0-67, 100-155, 200-205, 300-308)");
+    // 320..362 = raw scaled integers (updateRawFrame)
+    // 400..605 = harmonic analysis (updateHarmonics)
+    // 620..655 = perf histograms (updatePerfHistogram)
+    Logger::getInstance().info("ModbusServer: Add IR used ranges (0-67, 100-155, 200-205, 300-308, 320-362, 400-605, 620-655)");
     addIregRange(0, 67);
     addIregRange(100, 155);
     addIregRange(200, 205);
     addIregRange(300, 308);
+    addIregRange(MB_RAW_URMS_A, MB_RAW_LAST);
+    addIregRange(MB_HARM_THD_U_A, MB_HARM_LAST);
+    addIregRange(MB_PERF_BASE, MB_PERF_LAST);
 
     // Holding registers actually used (system control block)
     Logger::getInstance().info("ModbusServer: Add HR used range (0-9)");
@@ -158,383 +164,148 @@ void ModbusServer::handleRTU() {
 }
 
 
+namespace {
+
+struct FloatRegister {
+    uint8_t field;      // MeterField
+    uint16_t address;   // First of the two input registers (high word)
+};
+
+// Float input registers fed from MeterData (see ModbusMap.h)
+const FloatRegister kFloatRegisters[] = {
+    { FIELD_URMS_A, MB_URMS_A }, { FIELD_URMS_B, MB_URMS_B }, { FIELD_URMS_C, MB_URMS_C },
+    { FIELD_IRMS_A, MB_IRMS_A }, { FIELD_IRMS_B, MB_IRMS_B }, { FIELD_IRMS_C, MB_IRMS_C },
+    { FIELD_P_A, MB_ACTIVE_POWER_A }, { FIELD_P_B, MB_ACTIVE_POWER_B },
+    { FIELD_P_C, MB_ACTIVE_POWER_C }, { FIELD_P_T, MB_ACTIVE_POWER_T },
+    { FIELD_Q_A, MB_REACTIVE_POWER_A }, { FIELD_Q_B, MB_REACTIVE_POWER_B },
+    { FIELD_Q_C, MB_REACTIVE_POWER_C }, { FIELD_Q_T, MB_REACTIVE_POWER_T },
+    { FIELD_S_A, MB_APPARENT_POWER_A }, { FIELD_S_B, MB_APPARENT_POWER_B },
+    { FIELD_S_C, MB_APPARENT_POWER_C }, { FIELD_S_T, MB_APPARENT_POWER_T },
+    { FIELD_PF_A, MB_POWER_FACTOR_A }, { FIELD_PF_B, MB_POWER_FACTOR_B },
+    { FIELD_PF_C, MB_POWER_FACTOR_C }, { FIELD_PF_T, MB_POWER_FACTOR_T },
+    { FIELD_PANGLE_A, MB_PHASE_ANGLE_A }, { FIELD_PANGLE_B, MB_PHASE_ANGLE_B }, { FIELD_PANGLE_C, MB_PHASE_ANGLE_C },
+    { FIELD_THDU_A, MB_VOLTAGE_THD_A }, { FIELD_THDU_B, MB_VOLTAGE_THD_B }, { FIELD_THDU_C, MB_VOLTAGE_THD_C },
+    { FIELD_THDI_A, MB_CURRENT_THD_A }, { FIELD_THDI_B, MB_CURRENT_THD_B }, { FIELD_THDI_C, MB_CURRENT_THD_C },
+    { FIELD_FREQ, MB_FREQUENCY },
+    { FIELD_IRMS_N, MB_NEUTRAL_CURRENT },
+    { FIELD_EP_FWD_A, MB_FWD_ACTIVE_ENERGY_A }, { FIELD_EP_FWD_B, MB_FWD_ACTIVE_ENERGY_B },
+    { FIELD_EP_FWD_C, MB_FWD_ACTIVE_ENERGY_C }, { FIELD_EP_FWD_T, MB_FWD_ACTIVE_ENERGY_T },
+    { FIELD_EP_REV_A, MB_REV_ACTIVE_ENERGY_A }, { FIELD_EP_REV_B, MB_REV_ACTIVE_ENERGY_B },
+    { FIELD_EP_REV_C, MB_REV_ACTIVE_ENERGY_C }, { FIELD_EP_REV_T, MB_REV_ACTIVE_ENERGY_T },
+    { FIELD_EQ_FWD_A, MB_FWD_REACTIVE_ENERGY_A }, { FIELD_EQ_FWD_B, MB_FWD_REACTIVE_ENERGY_B },
+    { FIELD_EQ_FWD_C, MB_FWD_REACTIVE_ENERGY_C }, { FIELD_EQ_FWD_T, MB_FWD_REACTIVE_ENERGY_T },
+    { FIELD_EQ_REV_A, MB_REV_REACTIVE_ENERGY_A }, { FIELD_EQ_REV_B, MB_REV_REACTIVE_ENERGY_B },
+    { FIELD_EQ_REV_C, MB_REV_REACTIVE_ENERGY_C }, { FIELD_EQ_REV_T, MB_REV_REACTIVE_ENERGY_T },
+    { FIELD_ES_A, MB_APPARENT_ENERGY_A }, { FIELD_ES_B, MB_APPARENT_ENERGY_B },
+    { FIELD_ES_C, MB_APPARENT_ENERGY_C }, { FIELD_ES_T, MB_APPARENT_ENERGY_T },
+    { FIELD_PFUND_A, MB_FUNDAMENTAL_POWER_A }, { FIELD_PFUND_B, MB_FUNDAMENTAL_POWER_B },
+    { FIELD_PFUND_C, MB_FUNDAMENTAL_POWER_C },
+    { FIELD_PHARM_A, MB_HARMONIC_POWER_A }, { FIELD_PHARM_B, MB_HARMONIC_POWER_B },
+    { FIELD_PHARM_C, MB_HARMONIC_POWER_C },
+    { FIELD_BOARD_TEMP, MB_BOARD_TEMP },
+    { FIELD_AMBIENT_TEMP, MB_AMBIENT_TEMP },
+    { FIELD_AMBIENT_HUMIDITY, MB_AMBIENT_HUMIDITY },
+};
+
+} // namespace
+
 void ModbusServer::updateMeterData(const MeterData& data) {
+    MeterFieldMask all;
+    all.setAll();
+    updateMeterData(data, all);
+}
+
+void ModbusServer::updateMeterData(const MeterData& data, const MeterFieldMask& changed) {
     _meterData = data;
 
-    const bool mbReady = _rtuEnabled;
     uint16_t highWord, lowWord;
-    
-    float2registers(data.phaseA.voltageRMS, highWord, lowWord);
-    _inputRegisters[MB_URMS_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_URMS_A, highWord);
-    _inputRegisters[MB_URMS_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_URMS_A + 1, lowWord);
-    
-    float2registers(data.phaseB.voltageRMS, highWord, lowWord);
-    _inputRegisters[MB_URMS_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_URMS_B, highWord);
-    _inputRegisters[MB_URMS_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_URMS_B + 1, lowWord);
-    
-    float2registers(data.phaseC.voltageRMS, highWord, lowWord);
-    _inputRegisters[MB_URMS_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_URMS_C, highWord);
-    _inputRegisters[MB_URMS_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_URMS_C + 1, lowWord);
-    
-    float2registers(data.phaseA.currentRMS, highWord, lowWord);
-    _inputRegisters[MB_IRMS_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_IRMS_A, highWord);
-    _inputRegisters[MB_IRMS_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_IRMS_A + 1, lowWord);
-    
-    float2registers(data.phaseB.currentRMS, highWord, lowWord);
-    _inputRegisters[MB_IRMS_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_IRMS_B, highWord);
-    _inputRegisters[MB_IRMS_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_IRMS_B + 1, lowWord);
-    
-    float2registers(data.phaseC.currentRMS, highWord, lowWord);
-    _inputRegisters[MB_IRMS_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_IRMS_C, highWord);
-    _inputRegisters[MB_IRMS_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_IRMS_C + 1, lowWord);
-    
-    float2registers(data.phaseA.activePower, highWord, lowWord);
-    _inputRegisters[MB_ACTIVE_POWER_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_A, highWord);
-    _inputRegisters[MB_ACTIVE_POWER_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_A + 1, lowWord);
-    
-    float2registers(data.phaseB.activePower, highWord, lowWord);
-    _inputRegisters[MB_ACTIVE_POWER_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_B, highWord);
-    _inputRegisters[MB_ACTIVE_POWER_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_B + 1, lowWord);
-    
-    float2registers(data.phaseC.activePower, highWord, lowWord);
-    _inputRegisters[MB_ACTIVE_POWER_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_C, highWord);
-    _inputRegisters[MB_ACTIVE_POWER_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_C + 1, lowWord);
-    
-    float2registers(data.totalActivePower, highWord, lowWord);
-    _inputRegisters[MB_ACTIVE_POWER_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_T, highWord);
-    _inputRegisters[MB_ACTIVE_POWER_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_ACTIVE_POWER_T + 1, lowWord);
-    
-    float2registers(data.phaseA.reactivePower, highWord, lowWord);
-    _inputRegisters[MB_REACTIVE_POWER_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_A, highWord);
-    _inputRegisters[MB_REACTIVE_POWER_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_A + 1, lowWord);
-    
-    float2registers(data.phaseB.reactivePower, highWord, lowWord);
-    _inputRegisters[MB_REACTIVE_POWER_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_B, highWord);
-    _inputRegisters[MB_REACTIVE_POWER_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_B + 1, lowWord);
-    
-    float2registers(data.phaseC.reactivePower, highWord, lowWord);
-    _inputRegisters[MB_REACTIVE_POWER_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_C, highWord);
-    _inputRegisters[MB_REACTIVE_POWER_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_C + 1, lowWord);
-    
-    float2registers(data.totalReactivePower, highWord, lowWord);
-    _inputRegisters[MB_REACTIVE_POWER_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_T, highWord);
-    _inputRegisters[MB_REACTIVE_POWER_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REACTIVE_POWER_T + 1, lowWord);
-    
-    float2registers(data.phaseA.apparentPower, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_POWER_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_A, highWord);
-    _inputRegisters[MB_APPARENT_POWER_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_A + 1, lowWord);
-    
-    float2registers(data.phaseB.apparentPower, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_POWER_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_B, highWord);
-    _inputRegisters[MB_APPARENT_POWER_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_B + 1, lowWord);
-    
-    float2registers(data.phaseC.apparentPower, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_POWER_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_C, highWord);
-    _inputRegisters[MB_APPARENT_POWER_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_C + 1, lowWord);
-    
-    float2registers(data.totalApparentPower, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_POWER_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_T, highWord);
-    _inputRegisters[MB_APPARENT_POWER_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_POWER_T + 1, lowWord);
-    
-    float2registers(data.phaseA.powerFactor, highWord, lowWord);
-    _inputRegisters[MB_POWER_FACTOR_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_A, highWord);
-    _inputRegisters[MB_POWER_FACTOR_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_A + 1, lowWord);
-    
-    float2registers(data.phaseB.powerFactor, highWord, lowWord);
-    _inputRegisters[MB_POWER_FACTOR_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_B, highWord);
-    _inputRegisters[MB_POWER_FACTOR_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_B + 1, lowWord);
-    
-    float2registers(data.phaseC.powerFactor, highWord, lowWord);
-    _inputRegisters[MB_POWER_FACTOR_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_C, highWord);
-    _inputRegisters[MB_POWER_FACTOR_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_C + 1, lowWord);
-    
-    float2registers(data.totalPowerFactor, highWord, lowWord);
-    _inputRegisters[MB_POWER_FACTOR_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_T, highWord);
-    _inputRegisters[MB_POWER_FACTOR_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_POWER_FACTOR_T + 1, lowWord);
-    
-    float2registers(data.phaseA.meanPhaseAngle, highWord, lowWord);
-    _inputRegisters[MB_PHASE_ANGLE_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_PHASE_ANGLE_A, highWord);
-    _inputRegisters[MB_PHASE_ANGLE_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_PHASE_ANGLE_A + 1, lowWord);
-    
-    float2registers(data.phaseB.meanPhaseAngle, highWord, lowWord);
-    _inputRegisters[MB_PHASE_ANGLE_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_PHASE_ANGLE_B, highWord);
-    _inputRegisters[MB_PHASE_ANGLE_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_PHASE_ANGLE_B + 1, lowWord);
-    
-    float2registers(data.phaseC.meanPhaseAngle, highWord, lowWord);
-    _inputRegisters[MB_PHASE_ANGLE_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_PHASE_ANGLE_C, highWord);
-    _inputRegisters[MB_PHASE_ANGLE_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_PHASE_ANGLE_C + 1, lowWord);
-    
-    float2registers(data.phaseA.voltageTHDN, highWord, lowWord);
-    _inputRegisters[MB_VOLTAGE_THD_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_VOLTAGE_THD_A, highWord);
-    _inputRegisters[MB_VOLTAGE_THD_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_VOLTAGE_THD_A + 1, lowWord);
-    
-    float2registers(data.phaseB.voltageTHDN, highWord, lowWord);
-    _inputRegisters[MB_VOLTAGE_THD_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_VOLTAGE_THD_B, highWord);
-    _inputRegisters[MB_VOLTAGE_THD_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_VOLTAGE_THD_B + 1, lowWord);
-    
-    float2registers(data.phaseC.voltageTHDN, highWord, lowWord);
-    _inputRegisters[MB_VOLTAGE_THD_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_VOLTAGE_THD_C, highWord);
-    _inputRegisters[MB_VOLTAGE_THD_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_VOLTAGE_THD_C + 1, lowWord);
-    
-    float2registers(data.phaseA.currentTHDN, highWord, lowWord);
-    _inputRegisters[MB_CURRENT_THD_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_CURRENT_THD_A, highWord);
-    _inputRegisters[MB_CURRENT_THD_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_CURRENT_THD_A + 1, lowWord);
-    
-    float2registers(data.phaseB.currentTHDN, highWord, lowWord);
-    _inputRegisters[MB_CURRENT_THD_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_CURRENT_THD_B, highWord);
-    _inputRegisters[MB_CURRENT_THD_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_CURRENT_THD_B + 1, lowWord);
-    
-    float2registers(data.phaseC.currentTHDN, highWord, lowWord);
-    _inputRegisters[MB_CURRENT_THD_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_CURRENT_THD_C, highWord);
-    _inputRegisters[MB_CURRENT_THD_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_CURRENT_THD_C + 1, lowWord);
-    
-    float2registers(data.frequency, highWord, lowWord);
-    _inputRegisters[MB_FREQUENCY] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FREQUENCY, highWord);
-    _inputRegisters[MB_FREQUENCY + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FREQUENCY + 1, lowWord);
-    
-    float2registers(data.neutralCurrent, highWord, lowWord);
-    _inputRegisters[MB_NEUTRAL_CURRENT] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_NEUTRAL_CURRENT, highWord);
-    _inputRegisters[MB_NEUTRAL_CURRENT + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_NEUTRAL_CURRENT + 1, lowWord);
-    
-    float2registers(data.phaseA.fwdActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_A, highWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_A + 1, lowWord);
-    
-    float2registers(data.phaseB.fwdActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_B, highWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_B + 1, lowWord);
-    
-    float2registers(data.phaseC.fwdActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_C, highWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_C + 1, lowWord);
-    
-    float2registers(data.totalFwdActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_T, highWord);
-    _inputRegisters[MB_FWD_ACTIVE_ENERGY_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_ACTIVE_ENERGY_T + 1, lowWord);
-    
-    float2registers(data.phaseA.revActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_A, highWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_A + 1, lowWord);
-    
-    float2registers(data.phaseB.revActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_B, highWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_B + 1, lowWord);
-    
-    float2registers(data.phaseC.revActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_C, highWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_C + 1, lowWord);
-    
-    float2registers(data.totalRevActiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_T, highWord);
-    _inputRegisters[MB_REV_ACTIVE_ENERGY_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_ACTIVE_ENERGY_T + 1, lowWord);
-    
-    float2registers(data.phaseA.fwdReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_A, highWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_A + 1, lowWord);
-    
-    float2registers(data.phaseB.fwdReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_B, highWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_B + 1, lowWord);
-    
-    float2registers(data.phaseC.fwdReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_C, highWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_C + 1, lowWord);
-    
-    float2registers(data.totalFwdReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_T, highWord);
-    _inputRegisters[MB_FWD_REACTIVE_ENERGY_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FWD_REACTIVE_ENERGY_T + 1, lowWord);
-    
-    float2registers(data.phaseA.revReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_A, highWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_A + 1, lowWord);
-    
-    float2registers(data.phaseB.revReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_B, highWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_B + 1, lowWord);
-    
-    float2registers(data.phaseC.revReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_C, highWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_C + 1, lowWord);
-    
-    float2registers(data.totalRevReactiveEnergy, highWord, lowWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_T, highWord);
-    _inputRegisters[MB_REV_REACTIVE_ENERGY_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_REV_REACTIVE_ENERGY_T + 1, lowWord);
-    
-    float2registers(data.phaseA.apparentEnergy, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_ENERGY_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_A, highWord);
-    _inputRegisters[MB_APPARENT_ENERGY_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_A + 1, lowWord);
-    
-    float2registers(data.phaseB.apparentEnergy, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_ENERGY_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_B, highWord);
-    _inputRegisters[MB_APPARENT_ENERGY_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_B + 1, lowWord);
-    
-    float2registers(data.phaseC.apparentEnergy, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_ENERGY_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_C, highWord);
-    _inputRegisters[MB_APPARENT_ENERGY_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_C + 1, lowWord);
-    
-    float2registers(data.totalApparentEnergy, highWord, lowWord);
-    _inputRegisters[MB_APPARENT_ENERGY_T] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_T, highWord);
-    _inputRegisters[MB_APPARENT_ENERGY_T + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_APPARENT_ENERGY_T + 1, lowWord);
-    
-    float2registers(data.phaseA.fundamentalPower, highWord, lowWord);
-    _inputRegisters[MB_FUNDAMENTAL_POWER_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FUNDAMENTAL_POWER_A, highWord);
-    _inputRegisters[MB_FUNDAMENTAL_POWER_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FUNDAMENTAL_POWER_A + 1, lowWord);
-    
-    float2registers(data.phaseB.fundamentalPower, highWord, lowWord);
-    _inputRegisters[MB_FUNDAMENTAL_POWER_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FUNDAMENTAL_POWER_B, highWord);
-    _inputRegisters[MB_FUNDAMENTAL_POWER_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FUNDAMENTAL_POWER_B + 1, lowWord);
-    
-    float2registers(data.phaseC.fundamentalPower, highWord, lowWord);
-    _inputRegisters[MB_FUNDAMENTAL_POWER_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FUNDAMENTAL_POWER_C, highWord);
-    _inputRegisters[MB_FUNDAMENTAL_POWER_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_FUNDAMENTAL_POWER_C + 1, lowWord);
-    
-    float2registers(data.phaseA.harmonicPower, highWord, lowWord);
-    _inputRegisters[MB_HARMONIC_POWER_A] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_HARMONIC_POWER_A, highWord);
-    _inputRegisters[MB_HARMONIC_POWER_A + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_HARMONIC_POWER_A + 1, lowWord);
-    
-    float2registers(data.phaseB.harmonicPower, highWord, lowWord);
-    _inputRegisters[MB_HARMONIC_POWER_B] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_HARMONIC_POWER_B, highWord);
-    _inputRegisters[MB_HARMONIC_POWER_B + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_HARMONIC_POWER_B + 1, lowWord);
-    
-    float2registers(data.phaseC.harmonicPower, highWord, lowWord);
-    _inputRegisters[MB_HARMONIC_POWER_C] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_HARMONIC_POWER_C, highWord);
-    _inputRegisters[MB_HARMONIC_POWER_C + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_HARMONIC_POWER_C + 1, lowWord);
-    
-    float2registers(data.boardTemperature, highWord, lowWord);
-    _inputRegisters[MB_BOARD_TEMP] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_BOARD_TEMP, highWord);
-    _inputRegisters[MB_BOARD_TEMP + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_BOARD_TEMP + 1, lowWord);
-    
-    float2registers(data.ambientTemperature, highWord, lowWord);
-    _inputRegisters[MB_AMBIENT_TEMP] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_AMBIENT_TEMP, highWord);
-    _inputRegisters[MB_AMBIENT_TEMP + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_AMBIENT_TEMP + 1, lowWord);
-    
-    float2registers(data.ambientHumidity, highWord, lowWord);
-    _inputRegisters[MB_AMBIENT_HUMIDITY] = highWord;
-    if (mbReady) _modbusRTU.Ireg(MB_AMBIENT_HUMIDITY, highWord);
-    _inputRegisters[MB_AMBIENT_HUMIDITY + 1] = lowWord;
-    if (mbReady) _modbusRTU.Ireg(MB_AMBIENT_HUMIDITY + 1, lowWord);
+    for (size_t i = 0; i < sizeof(kFloatRegisters) / sizeof(kFloatRegisters[0]); i++) {
+        const FloatRegister& r = kFloatRegisters[i];
+        if (!changed.test(r.field)) continue;
+        float2registers(meterFieldValue(data, r.field), highWord, lowWord);
+        setInputRegister(r.address, highWord);
+        setInputRegister(r.address + 1, lowWord);
+    }
+}
+
+void ModbusServer::setInputRegister(uint16_t address, uint16_t value) {
+    _inputRegisters[address] = value;
+    if (_rtuEnabled) _modbusRTU.Ireg(address, value);
+}
+
+void ModbusServer::updateRawFrame(const RawMeterFrame& frame) {
+    // Register values are copied as-is: no float work on this path.
+    for (uint8_t i = 0; i < 3; i++) {
+        setInputRegister(MB_RAW_URMS_A + i, frame.urms[i]);
+        setInputRegister(MB_RAW_THDN_U_A + i, frame.thdnU[i]);
+        setInputRegister(MB_RAW_THDN_I_A + i, frame.thdnI[i]);
+    }
+
+    for (uint8_t i = 0; i < 4; i++) {
+        setInputRegister(MB_RAW_IRMS_A + i, frame.irms[i]);
+        setInputRegister(MB_RAW_PF_A + i, (uint16_t)frame.pf[i]);
+
+        setInputRegister(MB_RAW_PMEAN_A + 2 * i,     (uint16_t)((uint32_t)frame.pmean[i] >> 16));
+        setInputRegister(MB_RAW_PMEAN_A + 2 * i + 1, (uint16_t)((uint32_t)frame.pmean[i] & 0xFFFF));
+        setInputRegister(MB_RAW_QMEAN_A + 2 * i,     (uint16_t)((uint32_t)frame.qmean[i] >> 16));
+        setInputRegister(MB_RAW_QMEAN_A + 2 * i + 1, (uint16_t)((uint32_t)frame.qmean[i] & 0xFFFF));
+        setInputRegister(MB_RAW_SMEAN_A + 2 * i,     (uint16_t)((uint32_t)frame.smean[i] >> 16));
+        setInputRegister(MB_RAW_SMEAN_A + 2 * i + 1, (uint16_t)((uint32_t)frame.smean[i] & 0xFFFF));
+    }
+
+    setInputRegister(MB_RAW_FREQUENCY, frame.freq);
+    setInputRegister(MB_RAW_TEMPERATURE, (uint16_t)frame.temp);
+}
+
+// Clamp a scaled value into an unsigned register
+static uint16_t toRegister(float value, float scale) {
+    const float v = value * scale + 0.5f;
+    if (v <= 0.0f) return 0;
+    if (v >= 65535.0f) return 0xFFFF;
+    return (uint16_t)v;
+}
+
+static void spectrumToRegisters(const HarmonicSpectrum& spec, float fundamentalScale, uint16_t* regs) {
+    const float fundamental = spec.magnitude[0];
+    regs[0] = toRegister(fundamental, fundamentalScale);
+    for (uint8_t h = 2; h <= HARMONIC_MAX_ORDER; h++) {
+        regs[h - 1] = fundamental > 0.0f ? toRegister(spec.magnitude[h - 1] / fundamental, 10000.0f) : 0;
+    }
+}
+
+void ModbusServer::updateHarmonics(const HarmonicData& data) {
+    uint16_t regs[HARMONIC_MAX_ORDER];
+    for (uint8_t i = 0; i < 3; i++) {
+        setInputRegister(MB_HARM_THD_U_A + i, toRegister(data.voltage[i].thd, 100.0f));
+        setInputRegister(MB_HARM_THD_I_A + i, toRegister(data.current[i].thd, 100.0f));
+        setInputRegister(MB_HARM_TDD_A + i, toRegister(data.tdd[i], 100.0f));
+        setInputRegister(MB_HARM_KFACTOR_A + i, toRegister(data.kFactor[i], 100.0f));
+
+        spectrumToRegisters(data.voltage[i], 100.0f, regs);
+        for (uint8_t h = 0; h < HARMONIC_MAX_ORDER; h++) {
+            setInputRegister(MB_HARM_SPECTRUM_UA + i * HARMONIC_MAX_ORDER + h, regs[h]);
+        }
+        spectrumToRegisters(data.current[i], 1000.0f, regs);
+        for (uint8_t h = 0; h < HARMONIC_MAX_ORDER; h++) {
+            setInputRegister(MB_HARM_SPECTRUM_IA + i * HARMONIC_MAX_ORDER + h, regs[h]);
+        }
+    }
+    setInputRegister(MB_HARM_SEQUENCE, (uint16_t)data.captureSequence);
+}
+
+static uint16_t saturateUs(uint32_t us) {
+    return (us > 0xFFFF) ? 0xFFFF : (uint16_t)us;
+}
+
+void ModbusServer::updatePerfHistogram(uint8_t metric, const PerfHistogramSnapshot& snap) {
+    if (metric >= (MB_PERF_LAST - MB_PERF_BASE + 1) / MB_PERF_BLOCK_SIZE) return;
+    const uint16_t base = MB_PERF_BASE + metric * MB_PERF_BLOCK_SIZE;
+    setInputRegister(base + MB_PERF_COUNT,     (uint16_t)(snap.count >> 16));
+    setInputRegister(base + MB_PERF_COUNT + 1, (uint16_t)(snap.count & 0xFFFF));
+    setInputRegister(base + MB_PERF_MEAN, saturateUs(snap.meanUs()));
+    setInputRegister(base + MB_PERF_P50,  saturateUs(snap.percentileUs(50)));
+    setInputRegister(base + MB_PERF_P99,  saturateUs(snap.percentileUs(99)));
+    setInputRegister(base + MB_PERF_MAX,  saturateUs(snap.maxUs));
 }
 
 void ModbusServer::updateSystemStatus(const SystemStatus& status) {
@@ -15,6 +15,9 @@
 #include <HardwareSerial.h>
 #include <ModbusRTU.h>
 #include "DataTypes.h"
+#include "RawMeterFrame.h"
+#include "MeterFields.h"
+#include "PerfHistogram.h"
 #include "ModbusMap.h"
 #include "Logger.h"
 
@@ -25,6 +28,11 @@ public:
     bool begin(const ModbusConfig& config);
     void handle();
     void updateMeterData(const MeterData& data);
+    // Only rewrites the registers of fields set in `changed`
+    void updateMeterData(const MeterData& data, const MeterFieldMask& changed);
+    void updateRawFrame(const RawMeterFrame& frame);
+    void updateHarmonics(const HarmonicData& data);
+    void updatePerfHistogram(uint8_t metric, const PerfHistogramSnapshot& snap);
     void updateSystemStatus(const SystemStatus& status);
     
     void setCoil(uint16_t address, bool state);
@@ -41,6 +49,7 @@ private:
     void handleRTU();
     
     void float2registers(float value, uint16_t& highWord, uint16_t& lowWord);
+    void setInputRegister(uint16_t address, uint16_t value);
     float registers2float(uint16_t highWord, uint16_t lowWord);
     
     uint16_t readInputRegister(uint16_t address);
@@ -117,6 +117,18 @@ uint32_t NTPSync::getTimestamp() const {
     return (uint32_t)now;
 }
 
+uint64_t NTPSync::utcMsAt(int64_t monoUs) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    const int64_t nowMonoUs = esp_timer_get_time();
+    if (tv.tv_sec < MIN_VALID_EPOCH) {
+        return 0;
+    }
+    // Both clocks are read back to back; the offset maps the monotonic stamp onto UTC
+    const int64_t nowUtcUs = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+    return (uint64_t)((nowUtcUs - (nowMonoUs - monoUs)) / 1000);
+}
+
 void NTPSync::setTimezoneOffset(int16_t minutes) {
     _timezoneOffsetMinutes = minutes;
     
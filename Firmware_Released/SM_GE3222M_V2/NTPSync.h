@@ -9,6 +9,7 @@
 
 #include <Arduino.h>
 #include <time.h>
+#include <esp_timer.h>
 
 class NTPSync {
 public:
@@ -20,6 +21,13 @@ public:
     bool isTimeSynced() const;
     String getTimeString(const char* format = "%Y-%m-%d %H:%M:%S") const;
     uint32_t getTimestamp() const;
+
+    /**
+     * UTC epoch milliseconds of an esp_timer_get_time() stamp, using the SNTP-disciplined
+     * system clock. Returns 0 while the clock has not been set.
+     */
+    static uint64_t utcMsAt(int64_t monoUs);
+    static constexpr time_t MIN_VALID_EPOCH = 1609459200;   // 2021-01-01, anything earlier is unset
     
     void setTimezoneOffset(int16_t minutes);
     int16_t getTimezoneOffset() const { return _timezoneOffsetMinutes; }
@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Perf Histogram
+ *
+ * Fixed-bucket, log2-scale latency histogram for one writer task and any number
+ * of readers. record() is a handful of stores and never blocks; readers copy the
+ * counters under a sequence counter and only retry if a record() overlapped the copy.
+ *
+ * Bucket 0 holds 0 us, bucket b (b >= 1) holds [2^(b-1), 2^b) us; the last bucket
+ * also collects everything above its lower edge (~262 ms).
+ */
+
+#include <Arduino.h>
+#include <atomic>
+
+constexpr uint8_t PERF_BUCKET_COUNT = 20;
+
+struct PerfHistogramSnapshot {
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint32_t buckets[PERF_BUCKET_COUNT];
+
+    uint32_t meanUs() const { return count ? (uint32_t)(sumUs / count) : 0; }
+
+    /**
+     * Upper edge of the bucket holding the given percentile, capped at maxUs
+     * @param pct 1..100
+     */
+    uint32_t percentileUs(uint8_t pct) const {
+        if (count == 0) return 0;
+        const uint32_t rank = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+        uint32_t seen = 0;
+        for (uint8_t b = 0; b < PERF_BUCKET_COUNT; b++) {
+            seen += buckets[b];
+            if (seen >= rank) {
+                const uint32_t edge = (b == 0) ? 0 : ((1UL << b) - 1);
+                return (b == PERF_BUCKET_COUNT - 1 || edge > maxUs) ? maxUs : edge;
+            }
+        }
+        return maxUs;
+    }
+
+    // Inclusive lower edge of bucket b in microseconds
+    static uint32_t bucketFloorUs(uint8_t b) { return (b == 0) ? 0 : (1UL << (b - 1)); }
+};
+
+class PerfHistogram {
+public:
+    PerfHistogram() : m_seq(0), m_count(0), m_maxUs(0), m_sumUs(0) {
+        for (uint8_t b = 0; b < PERF_BUCKET_COUNT; b++) m_buckets[b] = 0;
+    }
+
+    /**
+     * Writer: add one sample. Only ever called from the owning task.
+     */
+    void record(uint32_t us) {
+        const uint8_t b = bucketOf(us);
+        m_seq.fetch_add(1, std::memory_order_relaxed);     // Odd: update in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        m_buckets[b] = m_buckets[b] + 1;
+        m_count = m_count + 1;
+        m_sumUs += us;
+        if (us > m_maxUs) m_maxUs = us;
+        m_seq.fetch_add(1, std::memory_order_release);      // Even again
+    }
+
+    /**
+     * Reader: consistent copy of all counters. Never blocks.
+     */
+    void read(PerfHistogramSnapshot& out) const {
+        for (;;) {
+            const uint32_t seq = m_seq.load(std::memory_order_acquire);
+            if ((seq & 1) == 0) {
+                out.count = m_count;
+                out.maxUs = m_maxUs;
+                out.sumUs = m_sumUs;
+                for (uint8_t b = 0; b < PERF_BUCKET_COUNT; b++) out.buckets[b] = m_buckets[b];
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_seq.load(std::memory_order_relaxed) == seq) return;
+            }
+        }
+    }
+
+    static uint8_t bucketOf(uint32_t us) {
+        const uint8_t b = (us == 0) ? 0 : (uint8_t)(32 - __builtin_clz(us));
+        return (b < PERF_BUCKET_COUNT) ? b : (PERF_BUCKET_COUNT - 1);
+    }
+
+private:
+    std::atomic<uint32_t> m_seq;
+    volatile uint32_t m_count;
+    volatile uint32_t m_maxUs;
+    uint64_t m_sumUs;
+    volatile uint32_t m_buckets[PERF_BUCKET_COUNT];
+};
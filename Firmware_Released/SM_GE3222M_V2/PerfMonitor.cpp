@@ -0,0 +1,44 @@
+/**
+ * SM-GE3222M V2.0 - Perf Monitor Implementation
+ */
+
+#include "PerfMonitor.h"
+
+namespace {
+
+struct PerfMetricInfo {
+    const char* name;
+    const char* task;
+};
+
+const PerfMetricInfo kMetrics[PERF_METRIC_COUNT] = {
+    { "sweep",   "EnergyTask" },
+    { "filter",  "EnergyTask" },
+    { "publish", "EnergyTask" },
+    { "wake",    "EnergyTask" },
+    { "read",    "FastPowerTask" },
+    { "wake",    "FastPowerTask" },
+};
+
+} // namespace
+
+const char* perfMetricName(uint8_t metric) {
+    return metric < PERF_METRIC_COUNT ? kMetrics[metric].name : "";
+}
+
+const char* perfMetricTask(uint8_t metric) {
+    return metric < PERF_METRIC_COUNT ? kMetrics[metric].task : "";
+}
+
+PerfMonitor& PerfMonitor::getInstance() {
+    static PerfMonitor instance;
+    return instance;
+}
+
+void PerfMonitor::read(uint8_t metric, PerfHistogramSnapshot& out) const {
+    if (metric >= PERF_METRIC_COUNT) {
+        memset(&out, 0, sizeof(out));
+        return;
+    }
+    m_histograms[metric].read(out);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Perf Monitor
+ *
+ * Always-on timing instrumentation for the acquisition tasks. Each metric is a
+ * PerfHistogram written by exactly one task, so recording costs two esp_timer
+ * reads and a few stores; status readers (/api/perf, getPerf, Modbus) copy them
+ * lock-free.
+ *
+ * Features:
+ * - EnergyTask: SPI sweep, filter, snapshot publish and wake-up lateness
+ * - FastPowerTask: power register read and wake-up lateness
+ * - PerfWakeProbe measures how late a vTaskDelayUntil() loop wakes
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <esp_timer.h>
+#include "PerfHistogram.h"
+
+enum PerfMetric : uint8_t {
+    PERF_ENERGY_SWEEP = 0,      // readScheduledRaw(): SPI register sweep
+    PERF_ENERGY_FILTER,         // MeterFilterBank::apply()
+    PERF_ENERGY_PUBLISH,        // Snapshot fill, change tracking and commit
+    PERF_ENERGY_WAKE,           // EnergyTask wake-up lateness
+    PERF_FAST_POWER_READ,       // readActivePowerRaw()
+    PERF_FAST_POWER_WAKE,       // FastPowerTask wake-up lateness
+    PERF_METRIC_COUNT
+};
+
+// Short metric key ("sweep", "wake", ...) and the task that records it
+const char* perfMetricName(uint8_t metric);
+const char* perfMetricTask(uint8_t metric);
+
+class PerfMonitor {
+public:
+    static PerfMonitor& getInstance();
+
+    /**
+     * Add one sample (owning task only)
+     */
+    void record(PerfMetric metric, uint32_t us) { m_histograms[metric].record(us); }
+
+    /**
+     * Copy one histogram, any task
+     */
+    void read(uint8_t metric, PerfHistogramSnapshot& out) const;
+
+private:
+    PerfMonitor() = default;
+    ~PerfMonitor() = default;
+    PerfMonitor(const PerfMonitor&) = delete;
+    PerfMonitor& operator=(const PerfMonitor&) = delete;
+
+    PerfHistogram m_histograms[PERF_METRIC_COUNT];
+};
+
+/**
+ * Wake-up lateness of a periodic task. Tracks the ideal wake time alongside the
+ * vTaskDelayUntil() schedule, so lateness does not accumulate across periods.
+ */
+class PerfWakeProbe {
+public:
+    PerfWakeProbe() : m_expectedUs(0) {}
+
+    // Call before entering the loop (same point lastWakeTime is taken)
+    void start() { m_expectedUs = esp_timer_get_time(); }
+
+    /**
+     * Call right after vTaskDelayUntil() returns
+     * @param interval Ticks that were passed to vTaskDelayUntil()
+     * @return Microseconds between the scheduled and the actual wake-up
+     */
+    uint32_t lateUs(TickType_t interval) {
+        const int64_t nowUs = esp_timer_get_time();
+        m_expectedUs += (int64_t)interval * portTICK_PERIOD_MS * 1000;
+        const int64_t late = nowUs - m_expectedUs;
+        if (late < 0) {
+            // start() ran part-way into a tick; re-anchor on the tick edge
+            m_expectedUs = nowUs;
+            return 0;
+        }
+        return (late > UINT32_MAX) ? UINT32_MAX : (uint32_t)late;
+    }
+
+private:
+    int64_t m_expectedUs;
+};
@@ -16,6 +16,17 @@ constexpr uint32_t SPI_FREQUENCY_ATM90E36 = 200000;  // 200 kHz
 constexpr uint8_t  SPI_MODE_ATM90E36      = 3;       // SPI Mode 3
 constexpr uint8_t  SPI_BIT_ORDER          = MSBFIRST;
 
+// ATM90E36 SPI link training: candidate clocks tried in order above the 200 kHz baseline.
+// The fastest step that passes readback verification is kept.
+constexpr uint32_t SPI_TRAINING_STEPS_ATM90E36[] = { 1000000, 2000000, 4000000 };
+constexpr uint32_t SPI_RETRAIN_INTERVAL_MS       = 3600000;  // Periodic re-verification (1 h)
+constexpr uint32_t SPI_RETRAIN_AFTER_FAULT_MS    = 60000;    // Retry delay after falling back
+
+// ATM90E36 DMA interface. DMA_CTRL high hands the bus to the ATM90E36, which then clocks
+// raw ADC samples out as SPI master (SCLK/CS driven by the IC, data on SDO -> MISO).
+// GPIO12 is a strapping pin (flash voltage) and must stay LOW at boot; the board pulls it down.
+constexpr uint8_t PIN_ATM_DMA_CTRL      = 12;   // GPIO12 - ATM90E36 DMA_CTRL
+
 // ============================================================================
 // I2C Interface - MCP23017 I/O Expander & Sensors
 // ============================================================================
@@ -7,6 +7,17 @@
 #include "CalibrationManager.h"
 #include "DataLogger.h"
 #include "DHTSensorManager.h"
+#include "HarmonicAnalyzer.h"
+#include "HarmonicSweep.h"
+#include "MeterFilterBank.h"
+#include "MeterFields.h"
+#include "FastPowerSampler.h"
+#include "LoadShedController.h"
+#include "PerfMonitor.h"
+#include "TaskMonitor.h"
+#include "EnergyAccumulator.h"
+#include "TaskManager.h"
+#include "EventBus.h"
 
 ProtocolV2::ProtocolV2() {
 }
@@ -90,6 +101,20 @@ String ProtocolV2::handleCommand(const String& command, const JsonDocument& para
     
     if (command == "getMeterData") {
         return handleGetMeterData(params);
+    } else if (command == "getHarmonics") {
+        return handleGetHarmonics(params);
+    } else if (command == "getHarmonicRatios") {
+        return handleGetHarmonicRatios(params);
+    } else if (command == "getFastPower") {
+        return handleGetFastPower(params);
+    } else if (command == "getPerf") {
+        return handleGetPerf(params);
+    } else if (command == "getEnergy") {
+        return handleGetEnergy(params);
+    } else if (command == "getEvents") {
+        return handleGetEvents(params);
+    } else if (command == "getTasks") {
+        return handleGetTasks(params);
     } else if (command == "getSystemStatus") {
         return handleGetSystemStatus(params);
     } else if (command == "getConfig") {
@@ -122,6 +147,267 @@ String ProtocolV2::handleGetMeterData(const JsonDocument& params) {
     return buildResponse(ResponseStatus::OK, doc);
 }
 
+String ProtocolV2::handleGetHarmonics(const JsonDocument& params) {
+    // Latest analysis only; captures run on the harmonic task's schedule
+    HarmonicData data;
+    if (!HarmonicAnalyzer::getInstance().getLatest(data)) {
+        return buildResponse(ResponseStatus::ERROR, "No harmonic analysis available");
+    }
+    DynamicJsonDocument doc(HARMONIC_JSON_DOC_SIZE);
+    harmonicsToJson(data, doc);
+    return buildResponse(ResponseStatus::OK, doc);
+}
+
+String ProtocolV2::handleGetHarmonicRatios(const JsonDocument& params) {
+    // Cached hardware DFT results; the PowerQualityTask refreshes them
+    HarmonicRatios data;
+    if (!HarmonicSweep::getInstance().getLatest(data)) {
+        return buildResponse(ResponseStatus::ERROR, "No DFT results available");
+    }
+    DynamicJsonDocument doc(HARMONIC_RATIO_JSON_DOC_SIZE);
+    harmonicRatiosToJson(data, doc);
+    return buildResponse(ResponseStatus::OK, doc);
+}
+
+String ProtocolV2::handleGetFastPower(const JsonDocument& params) {
+    DynamicJsonDocument doc(JSON_DOC_SIZE);
+    fastPowerToJson(doc);
+    return buildResponse(ResponseStatus::OK, doc);
+}
+
+void ProtocolV2::fastPowerToJson(JsonDocument& doc) {
+    FastPowerSampler& sampler = FastPowerSampler::getInstance();
+    LoadShedController& shed = LoadShedController::getInstance();
+
+    doc["enabled"] = sampler.isEnabled();
+    doc["running"] = TaskManager::getInstance().getFastPowerTaskHandle() != nullptr;
+    doc["intervalMs"] = sampler.getIntervalMs();
+
+    PowerSample sample;
+    if (sampler.getLatest(sample)) {
+        JsonObject last = doc.createNestedObject("latest");
+        last["sequence"] = sample.sequence;
+        last["ageMs"] = (micros() - sample.timestampUs) / 1000UL;
+        last["powerA"] = sample.watts(RAW_A);
+        last["powerB"] = sample.watts(RAW_B);
+        last["powerC"] = sample.watts(RAW_C);
+        last["powerTotal"] = sample.watts(RAW_T);
+    }
+
+    const FastPowerStats st = sampler.getStats();
+    JsonObject stats = doc.createNestedObject("stats");
+    stats["samples"] = st.samples;
+    stats["failures"] = st.failures;
+    stats["overruns"] = st.overruns;
+    stats["lastReadUs"] = st.lastReadUs;
+    stats["maxReadUs"] = st.maxReadUs;
+
+    JsonObject ls = doc.createNestedObject("loadShed");
+    ls["armed"] = shed.isArmed();
+    ls["shedding"] = shed.isShedding();
+    ls["shedCount"] = shed.getShedCount();
+    ls["maxLatencyUs"] = shed.getMaxLatencyUs();
+}
+
+String ProtocolV2::handleGetEnergy(const JsonDocument& params) {
+    DynamicJsonDocument doc(JSON_DOC_SIZE);
+    energyToJson(doc);
+    return buildResponse(ResponseStatus::OK, doc);
+}
+
+void ProtocolV2::energyToJson(JsonDocument& doc) {
+    static const char* const kPhaseKeys[4] = { "A", "B", "C", "T" };
+    EnergyAccumulator& acc = EnergyAccumulator::getInstance();
+    const EnergyData e = acc.getAccumulatedEnergy();
+
+    doc["source"] = EnergyAccumulator::sourceName(acc.getSource());
+    doc["lastUpdate"] = e.lastUpdateTime;
+
+    // kWh / kVARh / kVAh of the reported register
+    JsonObject phases = doc.createNestedObject("phases");
+    const EnergyData::PhaseEnergy* reg[4] = { &e.phaseA, &e.phaseB, &e.phaseC, &e.total };
+    for (uint8_t ph = 0; ph < 4; ph++) {
+        JsonObject p = phases.createNestedObject(kPhaseKeys[ph]);
+        p["activeImport"] = reg[ph]->activeEnergyImport;
+        p["activeExport"] = reg[ph]->activeEnergyExport;
+        p["reactiveImport"] = reg[ph]->reactiveEnergyImport;
+        p["reactiveExport"] = reg[ph]->reactiveEnergyExport;
+        p["apparent"] = reg[ph]->apparentEnergy;
+    }
+
+    // Lifetime IC pulses (ENERGY_COUNTS_PER_KWH per kWh), [AP, AN, RP, RN, SA]
+    JsonObject counts = doc.createNestedObject("counts");
+    counts["perKWh"] = (uint32_t)ENERGY_COUNTS_PER_KWH;
+    for (uint8_t ph = 0; ph < 4; ph++) {
+        JsonArray c = counts.createNestedArray(kPhaseKeys[ph]);
+        for (uint8_t t = 0; t < RAW_EN_COUNT; t++) {
+            c.add(acc.getCount((RawEnergy)t, ph));
+        }
+    }
+
+    const EnergyCrossCheck check = acc.getCrossCheck();
+    JsonObject cc = doc.createNestedObject("crossCheck");
+    cc["counterKWh"] = check.counterKWh;
+    cc["integratedKWh"] = check.integratedKWh;
+    cc["valid"] = check.valid;
+    if (check.valid) {
+        cc["divergencePct"] = check.divergencePct;
+    }
+    cc["counterResets"] = check.counterResets;
+    cc["staleFrames"] = check.staleFrames;
+
+    const EnergyJournalStats js = acc.getJournalStats();
+    JsonObject journal = doc.createNestedObject("journal");
+    journal["ready"] = js.ready;
+    journal["sequence"] = js.sequence;
+    journal["slots"] = js.slots;
+    journal["appends"] = js.appends;
+    journal["erases"] = js.erases;
+    journal["skipped"] = js.skipped;
+    journal["errors"] = js.errors;
+}
+
+String ProtocolV2::handleGetEvents(const JsonDocument& params) {
+    DynamicJsonDocument doc(EVENTS_JSON_DOC_SIZE);
+    eventsToJson(doc);
+    return buildResponse(ResponseStatus::OK, doc);
+}
+
+void ProtocolV2::eventsToJson(JsonDocument& doc) {
+    EventBus& bus = EventBus::getInstance();
+    
+    const EventPoolStats pool = bus.getPoolStats();
+    JsonObject p = doc.createNestedObject("pool");
+    p["blocks"] = pool.blocks;
+    p["blockSize"] = pool.blockSize;
+    p["inUse"] = pool.inUse;
+    p["maxInUse"] = pool.maxInUse;
+
+    JsonObject types = doc.createNestedObject("types");
+    for (uint8_t t = 0; t < EventBus::MAX_EVENT_TYPES; t++) {
+        const EventType type = static_cast<EventType>(t);
+        const EventTypeStats st = bus.getStats(type);
+        JsonObject o = types.createNestedObject(EventBus::eventTypeName(type));
+        o["priority"] = (bus.getPriority(type) == EventPriority::URGENT) ? "urgent" : "normal";
+        o["policy"] = (bus.getPolicy(type) == EventPolicy::LATEST_VALUE) ? "latest" : "dropOldest";
+        o["generation"] = bus.getGeneration(type);
+        o["published"] = st.published;
+        o["dispatched"] = st.dispatched;
+        o["dropped"] = st.dropped;
+        o["coalesced"] = st.coalesced;
+        o["rejected"] = st.rejected;
+    }
+
+    // Callback address identifies the subscriber (addr2line against the ELF)
+    static EventSubscriberStats subs[EventBus::MAX_EVENT_TYPES * 2];
+    const uint8_t n = bus.getSubscriberStats(subs, sizeof(subs) / sizeof(subs[0]));
+    doc["slowCallbackUs"] = EventBus::SLOW_CALLBACK_US;
+    JsonArray list = doc.createNestedArray("subscribers");
+    for (uint8_t i = 0; i < n; i++) {
+        char addr[12];
+        snprintf(addr, sizeof(addr), "0x%08lx", (unsigned long)(uintptr_t)subs[i].callback);
+        JsonObject o = list.createNestedObject();
+        o["event"] = EventBus::eventTypeName(subs[i].type);
+        o["callback"] = addr;
+        o["calls"] = subs[i].calls;
+        o["slowCalls"] = subs[i].slowCalls;
+        o["lastUs"] = subs[i].lastUs;
+        o["maxUs"] = subs[i].maxUs;
+        o["meanUs"] = subs[i].calls ? (uint32_t)(subs[i].totalUs / subs[i].calls) : 0;
+    }
+}
+
+String ProtocolV2::handleGetTasks(const JsonDocument& params) {
+    DynamicJsonDocument doc(TASKS_JSON_DOC_SIZE);
+    tasksToJson(doc);
+    return buildResponse(ResponseStatus::OK, doc);
+}
+
+void ProtocolV2::tasksToJson(JsonDocument& doc) {
+    TaskMonitor& monitor = TaskMonitor::getInstance();
+
+    // CPU figures cover the DiagnosticsTask's last sample window; null until two samples exist
+    const CpuLoadStats load = monitor.getCpuLoad();
+    doc["uptimeMs"] = millis();
+    doc["source"] = load.runTimeStats ? "runTimeStats" : "scheduler";
+    doc["windowMs"] = load.windowMs;
+    doc["samples"] = load.samples;
+    JsonArray cores = doc.createNestedArray("coreLoad");
+    for (uint8_t c = 0; c < load.cores; c++) {
+        if (load.corePct[c] < 0.0f) cores.add(nullptr);
+        else cores.add(load.corePct[c]);
+    }
+
+    // Local copy: the web server and the TCP JSON clients can ask at the same time
+    TaskRuntimeStats tasks[TaskMonitor::MAX_TASKS];
+    const uint8_t n = monitor.getTasks(tasks, TaskMonitor::MAX_TASKS);
+    JsonArray list = doc.createNestedArray("tasks");
+    for (uint8_t i = 0; i < n; i++) {
+        const TaskRuntimeStats& t = tasks[i];
+        JsonObject o = list.createNestedObject();
+        o["name"] = t.name;
+        if (t.core < 0) o["core"] = nullptr;
+        else o["core"] = t.core;
+        o["priority"] = t.priority;
+        o["stackSize"] = t.stackSize;
+        o["stackFreeMin"] = t.stackFreeMin;
+        if (t.cpuPct < 0.0f) o["cpu"] = nullptr;
+        else o["cpu"] = t.cpuPct;
+
+        if (!t.scheduled) continue;
+        JsonObject s = o.createNestedObject("schedule");
+        s["periodMs"] = t.schedule.periodMs;
+        s["phaseMs"] = t.schedule.phaseMs;
+        s["deadlineMs"] = t.schedule.deadlineMs;
+        s["releases"] = t.schedule.releases;
+        s["skipped"] = t.schedule.skipped;
+        s["deadlineMisses"] = t.schedule.deadlineMisses;
+        s["maxLateUs"] = t.schedule.maxLateUs;
+        s["lastResponseUs"] = t.schedule.lastResponseUs;
+        s["maxResponseUs"] = t.schedule.maxResponseUs;
+        s["lastExecUs"] = t.schedule.lastExecUs;
+        s["wcetUs"] = t.schedule.maxExecUs;
+        s["meanExecUs"] = t.schedule.releases ? (uint32_t)(t.schedule.totalExecUs / t.schedule.releases) : 0;
+    }
+}
+
+String ProtocolV2::handleGetPerf(const JsonDocument& params) {
+    DynamicJsonDocument doc(PERF_JSON_DOC_SIZE);
+    perfToJson(doc);
+    return buildResponse(ResponseStatus::OK, doc);
+}
+
+void ProtocolV2::perfToJson(JsonDocument& doc) {
+    doc["uptimeMs"] = millis();
+    JsonArray floors = doc.createNestedArray("bucketFloorUs");
+    for (uint8_t b = 0; b < PERF_BUCKET_COUNT; b++) {
+        floors.add(PerfHistogramSnapshot::bucketFloorUs(b));
+    }
+
+    // Grouped by the task that records each histogram
+    JsonObject tasks = doc.createNestedObject("tasks");
+    for (uint8_t m = 0; m < PERF_METRIC_COUNT; m++) {
+        PerfHistogramSnapshot snap;
+        PerfMonitor::getInstance().read(m, snap);
+
+        const char* taskName = perfMetricTask(m);
+        JsonObject task = tasks.containsKey(taskName) ? tasks[taskName].as<JsonObject>()
+                                                      : tasks.createNestedObject(taskName);
+
+        JsonObject h = task.createNestedObject(perfMetricName(m));
+        h["count"] = snap.count;
+        h["meanUs"] = snap.meanUs();
+        h["p50Us"] = snap.percentileUs(50);
+        h["p90Us"] = snap.percentileUs(90);
+        h["p99Us"] = snap.percentileUs(99);
+        h["maxUs"] = snap.maxUs;
+        JsonArray buckets = h.createNestedArray("buckets");
+        for (uint8_t b = 0; b < PERF_BUCKET_COUNT; b++) {
+            buckets.add(snap.buckets[b]);
+        }
+    }
+}
+
 String ProtocolV2::handleGetSystemStatus(const JsonDocument& params) {
     SystemStatus status = SystemMonitor::getInstance().getSystemStatus();
     DynamicJsonDocument doc(JSON_DOC_SIZE);
@@ -283,9 +569,63 @@ void ProtocolV2::meterDataToJson(const MeterData& data, JsonDocument& doc) {
     doc["ambientTemperature"] = data.ambientTemperature;
     doc["ambientHumidity"] = data.ambientHumidity;
     doc["timestamp"] = data.timestamp;
+    doc["timestampUs"] = data.timestampUs;
+    doc["utcMs"] = data.utcMs;
     doc["sequenceNumber"] = data.sequenceNumber;
 }
 
+void ProtocolV2::harmonicsToJson(const HarmonicData& data, JsonDocument& doc) {
+    static const char* const kPhaseNames[3] = { "phaseA", "phaseB", "phaseC" };
+
+    doc["timestamp"] = data.timestamp;
+    doc["sequence"] = data.captureSequence;
+    doc["frequency"] = data.lineFrequency;
+    doc["maxOrder"] = HARMONIC_MAX_ORDER;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        JsonObject phase = doc.createNestedObject(kPhaseNames[i]);
+        JsonObject voltage = phase.createNestedObject("voltage");
+        spectrumToJson(data.voltage[i], voltage);
+        JsonObject current = phase.createNestedObject("current");
+        spectrumToJson(data.current[i], current);
+        phase["tdd"] = data.tdd[i];
+        phase["kFactor"] = data.kFactor[i];
+    }
+}
+
+void ProtocolV2::spectrumToJson(const HarmonicSpectrum& spec, JsonObject& obj) {
+    obj["rms"] = spec.rms;
+    obj["thd"] = spec.thd;
+    JsonArray mag = obj.createNestedArray("magnitude");
+    JsonArray ang = obj.createNestedArray("phase");
+    for (uint8_t h = 0; h < HARMONIC_MAX_ORDER; h++) {
+        mag.add(spec.magnitude[h]);
+        ang.add(spec.phase[h]);
+    }
+}
+
+void ProtocolV2::harmonicRatiosToJson(const HarmonicRatios& data, JsonDocument& doc) {
+    static const char* const kChannelNames[DFT_CHANNEL_COUNT] = { "currentA", "currentB", "currentC",
+                                                                  "voltageA", "voltageB", "voltageC" };
+    const uint32_t age = millis() - data.timestamp;
+
+    doc["timestamp"] = data.timestamp;
+    doc["sequence"] = data.sequence;
+    doc["ageMs"] = age;
+    doc["stale"] = age > HarmonicSweep::STALE_MS;
+    doc["firstOrder"] = 2;
+
+    for (uint8_t ch = 0; ch < DFT_CHANNEL_COUNT; ch++) {
+        JsonObject obj = doc.createNestedObject(kChannelNames[ch]);
+        obj["fundamental"] = HarmonicSweep::fundamental(data, ch);
+        obj["thd"] = HarmonicSweep::ratioPercent(data.thd[ch]);
+        JsonArray ratio = obj.createNestedArray("ratio");
+        for (uint8_t h = 0; h < DFT_RATIO_COUNT; h++) {
+            ratio.add(HarmonicSweep::ratioPercent(data.ratio[ch][h]));
+        }
+    }
+}
+
 void ProtocolV2::phaseDataToJson(const PhaseData& phase, JsonObject& obj) {
     obj["voltageRMS"] = phase.voltageRMS;
     obj["currentRMS"] = phase.currentRMS;
@@ -345,6 +685,28 @@ void ProtocolV2::configToJson(JsonDocument& doc) {
         sys["dhtEnabled"] = sysCfg.dhtEnabled;
         sys["dhtReadIntervalMs"] = sysCfg.dhtReadIntervalMs;
         sys["dhtDebugLogging"] = sysCfg.dhtDebugLogging;
+
+        JsonObject filters = sys.createNestedObject("filters");
+        for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+            char spec[12];
+            MeterFilterBank::formatSpec(sysCfg.meterFilters[ch], spec, sizeof(spec));
+            filters[MeterFilterBank::channelName(ch)] = spec;
+        }
+
+        JsonObject deadbands = sys.createNestedObject("deadbands");
+        for (uint8_t q = 0; q < MQ_COUNT; q++) {
+            deadbands[meterQuantityName(q)] = sysCfg.meterDeadbands[q];
+        }
+
+        JsonObject fp = sys.createNestedObject("fastPower");
+        fp["enabled"] = sysCfg.fastPowerEnabled;
+        fp["intervalMs"] = sysCfg.fastPowerIntervalMs;
+        fp["shedRelay"] = sysCfg.loadShedRelay;
+        fp["shedLimitW"] = sysCfg.loadShedLimitW;
+        fp["shedRestoreW"] = sysCfg.loadShedRestoreW;
+        fp["shedRestoreMs"] = sysCfg.loadShedRestoreMs;
+
+        sys["energySource"] = EnergyAccumulator::sourceName(sysCfg.energySource);
     }
     // WiFi (SMNetworkManager)
     {
@@ -382,6 +744,7 @@ void ProtocolV2::configToJson(JsonDocument& doc) {
         mqtt["clientID"] = mqttCfg.clientID;
         mqtt["baseTopic"] = mqttCfg.baseTopic;
         mqtt["publishInterval"] = mqttCfg.publishInterval;
+        mqtt["binaryPayload"] = mqttCfg.binaryPayload;
     }
 }
 
@@ -406,12 +769,96 @@ bool ProtocolV2::jsonToConfig(const JsonDocument& doc) {
             if (sys.containsKey("dhtDebugLogging")) sysCfg.dhtDebugLogging = sys["dhtDebugLogging"];
             if (sysCfg.dhtReadIntervalMs < 2000) sysCfg.dhtReadIntervalMs = 2000;
 
+            // "filters": { "<channel>": "none" | "sma:N" | "ema:N" | "median:N", ... }
+            const bool filtersTouched = sys.containsKey("filters");
+            if (filtersTouched) {
+                JsonObjectConst filters = sys["filters"].as<JsonObjectConst>();
+                for (uint8_t ch = 0; ch < MF_CHANNEL_COUNT; ch++) {
+                    const char* name = MeterFilterBank::channelName(ch);
+                    if (!filters.containsKey(name)) continue;
+                    if (!MeterFilterBank::parseSpec(filters[name].as<const char*>(), sysCfg.meterFilters[ch])) {
+                        Logger::getInstance().warn("ProtocolV2: Invalid filter spec for %s", name);
+                        success = false;
+                    }
+                }
+            }
+
+            // "deadbands": { "voltage": 0.1, "current": 0.01, ... } (change-tracking thresholds)
+            const bool deadbandsTouched = sys.containsKey("deadbands");
+            if (deadbandsTouched) {
+                JsonObjectConst deadbands = sys["deadbands"].as<JsonObjectConst>();
+                for (uint8_t q = 0; q < MQ_COUNT; q++) {
+                    const char* name = meterQuantityName(q);
+                    if (!deadbands.containsKey(name)) continue;
+                    const float band = deadbands[name].as<float>();
+                    if (band < 0.0f) {
+                        Logger::getInstance().warn("ProtocolV2: Invalid deadband for %s", name);
+                        success = false;
+                        continue;
+                    }
+                    sysCfg.meterDeadbands[q] = band;
+                }
+            }
+
+            // "fastPower": { "enabled", "intervalMs", "shedRelay", "shedLimitW", "shedRestoreW", "shedRestoreMs" }
+            const bool fastPowerTouched = sys.containsKey("fastPower");
+            if (fastPowerTouched) {
+                JsonObjectConst fp = sys["fastPower"].as<JsonObjectConst>();
+                if (fp.containsKey("enabled")) sysCfg.fastPowerEnabled = fp["enabled"];
+                if (fp.containsKey("intervalMs")) {
+                    const unsigned ms = fp["intervalMs"];
+                    sysCfg.fastPowerIntervalMs = FastPowerSampler::sanitizeInterval(ms > 255 ? 255 : (uint8_t)ms);
+                }
+                if (fp.containsKey("shedRelay")) {
+                    const unsigned relay = fp["shedRelay"];
+                    if (relay <= 2) {
+                        sysCfg.loadShedRelay = (uint8_t)relay;
+                    } else {
+                        Logger::getInstance().warn("ProtocolV2: Invalid shed relay %u", (unsigned)relay);
+                        success = false;
+                    }
+                }
+                if (fp.containsKey("shedLimitW")) sysCfg.loadShedLimitW = fp["shedLimitW"];
+                if (fp.containsKey("shedRestoreW")) sysCfg.loadShedRestoreW = fp["shedRestoreW"];
+                if (fp.containsKey("shedRestoreMs")) sysCfg.loadShedRestoreMs = fp["shedRestoreMs"];
+            }
+
+            // "energySource": "counters" | "integrated"
+            const bool energySourceTouched = sys.containsKey("energySource");
+            if (energySourceTouched) {
+                const char* src = sys["energySource"] | "";
+                if (strcmp(src, EnergyAccumulator::sourceName(EnergySource::COUNTERS)) == 0) {
+                    sysCfg.energySource = EnergySource::COUNTERS;
+                } else if (strcmp(src, EnergyAccumulator::sourceName(EnergySource::INTEGRATED)) == 0) {
+                    sysCfg.energySource = EnergySource::INTEGRATED;
+                } else {
+                    Logger::getInstance().warn("ProtocolV2: Invalid energy source '%s'", src);
+                    success = false;
+                }
+            }
+
             bool sysSaved = cfg.setSystemConfig(sysCfg);
             success &= sysSaved;
             if (sysSaved && dhtFieldsTouched) {
                 // Apply DHT settings immediately (no reboot required for enable/interval/debug changes).
                 DHTSensorManager::getInstance().reloadConfig(true);
             }
+            if (sysSaved && filtersTouched) {
+                EnergyMeter::getInstance().applyFilterConfig(sysCfg);
+            }
+            if (sysSaved && deadbandsTouched) {
+                EnergyMeter::getInstance().applyDeadbandConfig(sysCfg);
+            }
+            if (sysSaved && fastPowerTouched) {
+                FastPowerSampler::getInstance().applyConfig(sysCfg);
+                LoadShedController::getInstance().applyConfig(sysCfg);
+                if (sysCfg.fastPowerEnabled && TaskManager::getInstance().getFastPowerTaskHandle() == nullptr) {
+                    Logger::getInstance().info("ProtocolV2: Fast power mode starts after a restart");
+                }
+            }
+            if (sysSaved && energySourceTouched) {
+                EnergyAccumulator::getInstance().applyConfig(sysCfg);
+            }
         }
     }
     
@@ -447,6 +894,7 @@ bool ProtocolV2::jsonToConfig(const JsonDocument& doc) {
             if (mqtt.containsKey("port")) mqttCfg.port = mqtt["port"];
             if (mqtt.containsKey("username")) strncpy(mqttCfg.username, mqtt["username"], sizeof(mqttCfg.username));
             if (mqtt.containsKey("password")) strncpy(mqttCfg.password, mqtt["password"], sizeof(mqttCfg.password));
+            if (mqtt.containsKey("binaryPayload")) mqttCfg.binaryPayload = mqtt["binaryPayload"];
             
             success &= cfg.setMQTTConfig(mqttCfg);
         }
@@ -35,6 +35,13 @@ public:
     
     // Specific command handlers
     String handleGetMeterData(const JsonDocument& params);
+    String handleGetHarmonics(const JsonDocument& params);
+    String handleGetHarmonicRatios(const JsonDocument& params);
+    String handleGetFastPower(const JsonDocument& params);
+    String handleGetPerf(const JsonDocument& params);
+    String handleGetEnergy(const JsonDocument& params);
+    String handleGetEvents(const JsonDocument& params);
+    String handleGetTasks(const JsonDocument& params);
     String handleGetSystemStatus(const JsonDocument& params);
     String handleGetConfig(const JsonDocument& params);
     String handleSetConfig(const JsonDocument& params);
@@ -44,9 +51,23 @@ public:
     String handleReset(const JsonDocument& params);
     String handleFactoryReset(const JsonDocument& params);
     
+    static const size_t HARMONIC_JSON_DOC_SIZE = 12288;   // 6 spectra x 62 floats
+    static const size_t HARMONIC_RATIO_JSON_DOC_SIZE = 6144;  // 6 channels x 31 ratios
+    static const size_t PERF_JSON_DOC_SIZE = 4096;            // 6 histograms x 20 buckets
+    static const size_t EVENTS_JSON_DOC_SIZE = 6144;          // 12 event types + subscribers
+    static const size_t TASKS_JSON_DOC_SIZE = 6144;           // 16 tasks + schedule stats
+
     // Helper functions (public for WebServerManager)
     void meterDataToJson(const MeterData& data, JsonDocument& doc);
     void phaseDataToJson(const PhaseData& phase, JsonObject& obj);
+    void harmonicsToJson(const HarmonicData& data, JsonDocument& doc);
+    void spectrumToJson(const HarmonicSpectrum& spec, JsonObject& obj);
+    void harmonicRatiosToJson(const HarmonicRatios& data, JsonDocument& doc);
+    void fastPowerToJson(JsonDocument& doc);
+    void perfToJson(JsonDocument& doc);
+    void energyToJson(JsonDocument& doc);
+    void eventsToJson(JsonDocument& doc);
+    void tasksToJson(JsonDocument& doc);
     void systemStatusToJson(const SystemStatus& status, JsonDocument& doc);
     void configToJson(JsonDocument& doc);
     bool jsonToConfig(const JsonDocument& doc);
@@ -0,0 +1,49 @@
+/**
+ * SM-GE3222M V2.0 - Raw Meter Frame conversion
+ */
+
+#include "RawMeterFrame.h"
+
+static void convertPhase(const RawMeterFrame& raw, uint8_t ph, PhaseData& out) {
+    out.voltageRMS        = rawToFloat(raw.urms[ph], RawQuantity::VOLTAGE);
+    out.currentRMS        = rawToFloat(raw.irms[ph], RawQuantity::CURRENT);
+    out.activePower       = rawToFloat(raw.pmean[ph], RawQuantity::POWER);
+    out.reactivePower     = rawToFloat(raw.qmean[ph], RawQuantity::POWER);
+    out.apparentPower     = rawToFloat(raw.smean[ph], RawQuantity::POWER);
+    out.powerFactor       = rawToFloat(raw.pf[ph], RawQuantity::POWER_FACTOR);
+    out.meanPhaseAngle    = rawToFloat(raw.pangle[ph], RawQuantity::ANGLE);
+    out.voltagePhaseAngle = rawToFloat(raw.uangle[ph], RawQuantity::ANGLE);
+    out.voltageTHDN       = rawToFloat(raw.thdnU[ph], RawQuantity::VOLTAGE_THD);
+    out.currentTHDN       = rawToFloat(raw.thdnI[ph], RawQuantity::CURRENT_THD);
+
+    out.fwdActiveEnergy   = energyCountToFloat(raw.energy[RAW_EN_AP][ph]);
+    out.revActiveEnergy   = energyCountToFloat(raw.energy[RAW_EN_AN][ph]);
+    out.fwdReactiveEnergy = energyCountToFloat(raw.energy[RAW_EN_RP][ph]);
+    out.revReactiveEnergy = energyCountToFloat(raw.energy[RAW_EN_RN][ph]);
+    out.apparentEnergy    = energyCountToFloat(raw.energy[RAW_EN_SA][ph]);
+}
+
+void rawFrameToMeterData(const RawMeterFrame& raw, MeterData& data) {
+    convertPhase(raw, RAW_A, data.phaseA);
+    convertPhase(raw, RAW_B, data.phaseB);
+    convertPhase(raw, RAW_C, data.phaseC);
+
+    data.totalActivePower   = rawToFloat(raw.pmean[RAW_T], RawQuantity::POWER);
+    data.totalReactivePower = rawToFloat(raw.qmean[RAW_T], RawQuantity::POWER);
+    data.totalApparentPower = rawToFloat(raw.smean[RAW_T], RawQuantity::POWER);
+    data.totalPowerFactor   = rawToFloat(raw.pf[RAW_T], RawQuantity::POWER_FACTOR);
+
+    data.neutralCurrent   = rawToFloat(raw.irms[RAW_N], RawQuantity::CURRENT);
+    data.frequency        = rawToFloat(raw.freq, RawQuantity::FREQUENCY);
+    data.boardTemperature = rawToFloat(raw.temp, RawQuantity::TEMPERATURE);
+
+    data.meteringStatus0 = raw.sysStatus0;
+    data.meteringStatus1 = raw.sysStatus1;
+
+    // Energy since driver init (kWh / kVARh / kVAh)
+    data.totalFwdActiveEnergy   = energyCountToFloat(raw.energy[RAW_EN_AP][RAW_T]);
+    data.totalRevActiveEnergy   = energyCountToFloat(raw.energy[RAW_EN_AN][RAW_T]);
+    data.totalFwdReactiveEnergy = energyCountToFloat(raw.energy[RAW_EN_RP][RAW_T]);
+    data.totalRevReactiveEnergy = energyCountToFloat(raw.energy[RAW_EN_RN][RAW_T]);
+    data.totalApparentEnergy    = energyCountToFloat(raw.energy[RAW_EN_SA][RAW_T]);
+}
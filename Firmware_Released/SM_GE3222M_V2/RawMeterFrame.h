@@ -0,0 +1,105 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Raw Meter Frame
+ *
+ * Fixed-point ATM90E36 register values as captured by the register sweep.
+ * The acquisition path (driver -> EnergyMeter) only moves integers; conversion
+ * to engineering units happens when a consumer asks for a MeterData.
+ *
+ * Features:
+ * - One struct per acquisition cycle, no floating point on the hot path
+ * - constexpr per-quantity scale table (engineering unit per register LSB)
+ * - Single-precision conversion (the ESP32 FPU has no double support)
+ */
+
+#include <Arduino.h>
+#include "DataTypes.h"
+
+// Quantity classes sharing a register scale
+enum class RawQuantity : uint8_t {
+    VOLTAGE = 0,    // Urms          0.01 V
+    CURRENT,        // Irms          0.001 A
+    POWER,          // P/Q/S mean    0.00032 W/VAR/VA (32-bit HI/LO)
+    POWER_FACTOR,   // PFmean        0.001
+    ANGLE,          // P/U angle     0.1 degree
+    VOLTAGE_THD,    // THDNU         0.01 %
+    CURRENT_THD,    // THDNI         0.001 %
+    FREQUENCY,      // Freq          0.01 Hz
+    TEMPERATURE,    // Temp          1 degC
+    ENERGY,         // *Energy       0.01 CF at 3200 imp/kWh
+    COUNT
+};
+
+// Engineering units per LSB, indexed by RawQuantity.
+constexpr float RAW_SCALE[(uint8_t)RawQuantity::COUNT] = {
+    0.01f,                  // VOLTAGE
+    0.001f,                 // CURRENT
+    0.00032f,               // POWER
+    0.001f,                 // POWER_FACTOR
+    0.1f,                   // ANGLE
+    0.01f,                  // VOLTAGE_THD
+    0.001f,                 // CURRENT_THD
+    0.01f,                  // FREQUENCY
+    1.0f,                   // TEMPERATURE
+    1.0f / (100.0f * 3200.0f)   // ENERGY (kWh)
+};
+
+constexpr float rawScale(RawQuantity q) {
+    return RAW_SCALE[(uint8_t)q];
+}
+
+inline float rawToFloat(int32_t raw, RawQuantity q) {
+    return (float)raw * rawScale(q);
+}
+
+// Phase index used by the per-phase arrays (N only exists for current)
+enum RawPhase : uint8_t { RAW_A = 0, RAW_B, RAW_C, RAW_T, RAW_N = RAW_T };
+
+// Energy counter index (forward/reverse active, forward/reverse reactive, apparent)
+enum RawEnergy : uint8_t { RAW_EN_AP = 0, RAW_EN_AN, RAW_EN_RP, RAW_EN_RN, RAW_EN_SA, RAW_EN_COUNT };
+
+// Pulse count in RawQuantity::ENERGY units to kWh / kVARh / kVAh
+inline float energyCountToFloat(uint64_t count) {
+    return (float)count * rawScale(RawQuantity::ENERGY);
+}
+
+// Exact pulse rate behind RAW_SCALE[ENERGY], for registers that must not lose
+// resolution (EnergyAccumulator); off the acquisition path, so double is fine
+constexpr double ENERGY_COUNTS_PER_KWH = 100.0 * 3200.0;
+
+inline double energyCountToDouble(uint64_t count) {
+    return (double)count / ENERGY_COUNTS_PER_KWH;
+}
+
+struct RawMeterFrame {
+    uint16_t urms[3];           // A, B, C
+    uint16_t irms[4];           // A, B, C, N
+    int32_t  pmean[4];          // A, B, C, T
+    int32_t  qmean[4];          // A, B, C, T
+    int32_t  smean[4];          // A, B, C, T (arithmetic sum)
+    int16_t  pf[4];             // A, B, C, T
+    int16_t  pangle[3];         // Mean phase angle A, B, C
+    int16_t  uangle[3];         // Voltage phase angle A, B, C
+    uint16_t thdnU[3];
+    uint16_t thdnI[3];
+    uint16_t freq;
+    int16_t  temp;
+    uint16_t sysStatus0;
+    uint16_t sysStatus1;
+    uint64_t energy[RAW_EN_COUNT][4];   // Pulses since driver init, [RawEnergy][A, B, C, T]
+    uint32_t energyEpoch;       // Changes only when the driver restarts the energy totals (0 = none yet)
+    int64_t  captureUs;         // esp_timer_get_time() right after the sweep (monotonic)
+    uint64_t utcMs;             // UTC epoch ms of captureUs, 0 while the clock is unset (set by EnergyMeter)
+
+    RawMeterFrame() {
+        memset(this, 0, sizeof(RawMeterFrame));
+    }
+};
+
+/**
+ * Convert a raw frame to engineering units.
+ * Only the ATM90E36-derived fields of data are written; ambient/board
+ * bookkeeping fields (timestamp, sequenceNumber, valid, ambient*) are left as-is.
+ */
+void rawFrameToMeterData(const RawMeterFrame& raw, MeterData& data);
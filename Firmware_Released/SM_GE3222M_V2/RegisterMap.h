@@ -258,6 +258,37 @@ constexpr uint16_t REG_U_ANGLE_A        = 0xFD;  // Phase A Voltage Phase Angle
 constexpr uint16_t REG_U_ANGLE_B        = 0xFE;  // Phase B Voltage Phase Angle
 constexpr uint16_t REG_U_ANGLE_C        = 0xFF;  // Phase C Voltage Phase Angle
 
+// ============================================================================
+// HARMONIC DFT REGISTERS (datasheet 3.6 / Table-14)
+// ============================================================================
+// Six result blocks of 32 registers: HR2..HR32 at +00H..+1EH, THD at +1FH.
+// Harmonic ratio / THD (%) = register value / 163.84
+constexpr uint16_t REG_DFT_AI_HR2       = 0x100; // Phase A Current harmonic ratios
+constexpr uint16_t REG_DFT_BI_HR2       = 0x120; // Phase B Current harmonic ratios
+constexpr uint16_t REG_DFT_CI_HR2       = 0x140; // Phase C Current harmonic ratios
+constexpr uint16_t REG_DFT_AV_HR2       = 0x160; // Phase A Voltage harmonic ratios
+constexpr uint16_t REG_DFT_BV_HR2       = 0x180; // Phase B Voltage harmonic ratios
+constexpr uint16_t REG_DFT_CV_HR2       = 0x1A0; // Phase C Voltage harmonic ratios
+constexpr uint16_t DFT_BLOCK_STRIDE     = 0x20;  // Registers per channel block
+constexpr uint16_t DFT_THD_OFFSET       = 0x1F;  // THD ratio within a block
+
+// Fundamental component: I = value * 3.2656e-3 / 2^scale, U = value * 3.2656e-2 / 2^scale
+constexpr uint16_t REG_DFT_AI_FUND      = 0x1C0; // Phase A Current fundamental
+constexpr uint16_t REG_DFT_AV_FUND      = 0x1C1; // Phase A Voltage fundamental
+constexpr uint16_t REG_DFT_BI_FUND      = 0x1C2; // Phase B Current fundamental
+constexpr uint16_t REG_DFT_BV_FUND      = 0x1C3; // Phase B Voltage fundamental
+constexpr uint16_t REG_DFT_CI_FUND      = 0x1C4; // Phase C Current fundamental
+constexpr uint16_t REG_DFT_CV_FUND      = 0x1C5; // Phase C Voltage fundamental
+
+constexpr uint16_t REG_DFT_SCALE        = 0x1D0; // Input gain: [2:0]AI [5:3]BI [8:6]CI [10:9]AV [12:11]BV [14:13]CV
+constexpr uint16_t REG_DFT_CTRL         = 0x1D1; // DFT control
+constexpr uint16_t DFT_SCALE_NO_WINDOW  = 0x8000; // DFT_SCALE b15: disable the Hanning window
+constexpr uint16_t DFT_CTRL_START       = 0x0001; // 1 = start (self-clearing), 0 = reset/abort
+
+constexpr float DFT_RATIO_SCALE         = 163.84f; // Register value per %
+constexpr float DFT_FUND_I_LSB          = 3.2656e-3f;
+constexpr float DFT_FUND_U_LSB          = 3.2656e-2f;
+
 // ============================================================================
 // CALIBRATION CONSTANTS
 // ============================================================================
@@ -272,6 +303,35 @@ constexpr uint16_t CAL_CS_THREE         = 0x02F6;  // CS3 expected value (V1.0 d
 constexpr uint16_t DEFAULT_PL_CONST_H   = 0x0861;
 constexpr uint16_t DEFAULT_PL_CONST_L   = 0xC468;
 
+// ============================================================================
+// STATUS REGISTER BITS (datasheet 6.2.2 / 6.5)
+// ============================================================================
+// SysStatus0 (01H, read-clear) -> IRQ0 when enabled in FuncEn0 (03H, same bit)
+constexpr uint16_t SYS0_CS0_ERR         = 0x4000;  // CS0 checksum error (also WarnOut)
+constexpr uint16_t SYS0_CS1_ERR         = 0x1000;  // CS1 checksum error (also WarnOut)
+constexpr uint16_t SYS0_CS2_ERR         = 0x0400;  // CS2 checksum error (also WarnOut)
+constexpr uint16_t SYS0_CS3_ERR         = 0x0100;  // CS3 checksum error (also WarnOut)
+constexpr uint16_t SYS0_U_REV_WN        = 0x0080;  // Voltage phase sequence error
+constexpr uint16_t SYS0_I_REV_WN        = 0x0040;  // Current phase sequence error
+constexpr uint16_t SYS0_SAG_WARN        = 0x0008;  // Voltage sag on one or more phases
+constexpr uint16_t SYS0_PHASE_LOSE_WN   = 0x0004;  // Phase loss on one or more phases
+
+// SysStatus1 (02H, read-clear) -> IRQ1 when enabled in FuncEn1 (04H, same bit)
+constexpr uint16_t SYS1_IN_OV1          = 0x8000;  // Sampled N current above INWarnTh1
+constexpr uint16_t SYS1_IN_OV0          = 0x4000;  // Calculated N current above INWarnTh0
+constexpr uint16_t SYS1_THDU_OV         = 0x0800;  // Voltage THD above THDNUTh
+constexpr uint16_t SYS1_THDI_OV         = 0x0400;  // Current THD above THDNITh
+constexpr uint16_t SYS1_DFT_DONE        = 0x0200;  // DFT result ready
+constexpr uint16_t SYS1_REV_CHG_MASK    = 0x00FF;  // Active/reactive energy direction changed
+
+// EnStatus1 (96H, live) - per-phase sag / phase loss
+constexpr uint16_t EN1_SAG_PHASE_A      = 0x0040;
+constexpr uint16_t EN1_SAG_PHASE_B      = 0x0020;
+constexpr uint16_t EN1_SAG_PHASE_C      = 0x0010;
+constexpr uint16_t EN1_PHASE_LOSS_A     = 0x0004;
+constexpr uint16_t EN1_PHASE_LOSS_B     = 0x0002;
+constexpr uint16_t EN1_PHASE_LOSS_C     = 0x0001;
+
 // SPI Protocol Constants
 constexpr uint16_t SPI_READ_FLAG        = 0x8000;  // Bit 15 = 1 for READ
 constexpr uint16_t SPI_WRITE_FLAG       = 0x0000;  // Bit 15 = 0 for WRITE
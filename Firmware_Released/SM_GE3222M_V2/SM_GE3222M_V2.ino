@@ -43,6 +43,7 @@
 #include "ATM90E36Driver.h"
 #include "EnergyMeter.h"
 #include "EnergyAccumulator.h"
+#include "WaveformCapture.h"
 #include "CalibrationManager.h"
 
 // Storage modules
@@ -284,19 +285,23 @@ bool initPhase3_EnergyMetering() {
         checkBootStep("Checksum Verification", true);
     }
     
-    // Initialize Energy Meter (with 5-sample moving average filtering)
-    if (!EnergyMeter::getInstance().init(5)) {
+    // Initialize Energy Meter (per-channel filters from SystemConfig)
+    if (!EnergyMeter::getInstance().init()) {
         return checkBootStatus("Energy Meter Init", false);
     }
     checkBootStep("Energy Meter Init", true);
     
     // Initialize Energy Accumulator and restore state
-    if (!EnergyAccumulator::getInstance().init(60)) { // Persist every 60 seconds
+    // Restores from the energy journal / NVS; NVS kWh snapshot every 60 s unless journaled
+    if (!EnergyAccumulator::getInstance().init(60)) {
         return checkBootStatus("Energy Accumulator Init", false);
     }
-    EnergyAccumulator::getInstance().loadFromNVS();
     checkBootStep("Energy Accumulator Init", true);
     checkBootStep("Energy State Restored", true);
+
+    // Waveform capture ring (ATM90E36 DMA mode); optional, metering runs without it
+    bool waveOk = WaveformCapture::getInstance().init();
+    printBootOptionalStep("Waveform Capture Init", waveOk);
     
     // Perform initial read
     if (EnergyMeter::getInstance().update()) {
@@ -466,9 +471,9 @@ bool initPhase6_Tasks() {
         return checkBootStatus("Task Creation", false);
     }
 
-    checkBootStep("EnergyTask (Core 1, Priority 5, 500ms)", true);
-    checkBootStep("AccumulatorTask (Core 1, Priority 4, 1000ms)", true);
-    checkBootStep("ModbusTask (Core 1, Priority 3, 10ms poll)", true);
+    checkBootStep("EnergyTask (Core 1, Priority 5, FAST group tick)", true);
+    checkBootStep("AccumulatorTask (Core 1, Priority 4, publishInterval)", true);
+    checkBootStep("ModbusTask (Core 1, Priority 3, 50ms poll)", true);
     printBootOptionalStep("TCPServerTask (Core 0, Priority 2, 20ms poll)", TaskManager::getInstance().isTCPServerTaskRunning());
     printBootOptionalStep("MQTTTask (stub)", TaskManager::getInstance().getMQTTTaskHandle() != nullptr);
     printBootOptionalStep("DHTTask (Core 0, Priority 1, 500ms scheduler)", TaskManager::getInstance().getDHTTaskHandle() != nullptr);
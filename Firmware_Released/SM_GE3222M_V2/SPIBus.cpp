@@ -9,6 +9,7 @@
 
 SPIBus::SPIBus()
     : m_initialized(false)
+    , m_suspended(false)
     , m_defaultFrequency(SPI_FREQUENCY_ATM90E36)
     , m_mutex(nullptr)
     , m_sckPin(-1)
@@ -79,6 +80,52 @@ void SPIBus::unlock() {
         xSemaphoreGive(m_mutex);
     }
 }
+
+bool SPIBus::suspend(uint32_t timeoutMs) {
+    if (!m_initialized || m_suspended) {
+        return false;
+    }
+
+    if (!lock(timeoutMs)) {
+        return false;
+    }
+
+    // Release the pins so the external master can drive SCLK while we listen on MISO.
+    SPI.end();
+    pinMode(m_sckPin, INPUT);
+    pinMode(m_misoPin, INPUT);
+    pinMode(m_mosiPin, INPUT);
+    m_suspended = true;
+    return true;
+}
+
+void SPIBus::resume() {
+    if (!m_suspended) {
+        return;
+    }
+    SPI.begin(m_sckPin, m_misoPin, m_mosiPin);
+    m_suspended = false;
+    unlock();
+}
+
+bool SPIBus::beginTransaction(uint32_t frequency, uint8_t mode, uint32_t timeoutMs) {
+    if (!m_initialized) {
+        return false;
+    }
+
+    if (!lock(timeoutMs)) {
+        return false;
+    }
+
+    SPI.beginTransaction(SPISettings(frequency, MSBFIRST, mode));
+    return true;
+}
+
+void SPIBus::endTransaction() {
+    SPI.endTransaction();
+    unlock();
+}
+
 uint16_t SPIBus::transfer16(uint8_t csPin, uint16_t data, uint32_t frequency, uint8_t mode) {
     if (!m_initialized) {
         return 0xFFFF;
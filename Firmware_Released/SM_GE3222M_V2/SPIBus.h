@@ -11,6 +11,7 @@
  * - ATM90E36-specific protocol support (200kHz, Mode3, MSB-first)
  * - Automatic byte swapping for 16-bit data
  * - Multiple chip select support
+ * - Held-bus batch transactions (used by the ATM90E36 driver transport)
  * 
  * Ported from V1.0 EnergyATM90E36.cpp CommEnergyIC() function
  */
@@ -84,6 +85,28 @@ public:
     bool lock(uint32_t timeoutMs = 100);
     void unlock();
 
+    /**
+     * Lock the bus and open an SPI transaction for a batch of transfers.
+     * Between the two calls the caller may drive CS and use SPI.transfer*() directly.
+     * @param frequency SPI frequency
+     * @param mode SPI mode
+     * @param timeoutMs Mutex timeout
+     * @return true if the bus was acquired (endTransaction() must follow)
+     */
+    bool beginTransaction(uint32_t frequency, uint8_t mode = SPI_MODE_ATM90E36, uint32_t timeoutMs = 100);
+    void endTransaction();
+
+    /**
+     * Hand the bus pins to an external master (ATM90E36 DMA mode).
+     * Takes the bus mutex and detaches SCK/MISO/MOSI from the SPI peripheral;
+     * all transfers fail with a mutex timeout until resume().
+     * @param timeoutMs Mutex timeout
+     * @return true if the bus was suspended (resume() must follow)
+     */
+    bool suspend(uint32_t timeoutMs = 1000);
+    void resume();
+    bool isSuspended() const { return m_suspended; }
+
     /**
      * Check if SPI bus is initialized
      */
@@ -119,6 +142,7 @@ private:
 
     // State
     bool m_initialized;
+    bool m_suspended;
     uint32_t m_defaultFrequency;
     SemaphoreHandle_t m_mutex;
     
@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Snapshot Buffer
+ *
+ * Double-buffered, generation-counted snapshot for one writer and any number of
+ * readers (a seqlock per slot). The writer fills the slot readers are not using and
+ * then publishes it, so it never waits for a reader; a reader only retries when the
+ * writer lapped it (two publishes during one copy).
+ *
+ * Unlike a single-slot seqlock, a reader that preempts the writer mid-update still
+ * sees a stable slot, so a high-priority reader cannot spin against a blocked writer.
+ */
+
+#include <Arduino.h>
+#include <atomic>
+
+// Reader/writer counters (monotonic since boot)
+struct SnapshotStats {
+    uint32_t reads;         // Completed read() calls
+    uint32_t retries;       // Torn copies that were re-read
+    uint32_t maxRetries;    // Worst single read()
+    uint32_t writes;        // Published generations
+};
+
+template <typename T>
+class SnapshotBuffer {
+public:
+    SnapshotBuffer() : m_active(0), m_writeSlot(0), m_reads(0), m_retries(0), m_maxRetries(0), m_writes(0) {
+        m_seq[0].store(0, std::memory_order_relaxed);
+        m_seq[1].store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Writer: start an update. Returns the idle slot pre-filled with the published
+     * value, so callers only assign the fields they change. Must be followed by commit().
+     */
+    T& beginWrite() {
+        const uint8_t active = m_active.load(std::memory_order_relaxed);
+        m_writeSlot = active ^ 1;
+        m_seq[m_writeSlot].fetch_add(1, std::memory_order_relaxed);   // Odd: slot being written
+        std::atomic_thread_fence(std::memory_order_release);
+        m_slots[m_writeSlot] = m_slots[active];
+        return m_slots[m_writeSlot];
+    }
+
+    /**
+     * Writer: publish the slot returned by beginWrite().
+     */
+    void commit() {
+        m_seq[m_writeSlot].fetch_add(1, std::memory_order_release);   // Even again
+        m_active.store(m_writeSlot, std::memory_order_release);
+        m_writes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Writer: the published value (only stable from the writing task).
+     */
+    const T& published() const {
+        return m_slots[m_active.load(std::memory_order_relaxed)];
+    }
+
+    /**
+     * Reader: copy the latest published value. Never blocks.
+     * @return Number of retries needed (0 unless the writer lapped the copy)
+     */
+    uint32_t read(T& out) {
+        uint32_t retries = 0;
+        for (;;) {
+            const uint8_t slot = m_active.load(std::memory_order_acquire);
+            const uint32_t seq = m_seq[slot].load(std::memory_order_acquire);
+            if ((seq & 1) == 0) {
+                out = m_slots[slot];
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_seq[slot].load(std::memory_order_relaxed) == seq) {
+                    break;
+                }
+            }
+            retries++;
+        }
+
+        m_reads.fetch_add(1, std::memory_order_relaxed);
+        if (retries > 0) {
+            m_retries.fetch_add(retries, std::memory_order_relaxed);
+            uint32_t worst = m_maxRetries.load(std::memory_order_relaxed);
+            while (retries > worst &&
+                   !m_maxRetries.compare_exchange_weak(worst, retries, std::memory_order_relaxed)) {
+            }
+        }
+        return retries;
+    }
+
+    // Published generations; changes whenever a new value is committed
+    uint32_t generation() const { return m_writes.load(std::memory_order_acquire); }
+
+    SnapshotStats getStats() const {
+        SnapshotStats s;
+        s.reads = m_reads.load(std::memory_order_relaxed);
+        s.retries = m_retries.load(std::memory_order_relaxed);
+        s.maxRetries = m_maxRetries.load(std::memory_order_relaxed);
+        s.writes = m_writes.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    T m_slots[2];
+    std::atomic<uint32_t> m_seq[2];     // Per-slot sequence, odd while the writer owns the slot
+    std::atomic<uint8_t> m_active;      // Slot readers copy from
+    uint8_t m_writeSlot;                // Writer-private
+
+    std::atomic<uint32_t> m_reads;
+    std::atomic<uint32_t> m_retries;
+    std::atomic<uint32_t> m_maxRetries;
+    std::atomic<uint32_t> m_writes;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - SPSC Ring
+ *
+ * Fixed-capacity, lock-free ring for exactly one producer task and one consumer
+ * task. Head and tail are each written by one side only, so push()/pop() are a
+ * copy plus one release store; neither side ever blocks or disables interrupts.
+ *
+ * A full ring rejects the new element (the producer counts it as an overrun)
+ * rather than overwriting the oldest one under the consumer.
+ */
+
+#include <Arduino.h>
+#include <atomic>
+
+template <typename T, uint16_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : m_head(0), m_tail(0), m_overruns(0) {}
+
+    /**
+     * Producer: append one element.
+     * @return false when the ring is full (element dropped)
+     */
+    bool push(const T& item) {
+        const uint16_t head = m_head.load(std::memory_order_relaxed);
+        const uint16_t tail = m_tail.load(std::memory_order_acquire);
+        if ((uint16_t)(head - tail) >= N) {
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_items[head & (N - 1)] = item;
+        m_head.store((uint16_t)(head + 1), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer: remove the oldest element.
+     * @return false when the ring is empty
+     */
+    bool pop(T& out) {
+        const uint16_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint16_t head = m_head.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;
+        }
+        out = m_items[tail & (N - 1)];
+        m_tail.store((uint16_t)(tail + 1), std::memory_order_release);
+        return true;
+    }
+
+    // Either side; exact only from the consumer
+    uint16_t size() const {
+        return (uint16_t)(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire));
+    }
+
+    static constexpr uint16_t capacity() { return N; }
+
+    // Elements rejected because the consumer fell behind
+    uint32_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+
+private:
+    T m_items[N];
+    std::atomic<uint16_t> m_head;       // Next slot to fill (producer)
+    std::atomic<uint16_t> m_tail;       // Next slot to drain (consumer)
+    std::atomic<uint32_t> m_overruns;
+};
@@ -3,6 +3,7 @@
 #include "EnergyMeter.h"
 #include "SystemMonitor.h"
 #include "ConfigManager.h"
+#include "MeterWireFormat.h"
 #include <cstring>
 
 TCPDataServer::TCPDataServer()
@@ -186,7 +187,14 @@ void TCPDataServer::processCommand(ClientState& state, const char* command) {
     Logger::getInstance().debug("[TCP] Command: %s", cmd.c_str());
 
     if (cmd == "data" || cmd == "getreadings") {
-        sendMeterData(state.client);
+        if (state.binaryData) sendMeterFrame(state.client);
+        else sendMeterData(state.client);
+    } else if (cmd == "format bin" || cmd == "format binary") {
+        state.binaryData = true;
+        state.client.print("OK\r\n");
+    } else if (cmd == "format text") {
+        state.binaryData = false;
+        state.client.print("OK\r\n");
     } else if (cmd == "status" || cmd == "getmeterinfo") {
         sendSystemStatus(state.client);
     } else if (cmd == "config" || cmd == "getconfig") {
@@ -209,6 +217,20 @@ void TCPDataServer::sendMeterData(WiFiClient& client) {
     client.print(data);
 }
 
+void TCPDataServer::sendMeterFrame(WiFiClient& client) {
+    if (!client || !client.connected()) return;
+    MeterData data = EnergyMeter::getInstance().getSnapshot();
+    if (!data.valid) {
+        client.print("ERROR: No meter data available");
+        return;
+    }
+    MeterFieldMask all;
+    all.setAll();
+    uint8_t frame[METER_WIRE_MAX_SIZE];
+    const size_t len = encodeMeterWireFrame(data, all, frame, sizeof(frame));
+    client.write(frame, len);
+}
+
 void TCPDataServer::sendSystemStatus(WiFiClient& client) {
     if (!client || !client.connected()) return;
     String data = buildV1SystemInfo();
@@ -239,6 +261,7 @@ void TCPDataServer::sendHelp(WiFiClient& client) {
     String help = "SM-GE3222M V2.0 TCP Server\r\n";
     help += "Commands:\r\n";
     help += "  data       - Get meter readings (V1.0 format)\r\n";
+    help += "  format bin - Send readings as binary frames (format text to revert)\r\n";
     help += "  status     - Get system status\r\n";
     help += "  config     - Get configuration\r\n";
     help += "  reset      - Reset device\r\n";
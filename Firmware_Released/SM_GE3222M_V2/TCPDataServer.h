@@ -10,7 +10,8 @@
 // tcp_alloc core-lock asserts ("Required to lock TCPIP core functionality!").
 //
 // Supports up to 4 simultaneous clients. Each client may send newline-terminated
-// commands. Responses are V1.0 compatible.
+// commands. Responses are V1.0 compatible; "format bin" switches a client's
+// meter data to the binary MeterWireFormat frame.
 
 #include <Arduino.h>
 #include <WiFi.h>
@@ -43,6 +44,7 @@ private:
     struct ClientState {
         WiFiClient client;
         bool inUse = false;
+        bool binaryData = false;        // "data" answers with a MeterWireFormat frame
         uint32_t lastActivityTime = 0;
         char rxBuffer[256];
         uint16_t rxBufferLen = 0;
@@ -50,6 +52,7 @@ private:
         void reset() {
             if (client) client.stop();
             inUse = false;
+            binaryData = false;
             lastActivityTime = 0;
             rxBufferLen = 0;
             memset(rxBuffer, 0, sizeof(rxBuffer));
@@ -59,6 +62,7 @@ private:
     // Protocol handling
     void processCommand(ClientState& state, const char* command);
     void sendMeterData(WiFiClient& client);
+    void sendMeterFrame(WiFiClient& client);
     void sendSystemStatus(WiFiClient& client);
     void sendConfig(WiFiClient& client);
     void sendHelp(WiFiClient& client);
@@ -5,11 +5,13 @@
 
 #include "TaskManager.h"
 #include "EnergyMeter.h"
+#include "ATM90E36Driver.h"
 #include "EnergyAccumulator.h"
 #include "ModbusServer.h"
 #include "TCPDataServer.h"
 #include "WebUIManager.h"
 #include "DHTSensorManager.h"
+#include "GPIOManager.h"
 #include "SMNetworkManager.h"
 
 #if defined(ARDUINO_ARCH_ESP32)
@@ -20,6 +22,15 @@
 #include "EventBus.h"
 #include "WatchdogManager.h"
 #include "DataLogger.h"
+#include "HarmonicAnalyzer.h"
+#include "HarmonicSweep.h"
+#include "FastPowerSampler.h"
+#include "LoadShedController.h"
+#include "PerfMonitor.h"
+#include "TaskScheduler.h"
+#include "TaskMonitor.h"
+#include "MQTTPublisher.h"
+#include <new>
 
 
 namespace {
@@ -41,6 +52,7 @@ static BaseType_t createPinnedTaskWithFallback(TaskFunction_t fn, const char* na
             BaseType_t r = xTaskCreatePinnedToCore(fn, name, stacks[i], nullptr, prio, outHandle, core);
             if (r == pdPASS) {
                 Logger::getInstance().info("TaskManager: %s created stack=%u core=%d", name, (unsigned)stacks[i], (int)core);
+                TaskMonitor::getInstance().track(*outHandle, name, stacks[i], prio, core);
                 return r;
             }
             Logger::getInstance().warn("TaskManager: %s create failed stack=%u core=%d", name, (unsigned)stacks[i], (int)core);
@@ -58,6 +70,14 @@ static BaseType_t createOptionalPinnedTask(TaskFunction_t fn, const char* name,
     for (uint32_t v : stacks) { bool exists=false; for (size_t i=0;i<n;++i) if (uniq[i]==v) { exists=true; break; } if (!exists) uniq[n++]=v; }
     return createPinnedTaskWithFallback(fn, name, uniq, n, prio, outHandle, preferredCore);
 }
+
+// Unregistered first, so TaskMonitor never samples a deleted handle
+static void deleteTrackedTask(TaskHandle_t& handle) {
+    if (!handle) return;
+    TaskMonitor::getInstance().untrack(handle);
+    vTaskDelete(handle);
+    handle = nullptr;
+}
 }
 
 TaskManager& TaskManager::getInstance() {
@@ -67,13 +87,18 @@ TaskManager& TaskManager::getInstance() {
 
 TaskManager::TaskManager()
     : _energyTask(nullptr)
+    , _powerQualityTask(nullptr)
     , _accumulatorTask(nullptr)
     , _modbusTask(nullptr)
     , _tcpServerTask(nullptr)
     , _mqttTask(nullptr)
     , _diagnosticsTask(nullptr)
     , _dhtTask(nullptr)
+    , _harmonicTask(nullptr)
     , _webUiTask(nullptr)
+    , _fastPowerTask(nullptr)
+    , _loadShedTask(nullptr)
+    , _eventTask(nullptr)
     , _tasksRunning(false) {
 }
 
@@ -92,6 +117,36 @@ bool TaskManager::createAllTasks() {
     Logger::getInstance().info("TaskManager: Heap free=%u internal=%u", (unsigned)ESP.getFreeHeap(), (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
 #endif
     
+    // Create Event Task (Core 0, Priority 3) - OPTIONAL
+    // Started first so events published by the tasks below are delivered from the start.
+    // Without it events are still queued and counted, but not delivered.
+    EventBus& eventBus = EventBus::getInstance();
+    if (eventBus.init()) {
+        BaseType_t evResult = createOptionalPinnedTask(eventTaskFunc, "EventTask", EVENT_STACK_SIZE,
+                                                       EVENT_PRIORITY, &_eventTask, CORE_0);
+        if (evResult != pdPASS) {
+            _eventTask = nullptr;
+            Logger::getInstance().warn("TaskManager: Failed to create EventTask (optional) - events not delivered");
+        }
+        eventBus.setDispatcher(_eventTask);
+    }
+    
+    // Periodic tasks release on one grid; the phases keep the ATM90E36 sweep, Modbus
+    // and W5500 traffic off each other's ticks. readInterval/publishInterval follow
+    // CONFIG_CHANGED at runtime.
+    SystemConfig sysCfg;
+    ConfigManager::getInstance().loadSystemConfig(sysCfg);
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    sched.registerTask(SchedTask::ENERGY, ATM90E36Driver::getInstance().getPollPeriod(PollGroup::FAST),
+                       ENERGY_PHASE_MS, ENERGY_DEADLINE_MS);
+    sched.registerTask(SchedTask::MODBUS, MODBUS_PERIOD_MS, MODBUS_PHASE_MS, MODBUS_DEADLINE_MS);
+    sched.registerTask(SchedTask::TCP_SERVER, TCP_SERVER_PERIOD_MS, TCP_SERVER_PHASE_MS, TCP_SERVER_DEADLINE_MS);
+    sched.registerTask(SchedTask::ACCUMULATOR, 1000, ACCUMULATOR_PHASE_MS, ACCUMULATOR_DEADLINE_MS);
+    sched.applyConfig(sysCfg);
+    eventBus.subscribe(EventType::CONFIG_CHANGED, onConfigChanged);
+    // The WebSocket push follows the EnergyTask's METER_DATA_UPDATED topic
+    eventBus.subscribe(EventType::METER_DATA_UPDATED, WebUIManager::onMeterData);
+    
     // Create Energy Task (Core 1, Priority 5)
     const uint32_t energyStacks[] = { ENERGY_STACK_SIZE, 3072, 2560, 2048 };
     BaseType_t result = createPinnedTaskWithFallback(
@@ -102,7 +157,54 @@ bool TaskManager::createAllTasks() {
         return false;
     }
     Logger::getInstance().info("TaskManager: EnergyTask created");
+
+    // Hardware DFT sweep, serviced by the PowerQualityTask (DFTDone arrives on IRQ1)
+    HarmonicSweep::getInstance().init();
+
+    // Create Power Quality Task (Core 1, Priority 6) - OPTIONAL
+    // Without it, status bits are still latched by the EnergyTask sweep but not published.
+    result = createOptionalPinnedTask(
+        powerQualityTaskFunc,
+        "PowerQualityTask",
+        POWER_QUALITY_STACK_SIZE,
+        POWER_QUALITY_PRIORITY,
+        &_powerQualityTask,
+        CORE_1
+    );
+
+    if (result != pdPASS) {
+        _powerQualityTask = nullptr;
+        Logger::getInstance().warn("TaskManager: Failed to create PowerQualityTask (optional) - PQ events disabled");
+    } else if (!GPIOManager::getInstance().enableStatusInterrupts(_powerQualityTask)) {
+        Logger::getInstance().warn("TaskManager: ATM90E36 IRQ inputs unavailable - PowerQualityTask polling every %lums",
+                                   (unsigned long)POWER_QUALITY_FALLBACK_MS);
+    }
     
+    // Fast power mode (Core 1): FastPowerTask (P7) samples PmeanA/B/C/T and wakes the
+    // LoadShedTask (P6) through the SPSC ring. Only started when selected in SystemConfig.
+    {
+        FastPowerSampler& sampler = FastPowerSampler::getInstance();
+        sampler.applyConfig(sysCfg);
+        LoadShedController::getInstance().applyConfig(sysCfg);
+
+        if (sysCfg.fastPowerEnabled) {
+            result = createOptionalPinnedTask(loadShedTaskFunc, "LoadShedTask", LOAD_SHED_STACK_SIZE,
+                                              LOAD_SHED_PRIORITY, &_loadShedTask, CORE_1);
+            if (result != pdPASS) {
+                _loadShedTask = nullptr;
+                Logger::getInstance().warn("TaskManager: Failed to create LoadShedTask (optional) - samples not consumed");
+            }
+            sampler.setConsumer(_loadShedTask);
+
+            result = createOptionalPinnedTask(fastPowerTaskFunc, "FastPowerTask", FAST_POWER_STACK_SIZE,
+                                              FAST_POWER_PRIORITY, &_fastPowerTask, CORE_1);
+            if (result != pdPASS) {
+                _fastPowerTask = nullptr;
+                Logger::getInstance().warn("TaskManager: Failed to create FastPowerTask (optional) - fast power mode disabled");
+            }
+        }
+    }
+
     // Create Accumulator Task (Core 1, Priority 4)
     {
         const uint32_t stacks[] = { ACCUMULATOR_STACK_SIZE, 3072, 2560, 2048 };
@@ -113,7 +215,7 @@ bool TaskManager::createAllTasks() {
     
     if (result != pdPASS) {
         Logger::getInstance().error("TaskManager: Failed to create AccumulatorTask");
-        if (_energyTask) { vTaskDelete(_energyTask); _energyTask = nullptr; }
+        deleteTrackedTask(_energyTask);
         return false;
     }
     Logger::getInstance().info("TaskManager: AccumulatorTask created");
@@ -128,8 +230,8 @@ bool TaskManager::createAllTasks() {
     
     if (result != pdPASS) {
         Logger::getInstance().error("TaskManager: Failed to create ModbusTask");
-        if (_accumulatorTask) { vTaskDelete(_accumulatorTask); _accumulatorTask = nullptr; }
-        if (_energyTask) { vTaskDelete(_energyTask); _energyTask = nullptr; }
+        deleteTrackedTask(_accumulatorTask);
+        deleteTrackedTask(_energyTask);
         return false;
     }
     Logger::getInstance().info("TaskManager: ModbusTask created");
@@ -216,6 +318,26 @@ bool TaskManager::createAllTasks() {
         Logger::getInstance().info("TaskManager: Created DHTTask on Core 0");
     }
 
+    // Create Harmonic Analysis Task (Core 0, Priority 1) - OPTIONAL
+    // Skipped when the FFT work buffers cannot be allocated.
+    if (HarmonicAnalyzer::getInstance().init()) {
+        result = createOptionalPinnedTask(
+            harmonicTaskFunc,
+            "HarmonicTask",
+            HARMONIC_STACK_SIZE,
+            HARMONIC_PRIORITY,
+            &_harmonicTask,
+            CORE_0
+        );
+
+        if (result != pdPASS) {
+            _harmonicTask = nullptr;
+            Logger::getInstance().warn("TaskManager: Failed to create HarmonicTask (optional) - harmonic analysis disabled");
+        } else {
+            Logger::getInstance().info("TaskManager: Created HarmonicTask on Core 0");
+        }
+    }
+
     
     _tasksRunning = true;
     Logger::getInstance().info("TaskManager: All tasks created successfully");
@@ -228,6 +350,7 @@ void TaskManager::stopAllTasks() {
     }
     
     Logger::getInstance().info("TaskManager: Stopping all tasks...");
+    TaskMonitor::getInstance().clear();
     
     if (_diagnosticsTask) {
         vTaskDelete(_diagnosticsTask);
@@ -239,6 +362,11 @@ void TaskManager::stopAllTasks() {
         _dhtTask = nullptr;
     }
 
+    if (_harmonicTask) {
+        vTaskDelete(_harmonicTask);
+        _harmonicTask = nullptr;
+    }
+
     if (_webUiTask) {
         vTaskDelete(_webUiTask);
         _webUiTask = nullptr;
@@ -263,11 +391,33 @@ void TaskManager::stopAllTasks() {
         vTaskDelete(_accumulatorTask);
         _accumulatorTask = nullptr;
     }
+
+    if (_fastPowerTask) {
+        vTaskDelete(_fastPowerTask);
+        _fastPowerTask = nullptr;
+    }
+
+    if (_loadShedTask) {
+        FastPowerSampler::getInstance().setConsumer(nullptr);
+        vTaskDelete(_loadShedTask);
+        _loadShedTask = nullptr;
+    }
     
+    if (_powerQualityTask) {
+        vTaskDelete(_powerQualityTask);
+        _powerQualityTask = nullptr;
+    }
+
     if (_energyTask) {
         vTaskDelete(_energyTask);
         _energyTask = nullptr;
     }
+
+    if (_eventTask) {
+        EventBus::getInstance().setDispatcher(nullptr);
+        vTaskDelete(_eventTask);
+        _eventTask = nullptr;
+    }
     
     _tasksRunning = false;
     Logger::getInstance().info("TaskManager: All tasks stopped");
@@ -278,68 +428,192 @@ void TaskManager::stopAllTasks() {
 // ============================================================================
 
 void TaskManager::energyTaskFunc(void* param) {
-    Logger::getInstance().info("EnergyTask: Started (500ms interval)");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    Logger::getInstance().info("EnergyTask: Started (%lums tick, publish every %lums)",
+                               (unsigned long)sched.getPeriod(SchedTask::ENERGY),
+                               (unsigned long)sched.getReadIntervalMs());
     EnergyMeter& meter = EnergyMeter::getInstance();
     EventBus& eventBus = EventBus::getInstance();
     
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    const TickType_t interval = pdMS_TO_TICKS(500);
+    PerfMonitor& perf = PerfMonitor::getInstance();
     
     while (true) {
+        perf.record(PERF_ENERGY_WAKE, sched.waitForRelease(SchedTask::ENERGY));
+        
+        // The tick follows the FAST register group; slower groups are skipped
+        // inside the driver until they are due.
         if (meter.update()) {
-            MeterData data = meter.getSnapshot();
-            DataLogger::getInstance().logReading(data);
-            eventBus.publish(EventType::METER_DATA_UPDATED, &data, sizeof(data));
+            if (sched.isDue(SchedTask::ENERGY, sched.getReadIntervalMs())) {
+                // Snapshot built in place in a pool block: the topic value is never copied
+                EventRef value = eventBus.allocate(EventType::METER_DATA_UPDATED, sizeof(MeterData));
+                if (value) {
+                    const MeterData* data = new (value.data()) MeterData(meter.getSnapshot());
+                    DataLogger::getInstance().logReading(*data);
+                    eventBus.publish(EventType::METER_DATA_UPDATED, value);
+                } else {
+                    DataLogger::getInstance().logReading(meter.getSnapshot());
+                }
+            }
+        }
+        sched.complete(SchedTask::ENERGY);
+    }
+}
+
+void TaskManager::eventTaskFunc(void* param) {
+    Logger::getInstance().info("EventTask: Started (notified)");
+    EventBus& eventBus = EventBus::getInstance();
+
+    while (true) {
+        // Woken by every publish; callbacks run here, without any EventBus lock held
+        eventBus.dispatch(EVENT_IDLE_MS);
+    }
+}
+
+void TaskManager::fastPowerTaskFunc(void* param) {
+    FastPowerSampler& sampler = FastPowerSampler::getInstance();
+    Logger::getInstance().info("FastPowerTask: Started (%lums)", (unsigned long)sampler.getIntervalMs());
+
+    PerfMonitor& perf = PerfMonitor::getInstance();
+    PerfWakeProbe wake;
+
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    wake.start();
+    while (true) {
+        if (sampler.isEnabled()) {
+            sampler.sample();
         }
+        TickType_t interval = pdMS_TO_TICKS(sampler.getIntervalMs());
+        if (interval == 0) interval = 1;
         vTaskDelayUntil(&lastWakeTime, interval);
+        perf.record(PERF_FAST_POWER_WAKE, wake.lateUs(interval));
+    }
+}
+
+void TaskManager::loadShedTaskFunc(void* param) {
+    Logger::getInstance().info("LoadShedTask: Started");
+    FastPowerSampler& sampler = FastPowerSampler::getInstance();
+    LoadShedController& shed = LoadShedController::getInstance();
+
+    while (true) {
+        // Woken by each queued sample; the timeout only covers fast power being switched off
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOAD_SHED_IDLE_MS));
+
+        PowerSample sample;
+        while (sampler.pop(sample)) {
+            shed.process(sample);
+        }
+        if (!sampler.isEnabled() && shed.isShedding()) {
+            shed.release();
+        }
+    }
+}
+
+void TaskManager::powerQualityTaskFunc(void* param) {
+    Logger::getInstance().info("PowerQualityTask: Started (IRQ notified, %lums fallback)",
+                               (unsigned long)POWER_QUALITY_FALLBACK_MS);
+    ATM90E36Driver& driver = ATM90E36Driver::getInstance();
+    GPIOManager& gpio = GPIOManager::getInstance();
+    EventBus& eventBus = EventBus::getInstance();
+    HarmonicSweep& sweep = HarmonicSweep::getInstance();
+
+    while (true) {
+        const bool notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POWER_QUALITY_FALLBACK_MS)) > 0;
+
+        PowerQualityEvent evt;
+        evt.source = PQ_SOURCE_POLL;
+        if (gpio.isInitialized()) {
+            // Active-low inputs; reading Port B also re-arms INTB
+            const uint8_t port = gpio.readStatusInputs();
+            if (port != 0xFF) {
+                if (!(port & (1U << MCP_PORTB_IRQ_1)))    evt.source |= PQ_SOURCE_IRQ0;
+                if (!(port & (1U << MCP_PORTB_IRQ_2)))    evt.source |= PQ_SOURCE_IRQ1;
+                if (!(port & (1U << MCP_PORTB_ATM_WARN))) evt.source |= PQ_SOURCE_WARN;
+            }
+        }
+        if (notified) {
+            evt.source &= (uint8_t)~PQ_SOURCE_POLL;
+            evt.irqMicros = gpio.getLastStatusIrqMicros();
+        }
+
+        if (driver.readPowerQuality(evt)) {
+            Logger::getInstance().warn("PQ event: SYS0=0x%04X SYS1=0x%04X EN1=0x%04X sag=%u loss=%u src=0x%02X",
+                                       evt.sysStatus0, evt.sysStatus1, evt.enStatus1,
+                                       evt.sagPhases, evt.phaseLossPhases, evt.source);
+            // Copied once into a pool block; the bus sends it on the URGENT lane
+            EventRef payload = eventBus.allocate(EventType::POWER_QUALITY_EVENT, sizeof(evt));
+            if (payload) {
+                new (payload.data()) PowerQualityEvent(evt);
+                eventBus.publish(EventType::POWER_QUALITY_EVENT, payload);
+            }
+        }
+
+        // readPowerQuality() has just latched DFTDone, if the wake-up was for it.
+        sweep.service();
     }
 }
 
 void TaskManager::accumulatorTaskFunc(void* param) {
-    Logger::getInstance().info("AccumulatorTask: Started (1000ms interval)");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    Logger::getInstance().info("AccumulatorTask: Started (%lums interval)",
+                               (unsigned long)sched.getPeriod(SchedTask::ACCUMULATOR));
     EnergyAccumulator& accumulator = EnergyAccumulator::getInstance();
     EnergyMeter& meter = EnergyMeter::getInstance();
     
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    const TickType_t interval = pdMS_TO_TICKS(1000);
-    
-    uint32_t autoSaveCounter = 0;
-    const uint32_t AUTO_SAVE_INTERVAL = 300;  // Save every 5 minutes
+    RawMeterFrame frame;
     
+    // Persistence (journal + NVS) is scheduled inside EnergyAccumulator::update()
     while (true) {
+        sched.waitForRelease(SchedTask::ACCUMULATOR);
+        // Pulse counters first: they are the reported register unless configured otherwise
+        if (meter.getRawFrame(frame)) {
+            accumulator.updateCounters(frame);
+        }
         MeterData data = meter.getSnapshot();
         accumulator.update(data);
-        
-        autoSaveCounter++;
-        if (autoSaveCounter >= AUTO_SAVE_INTERVAL) {
-            accumulator.saveToNVS();
-            autoSaveCounter = 0;
-        }
-        vTaskDelayUntil(&lastWakeTime, interval);
+        sched.complete(SchedTask::ACCUMULATOR);
     }
 }
 
 void TaskManager::modbusTaskFunc(void* param) {
-    Logger::getInstance().info("ModbusTask: Started (10ms poll)");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    Logger::getInstance().info("ModbusTask: Started (%lums poll, registers every %lums)",
+                               (unsigned long)sched.getPeriod(SchedTask::MODBUS),
+                               (unsigned long)sched.getReadIntervalMs());
     ModbusServer& modbus = ModbusServer::getInstance();
     EnergyMeter& meter = EnergyMeter::getInstance();
-    
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    const TickType_t interval = pdMS_TO_TICKS(50);
-    
-    uint32_t updateCounter = 0;
-    const uint32_t UPDATE_INTERVAL = 50;  // Update every 500ms
+    HarmonicAnalyzer& harmonics = HarmonicAnalyzer::getInstance();
+    PerfMonitor& perf = PerfMonitor::getInstance();
+    uint32_t harmonicSeq = 0;
+    uint32_t meterDeltaSeq = 0;     // 0: first pass writes every register
     
     while (true) {
+        sched.waitForRelease(SchedTask::MODBUS);
         modbus.handle();
         
-        updateCounter++;
-        if (updateCounter >= UPDATE_INTERVAL) {
-            MeterData data = meter.getSnapshot();
-            modbus.updateMeterData(data);
-            updateCounter = 0;
+        // Register image refreshed at the reading cadence
+        if (sched.isDue(SchedTask::MODBUS, sched.getReadIntervalMs())) {
+            MeterData data;
+            MeterFieldMask changed;
+            meterDeltaSeq = meter.getSnapshotDelta(meterDeltaSeq, data, changed);
+            modbus.updateMeterData(data, changed);
+            RawMeterFrame frame;
+            if (meter.getRawFrame(frame)) {
+                modbus.updateRawFrame(frame);
+            }
+            for (uint8_t m = 0; m < PERF_METRIC_COUNT; m++) {
+                PerfHistogramSnapshot snap;
+                perf.read(m, snap);
+                modbus.updatePerfHistogram(m, snap);
+            }
+            if (harmonics.getSequence() != harmonicSeq) {
+                HarmonicData hd;
+                if (harmonics.getLatest(hd)) {
+                    modbus.updateHarmonics(hd);
+                }
+                harmonicSeq = harmonics.getSequence();
+            }
         }
-        vTaskDelayUntil(&lastWakeTime, interval);
+        sched.complete(SchedTask::MODBUS);
     }
 }
 
@@ -347,16 +621,24 @@ void TaskManager::modbusTaskFunc(void* param) {
 
 
 void TaskManager::tcpServerTaskFunc(void* param) {
-    Logger::getInstance().info("TCPServerTask: Started (20ms poll)");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    Logger::getInstance().info("TCPServerTask: Started (%lums poll)",
+                               (unsigned long)sched.getPeriod(SchedTask::TCP_SERVER));
     TCPDataServer& server = TCPDataServer::getInstance();
 
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    const TickType_t interval = pdMS_TO_TICKS(20);
-
     while (true) {
+        sched.waitForRelease(SchedTask::TCP_SERVER);
         // handle() is safe even if begin() wasn't called; it will just do nothing.
         server.handle();
-        vTaskDelayUntil(&lastWakeTime, interval);
+        sched.complete(SchedTask::TCP_SERVER);
+    }
+}
+
+void TaskManager::onConfigChanged(EventType type, void* data) {
+    // EventTask context; the scheduled tasks pick up new periods on their next release
+    SystemConfig sysCfg;
+    if (ConfigManager::getInstance().loadSystemConfig(sysCfg)) {
+        TaskScheduler::getInstance().applyConfig(sysCfg);
     }
 }
 
@@ -390,6 +672,27 @@ void TaskManager::dhtTaskFunc(void* param) {
     }
 }
 
+void TaskManager::harmonicTaskFunc(void* param) {
+    Logger::getInstance().info("HarmonicTask: Started (%lums interval)", (unsigned long)HarmonicAnalyzer::ANALYSIS_INTERVAL_MS);
+    HarmonicAnalyzer& analyzer = HarmonicAnalyzer::getInstance();
+
+    // Let the meter settle so the RMS/frequency references are valid.
+    vTaskDelay(pdMS_TO_TICKS(10000));
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    const TickType_t interval = pdMS_TO_TICKS(HarmonicAnalyzer::ANALYSIS_INTERVAL_MS);
+
+    while (true) {
+        if (analyzer.update()) {
+            MQTTPublisher& mqtt = MQTTPublisher::getInstance();
+            HarmonicData data;
+            if (mqtt.isConnected() && analyzer.getLatest(data)) {
+                mqtt.publishHarmonics(data);
+            }
+        }
+        vTaskDelayUntil(&lastWakeTime, interval);
+    }
+}
+
 void TaskManager::mqttTaskFunc(void* param) {
     // Placeholder to keep API compatibility; MQTT can be added/enabled later.
     Logger::getInstance().info("MQTTTask: Started (disabled stub)");
@@ -398,12 +701,70 @@ void TaskManager::mqttTaskFunc(void* param) {
     }
 }
 
+void TaskManager::logSchedulerStats() {
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    for (uint8_t t = 0; t < (uint8_t)SchedTask::COUNT; t++) {
+        const TaskScheduleStats s = sched.getStats((SchedTask)t);
+        Logger::getInstance().info("Sched %s: %lums@+%lums, %lu releases, %lu skipped, %lu/%lums deadline misses (worst %luus, WCET %luus)",
+                                   TaskScheduler::taskName((SchedTask)t),
+                                   (unsigned long)s.periodMs, (unsigned long)s.phaseMs,
+                                   (unsigned long)s.releases, (unsigned long)s.skipped,
+                                   (unsigned long)s.deadlineMisses, (unsigned long)s.deadlineMs,
+                                   (unsigned long)s.maxResponseUs, (unsigned long)s.maxExecUs);
+    }
+}
+
+void TaskManager::logTaskStats() {
+    TaskMonitor& monitor = TaskMonitor::getInstance();
+    const CpuLoadStats load = monitor.getCpuLoad();
+    if (load.runTimeStats) {
+        Logger::getInstance().info("CPU load over %lums: core0 %.1f%% core1 %.1f%%",
+                                   (unsigned long)load.windowMs, load.corePct[0],
+                                   (load.cores > 1) ? load.corePct[1] : -1.0f);
+    }
+
+    static TaskRuntimeStats tasks[TaskMonitor::MAX_TASKS];
+    const uint8_t n = monitor.getTasks(tasks, TaskMonitor::MAX_TASKS);
+    for (uint8_t i = 0; i < n; i++) {
+        const TaskRuntimeStats& t = tasks[i];
+        if (t.stackFreeMin < TaskMonitor::STACK_LOW_BYTES) {
+            Logger::getInstance().warn("Task %s: stack %lu/%lu bytes free at worst",
+                                       t.name, (unsigned long)t.stackFreeMin, (unsigned long)t.stackSize);
+        }
+        Logger::getInstance().info("Task %s: core %d prio %u cpu %.1f%% stack free %lu/%lu",
+                                   t.name, (int)t.core, (unsigned)t.priority, t.cpuPct,
+                                   (unsigned long)t.stackFreeMin, (unsigned long)t.stackSize);
+    }
+}
+
+void TaskManager::logEventBusStats() {
+    EventBus& eventBus = EventBus::getInstance();
+    const EventPoolStats pool = eventBus.getPoolStats();
+    Logger::getInstance().info("EventBus: pool %u/%u blocks in use (max %u)",
+                               (unsigned)pool.inUse, (unsigned)pool.blocks, (unsigned)pool.maxInUse);
+
+    // Only subscribers that have been slow at least once
+    static EventSubscriberStats subs[EventBus::MAX_EVENT_TYPES * 2];
+    const uint8_t n = eventBus.getSubscriberStats(subs, sizeof(subs) / sizeof(subs[0]));
+    for (uint8_t i = 0; i < n; i++) {
+        if (subs[i].slowCalls == 0) continue;
+        Logger::getInstance().warn("EventBus: subscriber %p on event %d slow %lu/%lu calls (max %luus, mean %luus)",
+                                   (void*)subs[i].callback, (int)subs[i].type,
+                                   (unsigned long)subs[i].slowCalls, (unsigned long)subs[i].calls,
+                                   (unsigned long)subs[i].maxUs,
+                                   (unsigned long)(subs[i].totalUs / subs[i].calls));
+    }
+}
+
 void TaskManager::diagnosticsTaskFunc(void* param) {
     Logger::getInstance().info("DiagnosticsTask: Started (5000ms interval)");
     TickType_t lastWakeTime = xTaskGetTickCount();
     const TickType_t interval = pdMS_TO_TICKS(5000);
     
     while (true) {
+        // CPU shares cover the time since the previous pass
+        TaskMonitor::getInstance().sample();
+
         uint32_t freeHeap = ESP.getFreeHeap();
         uint32_t minFreeHeap = ESP.getMinFreeHeap();
         
@@ -412,6 +773,26 @@ void TaskManager::diagnosticsTaskFunc(void* param) {
         if (nowMs - lastLogMs > 60000) {
             lastLogMs = nowMs;
             Logger::getInstance().info("Heap: %u bytes free (min: %u)", freeHeap, minFreeHeap);
+            Logger::getInstance().info("ATM90E36 sweep: %lu us (%u regs, %lu sweeps, %lu 32-bit retries)",
+                                       (unsigned long)ATM90E36Driver::getInstance().getLastSweepMicros(),
+                                       (unsigned)ATM90E36Driver::SWEEP_REG_COUNT,
+                                       (unsigned long)ATM90E36Driver::getInstance().getSweepCount(),
+                                       (unsigned long)ATM90E36Driver::getInstance().getRead32Retries());
+            Logger::getInstance().info("ATM90E36 SPI: %lu Hz (%lu link faults, %lu energy reads dropped)",
+                                       (unsigned long)ATM90E36Driver::getInstance().getSpiClock(),
+                                       (unsigned long)ATM90E36Driver::getInstance().getSpiFaultCount(),
+                                       (unsigned long)ATM90E36Driver::getInstance().getEnergyReadsDropped());
+            Logger::getInstance().info("ATM90E36 PQ: %lu events (%lu IRQ edges)",
+                                       (unsigned long)ATM90E36Driver::getInstance().getPowerQualityEventCount(),
+                                       (unsigned long)GPIOManager::getInstance().getStatusIrqCount());
+            const SnapshotStats snap = EnergyMeter::getInstance().getSnapshotStats();
+            Logger::getInstance().info("Meter snapshot: %lu reads, %lu writes, %lu torn-read retries (worst %lu)",
+                                       (unsigned long)snap.reads, (unsigned long)snap.writes,
+                                       (unsigned long)snap.retries, (unsigned long)snap.maxRetries);
+            const AcquisitionTiming timing = EnergyMeter::getInstance().getAcquisitionTiming();
+            Logger::getInstance().info("Meter timing: FAST interval last=%luus min=%luus max=%luus (%lu intervals)",
+                                       (unsigned long)timing.lastIntervalUs, (unsigned long)timing.minIntervalUs,
+                                       (unsigned long)timing.maxIntervalUs, (unsigned long)timing.intervals);
             auto dht = DHTSensorManager::getInstance().getSnapshot();
             Logger::getInstance().info("DHT22 status: en=%s valid=%s T=%.1fC RH=%.1f%% ok=%lu fail=%lu age=%lums",
                                        dht.enabled ? "Y" : "N",
@@ -420,6 +801,9 @@ void TaskManager::diagnosticsTaskFunc(void* param) {
                                        (unsigned long)dht.successCount,
                                        (unsigned long)dht.failCount,
                                        (unsigned long)(dht.lastGoodReadMs ? (millis() - dht.lastGoodReadMs) : 0));
+            logSchedulerStats();
+            logTaskStats();
+            logEventBusStats();
         }
         
         if (freeHeap < 10000) {
@@ -7,11 +7,20 @@
  * 
  * Task Architecture:
  * Core 1 (Energy & Modbus):
- *   - EnergyTask: Read ATM90E36, update meter (500ms, P5)
- *   - AccumulatorTask: Update energy accumulator, auto-save (1000ms, P4)
+ *   - FastPowerTask: PmeanA/B/C/T every 20-50ms into an SPSC ring (fast power mode only, P7)
+ *   - LoadShedTask: Drains the ring, relay load shedding (notified, fast power mode only, P6)
+ *   - PowerQualityTask: ATM90E36 IRQ/WarnOut status events, hardware DFT sweep (notified, P6)
+ *   - EnergyTask: Read ATM90E36 (FAST group, 100ms), publish every readInterval (P5)
+ *   - AccumulatorTask: Update energy accumulator, journal (publishInterval, 1s default, P4)
+ *   - ModbusTask: RTU/TCP poll (50ms), registers refreshed every readInterval (P3)
+ *
+ * EnergyTask, ModbusTask, TCPServerTask and AccumulatorTask are released by
+ * TaskScheduler on staggered phases (see *_PHASE_MS).
  * 
  * Core 0 (Communications & Diagnostics):
+ *   - EventTask: EventBus dispatcher, runs all subscriber callbacks (notified, P3)
  *   - DiagnosticsTask: System monitoring, logging (5000ms, P1)
+ *   - HarmonicTask: Waveform capture + FFT harmonic analysis (60s, P1)
  */
 
 #ifndef TASKMANAGER_H
@@ -34,6 +43,7 @@ public:
     bool isRunning() const { return _tasksRunning; }
     
     TaskHandle_t getEnergyTaskHandle() const { return _energyTask; }
+    TaskHandle_t getPowerQualityTaskHandle() const { return _powerQualityTask; }
     TaskHandle_t getAccumulatorTaskHandle() const { return _accumulatorTask; }
     TaskHandle_t getModbusTaskHandle() const { return _modbusTask; }
     TaskHandle_t getTCPServerTaskHandle() const { return _tcpServerTask; }
@@ -41,8 +51,12 @@ public:
     bool isTCPServerTaskRunning() const { return _tcpServerTask != nullptr; }
     TaskHandle_t getDiagnosticsTaskHandle() const { return _diagnosticsTask; }
     TaskHandle_t getDHTTaskHandle() const { return _dhtTask; }
+    TaskHandle_t getHarmonicTaskHandle() const { return _harmonicTask; }
     TaskHandle_t getWebUITaskHandle() const { return _webUiTask; }
     bool isWebUITaskRunning() const { return _webUiTask != nullptr; }
+    TaskHandle_t getFastPowerTaskHandle() const { return _fastPowerTask; }
+    TaskHandle_t getLoadShedTaskHandle() const { return _loadShedTask; }
+    TaskHandle_t getEventTaskHandle() const { return _eventTask; }
     
 private:
     TaskManager();
@@ -51,22 +65,37 @@ private:
     TaskManager& operator=(const TaskManager&) = delete;
     
     static void energyTaskFunc(void* param);
+    static void powerQualityTaskFunc(void* param);
     static void accumulatorTaskFunc(void* param);
     static void modbusTaskFunc(void* param);
     static void tcpServerTaskFunc(void* param);
     static void mqttTaskFunc(void* param);
     static void diagnosticsTaskFunc(void* param);
     static void dhtTaskFunc(void* param);
+    static void harmonicTaskFunc(void* param);
     static void webUiTaskFunc(void* param);
+    static void fastPowerTaskFunc(void* param);
+    static void loadShedTaskFunc(void* param);
+    static void eventTaskFunc(void* param);
+    
+    static void onConfigChanged(EventType type, void* data);
+    static void logSchedulerStats();
+    static void logTaskStats();
+    static void logEventBusStats();
     
     TaskHandle_t _energyTask;
+    TaskHandle_t _powerQualityTask;
     TaskHandle_t _accumulatorTask;
     TaskHandle_t _modbusTask;
     TaskHandle_t _tcpServerTask;
     TaskHandle_t _mqttTask;
     TaskHandle_t _diagnosticsTask;
     TaskHandle_t _dhtTask;
+    TaskHandle_t _harmonicTask;
     TaskHandle_t _webUiTask;
+    TaskHandle_t _fastPowerTask;
+    TaskHandle_t _loadShedTask;
+    TaskHandle_t _eventTask;
     
     bool _tasksRunning;
     // NOTE: Synchronous WebServer can block during SPIFFS file streaming; running it in a dedicated Core0 task
@@ -76,15 +105,23 @@ private:
     
     // Stack sizes (bytes)
     static constexpr uint32_t ENERGY_STACK_SIZE = 4096;
+    static constexpr uint32_t POWER_QUALITY_STACK_SIZE = 3072;
     static constexpr uint32_t ACCUMULATOR_STACK_SIZE = 4096;
     static constexpr uint32_t MODBUS_STACK_SIZE = 4096;
     static constexpr uint32_t TCP_SERVER_STACK_SIZE = 4096;
     static constexpr uint32_t MQTT_STACK_SIZE = 4096;
     static constexpr uint32_t DIAGNOSTICS_STACK_SIZE = 3072;
     static constexpr uint32_t DHT_STACK_SIZE = 3072;
+    static constexpr uint32_t HARMONIC_STACK_SIZE = 4096;
     static constexpr uint32_t WEBUI_STACK_SIZE = 4096;
+    static constexpr uint32_t FAST_POWER_STACK_SIZE = 2560;
+    static constexpr uint32_t LOAD_SHED_STACK_SIZE = 3072;
+    static constexpr uint32_t EVENT_STACK_SIZE = 4096;      // Subscriber callbacks run on it
     
     // Task priorities (higher = more important)
+    static constexpr UBaseType_t FAST_POWER_PRIORITY = 7;    // Short SPI batch, must not slip behind the sweep
+    static constexpr UBaseType_t LOAD_SHED_PRIORITY = 6;
+    static constexpr UBaseType_t POWER_QUALITY_PRIORITY = 6;
     static constexpr UBaseType_t ENERGY_PRIORITY = 5;
     static constexpr UBaseType_t ACCUMULATOR_PRIORITY = 4;
     static constexpr UBaseType_t MODBUS_PRIORITY = 3;
@@ -92,11 +129,37 @@ private:
     static constexpr UBaseType_t MQTT_PRIORITY = 2;
     static constexpr UBaseType_t DIAGNOSTICS_PRIORITY = 1;
     static constexpr UBaseType_t DHT_PRIORITY = 1;
+    static constexpr UBaseType_t HARMONIC_PRIORITY = 1;  // Below all comms tasks on Core 0
     static constexpr UBaseType_t WEBUI_PRIORITY = 2;
+    static constexpr UBaseType_t EVENT_PRIORITY = 3;     // Above the comms tasks it feeds
     
     // Core affinity (ESP32 dual-core)
     static constexpr BaseType_t CORE_0 = 0;  // Communications
     static constexpr BaseType_t CORE_1 = 1;  // Energy & Modbus
+
+    // TaskScheduler grid (ms). EnergyTask ticks at the FAST register-group period
+    // and publishes every readInterval; AccumulatorTask runs every publishInterval.
+    // Phases are chosen so no two of these tasks are ever released on the same tick.
+    static constexpr uint32_t ENERGY_PHASE_MS = 0;
+    static constexpr uint32_t ENERGY_DEADLINE_MS = 50;
+    static constexpr uint32_t TCP_SERVER_PERIOD_MS = 20;
+    static constexpr uint32_t TCP_SERVER_PHASE_MS = 10;
+    static constexpr uint32_t TCP_SERVER_DEADLINE_MS = 20;
+    static constexpr uint32_t MODBUS_PERIOD_MS = 50;
+    static constexpr uint32_t MODBUS_PHASE_MS = 25;
+    static constexpr uint32_t MODBUS_DEADLINE_MS = 25;
+    static constexpr uint32_t ACCUMULATOR_PHASE_MS = 60;
+    static constexpr uint32_t ACCUMULATOR_DEADLINE_MS = 500;
+
+    // PowerQualityTask wakes on the MCP23017 INTB notification; without an edge it
+    // still polls the latched status at this period (MCP missing or edge lost).
+    static constexpr uint32_t POWER_QUALITY_FALLBACK_MS = 1000;
+
+    // LoadShedTask wake-up without samples (fast power switched off at runtime)
+    static constexpr uint32_t LOAD_SHED_IDLE_MS = 500;
+
+    // EventTask wake-up without a publish
+    static constexpr uint32_t EVENT_IDLE_MS = 1000;
 };
 
 #endif // TASKMANAGER_H
\ No newline at end of file
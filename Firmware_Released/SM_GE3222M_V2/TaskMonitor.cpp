@@ -0,0 +1,265 @@
+/**
+ * SM-GE3222M V2.0 - Task Monitor Implementation
+ */
+
+#include "TaskMonitor.h"
+#include "Logger.h"
+#include <esp_timer.h>
+#include <esp_idf_version.h>
+
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+#define TASKMONITOR_RUN_TIME_STATS 1
+#else
+#define TASKMONITOR_RUN_TIME_STATS 0
+#endif
+
+namespace {
+
+constexpr uint8_t MAX_CORES = sizeof(CpuLoadStats::corePct) / sizeof(CpuLoadStats::corePct[0]);
+constexpr uint8_t CORE_COUNT = (portNUM_PROCESSORS < MAX_CORES) ? portNUM_PROCESSORS : MAX_CORES;
+
+#if TASKMONITOR_RUN_TIME_STATS
+#ifdef configRUN_TIME_COUNTER_TYPE
+typedef configRUN_TIME_COUNTER_TYPE RunTimeCounter;
+#else
+typedef uint32_t RunTimeCounter;
+#endif
+
+// All tasks in the system (WiFi, lwIP, IPC, idle...), filled by the DiagnosticsTask only
+constexpr UBaseType_t MAX_SYSTEM_TASKS = 40;
+TaskStatus_t s_status[MAX_SYSTEM_TASKS];
+
+TaskHandle_t idleTaskForCore(uint8_t core) {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    return xTaskGetIdleTaskHandleForCore(core);
+#else
+    return xTaskGetIdleTaskHandleForCPU(core);
+#endif
+}
+
+const TaskStatus_t* findStatus(TaskHandle_t handle, UBaseType_t n) {
+    for (UBaseType_t i = 0; i < n; i++) {
+        if (s_status[i].xHandle == handle) return &s_status[i];
+    }
+    return nullptr;
+}
+#endif
+
+} // namespace
+
+TaskMonitor& TaskMonitor::getInstance() {
+    static TaskMonitor instance;
+    return instance;
+}
+
+TaskMonitor::TaskMonitor()
+    : m_count(0)
+    , m_lastSampleUs(0)
+    , m_lastTotalRunTime(0)
+{
+    memset(m_tasks, 0, sizeof(m_tasks));
+    memset(&m_load, 0, sizeof(m_load));
+    memset(m_lastIdleRunTime, 0, sizeof(m_lastIdleRunTime));
+    memset(m_lastExecUs, 0, sizeof(m_lastExecUs));
+    m_load.cores = CORE_COUNT;
+    for (uint8_t c = 0; c < MAX_CORES; c++) {
+        m_load.corePct[c] = -1.0f;
+    }
+    m_load.runTimeStats = TASKMONITOR_RUN_TIME_STATS;
+    m_mutex = xSemaphoreCreateMutex();
+}
+
+void TaskMonitor::track(TaskHandle_t handle, const char* name, uint32_t stackSize,
+                        UBaseType_t priority, BaseType_t core) {
+    if (handle == nullptr || name == nullptr) return;
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        Logger::getInstance().warn("TaskMonitor: %s not tracked (busy)", name);
+        return;
+    }
+
+    if (m_count >= MAX_TASKS) {
+        xSemaphoreGive(m_mutex);
+        Logger::getInstance().warn("TaskMonitor: %s not tracked (%u tasks max)", name, (unsigned)MAX_TASKS);
+        return;
+    }
+
+    Entry& e = m_tasks[m_count++];
+    memset(&e, 0, sizeof(e));
+    e.handle = handle;
+    e.name = name;
+    e.core = (core == tskNO_AFFINITY) ? -1 : (int8_t)core;
+    e.priority = (uint8_t)priority;
+    e.stackSize = stackSize;
+    e.stackFreeMin = stackSize;
+    e.cpuPct = -1.0f;
+    e.sched = -1;
+    for (uint8_t t = 0; t < (uint8_t)SchedTask::COUNT; t++) {
+        if (strcmp(TaskScheduler::taskName((SchedTask)t), name) == 0) {
+            e.sched = (int8_t)t;
+            break;
+        }
+    }
+    xSemaphoreGive(m_mutex);
+}
+
+void TaskMonitor::untrack(TaskHandle_t handle) {
+    if (handle == nullptr) return;
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) != pdTRUE) return;
+    for (uint8_t i = 0; i < m_count; i++) {
+        if (m_tasks[i].handle == handle) {
+            memmove(&m_tasks[i], &m_tasks[i + 1], sizeof(Entry) * (m_count - i - 1));
+            m_count--;
+            break;
+        }
+    }
+    xSemaphoreGive(m_mutex);
+}
+
+void TaskMonitor::clear() {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) != pdTRUE) return;
+    m_count = 0;
+    xSemaphoreGive(m_mutex);
+}
+
+void TaskMonitor::sample() {
+    // Worked on outside the mutex; uxTaskGetSystemState() suspends the scheduler
+    static Entry tasks[MAX_TASKS];
+    uint8_t count = 0;
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+    count = m_count;
+    memcpy(tasks, m_tasks, sizeof(Entry) * count);
+    for (uint8_t i = 0; i < count; i++) {
+        // Taken under the mutex: untrack()/clear() run before TaskManager deletes a task.
+        // ESP-IDF stacks are counted in bytes.
+        tasks[i].stackFreeMin = (uint32_t)uxTaskGetStackHighWaterMark(tasks[i].handle);
+    }
+    xSemaphoreGive(m_mutex);
+
+    const int64_t nowUs = esp_timer_get_time();
+    const int64_t windowUs = (m_lastSampleUs == 0) ? 0 : nowUs - m_lastSampleUs;
+    m_lastSampleUs = nowUs;
+
+    CpuLoadStats load = m_load;
+    if (!sampleRunTime(tasks, count, load)) {
+        sampleExecTime(tasks, count, windowUs);
+    }
+    load.windowMs = (uint32_t)(windowUs / 1000);
+    load.samples++;
+
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+    // Tasks tracked, untracked or cleared meanwhile keep their entry as it is
+    for (uint8_t i = 0; i < count && i < m_count; i++) {
+        if (m_tasks[i].handle == tasks[i].handle) {
+            m_tasks[i] = tasks[i];
+        }
+    }
+    m_load = load;
+    xSemaphoreGive(m_mutex);
+}
+
+bool TaskMonitor::sampleRunTime(Entry* tasks, uint8_t count, CpuLoadStats& load) {
+#if TASKMONITOR_RUN_TIME_STATS
+    RunTimeCounter total = 0;
+    const UBaseType_t n = uxTaskGetSystemState(s_status, MAX_SYSTEM_TASKS, &total);
+    if (n == 0) {
+        Logger::getInstance().warn("TaskMonitor: more than %u tasks, CPU not sampled", (unsigned)MAX_SYSTEM_TASKS);
+        return false;
+    }
+
+    // Counters are per task and wrap; each core accrues one window of run time
+    const bool first = (load.samples == 0);
+    const RunTimeCounter window = total - (RunTimeCounter)m_lastTotalRunTime;
+    m_lastTotalRunTime = total;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const TaskStatus_t* st = findStatus(tasks[i].handle, n);
+        if (st == nullptr) {
+            tasks[i].cpuPct = -1.0f;
+            continue;
+        }
+        const RunTimeCounter used = st->ulRunTimeCounter - (RunTimeCounter)tasks[i].lastRunTime;
+        tasks[i].cpuPct = (tasks[i].hasRunTime && !first && window > 0) ? (float)used * 100.0f / (float)window : -1.0f;
+        tasks[i].lastRunTime = st->ulRunTimeCounter;
+        tasks[i].hasRunTime = true;
+    }
+
+    for (uint8_t c = 0; c < CORE_COUNT; c++) {
+        const TaskStatus_t* idle = findStatus(idleTaskForCore(c), n);
+        if (idle == nullptr) {
+            load.corePct[c] = -1.0f;
+            continue;
+        }
+        const RunTimeCounter idleUsed = idle->ulRunTimeCounter - (RunTimeCounter)m_lastIdleRunTime[c];
+        m_lastIdleRunTime[c] = idle->ulRunTimeCounter;
+        if (first || window == 0) {
+            load.corePct[c] = -1.0f;
+        } else {
+            const float busy = 100.0f - (float)idleUsed * 100.0f / (float)window;
+            load.corePct[c] = (busy < 0.0f) ? 0.0f : busy;
+        }
+    }
+    return true;
+#else
+    (void)tasks;
+    (void)count;
+    (void)load;
+    return false;
+#endif
+}
+
+void TaskMonitor::sampleExecTime(Entry* tasks, uint8_t count, int64_t windowUs) {
+    // Wake-up to complete() of each release, so time preempted by other tasks counts too
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    uint64_t execUs[(uint8_t)SchedTask::COUNT];
+    for (uint8_t t = 0; t < (uint8_t)SchedTask::COUNT; t++) {
+        execUs[t] = sched.getStats((SchedTask)t).totalExecUs;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        const int8_t t = tasks[i].sched;
+        tasks[i].cpuPct = (t >= 0 && windowUs > 0)
+            ? (float)(execUs[t] - m_lastExecUs[t]) * 100.0f / (float)windowUs
+            : -1.0f;
+    }
+    memcpy(m_lastExecUs, execUs, sizeof(m_lastExecUs));
+}
+
+uint8_t TaskMonitor::getTasks(TaskRuntimeStats* out, uint8_t maxEntries) const {
+    if (out == nullptr || maxEntries == 0) return 0;
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return 0;
+
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < m_count && n < maxEntries; i++) {
+        const Entry& e = m_tasks[i];
+        TaskRuntimeStats& s = out[n++];
+        memset(&s, 0, sizeof(s));
+        s.name = e.name;
+        s.core = e.core;
+        s.priority = e.priority;
+        s.stackSize = e.stackSize;
+        s.stackFreeMin = e.stackFreeMin;
+        s.cpuPct = e.cpuPct;
+        s.scheduled = (e.sched >= 0);
+        if (s.scheduled) {
+            s.schedule = TaskScheduler::getInstance().getStats((SchedTask)e.sched);
+        }
+    }
+    xSemaphoreGive(m_mutex);
+    return n;
+}
+
+CpuLoadStats TaskMonitor::getCpuLoad() const {
+    CpuLoadStats load;
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        memset(&load, 0, sizeof(load));
+        load.cores = CORE_COUNT;
+        for (uint8_t c = 0; c < MAX_CORES; c++) {
+            load.corePct[c] = -1.0f;
+        }
+        return load;
+    }
+    load = m_load;
+    xSemaphoreGive(m_mutex);
+    return load;
+}
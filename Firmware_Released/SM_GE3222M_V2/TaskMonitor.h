@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Task Monitor
+ *
+ * Runtime statistics of the tasks TaskManager creates, so priorities and
+ * stack sizes can be set from measurements. TaskManager registers every task
+ * it creates; the DiagnosticsTask calls sample() every few seconds and readers
+ * (/api/tasks, getTasks, LCD) copy the last sample.
+ *
+ * Features:
+ * - CPU share per task and load per core over the last sample window, from
+ *   the FreeRTOS run-time counters (configGENERATE_RUN_TIME_STATS). Without
+ *   them only the TaskScheduler tasks get a share (from their execution time)
+ *   and core load is unknown
+ * - Stack high-water mark per task
+ * - Releases, deadline misses, wake-up lateness and worst-case execution time
+ *   of the tasks released by TaskScheduler, matched by task name
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "TaskScheduler.h"
+
+struct TaskRuntimeStats {
+    const char* name;
+    int8_t core;                // -1 = not pinned
+    uint8_t priority;
+    uint32_t stackSize;         // Bytes
+    uint32_t stackFreeMin;      // High-water mark: fewest bytes ever left free
+    float cpuPct;               // Share of one core over the window, -1 = unknown
+    bool scheduled;             // Released by TaskScheduler; schedule is valid
+    TaskScheduleStats schedule;
+};
+
+struct CpuLoadStats {
+    uint8_t cores;
+    float corePct[2];           // Busy share per core, -1 = unknown
+    bool runTimeStats;          // Measured by the FreeRTOS run-time counters
+    uint32_t windowMs;          // Length of the last sample window
+    uint32_t samples;
+};
+
+class TaskMonitor {
+public:
+    static TaskMonitor& getInstance();
+
+    /**
+     * Register a task right after it was created
+     * @param core Core it is pinned to, or tskNO_AFFINITY
+     */
+    void track(TaskHandle_t handle, const char* name, uint32_t stackSize,
+               UBaseType_t priority, BaseType_t core);
+
+    /**
+     * Forget one task (before TaskManager deletes it)
+     */
+    void untrack(TaskHandle_t handle);
+
+    /**
+     * Forget all tasks (before TaskManager deletes them)
+     */
+    void clear();
+
+    /**
+     * Take a sample: CPU over the time since the previous call, stack marks
+     */
+    void sample();
+
+    /**
+     * Copy out the last sample; schedule statistics are read live
+     * @return Number of entries written (at most maxEntries)
+     */
+    uint8_t getTasks(TaskRuntimeStats* out, uint8_t maxEntries) const;
+    CpuLoadStats getCpuLoad() const;
+
+    static constexpr uint8_t MAX_TASKS = 16;
+    static constexpr uint32_t STACK_LOW_BYTES = 512;    // Logged as a warning below this
+
+private:
+    TaskMonitor();
+    ~TaskMonitor() = default;
+    TaskMonitor(const TaskMonitor&) = delete;
+    TaskMonitor& operator=(const TaskMonitor&) = delete;
+
+    struct Entry {
+        TaskHandle_t handle;
+        const char* name;
+        int8_t core;
+        uint8_t priority;
+        int8_t sched;               // SchedTask index, -1 = not scheduled
+        uint32_t stackSize;
+        uint32_t stackFreeMin;
+        float cpuPct;
+        uint64_t lastRunTime;       // Counter at the previous sample
+        bool hasRunTime;
+    };
+
+    bool sampleRunTime(Entry* tasks, uint8_t count, CpuLoadStats& load);
+    void sampleExecTime(Entry* tasks, uint8_t count, int64_t windowUs);
+
+    Entry m_tasks[MAX_TASKS];
+    uint8_t m_count;
+    CpuLoadStats m_load;
+    int64_t m_lastSampleUs;
+    uint64_t m_lastTotalRunTime;
+    uint64_t m_lastIdleRunTime[2];
+    uint64_t m_lastExecUs[(uint8_t)SchedTask::COUNT];
+    SemaphoreHandle_t m_mutex;
+};
@@ -0,0 +1,237 @@
+/**
+ * SM-GE3222M V2.0 - Task Scheduler Implementation
+ */
+
+#include "TaskScheduler.h"
+#include "Logger.h"
+#include <esp_timer.h>
+
+namespace {
+
+const char* const kTaskNames[(uint8_t)SchedTask::COUNT] = {
+    "EnergyTask", "ModbusTask", "TCPServerTask", "AccumulatorTask"
+};
+
+constexpr int64_t TICK_US = (int64_t)portTICK_PERIOD_MS * 1000;
+
+uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        const uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+} // namespace
+
+const char* TaskScheduler::taskName(SchedTask task) {
+    return (uint8_t)task < (uint8_t)SchedTask::COUNT ? kTaskNames[(uint8_t)task] : "";
+}
+
+TaskScheduler& TaskScheduler::getInstance() {
+    static TaskScheduler instance;
+    return instance;
+}
+
+TaskScheduler::TaskScheduler()
+    : m_readIntervalMs(500)
+{
+    for (uint8_t i = 0; i < (uint8_t)SchedTask::COUNT; i++) {
+        Entry& e = m_entries[i];
+        e.periodMs.store(0);
+        e.phaseMs = 0;
+        e.deadlineMs = 0;
+        e.registered = false;
+        e.owner = nullptr;
+        e.plannedPeriodMs = 0;
+        e.index = 0;
+        e.releaseUs = 0;
+        e.wakeUs = 0;
+        e.released = false;
+        memset(&e.stats, 0, sizeof(e.stats));
+    }
+}
+
+void TaskScheduler::registerTask(SchedTask task, uint32_t periodMs, uint32_t phaseMs, uint32_t deadlineMs) {
+    const uint8_t idx = (uint8_t)task;
+    if (idx >= (uint8_t)SchedTask::COUNT) return;
+
+    Entry& e = m_entries[idx];
+    if (periodMs < MIN_PERIOD_MS) periodMs = MIN_PERIOD_MS;
+    e.periodMs.store(periodMs);
+    e.phaseMs = phaseMs % periodMs;
+    e.deadlineMs = (deadlineMs == 0 || deadlineMs > periodMs) ? periodMs : deadlineMs;
+    e.registered = true;
+
+    Logger::getInstance().info("TaskScheduler: %s period %lums phase %lums deadline %lums",
+                               kTaskNames[idx], (unsigned long)periodMs,
+                               (unsigned long)e.phaseMs, (unsigned long)e.deadlineMs);
+    checkStagger(idx);
+}
+
+void TaskScheduler::setPeriod(SchedTask task, uint32_t periodMs) {
+    const uint8_t idx = (uint8_t)task;
+    if (idx >= (uint8_t)SchedTask::COUNT || !m_entries[idx].registered) return;
+
+    Entry& e = m_entries[idx];
+    if (periodMs < MIN_PERIOD_MS) periodMs = MIN_PERIOD_MS;
+    if (e.periodMs.exchange(periodMs) == periodMs) return;
+
+    Logger::getInstance().info("TaskScheduler: %s period now %lums", kTaskNames[idx], (unsigned long)periodMs);
+    checkStagger(idx);
+
+    // A task asleep on the old grid (up to an hour for the accumulator) re-plans now
+    if (e.owner != nullptr) {
+        xTaskNotifyGive(e.owner);
+    }
+}
+
+void TaskScheduler::applyConfig(const SystemConfig& config) {
+    // Readings can't be taken faster than the EnergyTask sweeps
+    uint32_t readMs = config.readInterval;
+    const uint32_t energyMs = getPeriod(SchedTask::ENERGY);
+    if (readMs < energyMs) readMs = energyMs;
+    if (readMs < MIN_PERIOD_MS) readMs = MIN_PERIOD_MS;
+    if (readMs > MAX_READ_INTERVAL_MS) readMs = MAX_READ_INTERVAL_MS;
+    m_readIntervalMs.store(readMs);
+
+    uint16_t publishSec = config.publishInterval;
+    if (publishSec < 1) publishSec = 1;
+    if (publishSec > MAX_PUBLISH_INTERVAL_SEC) publishSec = MAX_PUBLISH_INTERVAL_SEC;
+    setPeriod(SchedTask::ACCUMULATOR, (uint32_t)publishSec * 1000);
+
+    Logger::getInstance().info("TaskScheduler: read interval %lums, accumulator %us",
+                               (unsigned long)readMs, (unsigned)publishSec);
+}
+
+uint32_t TaskScheduler::waitForRelease(SchedTask task) {
+    const uint8_t idx = (uint8_t)task;
+    if (idx >= (uint8_t)SchedTask::COUNT || !m_entries[idx].registered) {
+        vTaskDelay(1);
+        return 0;
+    }
+
+    Entry& e = m_entries[idx];
+    if (e.owner == nullptr) {
+        e.owner = xTaskGetCurrentTaskHandle();
+    }
+
+    while (true) {
+        const uint32_t periodMs = e.periodMs.load();
+        const int64_t periodUs = (int64_t)periodMs * 1000;
+        const int64_t phaseUs = (int64_t)e.phaseMs * 1000;
+        const int64_t nowUs = esp_timer_get_time();
+
+        // First grid point at or after now
+        const uint64_t nowIndex = (nowUs <= phaseUs) ? 0 : (uint64_t)((nowUs - phaseUs + periodUs - 1) / periodUs);
+
+        uint64_t next = nowIndex;
+        if (e.released && e.plannedPeriodMs == periodMs) {
+            next = e.index + 1;
+            if (next < nowIndex) {
+                // Overran whole periods: resume on the grid rather than catching up
+                e.stats.skipped += (uint32_t)(nowIndex - next);
+                next = nowIndex;
+            }
+        }
+
+        const int64_t releaseUs = phaseUs + (int64_t)next * periodUs;
+        const int64_t remainingUs = releaseUs - nowUs;
+        if (remainingUs > TICK_US / 2) {
+            const TickType_t ticks = (TickType_t)((remainingUs + TICK_US / 2) / TICK_US);
+            if (ulTaskNotifyTake(pdTRUE, ticks) > 0) {
+                continue;       // Period changed: plan again on the new grid
+            }
+        }
+
+        e.index = next;
+        e.releaseUs = releaseUs;
+        e.plannedPeriodMs = periodMs;
+        e.released = true;
+        e.stats.releases++;
+
+        e.wakeUs = esp_timer_get_time();
+        const int64_t late = e.wakeUs - releaseUs;
+        const uint32_t lateUs = (late <= 0) ? 0 : (late > UINT32_MAX) ? UINT32_MAX : (uint32_t)late;
+        if (lateUs > e.stats.maxLateUs) {
+            e.stats.maxLateUs = lateUs;
+        }
+        return lateUs;
+    }
+}
+
+void TaskScheduler::complete(SchedTask task) {
+    const uint8_t idx = (uint8_t)task;
+    if (idx >= (uint8_t)SchedTask::COUNT || !m_entries[idx].released) return;
+
+    Entry& e = m_entries[idx];
+    const int64_t nowUs = esp_timer_get_time();
+    const int64_t response = nowUs - e.releaseUs;
+    const uint32_t responseUs = (response <= 0) ? 0 : (response > UINT32_MAX) ? UINT32_MAX : (uint32_t)response;
+    e.stats.lastResponseUs = responseUs;
+    if (responseUs > e.stats.maxResponseUs) {
+        e.stats.maxResponseUs = responseUs;
+    }
+    if (responseUs > e.deadlineMs * 1000) {
+        e.stats.deadlineMisses++;
+    }
+
+    // Includes time preempted by higher-priority tasks, so it bounds the WCET from above
+    const int64_t exec = nowUs - e.wakeUs;
+    const uint32_t execUs = (exec <= 0) ? 0 : (exec > UINT32_MAX) ? UINT32_MAX : (uint32_t)exec;
+    e.stats.lastExecUs = execUs;
+    e.stats.totalExecUs += execUs;
+    if (execUs > e.stats.maxExecUs) {
+        e.stats.maxExecUs = execUs;
+    }
+}
+
+bool TaskScheduler::isDue(SchedTask task, uint32_t intervalMs) const {
+    const uint8_t idx = (uint8_t)task;
+    if (idx >= (uint8_t)SchedTask::COUNT) return false;
+
+    const Entry& e = m_entries[idx];
+    const uint32_t periodMs = e.plannedPeriodMs ? e.plannedPeriodMs : e.periodMs.load();
+    if (periodMs == 0) return true;
+    uint32_t every = (intervalMs + periodMs / 2) / periodMs;
+    if (every == 0) every = 1;
+    return (e.index % every) == 0;
+}
+
+uint32_t TaskScheduler::getPeriod(SchedTask task) const {
+    const uint8_t idx = (uint8_t)task;
+    return idx < (uint8_t)SchedTask::COUNT ? m_entries[idx].periodMs.load() : 0;
+}
+
+TaskScheduleStats TaskScheduler::getStats(SchedTask task) const {
+    TaskScheduleStats s;
+    memset(&s, 0, sizeof(s));
+    const uint8_t idx = (uint8_t)task;
+    if (idx >= (uint8_t)SchedTask::COUNT) return s;
+
+    // Counters are written by the owning task only; a copy may be one release behind
+    const Entry& e = m_entries[idx];
+    s = e.stats;
+    s.periodMs = e.periodMs.load();
+    s.phaseMs = e.phaseMs;
+    s.deadlineMs = e.deadlineMs;
+    return s;
+}
+
+void TaskScheduler::checkStagger(uint8_t idx) const {
+    // Grids i and j share a release iff the phase difference is a multiple of gcd(periods)
+    const Entry& a = m_entries[idx];
+    for (uint8_t j = 0; j < (uint8_t)SchedTask::COUNT; j++) {
+        const Entry& b = m_entries[j];
+        if (j == idx || !b.registered) continue;
+        const uint32_t pa = a.periodMs.load();
+        const uint32_t pb = b.periodMs.load();
+        const uint32_t g = gcd(pa, pb);
+        const uint32_t diff = (a.phaseMs > b.phaseMs) ? a.phaseMs - b.phaseMs : b.phaseMs - a.phaseMs;
+        if (g != 0 && diff % g == 0) {
+            Logger::getInstance().warn("TaskScheduler: %s and %s release on the same tick every %lums",
+                                       kTaskNames[idx], kTaskNames[j], (unsigned long)((uint64_t)pa / g * pb));
+        }
+    }
+}
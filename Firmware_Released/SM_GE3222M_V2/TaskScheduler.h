@@ -0,0 +1,126 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Task Scheduler
+ *
+ * Release times for the periodic tasks. Every registered task runs on a grid
+ * anchored at boot: release k is at phase + k * period. Tasks sharing a bus
+ * get different phases, so their releases never land on the same tick (SPI
+ * sweep, Modbus poll, W5500 traffic).
+ *
+ * Features:
+ * - Period, phase offset and deadline per task; periods change at runtime
+ *   (applyConfig() on CONFIG_CHANGED) and a sleeping task re-plans at once
+ * - Overruns skip to the next grid point instead of bunching up, so phases
+ *   stay staggered; skipped releases and deadline misses are counted
+ * - Wake-up lateness, response time and execution time (worst case and total)
+ *   per task for TaskMonitor
+ * - isDue() for work done every N releases (snapshot publish, Modbus refresh),
+ *   aligned to the same grid
+ * - SystemConfig::readInterval sets the reading cadence, publishInterval the
+ *   AccumulatorTask period
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "DataTypes.h"
+
+enum class SchedTask : uint8_t {
+    ENERGY = 0,         // ATM90E36 sweep (SPI)
+    MODBUS,             // RTU poll + Modbus TCP (W5500, SPI)
+    TCP_SERVER,         // TCP JSON clients (W5500, SPI)
+    ACCUMULATOR,        // Energy counters, journal (flash)
+    COUNT
+};
+
+struct TaskScheduleStats {
+    uint32_t periodMs;
+    uint32_t phaseMs;
+    uint32_t deadlineMs;
+    uint32_t releases;
+    uint32_t skipped;           // Releases lost because the previous run overran
+    uint32_t deadlineMisses;
+    uint32_t lastResponseUs;    // Release to complete()
+    uint32_t maxResponseUs;
+    uint32_t maxLateUs;         // Release to wake-up
+    uint32_t lastExecUs;        // Wake-up to complete()
+    uint32_t maxExecUs;         // Observed worst-case execution time
+    uint64_t totalExecUs;
+};
+
+class TaskScheduler {
+public:
+    static TaskScheduler& getInstance();
+
+    /**
+     * Register a periodic task (before it first calls waitForRelease())
+     * Warns if its releases can coincide with another registered task.
+     */
+    void registerTask(SchedTask task, uint32_t periodMs, uint32_t phaseMs, uint32_t deadlineMs);
+
+    /**
+     * Change a period at runtime; the task re-plans its next release immediately
+     */
+    void setPeriod(SchedTask task, uint32_t periodMs);
+
+    /**
+     * Reading cadence (readInterval) and AccumulatorTask period (publishInterval)
+     */
+    void applyConfig(const SystemConfig& config);
+
+    /**
+     * Block the calling task until its next release (owning task only)
+     * @return Wake-up lateness in microseconds
+     */
+    uint32_t waitForRelease(SchedTask task);
+
+    /**
+     * End of the work for the current release: response and execution time,
+     * deadline check
+     */
+    void complete(SchedTask task);
+
+    /**
+     * True on the releases that fall on an intervalMs grid (interval rounded to
+     * whole periods, at least every release)
+     */
+    bool isDue(SchedTask task, uint32_t intervalMs) const;
+
+    uint32_t getPeriod(SchedTask task) const;
+    uint32_t getReadIntervalMs() const { return m_readIntervalMs.load(); }
+    TaskScheduleStats getStats(SchedTask task) const;
+
+    static const char* taskName(SchedTask task);
+
+    static constexpr uint32_t MIN_PERIOD_MS = 10;
+    static constexpr uint32_t MAX_READ_INTERVAL_MS = 60000;
+    static constexpr uint16_t MAX_PUBLISH_INTERVAL_SEC = 3600;
+
+private:
+    TaskScheduler();
+    ~TaskScheduler() = default;
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    struct Entry {
+        std::atomic<uint32_t> periodMs;
+        uint32_t phaseMs;
+        uint32_t deadlineMs;
+        bool registered;
+        TaskHandle_t owner;         // Notified on a period change
+        // Owning task only
+        uint32_t plannedPeriodMs;   // Period the current release was planned with
+        uint64_t index;             // Grid index of the current release
+        int64_t releaseUs;
+        int64_t wakeUs;
+        bool released;
+        TaskScheduleStats stats;
+    };
+
+    void checkStagger(uint8_t idx) const;
+
+    Entry m_entries[(uint8_t)SchedTask::COUNT];
+    std::atomic<uint32_t> m_readIntervalMs;
+};
@@ -0,0 +1,265 @@
+/**
+ * SM-GE3222M V2.0 - ATM90E36 Waveform Capture Implementation
+ */
+
+#include "WaveformCapture.h"
+#include <driver/i2s.h>
+#include <esp_heap_caps.h>
+#include "PinMap.h"
+#include "Logger.h"
+#include "ATM90E36Driver.h"
+#include "EnergyMeter.h"
+#include "RawMeterFrame.h"
+
+namespace {
+
+constexpr i2s_port_t WAVE_I2S_PORT = I2S_NUM_0;
+
+// DMACtrl fields (see M90E36A datasheet, DMA mode)
+constexpr uint16_t DMA_PIN_DIR_SDO  = 0x0100;  // b8: samples on SDO (ESP32 MISO)
+constexpr uint16_t DMA_WIDTH_16BIT  = 0x0080;  // b7:6 = 10
+// CLK_DRV = CLK_IDLE = 0 (Mode0): data changes on the falling edge, I2S samples on the rising one
+
+} // namespace
+
+WaveformCapture& WaveformCapture::getInstance() {
+    static WaveformCapture instance;
+    return instance;
+}
+
+WaveformCapture::WaveformCapture()
+    : m_initialized(false)
+    , m_ringInPsram(false)
+    , m_ring(nullptr)
+    , m_ringWords(0)
+    , m_writePos(0)
+    , m_captureStart(0)
+    , m_captures(0)
+    , m_mutex(nullptr) {
+}
+
+bool WaveformCapture::init() {
+    if (m_initialized) {
+        return true;
+    }
+
+    Logger& logger = Logger::getInstance();
+
+    // Keep the ATM90E36 in register (slave) mode until a capture is requested.
+    pinMode(PIN_ATM_DMA_CTRL, OUTPUT);
+    digitalWrite(PIN_ATM_DMA_CTRL, LOW);
+
+    m_mutex = xSemaphoreCreateMutex();
+    if (!m_mutex) {
+        logger.error("Waveform: Failed to create mutex");
+        return false;
+    }
+
+    if (psramFound()) {
+        m_ring = static_cast<int16_t*>(heap_caps_malloc(RING_BYTES_PSRAM, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+        if (m_ring) {
+            m_ringWords = RING_BYTES_PSRAM / sizeof(int16_t);
+            m_ringInPsram = true;
+        }
+    }
+    if (!m_ring) {
+        m_ring = static_cast<int16_t*>(heap_caps_malloc(RING_BYTES_INTERNAL, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+        if (!m_ring) {
+            logger.error("Waveform: Failed to allocate %u byte sample ring", (unsigned)RING_BYTES_INTERNAL);
+            return false;
+        }
+        m_ringWords = RING_BYTES_INTERNAL / sizeof(int16_t);
+    }
+
+    m_initialized = true;
+    logger.info("Waveform: %u KB sample ring in %s (%u cycles of all channels at 50 Hz)",
+                (unsigned)(getRingBytes() / 1024), m_ringInPsram ? "PSRAM" : "heap",
+                (unsigned)maxCycles(WAVE_CH_ALL));
+    return true;
+}
+
+uint8_t WaveformCapture::countChannels(uint8_t mask) {
+    return (uint8_t)__builtin_popcount(mask & WAVE_CH_ALL);
+}
+
+uint16_t WaveformCapture::dmaCtrlValue(uint8_t mask) {
+    return (uint16_t)(((uint16_t)(mask & WAVE_CH_ALL) << 9) | DMA_PIN_DIR_SDO | DMA_WIDTH_16BIT | DMA_CLK_DIV);
+}
+
+uint16_t WaveformCapture::maxCycles(uint8_t channelMask) const {
+    const uint8_t channels = countChannels(channelMask);
+    if (channels == 0) return 0;
+    const size_t framesPerCycle = SAMPLE_RATE_HZ / 50;
+    const size_t cycles = m_ringWords / (framesPerCycle * channels);
+    return (uint16_t)(cycles > 0xFFFF ? 0xFFFF : cycles);
+}
+
+bool WaveformCapture::startReceiver() {
+    i2s_config_t cfg = {};
+    cfg.mode = (i2s_mode_t)(I2S_MODE_SLAVE | I2S_MODE_RX);
+    cfg.sample_rate = SAMPLE_RATE_HZ;                       // Informational in slave mode
+    cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    cfg.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;         // SCLK only runs while CS (WS) is low
+    cfg.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+    cfg.intr_alloc_flags = 0;
+    cfg.dma_buf_count = DMA_BUF_COUNT;
+    cfg.dma_buf_len = DMA_BUF_LEN;
+    cfg.use_apll = false;
+
+    if (i2s_driver_install(WAVE_I2S_PORT, &cfg, 0, nullptr) != ESP_OK) {
+        return false;
+    }
+
+    i2s_pin_config_t pins = {};
+    pins.bck_io_num = PIN_SPI_SCK;
+    pins.ws_io_num = PIN_SPI_CS_ATM90E36;
+    pins.data_out_num = I2S_PIN_NO_CHANGE;
+    pins.data_in_num = PIN_SPI_MISO;
+    if (i2s_set_pin(WAVE_I2S_PORT, &pins) != ESP_OK) {
+        i2s_driver_uninstall(WAVE_I2S_PORT);
+        return false;
+    }
+
+    i2s_zero_dma_buffer(WAVE_I2S_PORT);
+    return true;
+}
+
+void WaveformCapture::stopReceiver() {
+    i2s_stop(WAVE_I2S_PORT);
+    i2s_driver_uninstall(WAVE_I2S_PORT);
+}
+
+size_t WaveformCapture::receive(int16_t* dst, size_t words, uint32_t timeoutMs) {
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    size_t remaining = words * sizeof(int16_t);
+    const uint32_t startMs = millis();
+
+    // i2s_read() copies each completed DMA descriptor directly into the ring slot.
+    while (remaining > 0 && (millis() - startMs) < timeoutMs) {
+        size_t got = 0;
+        if (i2s_read(WAVE_I2S_PORT, out, remaining, &got, pdMS_TO_TICKS(RX_MARGIN_MS)) != ESP_OK) {
+            break;
+        }
+        if (got == 0) {
+            break;  // No clock from the ATM90E36 (DMA_CTRL not wired or DMACtrl rejected)
+        }
+        out += got;
+        remaining -= got;
+    }
+    return words - remaining / sizeof(int16_t);
+}
+
+bool WaveformCapture::capture(uint8_t channelMask, uint16_t cycles) {
+    Logger& logger = Logger::getInstance();
+    if (!m_initialized) {
+        logger.error("Waveform: Not initialized");
+        return false;
+    }
+
+    channelMask &= WAVE_CH_ALL;
+    const uint8_t channels = countChannels(channelMask);
+    if (channels == 0 || cycles == 0) {
+        return false;
+    }
+
+    if (xSemaphoreTake(m_mutex, 0) != pdTRUE) {
+        logger.warn("Waveform: Capture already in progress");
+        return false;
+    }
+
+    // Frame count from the measured line frequency (0.01 Hz/LSB)
+    uint32_t lineCentiHz = 5000;
+    RawMeterFrame frame;
+    if (EnergyMeter::getInstance().getRawFrame(frame) && frame.freq >= 4000 && frame.freq <= 7000) {
+        lineCentiHz = frame.freq;
+    }
+    uint32_t frames = (uint32_t)(((uint64_t)cycles * SAMPLE_RATE_HZ * 100 + lineCentiHz / 2) / lineCentiHz);
+    const size_t maxFrames = m_ringWords / channels;
+    if (frames > maxFrames) {
+        logger.warn("Waveform: %u cycles exceed the sample ring, clamped to %u frames", cycles, (unsigned)maxFrames);
+        frames = maxFrames;
+    }
+    const size_t words = (size_t)frames * channels;
+
+    // Captures are kept contiguous; one that does not fit before the end starts over at 0.
+    size_t start = m_writePos;
+    if (start + words > m_ringWords) {
+        start = 0;
+    }
+    m_info.valid = false;
+
+    ATM90E36Driver& driver = ATM90E36Driver::getInstance();
+    if (!driver.beginWaveformCapture(dmaCtrlValue(channelMask))) {
+        xSemaphoreGive(m_mutex);
+        logger.warn("Waveform: ATM90E36 did not enter DMA mode");
+        return false;
+    }
+
+    // CS becomes an input: the ATM90E36 frames each sample set with it.
+    pinMode(PIN_SPI_CS_ATM90E36, INPUT);
+
+    size_t received = 0;
+    const uint32_t startMs = millis();
+    if (startReceiver()) {
+        digitalWrite(PIN_ATM_DMA_CTRL, HIGH);
+        received = receive(m_ring + start, words, (uint32_t)(frames * 1000UL / SAMPLE_RATE_HZ) + RX_MARGIN_MS);
+        digitalWrite(PIN_ATM_DMA_CTRL, LOW);
+        stopReceiver();
+    } else {
+        logger.error("Waveform: I2S receiver init failed");
+    }
+
+    pinMode(PIN_SPI_CS_ATM90E36, OUTPUT);
+    digitalWrite(PIN_SPI_CS_ATM90E36, HIGH);
+    driver.endWaveformCapture();
+
+    const bool ok = (received == words);
+    if (ok) {
+        m_captureStart = start;
+        m_writePos = start + words;
+        m_info.sequence++;
+        m_info.startMs = startMs;
+        m_info.sampleRateHz = SAMPLE_RATE_HZ;
+        m_info.channelMask = channelMask;
+        m_info.channelCount = channels;
+        m_info.frames = frames;
+        m_info.valid = true;
+        m_captures++;
+        logger.info("Waveform: Captured %u frames x %u ch (mask=0x%02X) in %lu ms",
+                    (unsigned)frames, channels, channelMask, (unsigned long)(millis() - startMs));
+    } else {
+        logger.warn("Waveform: Capture incomplete (%u of %u samples)", (unsigned)received, (unsigned)words);
+    }
+
+    xSemaphoreGive(m_mutex);
+    return ok;
+}
+
+WaveformInfo WaveformCapture::getInfo() {
+    WaveformInfo info;
+    if (m_mutex && xSemaphoreTake(m_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        info = m_info;
+        xSemaphoreGive(m_mutex);
+    }
+    return info;
+}
+
+size_t WaveformCapture::read(uint32_t sequence, size_t byteOffset, uint8_t* dst, size_t maxBytes) {
+    if (!m_initialized || !dst || maxBytes == 0) {
+        return 0;
+    }
+    if (xSemaphoreTake(m_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return 0;
+    }
+
+    size_t n = 0;
+    const size_t total = m_info.byteLength();
+    if (m_info.valid && m_info.sequence == sequence && byteOffset < total) {
+        n = total - byteOffset;
+        if (n > maxBytes) n = maxBytes;
+        memcpy(dst, reinterpret_cast<const uint8_t*>(m_ring + m_captureStart) + byteOffset, n);
+    }
+
+    xSemaphoreGive(m_mutex);
+    return n;
+}
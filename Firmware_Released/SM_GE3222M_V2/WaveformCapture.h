@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - ATM90E36 Waveform Capture
+ *
+ * Raw ADC sample capture through the ATM90E36 DMA interface. With DMA_CTRL high the
+ * ATM90E36 becomes SPI master and clocks one frame of the selected channels every
+ * 125 us (8 kHz); the ESP32 receives the stream with the I2S peripheral in slave
+ * mode (BCK = SCLK, WS = CS, DIN = SDO on the MISO line).
+ *
+ * Features:
+ * - Capture N line cycles of any subset of the 7 ADC channels (16-bit samples)
+ * - Sample ring allocated once at init (PSRAM when available, small internal fallback)
+ * - I2S DMA descriptors are drained straight into the ring slot (no staging buffer)
+ * - Read-out of the last capture in arbitrary chunks for the /api/waveform stream
+ *
+ * The shared SPI bus (ATM90E36 + W5500) is suspended for the duration of a capture.
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Channel selection. Bit n maps to DMACtrl ADC_CH_SEL bit (9 + n); within a frame the
+// ATM90E36 sends the selected channels from the highest bit down (IN, I1, V1, I2, V2, I3, V3).
+enum WaveformChannel : uint8_t {
+    WAVE_CH_V3  = 0x01,
+    WAVE_CH_I3  = 0x02,
+    WAVE_CH_V2  = 0x04,
+    WAVE_CH_I2  = 0x08,
+    WAVE_CH_V1  = 0x10,
+    WAVE_CH_I1  = 0x20,
+    WAVE_CH_IN  = 0x40,
+    WAVE_CH_ALL = 0x7F
+};
+
+// Description of the last completed capture
+struct WaveformInfo {
+    uint32_t sequence;      // Incremented per capture; readers use it to detect overwrite
+    uint32_t startMs;       // millis() when sampling started
+    uint16_t sampleRateHz;  // Frames per second per channel
+    uint8_t  channelMask;   // WaveformChannel bits
+    uint8_t  channelCount;
+    uint32_t frames;        // Samples per channel
+    bool     valid;
+
+    WaveformInfo() : sequence(0), startMs(0), sampleRateHz(0), channelMask(0),
+                     channelCount(0), frames(0), valid(false) {}
+
+    size_t byteLength() const { return (size_t)frames * channelCount * sizeof(int16_t); }
+};
+
+class WaveformCapture {
+public:
+    static WaveformCapture& getInstance();
+
+    /**
+     * Allocate the sample ring and park DMA_CTRL low.
+     * @return true if a ring buffer could be allocated
+     */
+    bool init();
+
+    /**
+     * Blocking capture of `cycles` line cycles of the selected channels.
+     * The frame count is derived from the measured line frequency (50 Hz if unknown)
+     * and clamped to the ring size.
+     * @param channelMask WaveformChannel bits
+     * @param cycles Number of line cycles
+     * @return true if the full capture was received
+     */
+    bool capture(uint8_t channelMask, uint16_t cycles);
+
+    WaveformInfo getInfo();
+
+    /**
+     * Copy part of the last capture (interleaved little-endian int16 frames).
+     * @param sequence WaveformInfo::sequence the caller started streaming
+     * @param byteOffset Offset into the capture
+     * @return bytes copied; 0 at the end, or if the capture was replaced/is in progress
+     */
+    size_t read(uint32_t sequence, size_t byteOffset, uint8_t* dst, size_t maxBytes);
+
+    uint16_t maxCycles(uint8_t channelMask) const;
+    size_t getRingBytes() const { return m_ringWords * sizeof(int16_t); }
+    bool isInPSRAM() const { return m_ringInPsram; }
+    uint32_t getCaptureCount() const { return m_captures; }
+
+    static constexpr uint16_t SAMPLE_RATE_HZ      = 8000;
+    static constexpr size_t   RING_BYTES_PSRAM    = 1024 * 1024;
+    static constexpr size_t   RING_BYTES_INTERNAL = 32 * 1024;
+
+private:
+    WaveformCapture();
+    ~WaveformCapture() = default;
+    WaveformCapture(const WaveformCapture&) = delete;
+    WaveformCapture& operator=(const WaveformCapture&) = delete;
+
+    bool startReceiver();
+    void stopReceiver();
+    size_t receive(int16_t* dst, size_t words, uint32_t timeoutMs);
+
+    static uint8_t countChannels(uint8_t mask);
+    static uint16_t dmaCtrlValue(uint8_t mask);
+
+    // I2S receiver: DMA descriptors double-buffer the 8 kHz stream
+    static constexpr uint8_t  DMA_BUF_COUNT   = 4;
+    static constexpr uint16_t DMA_BUF_LEN     = 256;  // 16-bit words per descriptor
+    static constexpr uint8_t  DMA_CLK_DIV     = 3;    // f_SCLK = 16.384 MHz / (2 + 2*3) = 2.048 MHz
+    static constexpr uint32_t RX_MARGIN_MS    = 100;
+
+    bool m_initialized;
+    bool m_ringInPsram;
+    int16_t* m_ring;
+    size_t m_ringWords;
+    size_t m_writePos;          // Next free word; a capture that does not fit wraps to 0
+    size_t m_captureStart;      // Word offset of the last capture
+    uint32_t m_captures;
+    WaveformInfo m_info;
+    SemaphoreHandle_t m_mutex;  // Held for the whole capture; readers never wait on it long
+};
@@ -10,6 +10,11 @@
 #include "SystemMonitor.h"
 #include "ProtocolV2.h"
 #include "DHTSensorManager.h"
+#include "WaveformCapture.h"
+#include "HarmonicAnalyzer.h"
+#include "HarmonicSweep.h"
+#include "MeterWireFormat.h"
+#include "EventBus.h"
 
 static const char PAGE_CONFIG_TEMPLATE[] PROGMEM = R"rawliteral(
 <!DOCTYPE html><html><head>
@@ -59,9 +64,9 @@ WebUIManager& WebUIManager::getInstance() { static WebUIManager i; return i; }
 
 WebUIManager::WebUIManager()
 #if WEBUI_ASYNC_ENABLED
-    : _server(80), _ws("/ws"), _lastWsBroadcastMs(0), _running(false), _port(80), _deferredStaReconnectAtMs(0)
+    : _server(80), _ws("/ws"), _wsBin("/ws/bin"), _lastWsBroadcastMs(0), _running(false), _meterPushPending(false), _port(80), _deferredStaReconnectAtMs(0)
 #else
-    : _server(80), _running(false), _port(80), _deferredStaReconnectAtMs(0)
+    : _server(80), _running(false), _meterPushPending(false), _port(80), _deferredStaReconnectAtMs(0)
 #endif
 {}
 
@@ -73,7 +78,7 @@ bool WebUIManager::begin(uint16_t port) {
     _server.begin();
     _running = true;
     Logger::getInstance().info("WebUI: Async HTTP server started on port %u", (unsigned)port);
-    Logger::getInstance().info("WebUI: Async WebSocket enabled at /ws (same port)");
+    Logger::getInstance().info("WebUI: Async WebSocket enabled at /ws and /ws/bin (same port)");
 #else
     _server.begin();
     _running = true;
@@ -94,15 +99,30 @@ void WebUIManager::loop() {
         networkManager.reconnectSTA();
     }
 
-    if (_ws.count() > 0) {
+    // Pushed when the EnergyTask publishes a new METER_DATA_UPDATED value (onMeterData)
+    if (_meterPushPending && (_ws.count() > 0 || _wsBin.count() > 0)) {
         const uint32_t now = millis();
-        if ((uint32_t)(now - _lastWsBroadcastMs) >= 1000UL) {
+        if ((uint32_t)(now - _lastWsBroadcastMs) >= WS_PUSH_MIN_MS) {
             _lastWsBroadcastMs = now;
-            String payload = buildMeterJson(false); // snapshot only; avoid SPI contention in network callback path
-            _ws.textAll(payload);
+            _meterPushPending = false;
+            // The topic block stays valid while this reference is held
+            EventRef value;
+            EventBus::getInstance().readLatest(EventType::METER_DATA_UPDATED, value);
+            if (value && value.size() == sizeof(MeterData)) {
+                const MeterData& m = *static_cast<const MeterData*>(value.data());
+                if (_ws.count() > 0) {
+                    _ws.textAll(buildMeterJson(m));
+                }
+                if (_wsBin.count() > 0) {
+                    uint8_t frame[METER_WIRE_MAX_SIZE];
+                    const size_t len = buildMeterFrame(m, frame, sizeof(frame));
+                    if (len > 0) _wsBin.binaryAll(frame, len);
+                }
+            }
         }
     }
     _ws.cleanupClients();
+    _wsBin.cleanupClients();
 #else
     if (_deferredStaReconnectAtMs != 0 && (int32_t)(millis() - _deferredStaReconnectAtMs) >= 0) {
         _deferredStaReconnectAtMs = 0;
@@ -117,18 +137,28 @@ void WebUIManager::scheduleSTAReconnect(uint32_t delayMs) {
     _deferredStaReconnectAtMs = millis() + delayMs;
 }
 
+void WebUIManager::onMeterData(EventType type, void* data) {
+    (void)type;
+    (void)data;
+    getInstance()._meterPushPending = true;
+}
+
 String WebUIManager::buildMeterJson(bool refreshMeter) {
     // For async network callbacks, use snapshots only (no direct SPI access) to avoid collisions with EnergyTask.
     if (refreshMeter) {
         EnergyMeter::getInstance().update();
     }
+    return buildMeterJson(EnergyMeter::getInstance().getSnapshot());
+}
 
-    MeterData m = EnergyMeter::getInstance().getSnapshot();
+String WebUIManager::buildMeterJson(const MeterData& m) {
     EnergyData e = EnergyAccumulator::getInstance().getAccumulatedEnergy();
     SystemStatus s = SystemMonitor::getInstance().getSystemStatus();
     auto dht = DHTSensorManager::getInstance().getSnapshot();
 
     DynamicJsonDocument doc(3328);
+    doc["timestampUs"] = m.timestampUs;
+    doc["utcMs"] = m.utcMs;
     doc["UrmsA"] = m.phaseA.voltageRMS;
     doc["UrmsB"] = m.phaseB.voltageRMS;
     doc["UrmsC"] = m.phaseC.voltageRMS;
@@ -202,6 +232,66 @@ String WebUIManager::buildConfigJson() {
     return out;
 }
 
+String WebUIManager::buildHarmonicsJson() {
+    HarmonicData data;
+    if (!HarmonicAnalyzer::getInstance().getLatest(data)) return String();
+    DynamicJsonDocument doc(ProtocolV2::HARMONIC_JSON_DOC_SIZE);
+    ProtocolV2::getInstance().harmonicsToJson(data, doc);
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+String WebUIManager::buildHarmonicRatiosJson() {
+    HarmonicRatios data;
+    if (!HarmonicSweep::getInstance().getLatest(data)) return String();
+    DynamicJsonDocument doc(ProtocolV2::HARMONIC_RATIO_JSON_DOC_SIZE);
+    ProtocolV2::getInstance().harmonicRatiosToJson(data, doc);
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+String WebUIManager::buildFastPowerJson() {
+    DynamicJsonDocument doc(1024);
+    ProtocolV2::getInstance().fastPowerToJson(doc);
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+String WebUIManager::buildPerfJson() {
+    DynamicJsonDocument doc(ProtocolV2::PERF_JSON_DOC_SIZE);
+    ProtocolV2::getInstance().perfToJson(doc);
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+String WebUIManager::buildEnergyJson() {
+    DynamicJsonDocument doc(3072);
+    ProtocolV2::getInstance().energyToJson(doc);
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+String WebUIManager::buildEventsJson() {
+    DynamicJsonDocument doc(ProtocolV2::EVENTS_JSON_DOC_SIZE);
+    ProtocolV2::getInstance().eventsToJson(doc);
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
+String WebUIManager::buildTasksJson() {
+    DynamicJsonDocument doc(ProtocolV2::TASKS_JSON_DOC_SIZE);
+    ProtocolV2::getInstance().tasksToJson(doc);
+    String out;
+    serializeJson(doc, out);
+    return out;
+}
+
 bool WebUIManager::applyConfigJson(const String& body) {
     if (body.isEmpty()) return false;
     DynamicJsonDocument doc(4096);
@@ -241,6 +331,35 @@ void WebUIManager::setupRoutes() {
     _server.on("/api/config", HTTP_GET, [this](AsyncWebServerRequest* request) {
         sendAsyncJson(request, 200, buildConfigJson());
     });
+    _server.on("/api/waveform", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleAsyncWaveform(request);
+    });
+    // Registered before /api/harmonics, which would otherwise also match this path
+    _server.on("/api/harmonics/dft", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        String json = buildHarmonicRatiosJson();
+        if (json.isEmpty()) sendAsyncJson(request, 404, "{\"status\":\"error\",\"message\":\"no dft results\"}");
+        else sendAsyncJson(request, 200, json);
+    });
+    _server.on("/api/harmonics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        String json = buildHarmonicsJson();
+        if (json.isEmpty()) sendAsyncJson(request, 404, "{\"status\":\"error\",\"message\":\"no analysis\"}");
+        else sendAsyncJson(request, 200, json);
+    });
+    _server.on("/api/fastpower", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendAsyncJson(request, 200, buildFastPowerJson());
+    });
+    _server.on("/api/perf", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendAsyncJson(request, 200, buildPerfJson());
+    });
+    _server.on("/api/energy", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendAsyncJson(request, 200, buildEnergyJson());
+    });
+    _server.on("/api/events", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendAsyncJson(request, 200, buildEventsJson());
+    });
+    _server.on("/api/tasks", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        sendAsyncJson(request, 200, buildTasksJson());
+    });
 
     _server.on("/api/config", HTTP_POST,
         [this](AsyncWebServerRequest* request) {
@@ -281,6 +400,14 @@ void WebUIManager::setupRoutes() {
     _server.on("/api/meter", HTTP_GET, [this]() { handleApiMeter(); });
     _server.on("/api/status", HTTP_GET, [this]() { handleApiStatus(); });
     _server.on("/api/config", HTTP_GET, [this]() { handleApiConfigGet(); });
+    _server.on("/api/waveform", HTTP_GET, [this]() { handleApiWaveform(); });
+    _server.on("/api/harmonics", HTTP_GET, [this]() { handleApiHarmonics(); });
+    _server.on("/api/harmonics/dft", HTTP_GET, [this]() { handleApiHarmonicRatios(); });
+    _server.on("/api/fastpower", HTTP_GET, [this]() { handleApiFastPower(); });
+    _server.on("/api/perf", HTTP_GET, [this]() { handleApiPerf(); });
+    _server.on("/api/energy", HTTP_GET, [this]() { handleApiEnergy(); });
+    _server.on("/api/events", HTTP_GET, [this]() { handleApiEvents(); });
+    _server.on("/api/tasks", HTTP_GET, [this]() { handleApiTasks(); });
     _server.on("/api/config", HTTP_POST, [this]() { handleApiConfigPost(); });
     _server.on("/save", HTTP_POST, [this]() { handleSaveForm(); });
 
@@ -295,6 +422,15 @@ void WebUIManager::setupRoutes() {
 #endif
 }
 
+bool WebUIManager::startWaveformCapture(bool hasCycles, const String& ch, const String& cycles) {
+    if (!hasCycles) return true;
+    const uint8_t mask = ch.isEmpty() ? (uint8_t)WAVE_CH_ALL : (uint8_t)strtoul(ch.c_str(), nullptr, 0);
+    long n = cycles.toInt();
+    if (n < 1) n = 1;
+    if (n > WAVEFORM_HTTP_MAX_CYCLES) n = WAVEFORM_HTTP_MAX_CYCLES;
+    return WaveformCapture::getInstance().capture(mask, (uint16_t)n);
+}
+
 String WebUIManager::buildWiFiSetupPage() {
     String page = FPSTR(PAGE_CONFIG_TEMPLATE);
     page.replace("%AP_SSID%", String(AP_SSID));
@@ -310,6 +446,27 @@ void WebUIManager::setupWebSocket() {
         handleWebSocketEvent(server, client, type, arg, data, len);
     });
     _server.addHandler(&_ws);
+
+    // Binary push only; a new client gets the current frame straight away
+    _wsBin.onEvent([this](AsyncWebSocket* server, AsyncWebSocketClient* client,
+                          AwsEventType type, void* arg, uint8_t* data, size_t len) {
+        if (type != WS_EVT_CONNECT) return;
+        uint8_t frame[METER_WIRE_MAX_SIZE];
+        const size_t frameLen = buildMeterFrame(frame, sizeof(frame));
+        if (frameLen > 0) client->binary(frame, frameLen);
+    });
+    _server.addHandler(&_wsBin);
+}
+
+size_t WebUIManager::buildMeterFrame(uint8_t* buf, size_t len) {
+    return buildMeterFrame(EnergyMeter::getInstance().getSnapshot(), buf, len);
+}
+
+size_t WebUIManager::buildMeterFrame(const MeterData& m, uint8_t* buf, size_t len) {
+    if (!m.valid) return 0;
+    MeterFieldMask all;
+    all.setAll();
+    return encodeMeterWireFrame(m, all, buf, len);
 }
 
 void WebUIManager::handleWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client,
@@ -369,6 +526,34 @@ void WebUIManager::handleAsyncStaticFile(AsyncWebServerRequest* request, const S
     request->send(resp);
 }
 
+void WebUIManager::handleAsyncWaveform(AsyncWebServerRequest* request) {
+    const bool hasCycles = request->hasParam("cycles");
+    const String ch = request->hasParam("ch") ? request->getParam("ch")->value() : String();
+    const String cycles = hasCycles ? request->getParam("cycles")->value() : String();
+    if (!startWaveformCapture(hasCycles, ch, cycles)) {
+        sendAsyncJson(request, 503, "{\"status\":\"error\",\"message\":\"capture failed\"}");
+        return;
+    }
+
+    const WaveformInfo info = WaveformCapture::getInstance().getInfo();
+    if (!info.valid) {
+        sendAsyncJson(request, 404, "{\"status\":\"error\",\"message\":\"no capture\"}");
+        return;
+    }
+
+    const uint32_t seq = info.sequence;
+    AsyncWebServerResponse* resp = request->beginResponse("application/octet-stream", info.byteLength(),
+        [seq](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return WaveformCapture::getInstance().read(seq, index, buffer, maxLen);
+        });
+    resp->addHeader("Cache-Control", "no-store");
+    resp->addHeader("X-Sample-Rate", String(info.sampleRateHz));
+    resp->addHeader("X-Channel-Mask", String(info.channelMask));
+    resp->addHeader("X-Frames", String(info.frames));
+    resp->addHeader("X-Capture-Ms", String(info.startMs));
+    request->send(resp);
+}
+
 void WebUIManager::sendAsyncJson(AsyncWebServerRequest* request, int code, const String& json) {
     AsyncWebServerResponse* resp = request->beginResponse(code, "application/json", json);
     resp->addHeader("Cache-Control", "no-store");
@@ -494,6 +679,71 @@ void WebUIManager::handleApiConfigPost() {
     sendJson(ok ? 200 : 500, ok ? "{\"status\":\"ok\"}" : "{\"status\":\"error\"}");
 }
 
+void WebUIManager::handleApiWaveform() {
+    if (!startWaveformCapture(_server.hasArg("cycles"), _server.arg("ch"), _server.arg("cycles"))) {
+        sendJson(503, "{\"status\":\"error\",\"message\":\"capture failed\"}");
+        return;
+    }
+
+    WaveformCapture& wave = WaveformCapture::getInstance();
+    const WaveformInfo info = wave.getInfo();
+    if (!info.valid) {
+        sendJson(404, "{\"status\":\"error\",\"message\":\"no capture\"}");
+        return;
+    }
+
+    const size_t total = info.byteLength();
+    _server.sendHeader("Cache-Control", "no-store");
+    _server.sendHeader("X-Sample-Rate", String(info.sampleRateHz));
+    _server.sendHeader("X-Channel-Mask", String(info.channelMask));
+    _server.sendHeader("X-Frames", String(info.frames));
+    _server.sendHeader("X-Capture-Ms", String(info.startMs));
+    _server.setContentLength(total);
+    _server.send(200, "application/octet-stream", "");
+
+    uint8_t chunk[512];
+    size_t offset = 0;
+    while (offset < total) {
+        const size_t n = wave.read(info.sequence, offset, chunk, sizeof(chunk));
+        if (n == 0) break;
+        _server.sendContent((const char*)chunk, n);
+        offset += n;
+        yield();
+    }
+}
+
+void WebUIManager::handleApiHarmonics() {
+    String json = buildHarmonicsJson();
+    if (json.isEmpty()) sendJson(404, "{\"status\":\"error\",\"message\":\"no analysis\"}");
+    else sendJson(200, json);
+}
+
+void WebUIManager::handleApiHarmonicRatios() {
+    String json = buildHarmonicRatiosJson();
+    if (json.isEmpty()) sendJson(404, "{\"status\":\"error\",\"message\":\"no dft results\"}");
+    else sendJson(200, json);
+}
+
+void WebUIManager::handleApiFastPower() {
+    sendJson(200, buildFastPowerJson());
+}
+
+void WebUIManager::handleApiPerf() {
+    sendJson(200, buildPerfJson());
+}
+
+void WebUIManager::handleApiEnergy() {
+    sendJson(200, buildEnergyJson());
+}
+
+void WebUIManager::handleApiEvents() {
+    sendJson(200, buildEventsJson());
+}
+
+void WebUIManager::handleApiTasks() {
+    sendJson(200, buildTasksJson());
+}
+
 void WebUIManager::handleSaveForm() {
     WiFiConfig cfg = networkManager.getConfig();
     if (_server.hasArg("ssid")) cfg.ssid = _server.arg("ssid");
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "DataTypes.h"
 
 #ifndef __has_include
 #define __has_include(x) 0
@@ -23,6 +24,10 @@ public:
     bool isRunning() const { return _running; }
     bool isAsyncEnabled() const { return WEBUI_ASYNC_ENABLED != 0; }
 
+    // METER_DATA_UPDATED subscriber (EventTask context); loop() pushes the
+    // published value to the /ws and /ws/bin clients
+    static void onMeterData(EventType type, void* data);
+
 private:
     WebUIManager();
 
@@ -30,25 +35,43 @@ private:
     void scheduleSTAReconnect(uint32_t delayMs = 300);
 
     String buildMeterJson(bool refreshMeter);
+    String buildMeterJson(const MeterData& m);
     String buildStatusJson();
     String buildConfigJson();
+    String buildHarmonicsJson();
+    String buildHarmonicRatiosJson();
+    String buildFastPowerJson();
+    String buildPerfJson();
+    String buildEnergyJson();
+    String buildEventsJson();
+    String buildTasksJson();
     bool applyConfigJson(const String& body);
 
     String buildWiFiSetupPage();
 
+    // /api/waveform?ch=<mask>&cycles=<n> captures first; without cycles the last capture is
+    // streamed. Captures run in the request handler, so they are kept short.
+    static constexpr uint16_t WAVEFORM_HTTP_MAX_CYCLES = 50;
+    bool startWaveformCapture(bool hasCycles, const String& ch, const String& cycles);
+
 #if WEBUI_ASYNC_ENABLED
     void setupWebSocket();
     void handleWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client,
                               AwsEventType type, void* arg, uint8_t* data, size_t len);
+    size_t buildMeterFrame(uint8_t* buf, size_t len);
+    size_t buildMeterFrame(const MeterData& m, uint8_t* buf, size_t len);
     void handleAsyncStaticFile(AsyncWebServerRequest* request, const String& path, const String& contentType);
     void handleAsyncSaveForm(AsyncWebServerRequest* request);
     void handleAsyncConfigPostBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    void handleAsyncWaveform(AsyncWebServerRequest* request);
     void sendAsyncJson(AsyncWebServerRequest* request, int code, const String& json);
     void sendAsyncCaptiveRedirect(AsyncWebServerRequest* request);
 
     AsyncWebServer _server;
     AsyncWebSocket _ws;
+    AsyncWebSocket _wsBin;              // Same push as /ws, as binary MeterWireFormat frames
     uint32_t _lastWsBroadcastMs;
+    static constexpr uint32_t WS_PUSH_MIN_MS = 1000;    // Newer values in between are skipped
     String _configPostBodyBuf;
 #else
     void handleRoot();
@@ -58,6 +81,14 @@ private:
     void handleApiStatus();
     void handleApiConfigGet();
     void handleApiConfigPost();
+    void handleApiWaveform();
+    void handleApiHarmonics();
+    void handleApiHarmonicRatios();
+    void handleApiFastPower();
+    void handleApiPerf();
+    void handleApiEnergy();
+    void handleApiEvents();
+    void handleApiTasks();
     void handleSaveForm();
     void handleCaptiveRedirect();
     void handleNotFound();
@@ -67,6 +98,7 @@ private:
 #endif
 
     bool _running;
+    volatile bool _meterPushPending;    // Set by onMeterData(), cleared by the push
     uint16_t _port;
     uint32_t _deferredStaReconnectAtMs;
 };
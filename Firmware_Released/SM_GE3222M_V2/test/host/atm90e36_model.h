@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - ATM90E36 Register Model (host tests)
+ *
+ * Behavioural model of the ATM90E36 SPI slave: one CS-framed access is an
+ * address word (bit 15 = read) followed by a data word.
+ *
+ * Features:
+ * - 0x00-0xFF register file, LastSPIData tracking, clear-on-read energy
+ *   registers (0x80-0x93)
+ * - Measurement updates injected between accesses (tear tests) through onAccess
+ * - Link limit: above maxClockHz reads come back bit-slipped
+ */
+
+#include <functional>
+
+#include "host_runtime.h"
+#include "EnergyATM90E36.h"
+#include "RegisterMap.h"
+
+class Atm90e36Model : public host::SpiDevice {
+public:
+    static constexpr uint16_t REG_COUNT = 0x100;
+
+    uint16_t regs[REG_COUNT];
+    uint32_t maxClockHz = 2000000;
+
+    // Called with the access index before the data word of every access
+    std::function<void(Atm90e36Model&, uint32_t)> onAccess;
+
+    uint32_t accesses = 0;
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+    uint32_t shortFrames = 0;   // CS released before the data word
+
+    Atm90e36Model() { reset(); }
+
+    void reset() {
+        memset(regs, 0, sizeof(regs));
+        accesses = reads = writes = shortFrames = 0;
+        m_phase = IDLE;
+    }
+
+    void set32(uint16_t hiAddr, uint16_t loAddr, int32_t value) {
+        regs[hiAddr] = (uint16_t)((uint32_t)value >> 16);
+        regs[loAddr] = (uint16_t)((uint32_t)value & 0xFFFF);
+    }
+
+    // A plausible 3-phase operating point
+    void loadOperatingPoint() {
+        regs[UrmsA] = 23012; regs[UrmsB] = 23105; regs[UrmsC] = 22987;
+        regs[IrmsA] = 5123;  regs[IrmsB] = 4870;  regs[IrmsC] = 5011;  regs[IrmsN] = 212;
+        set32(PmeanA, PmeanALSB, 3512345);
+        set32(PmeanB, PmeanBLSB, -1200000);
+        set32(PmeanC, PmeanCLSB, 3400000);
+        set32(PmeanT, PmeanTLSB, 5712345);
+        regs[PFmeanA] = 987; regs[PFmeanB] = (uint16_t)-955; regs[PFmeanC] = 990; regs[PFmeanT] = 970;
+        regs[Freq] = 5002;
+        regs[Temp] = 31;
+    }
+
+    static bool clearOnRead(uint16_t addr) { return addr >= APenergyT && addr <= SenergyC; }
+
+    // Direct access for transports that frame accesses themselves
+    uint16_t access(uint16_t addrWord, uint16_t dataWord, uint32_t clockHz) {
+        const uint16_t addr = addrWord & 0x03FF;
+        const bool read = (addrWord & 0x8000) != 0;
+
+        if (onAccess) onAccess(*this, accesses);
+        accesses++;
+
+        if (addr >= REG_COUNT) return 0xFFFF;
+
+        uint16_t value;
+        if (read) {
+            reads++;
+            value = regs[addr];
+            if (clearOnRead(addr)) regs[addr] = 0;
+            if (addr != REG_LAST_SPI_DATA) regs[REG_LAST_SPI_DATA] = value;
+        } else {
+            writes++;
+            regs[addr] = dataWord;
+            regs[REG_LAST_SPI_DATA] = dataWord;
+            value = dataWord;
+        }
+
+        // Past the link limit MISO is sampled a bit late
+        if (clockHz > maxClockHz) value = (uint16_t)((value << 1) | 1);
+        return value;
+    }
+
+    // host::SpiDevice
+    void select() override { m_phase = ADDRESS; }
+
+    void deselect() override {
+        if (m_phase == DATA) shortFrames++;
+        m_phase = IDLE;
+    }
+
+    uint16_t transfer16(uint16_t mosi, uint32_t clockHz) override {
+        switch (m_phase) {
+            case ADDRESS:
+                m_addrWord = mosi;
+                m_phase = DATA;
+                return 0x0000;
+            case DATA:
+                m_phase = DONE;
+                return access(m_addrWord, mosi, clockHz);
+            default:
+                return 0xFFFF;
+        }
+    }
+
+private:
+    enum Phase { IDLE, ADDRESS, DATA, DONE };
+    Phase m_phase = IDLE;
+    uint16_t m_addrWord = 0;
+};
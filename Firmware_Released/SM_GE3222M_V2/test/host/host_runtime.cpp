@@ -0,0 +1,820 @@
+/**
+ * SM-GE3222M V2.0 - Host Test Runtime Implementation
+ *
+ * Arduino, ESP-IDF and FreeRTOS calls used by the firmware modules, emulated
+ * on std::thread primitives so the modules run unmodified on a PC.
+ */
+
+#include "host_runtime.h"
+
+#include <SPI.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <esp_partition.h>
+#include <nvs_flash.h>
+#include <Preferences.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Logger.h"
+
+namespace {
+
+// ---- Clock ----
+
+using SteadyClock = std::chrono::steady_clock;
+
+const SteadyClock::time_point g_start = SteadyClock::now();
+std::atomic<bool>    g_virtual{false};
+std::atomic<int64_t> g_virtualUs{0};
+
+int64_t realUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - g_start).count();
+}
+
+void sleepUs(int64_t us) {
+    if (us <= 0) return;
+    if (g_virtual) {
+        g_virtualUs += us;
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+// Blocking waits time out on the virtual clock without sleeping
+template <typename Lock, typename Pred>
+bool waitTicks(std::condition_variable& cv, Lock& lock, TickType_t ticks, Pred ready) {
+    if (ready()) return true;
+    if (ticks == 0) return false;
+    if (g_virtual) {
+        if (ticks != portMAX_DELAY) g_virtualUs += (int64_t)ticks * 1000;
+        return ready();
+    }
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, ready);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+}
+
+// ---- Tasks ----
+
+struct HostTask {
+    std::string name;
+    std::mutex m;
+    std::condition_variable cv;
+    uint32_t notify = 0;
+};
+
+struct TaskExit {};
+
+thread_local HostTask* t_current = nullptr;
+
+// Handles stay valid after the task ends, so a late notify never touches
+// freed memory; the list keeps them reachable for LeakSanitizer
+HostTask* newTask(const char* name) {
+    static std::mutex m;
+    static std::vector<HostTask*>* all = new std::vector<HostTask*>();
+    HostTask* task = new HostTask();
+    task->name = name;
+    std::lock_guard<std::mutex> lock(m);
+    all->push_back(task);
+    return task;
+}
+
+HostTask* currentTask() {
+    if (t_current == nullptr) {
+        t_current = newTask("host");    // Threads not created through xTaskCreate*()
+    }
+    return t_current;
+}
+
+std::mutex g_taskMutex;
+std::map<TaskHandle_t, UBaseType_t> g_highWater;
+std::vector<TaskStatus_t> g_systemState;
+uint32_t g_totalRunTime = 0;
+TaskHandle_t g_idle[portNUM_PROCESSORS] = {};
+
+std::recursive_mutex g_critical;
+
+// ---- Semaphores and queues ----
+
+// Waiters are served in arrival order, as FreeRTOS does for tasks of equal
+// priority (a plain std::mutex lets the releasing thread take it straight back)
+struct HostSemaphore {
+    struct Waiter {
+        bool granted = false;
+    };
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<Waiter*> waiters;
+    UBaseType_t count;
+    UBaseType_t maxCount;
+    std::thread::id owner;
+    UBaseType_t depth = 0;
+
+    HostSemaphore(UBaseType_t initial, UBaseType_t max) : count(initial), maxCount(max) {}
+
+    // Called with m held
+    bool take(std::unique_lock<std::mutex>& lock, TickType_t ticks) {
+        if (count > 0 && waiters.empty()) {
+            count--;
+            return true;
+        }
+        if (ticks == 0) return false;
+        if (g_virtual) {
+            // Single-threaded on the virtual clock: nobody can give it back
+            if (ticks != portMAX_DELAY) g_virtualUs += (int64_t)ticks * 1000;
+            return false;
+        }
+        Waiter w;
+        waiters.push_back(&w);
+        auto granted = [&w] { return w.granted; };
+        if (ticks == portMAX_DELAY) {
+            cv.wait(lock, granted);
+        } else if (!cv.wait_for(lock, std::chrono::milliseconds(ticks), granted)) {
+            waiters.erase(std::find(waiters.begin(), waiters.end(), &w));
+            return false;
+        }
+        return true;
+    }
+
+    // Called with m held; false when already at maxCount
+    bool give() {
+        if (!waiters.empty()) {
+            waiters.front()->granted = true;
+            waiters.pop_front();
+            cv.notify_all();
+            return true;
+        }
+        if (count >= maxCount) return false;
+        count++;
+        return true;
+    }
+};
+
+struct HostQueue {
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::string> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+
+    HostQueue(UBaseType_t len, UBaseType_t size) : length(len), itemSize(size) {}
+};
+
+// ---- SPI ----
+
+struct SpiState {
+    std::mutex m;
+    std::map<uint8_t, host::SpiDevice*> devices;
+    host::SpiDevice* selected = nullptr;
+    uint32_t clockHz = 1000000;
+    uint64_t busNs = 0;
+    uint64_t carryNs = 0;       // Clocking time not yet moved onto the virtual clock
+    host::SpiStats stats = {};
+};
+
+SpiState& spi() {
+    static SpiState s;
+    return s;
+}
+
+// ---- Storage ----
+
+struct NvsValue {
+    char type;                  // Preferences put* type tag
+    std::string bytes;
+};
+
+struct NvsStore {
+    std::mutex m;
+    std::map<std::string, std::map<std::string, NvsValue>> namespaces;
+};
+
+NvsStore& nvs() {
+    static NvsStore s;
+    return s;
+}
+
+struct HostPartition {
+    esp_partition_t part;
+    std::string label;
+    std::vector<uint8_t> data;
+};
+
+std::mutex g_partitionMutex;
+std::deque<HostPartition> g_partitions;     // Stable addresses for the returned pointers
+
+HostPartition* findPartition(const esp_partition_t* part) {
+    for (HostPartition& p : g_partitions) {
+        if (&p.part == part) return &p;
+    }
+    return nullptr;
+}
+
+uint8_t g_pinLevel[64];
+
+bool verbose() {
+    const char* v = getenv("HOST_VERBOSE");
+    return v != nullptr && v[0] != '\0' && v[0] != '0';
+}
+
+} // namespace
+
+// ============================================================================
+// host:: controls
+// ============================================================================
+
+namespace host {
+
+void useVirtualClock(bool on) {
+    g_virtualUs = 0;
+    g_virtual = on;
+}
+
+bool isVirtualClock() {
+    return g_virtual;
+}
+
+int64_t nowUs() {
+    return g_virtual ? g_virtualUs.load() : realUs();
+}
+
+void advanceUs(int64_t us) {
+    sleepUs(us);
+}
+
+void attachSpiDevice(uint8_t csPin, SpiDevice* device) {
+    std::lock_guard<std::mutex> lock(spi().m);
+    spi().devices[csPin] = device;
+}
+
+SpiStats spiStats() {
+    std::lock_guard<std::mutex> lock(spi().m);
+    SpiStats s = spi().stats;
+    s.busUs = spi().busNs / 1000;
+    s.lastClockHz = spi().clockHz;
+    return s;
+}
+
+void resetSpiStats() {
+    std::lock_guard<std::mutex> lock(spi().m);
+    const bool open = spi().stats.inTransaction;
+    spi().stats = {};
+    spi().stats.inTransaction = open;
+    spi().busNs = 0;
+}
+
+void setStackHighWaterMark(TaskHandle_t task, UBaseType_t words) {
+    std::lock_guard<std::mutex> lock(g_taskMutex);
+    g_highWater[task] = words;
+}
+
+void setSystemState(const std::vector<TaskStatus_t>& tasks, uint32_t totalRunTime) {
+    std::lock_guard<std::mutex> lock(g_taskMutex);
+    g_systemState = tasks;
+    g_totalRunTime = totalRunTime;
+}
+
+void setIdleTask(BaseType_t core, TaskHandle_t task) {
+    if (core >= 0 && core < portNUM_PROCESSORS) g_idle[core] = task;
+}
+
+void addPartition(const char* label, size_t size) {
+    std::lock_guard<std::mutex> lock(g_partitionMutex);
+    g_partitions.emplace_back();
+    HostPartition& p = g_partitions.back();
+    p.label = label;
+    p.data.assign(size, 0xFF);
+    p.part.size = (uint32_t)size;
+    p.part.label = p.label.c_str();
+}
+
+void clearNvs() {
+    std::lock_guard<std::mutex> lock(nvs().m);
+    nvs().namespaces.clear();
+}
+
+void initLogger() {
+    Logger::getInstance().init(LogLevel::DEBUG, verbose());
+}
+
+size_t countLogs(LogLevel level, const char* text) {
+    size_t count = 0;
+    const LogEntry* logs = Logger::getInstance().getRecentLogs(count);
+    size_t found = 0;
+    for (size_t i = 0; logs != nullptr && i < count; ++i) {
+        if (logs[i].level == level && strstr(logs[i].message, text) != nullptr) found++;
+    }
+    return found;
+}
+
+} // namespace host
+
+// ============================================================================
+// Arduino
+// ============================================================================
+
+HardwareSerial Serial;
+HardwareSerial Serial2;
+SPIClass SPI;
+
+void HardwareSerial::begin(unsigned long, uint32_t, int8_t, int8_t) {}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    if (!verbose()) return 0;
+    va_list args;
+    va_start(args, format);
+    const int n = vprintf(format, args);
+    va_end(args);
+    return n > 0 ? (size_t)n : 0;
+}
+
+size_t HardwareSerial::print(const char* s) {
+    return printf("%s", s);
+}
+
+size_t HardwareSerial::printNumber(long v, int base) {
+    return base == 16 ? printf("%lX", v) : printf("%ld", v);
+}
+
+size_t HardwareSerial::printNumber(unsigned long v, int base) {
+    return base == 16 ? printf("%lX", v) : printf("%lu", v);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= sizeof(g_pinLevel)) return;
+    SpiState& s = spi();
+    std::lock_guard<std::mutex> lock(s.m);
+    const uint8_t prev = g_pinLevel[pin];
+    g_pinLevel[pin] = val;
+
+    auto it = s.devices.find(pin);
+    if (it == s.devices.end() || prev == val) return;
+    if (val == LOW) {
+        s.selected = it->second;
+        s.stats.selects++;
+        it->second->select();
+    } else if (s.selected == it->second) {
+        it->second->deselect();
+        s.selected = nullptr;
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < sizeof(g_pinLevel) ? g_pinLevel[pin] : LOW;
+}
+
+unsigned long millis() {
+    return (unsigned long)(host::nowUs() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)host::nowUs();
+}
+
+void delay(uint32_t ms) {
+    sleepUs((int64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    sleepUs(us);
+}
+
+// ============================================================================
+// SPI
+// ============================================================================
+
+void SPIClass::begin(int8_t, int8_t, int8_t, int8_t) {}
+void SPIClass::end() {}
+
+void SPIClass::beginTransaction(SPISettings settings) {
+    std::lock_guard<std::mutex> lock(spi().m);
+    spi().clockHz = settings._clock;
+    spi().stats.transactions++;
+    spi().stats.inTransaction = true;
+}
+
+void SPIClass::endTransaction() {
+    std::lock_guard<std::mutex> lock(spi().m);
+    spi().stats.inTransaction = false;
+}
+
+namespace {
+
+// Charges `bits` of clocking at the transaction clock and returns the device
+template <typename Xfer>
+auto clockBits(uint32_t bits, Xfer xfer) -> decltype(xfer(nullptr, 0u)) {
+    SpiState& s = spi();
+    int64_t advance = 0;
+    host::SpiDevice* dev;
+    uint32_t hz;
+    {
+        std::lock_guard<std::mutex> lock(s.m);
+        dev = s.selected;
+        hz = s.clockHz ? s.clockHz : 1;
+        const uint64_t ns = (uint64_t)bits * 1000000000ULL / hz;
+        s.busNs += ns;
+        s.stats.bits += bits;
+        if (g_virtual) {
+            s.carryNs += ns;
+            advance = (int64_t)(s.carryNs / 1000);
+            s.carryNs %= 1000;
+        }
+    }
+    g_virtualUs += advance;
+    return xfer(dev, hz);
+}
+
+} // namespace
+
+uint8_t SPIClass::transfer(uint8_t data) {
+    return clockBits(8, [data](host::SpiDevice* dev, uint32_t hz) -> uint8_t {
+        return dev ? dev->transfer(data, hz) : 0xFF;
+    });
+}
+
+uint16_t SPIClass::transfer16(uint16_t data) {
+    return clockBits(16, [data](host::SpiDevice* dev, uint32_t hz) -> uint16_t {
+        return dev ? dev->transfer16(data, hz) : 0xFFFF;
+    });
+}
+
+// ============================================================================
+// Preferences
+// ============================================================================
+
+bool Preferences::begin(const char* name, bool readOnly, const char*) {
+    if (m_open || name == nullptr || strlen(name) > 15) return false;
+    m_namespace = name;
+    m_readOnly = readOnly;
+    m_open = true;
+    return true;
+}
+
+void Preferences::end() {
+    m_open = false;
+}
+
+bool Preferences::clear() {
+    if (!m_open || m_readOnly) return false;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    nvs().namespaces.erase(m_namespace);
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!m_open || m_readOnly) return false;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    return nvs().namespaces[m_namespace].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!m_open) return false;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    const auto ns = nvs().namespaces.find(m_namespace);
+    return ns != nvs().namespaces.end() && ns->second.count(key) > 0;
+}
+
+String Preferences::getString(const char* key, const String& def) {
+    if (!m_open) return def;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    const auto ns = nvs().namespaces.find(m_namespace);
+    if (ns == nvs().namespaces.end()) return def;
+    const auto it = ns->second.find(key);
+    return (it != ns->second.end() && it->second.type == 'z') ? String(it->second.bytes) : def;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+    const String s = getString(key, String());
+    if (!isKey(key) || maxLen == 0 || s.length() >= maxLen) return 0;
+    memcpy(value, s.c_str(), s.length() + 1);
+    return s.length() + 1;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!m_open) return 0;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    const auto ns = nvs().namespaces.find(m_namespace);
+    if (ns == nvs().namespaces.end()) return 0;
+    const auto it = ns->second.find(key);
+    return (it != ns->second.end() && it->second.type == 'B') ? it->second.bytes.size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!m_open) return 0;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    const auto ns = nvs().namespaces.find(m_namespace);
+    if (ns == nvs().namespaces.end()) return 0;
+    const auto it = ns->second.find(key);
+    if (it == ns->second.end() || it->second.type != 'B' || it->second.bytes.size() > maxLen) return 0;
+    memcpy(buf, it->second.bytes.data(), it->second.bytes.size());
+    return it->second.bytes.size();
+}
+
+size_t Preferences::put(const char* key, char type, const void* value, size_t len) {
+    if (!m_open || m_readOnly || key == nullptr || strlen(key) > 15) return 0;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    nvs().namespaces[m_namespace][key] = NvsValue{ type, std::string((const char*)value, len) };
+    return len;
+}
+
+bool Preferences::get(const char* key, char type, void* out, size_t len) {
+    if (!m_open) return false;
+    std::lock_guard<std::mutex> lock(nvs().m);
+    const auto ns = nvs().namespaces.find(m_namespace);
+    if (ns == nvs().namespaces.end()) return false;
+    const auto it = ns->second.find(key);
+    if (it == ns->second.end() || it->second.type != type || it->second.bytes.size() != len) return false;
+    memcpy(out, it->second.bytes.data(), len);
+    return true;
+}
+
+// ============================================================================
+// ESP-IDF
+// ============================================================================
+
+esp_err_t nvs_flash_init() {
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase() {
+    host::clearNvs();
+    return ESP_OK;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t,
+                                                const char* label) {
+    if (type != ESP_PARTITION_TYPE_DATA || label == nullptr) return nullptr;
+    std::lock_guard<std::mutex> lock(g_partitionMutex);
+    for (const HostPartition& p : g_partitions) {
+        if (p.label == label) return &p.part;
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* part, size_t offset, void* dst, size_t len) {
+    std::lock_guard<std::mutex> lock(g_partitionMutex);
+    HostPartition* p = findPartition(part);
+    if (p == nullptr || offset + len > p->data.size()) return ESP_FAIL;
+    memcpy(dst, &p->data[offset], len);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* part, size_t offset, const void* src, size_t len) {
+    std::lock_guard<std::mutex> lock(g_partitionMutex);
+    HostPartition* p = findPartition(part);
+    if (p == nullptr || offset + len > p->data.size()) return ESP_FAIL;
+    const uint8_t* bytes = (const uint8_t*)src;
+    for (size_t i = 0; i < len; ++i) p->data[offset + i] &= bytes[i];     // NOR: only clears bits
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* part, size_t offset, size_t len) {
+    std::lock_guard<std::mutex> lock(g_partitionMutex);
+    HostPartition* p = findPartition(part);
+    if (p == nullptr || offset % 4096 != 0 || len % 4096 != 0 || offset + len > p->data.size()) return ESP_FAIL;
+    memset(&p->data[offset], 0xFF, len);
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+    return host::nowUs();
+}
+
+void* heap_caps_malloc(size_t size, uint32_t) {
+    return malloc(size);
+}
+
+void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+// ============================================================================
+// FreeRTOS tasks
+// ============================================================================
+
+void hostEnterCritical() {
+    g_critical.lock();
+}
+
+void hostExitCritical() {
+    g_critical.unlock();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t, void* param,
+                                   UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    HostTask* task = newTask(name ? name : "");
+    if (handle) *handle = task;
+    std::thread([fn, param, task]() {
+        t_current = task;
+        try {
+            fn(param);
+        } catch (const TaskExit&) {
+        }
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    // Only a task ending itself is supported (threads cannot be killed)
+    if (task == nullptr || task == currentTask()) throw TaskExit();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    sleepUs((int64_t)ticks * 1000);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(host::nowUs() / 1000);
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period) {
+    *previousWake += period;
+    const int64_t waitTicks = (int32_t)(*previousWake - xTaskGetTickCount());
+    if (waitTicks > 0) sleepUs(waitTicks * 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    std::lock_guard<std::mutex> lock(g_taskMutex);
+    auto it = g_highWater.find(task ? task : currentTask());
+    return it != g_highWater.end() ? it->second : 1024;
+}
+
+BaseType_t xPortGetCoreID() {
+    return 1;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    HostTask* t = static_cast<HostTask*>(task);
+    {
+        std::lock_guard<std::mutex> lock(t->m);
+        t->notify++;
+    }
+    t->cv.notify_all();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityWoken) *higherPriorityWoken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask* t = currentTask();
+    std::unique_lock<std::mutex> lock(t->m);
+    if (!waitTicks(t->cv, lock, ticks, [t] { return t->notify > 0; })) return 0;
+    const uint32_t value = t->notify;
+    t->notify = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* status, UBaseType_t maxCount, uint32_t* totalRunTime) {
+    std::lock_guard<std::mutex> lock(g_taskMutex);
+    if (g_systemState.size() > maxCount) return 0;
+    for (size_t i = 0; i < g_systemState.size(); ++i) status[i] = g_systemState[i];
+    if (totalRunTime) *totalRunTime = g_totalRunTime;
+    return (UBaseType_t)g_systemState.size();
+}
+
+TaskHandle_t xTaskGetIdleTaskHandleForCore(BaseType_t core) {
+    return (core >= 0 && core < portNUM_PROCESSORS) ? g_idle[core] : nullptr;
+}
+
+// ============================================================================
+// FreeRTOS semaphores
+// ============================================================================
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new HostSemaphore(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return new HostSemaphore(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return new HostSemaphore(0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    return new HostSemaphore(initialCount, maxCount);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    HostSemaphore* s = static_cast<HostSemaphore*>(sem);
+    std::unique_lock<std::mutex> lock(s->m);
+    return s->take(lock, ticks) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    HostSemaphore* s = static_cast<HostSemaphore*>(sem);
+    std::lock_guard<std::mutex> lock(s->m);
+    return s->give() ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks) {
+    HostSemaphore* s = static_cast<HostSemaphore*>(sem);
+    const std::thread::id self = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(s->m);
+    if (s->depth > 0 && s->owner == self) {
+        s->depth++;
+        return pdTRUE;
+    }
+    if (!s->take(lock, ticks)) return pdFALSE;
+    s->owner = self;
+    s->depth = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem) {
+    HostSemaphore* s = static_cast<HostSemaphore*>(sem);
+    std::lock_guard<std::mutex> lock(s->m);
+    if (s->depth == 0 || s->owner != std::this_thread::get_id()) return pdFALSE;
+    if (--s->depth > 0) return pdTRUE;
+    s->owner = std::thread::id();
+    return s->give() ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t* higherPriorityWoken) {
+    if (higherPriorityWoken) *higherPriorityWoken = pdFALSE;
+    return xSemaphoreGive(sem);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    delete static_cast<HostSemaphore*>(sem);
+}
+
+// ============================================================================
+// FreeRTOS queues
+// ============================================================================
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    return new HostQueue(length, itemSize);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    HostQueue* q = static_cast<HostQueue*>(queue);
+    {
+        std::unique_lock<std::mutex> lock(q->m);
+        if (!waitTicks(q->cv, lock, ticks, [q] { return q->items.size() < q->length; })) return errQUEUE_FULL;
+        q->items.emplace_back(static_cast<const char*>(item), q->itemSize);
+    }
+    q->cv.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    return xQueueSend(queue, item, ticks);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higherPriorityWoken) {
+    if (higherPriorityWoken) *higherPriorityWoken = pdFALSE;
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    HostQueue* q = static_cast<HostQueue*>(queue);
+    {
+        std::unique_lock<std::mutex> lock(q->m);
+        if (!waitTicks(q->cv, lock, ticks, [q] { return !q->items.empty(); })) return pdFALSE;
+        memcpy(item, q->items.front().data(), q->itemSize);
+        q->items.pop_front();
+    }
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    HostQueue* q = static_cast<HostQueue*>(queue);
+    std::lock_guard<std::mutex> lock(q->m);
+    return (UBaseType_t)q->items.size();
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete static_cast<HostQueue*>(queue);
+}
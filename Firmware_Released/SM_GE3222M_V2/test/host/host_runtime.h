@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host Test Runtime
+ *
+ * Controls for the emulated ESP32/FreeRTOS environment the firmware modules
+ * run on in the host tests (implementation in host_runtime.cpp).
+ *
+ * Features:
+ * - Real clock (steady_clock) or a virtual clock that only moves when the code
+ *   under test delays, blocks with a timeout or transfers on the SPI bus
+ * - SPI devices attached per chip-select pin, bus time charged at the
+ *   transaction clock (16 bits per transfer16)
+ * - Scripted stack high-water marks and run-time counters for TaskMonitor
+ * - NVS (Preferences) and data partitions in memory, kept for the whole run
+ */
+
+#include <Arduino.h>
+#include <freertos/task.h>
+#include <vector>
+#include "DataTypes.h"
+
+namespace host {
+
+// ---- Clock ----
+
+// Virtual: time starts at 0 and only moves through delays, timeouts, SPI
+// transfers and advanceUs(). Real: steady_clock since the first call.
+void useVirtualClock(bool on);
+bool isVirtualClock();
+int64_t nowUs();
+void advanceUs(int64_t us);
+
+// ---- SPI ----
+
+class SpiDevice {
+public:
+    virtual ~SpiDevice() = default;
+    virtual void select() {}
+    virtual void deselect() {}
+    virtual uint16_t transfer16(uint16_t mosi, uint32_t clockHz) = 0;
+    virtual uint8_t transfer(uint8_t mosi, uint32_t clockHz) { return (uint8_t)transfer16(mosi, clockHz); }
+};
+
+void attachSpiDevice(uint8_t csPin, SpiDevice* device);
+
+struct SpiStats {
+    uint32_t transactions;      // beginTransaction() calls
+    uint32_t selects;           // CS falling edges on attached devices
+    uint64_t bits;              // Bits clocked
+    uint64_t busUs;             // Modelled clocking time (bits / clock)
+    uint32_t lastClockHz;
+    bool     inTransaction;
+};
+
+SpiStats spiStats();
+void resetSpiStats();
+
+// ---- Tasks ----
+
+// Stack high-water mark (words) reported for a task handle (default 1024)
+void setStackHighWaterMark(TaskHandle_t task, UBaseType_t words);
+
+// Table returned by uxTaskGetSystemState() and the idle task handle per core
+void setSystemState(const std::vector<TaskStatus_t>& tasks, uint32_t totalRunTime);
+void setIdleTask(BaseType_t core, TaskHandle_t task);
+
+// ---- Storage ----
+
+// Erased data partition of `size` bytes for esp_partition_find_first(label)
+void addPartition(const char* label, size_t size);
+// Empty every Preferences namespace, as nvs_flash_erase() does
+void clearNvs();
+
+// ---- Logging ----
+
+// Logger::init() at DEBUG level; lines reach stdout only with HOST_VERBOSE=1
+void initLogger();
+// Log entries at `level` (in the Logger ring buffer) containing `text`
+size_t countLogs(LogLevel level, const char* text = "");
+
+} // namespace host
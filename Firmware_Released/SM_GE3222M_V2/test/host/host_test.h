@@ -0,0 +1,56 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host Test Checks
+ *
+ * Minimal check/report helpers shared by the test_*.cpp programs. A failed
+ * check prints its location and the test exits non-zero at the end.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "host_runtime.h"
+
+namespace host {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline int& checks() {
+    static int count = 0;
+    return count;
+}
+
+inline bool check(bool ok, const char* expr, const char* file, int line) {
+    checks()++;
+    if (!ok) {
+        failures()++;
+        printf("  FAIL %s:%d: %s\n", file, line, expr);
+    }
+    return ok;
+}
+
+// Prints the summary line and returns the process exit code
+inline int report(const char* name) {
+    printf("%s: %d checks, %d failed\n", name, checks(), failures());
+    return failures() == 0 ? 0 : 1;
+}
+
+// Host CPU time of fn() averaged over `runs` calls, in nanoseconds
+template <typename Fn>
+double nsPerCall(int runs, Fn fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) fn();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / runs;
+}
+
+} // namespace host
+
+#define CHECK(cond) host::check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(a, b) host::check((a) == (b), #a " == " #b, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, tol) host::check(std::fabs((double)(a) - (double)(b)) <= (tol), #a " ~= " #b, __FILE__, __LINE__)
@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: Arduino core
+ *
+ * Just enough of the ESP32 Arduino API to compile the firmware modules under
+ * test on a PC. Time, pins and Serial are provided by host_runtime.cpp.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+// The ESP32 core pulls the FreeRTOS task, queue and semaphore APIs in with Arduino.h
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define IRAM_ATTR
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#define SERIAL_8N1 0x800001c
+
+using std::min;
+using std::max;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+inline void yield() {}
+
+// Arduino String on top of std::string (only what the tested modules use)
+class String {
+public:
+    String() {}
+    String(const char* s) : m_s(s ? s : "") {}
+    String(const std::string& s) : m_s(s) {}
+    String(char c) : m_s(1, c) {}
+    String(int v) : m_s(std::to_string(v)) {}
+    String(unsigned int v) : m_s(std::to_string(v)) {}
+    String(long v) : m_s(std::to_string(v)) {}
+    String(unsigned long v) : m_s(std::to_string(v)) {}
+    String(float v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+    String(double v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+
+    const char* c_str() const { return m_s.c_str(); }
+    unsigned int length() const { return (unsigned int)m_s.size(); }
+    bool isEmpty() const { return m_s.empty(); }
+    void reserve(unsigned int n) { m_s.reserve(n); }
+
+    String& operator+=(const String& o) { m_s += o.m_s; return *this; }
+    String& operator+=(const char* o) { m_s += o; return *this; }
+    String& operator+=(char c) { m_s += c; return *this; }
+    friend String operator+(String a, const String& b) { a += b; return a; }
+    bool operator==(const String& o) const { return m_s == o.m_s; }
+    bool operator!=(const String& o) const { return m_s != o.m_s; }
+    char operator[](unsigned int i) const { return i < m_s.size() ? m_s[i] : 0; }
+
+private:
+    void fromDouble(double v, unsigned int decimals) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        m_s = buf;
+    }
+    std::string m_s;
+};
+
+// Serial port: output goes to stdout only when HOST_VERBOSE is set
+class HardwareSerial {
+public:
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+    void setTimeout(unsigned long) {}
+    operator bool() const { return true; }
+    int available() { return 0; }
+    int read() { return -1; }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char* s);
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c) { const char s[2] = { c, 0 }; return print(s); }
+    size_t print(int v, int base = 10) { return printNumber((long)v, base); }
+    size_t print(unsigned int v, int base = 10) { return printNumber((unsigned long)v, base); }
+    size_t print(long v, int base = 10) { return printNumber(v, base); }
+    size_t print(unsigned long v, int base = 10) { return printNumber(v, base); }
+    size_t print(double v, int decimals = 2) { return printf("%.*f", decimals, v); }
+    template <typename T> size_t println(T v) { return print(v) + print("\n"); }
+    template <typename T> size_t println(T v, int fmt) { return print(v, fmt) + print("\n"); }
+    size_t println() { return print("\n"); }
+
+private:
+    size_t printNumber(long v, int base);
+    size_t printNumber(unsigned long v, int base);
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;     // Modbus RTU port
@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: HardwareSerial
+ *
+ * The class lives in the Arduino.h stub, as on the ESP32 core.
+ */
+
+#include <Arduino.h>
@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: ModbusRTU (emelianov modbus-esp8266)
+ *
+ * The library's register store without the serial side. As in the library,
+ * a register must be added before it can be written or read; reads of an
+ * address that was never added fail like Illegal Data Address on the bus.
+ * readIregs() is the master's view (function code 0x04) for the tests.
+ */
+
+#include <Arduino.h>
+
+#include <map>
+
+class ModbusRTU {
+public:
+    ModbusRTU() { s_last = this; }
+
+    // The most recently constructed instance (ModbusServer keeps its own privately)
+    static ModbusRTU* hostInstance() { return s_last; }
+
+    bool begin(HardwareSerial*, int16_t = -1, bool = true) { return true; }
+    void setBaudrate(uint32_t) {}
+    bool slave(uint8_t id) { m_slave = id; return true; }
+    void task() {}
+
+    bool addIreg(uint16_t offset, uint16_t value = 0) { return add(m_ireg, offset, value); }
+    bool Ireg(uint16_t offset, uint16_t value) { return set(m_ireg, offset, value); }
+    uint16_t Ireg(uint16_t offset) { return get(m_ireg, offset); }
+
+    bool addHreg(uint16_t offset, uint16_t value = 0) { return add(m_hreg, offset, value); }
+    bool Hreg(uint16_t offset, uint16_t value) { return set(m_hreg, offset, value); }
+    uint16_t Hreg(uint16_t offset) { return get(m_hreg, offset); }
+
+    bool addCoil(uint16_t offset, bool value = false) { return add(m_coil, offset, value); }
+    bool Coil(uint16_t offset, bool value) { return set(m_coil, offset, value); }
+    bool Coil(uint16_t offset) { return get(m_coil, offset) != 0; }
+
+    bool addIsts(uint16_t offset, bool value = false) { return add(m_ists, offset, value); }
+    bool Ists(uint16_t offset, bool value) { return set(m_ists, offset, value); }
+    bool Ists(uint16_t offset) { return get(m_ists, offset) != 0; }
+
+    // Read Input Registers as a master sees them; false if any address is not mapped
+    bool readIregs(uint16_t start, uint16_t count, uint16_t* out) const {
+        for (uint16_t i = 0; i < count; ++i) {
+            const auto it = m_ireg.find((uint16_t)(start + i));
+            if (it == m_ireg.end()) return false;
+            out[i] = it->second;
+        }
+        return true;
+    }
+
+    uint8_t slaveId() const { return m_slave; }
+
+private:
+    using Store = std::map<uint16_t, uint16_t>;
+
+    static bool add(Store& store, uint16_t offset, uint16_t value) {
+        store.emplace(offset, value);
+        return true;
+    }
+
+    static bool set(Store& store, uint16_t offset, uint16_t value) {
+        const auto it = store.find(offset);
+        if (it == store.end()) return false;
+        it->second = value;
+        return true;
+    }
+
+    static uint16_t get(const Store& store, uint16_t offset) {
+        const auto it = store.find(offset);
+        return it == store.end() ? 0 : it->second;
+    }
+
+    static inline ModbusRTU* s_last = nullptr;
+
+    Store m_ireg;
+    Store m_hreg;
+    Store m_coil;
+    Store m_ists;
+    uint8_t m_slave = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: Preferences (ESP32 Arduino NVS wrapper)
+ *
+ * Namespaces and keys in a process-wide store (host_runtime.cpp), so a second
+ * Preferences object sees what an earlier one wrote, as after a reboot. Values
+ * keep the bytes and the type they were written with; a getter of another
+ * type returns its default, as a type mismatch does on the device.
+ */
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBool(const char* key, bool value)         { return put(key, 'b', &value, sizeof(value)); }
+    size_t putChar(const char* key, int8_t value)       { return put(key, 'c', &value, sizeof(value)); }
+    size_t putUChar(const char* key, uint8_t value)     { return put(key, 'C', &value, sizeof(value)); }
+    size_t putShort(const char* key, int16_t value)     { return put(key, 's', &value, sizeof(value)); }
+    size_t putUShort(const char* key, uint16_t value)   { return put(key, 'S', &value, sizeof(value)); }
+    size_t putInt(const char* key, int32_t value)       { return put(key, 'i', &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value)     { return put(key, 'I', &value, sizeof(value)); }
+    size_t putFloat(const char* key, float value)       { return put(key, 'f', &value, sizeof(value)); }
+    size_t putDouble(const char* key, double value)     { return put(key, 'd', &value, sizeof(value)); }
+    size_t putString(const char* key, const String& value) { return put(key, 'z', value.c_str(), value.length()); }
+    size_t putBytes(const char* key, const void* value, size_t len) { return put(key, 'B', value, len); }
+
+    bool     getBool(const char* key, bool def = false)         { return getAs(key, 'b', def); }
+    int8_t   getChar(const char* key, int8_t def = 0)           { return getAs(key, 'c', def); }
+    uint8_t  getUChar(const char* key, uint8_t def = 0)         { return getAs(key, 'C', def); }
+    int16_t  getShort(const char* key, int16_t def = 0)         { return getAs(key, 's', def); }
+    uint16_t getUShort(const char* key, uint16_t def = 0)       { return getAs(key, 'S', def); }
+    int32_t  getInt(const char* key, int32_t def = 0)           { return getAs(key, 'i', def); }
+    uint32_t getUInt(const char* key, uint32_t def = 0)         { return getAs(key, 'I', def); }
+    float    getFloat(const char* key, float def = 0.0f)        { return getAs(key, 'f', def); }
+    double   getDouble(const char* key, double def = 0.0)       { return getAs(key, 'd', def); }
+    String   getString(const char* key, const String& def = String());
+    size_t   getString(const char* key, char* value, size_t maxLen);
+    size_t   getBytesLength(const char* key);
+    size_t   getBytes(const char* key, void* buf, size_t maxLen);
+
+private:
+    size_t put(const char* key, char type, const void* value, size_t len);
+    // Copies exactly len bytes of a value of this type; false if there is none
+    bool get(const char* key, char type, void* out, size_t len);
+
+    template <typename T>
+    T getAs(const char* key, char type, T def) {
+        T value;
+        return get(key, type, &value, sizeof(value)) ? value : def;
+    }
+
+    std::string m_namespace;
+    bool m_open = false;
+    bool m_readOnly = false;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: SPI
+ *
+ * Transfers are routed to the host::SpiDevice attached to the chip select
+ * that is currently low (see host_runtime.h) and timed at the transaction clock.
+ */
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x01
+#define SPI_MODE2 0x02
+#define SPI_MODE3 0x03
+
+class SPISettings {
+public:
+    SPISettings() : _clock(1000000), _bitOrder(MSBFIRST), _dataMode(SPI_MODE0) {}
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+        : _clock(clock), _bitOrder(bitOrder), _dataMode(dataMode) {}
+    uint32_t _clock;
+    uint8_t  _bitOrder;
+    uint8_t  _dataMode;
+};
+
+class SPIClass {
+public:
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1);
+    void end();
+    void beginTransaction(SPISettings settings);
+    void endTransaction();
+    uint8_t transfer(uint8_t data);
+    uint16_t transfer16(uint16_t data);
+};
+
+extern SPIClass SPI;
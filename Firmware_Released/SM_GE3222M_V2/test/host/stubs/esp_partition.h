@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: partitions
+ *
+ * The partition table holds only what a test adds with host::addPartition()
+ * (NOR semantics: erased bytes read 0xFF, writes clear bits); lookups of
+ * anything else fail. Implemented in host_runtime.cpp.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct {
+    uint32_t size;
+    const char* label;
+} esp_partition_t;
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0x00, ESP_PARTITION_TYPE_DATA = 0x01 } esp_partition_type_t;
+typedef enum { ESP_PARTITION_SUBTYPE_ANY = 0xff } esp_partition_subtype_t;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label);
+esp_err_t esp_partition_read(const esp_partition_t* part, size_t offset, void* dst, size_t len);
+esp_err_t esp_partition_write(const esp_partition_t* part, size_t offset, const void* src, size_t len);
+esp_err_t esp_partition_erase_range(const esp_partition_t* part, size_t offset, size_t len);
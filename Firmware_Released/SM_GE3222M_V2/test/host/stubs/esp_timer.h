@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// Microseconds since start (host clock, see host::useVirtualClock())
+int64_t esp_timer_get_time();
@@ -0,0 +1,56 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: FreeRTOS
+ *
+ * Tasks are host threads, mutexes/queues/notifications are emulated in
+ * host_runtime.cpp. One tick is one millisecond, as on the firmware.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int          BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t     TickType_t;
+typedef uint32_t     StackType_t;
+
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdFAIL  pdFALSE
+#define pdPASS  pdTRUE
+#define errQUEUE_FULL 0
+
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS  ((TickType_t)1)
+#define portNUM_PROCESSORS  2
+#define configTICK_RATE_HZ  1000
+#define configMAX_PRIORITIES 25
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define tskNO_AFFINITY      0x7FFFFFFF
+
+// HOST_RUN_TIME_STATS builds the run-time counter path of TaskMonitor
+#ifdef HOST_RUN_TIME_STATS
+#define configGENERATE_RUN_TIME_STATS 1
+#define configUSE_TRACE_FACILITY      1
+#define configRUN_TIME_COUNTER_TYPE   uint32_t
+#else
+#define configGENERATE_RUN_TIME_STATS 0
+#define configUSE_TRACE_FACILITY      0
+#endif
+
+// Critical sections: one global recursive lock
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+void hostEnterCritical();
+void hostExitCritical();
+#define portENTER_CRITICAL(mux)     hostEnterCritical()
+#define portEXIT_CRITICAL(mux)      hostExitCritical()
+#define portENTER_CRITICAL_ISR(mux) hostEnterCritical()
+#define portEXIT_CRITICAL_ISR(mux)  hostExitCritical()
+#define portYIELD_FROM_ISR(x)       ((void)(x))
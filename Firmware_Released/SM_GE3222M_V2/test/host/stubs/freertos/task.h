@@ -0,0 +1,37 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef enum { eRunning = 0, eReady, eBlocked, eSuspended, eDeleted, eInvalid } eTaskState;
+
+typedef struct {
+    TaskHandle_t xHandle;
+    const char*  pcTaskName;
+    UBaseType_t  xTaskNumber;
+    eTaskState   eCurrentState;
+    UBaseType_t  uxCurrentPriority;
+    UBaseType_t  uxBasePriority;
+    uint32_t     ulRunTimeCounter;
+    StackType_t* pxStackBase;
+    uint32_t     usStackHighWaterMark;
+    BaseType_t   xCoreID;
+} TaskStatus_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityWoken);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* status, UBaseType_t maxCount, uint32_t* totalRunTime);
+TaskHandle_t xTaskGetIdleTaskHandleForCore(BaseType_t core);
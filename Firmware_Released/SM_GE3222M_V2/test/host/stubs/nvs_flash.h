@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * SM-GE3222M V2.0 - Host test stub: NVS flash
+ *
+ * Erasing empties the Preferences store (host_runtime.cpp).
+ */
+
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_NO_FREE_PAGES     0x110d
+#define ESP_ERR_NVS_NEW_VERSION_FOUND 0x1110
+
+esp_err_t nvs_flash_init();
+esp_err_t nvs_flash_erase();
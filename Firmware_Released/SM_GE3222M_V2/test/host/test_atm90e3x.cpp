@@ -0,0 +1,472 @@
+/**
+ * SM-GE3222M V2.0 - ATM90E36 bus access tests
+ *
+ * The V1 ATM90E3x driver against a mock transport, and the full
+ * ATM90E36Driver -> SPIBus -> SPI stack against the register model.
+ * Bus times are modelled on the virtual clock: CS delays plus 16 bits per
+ * word at the transaction clock.
+ */
+
+#include "host_test.h"
+#include "atm90e36_model.h"
+
+#include "ATM90E36Driver.h"
+#include "PinMap.h"
+#include "SPIBus.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Transport that frames accesses like SPIBusTransport, straight into the model
+class ModelTransport : public ATM90E3xTransport {
+public:
+    explicit ModelTransport(Atm90e36Model& chip) : m_chip(chip) {}
+
+    bool refuse = false;
+    bool open = false;
+    uint32_t begins = 0;
+    uint32_t ends = 0;
+    uint32_t frames = 0;
+    uint32_t framesOutsideBatch = 0;
+    unsigned long clockHz = 0;
+
+    bool Begin(unsigned long hz) override {
+        if (refuse) return false;
+        begins++;
+        open = true;
+        clockHz = hz;
+        return true;
+    }
+
+    unsigned short Frame(int, unsigned short addrWord, unsigned short dataWord,
+                         unsigned int csSetupUs, unsigned int csHoldUs) override {
+        frames++;
+        if (!open) framesOutsideBatch++;
+        delayMicroseconds(csSetupUs);
+        clockWord();
+        delayMicroseconds(ATM_SWEEP_ADDR_WAIT_US);
+        clockWord();
+        const unsigned short out = m_chip.access(addrWord, dataWord, clockHz);
+        delayMicroseconds(csHoldUs);
+        return out;
+    }
+
+    void End() override {
+        ends++;
+        open = false;
+    }
+
+private:
+    void clockWord() {
+        m_carryNs += 16ULL * 1000000000ULL / (clockHz ? clockHz : 1);
+        host::advanceUs((int64_t)(m_carryNs / 1000));
+        m_carryNs %= 1000;
+    }
+
+    Atm90e36Model& m_chip;
+    uint64_t m_carryNs = 0;
+};
+
+Atm90e36Model g_chip;
+
+bool initDriver(uint32_t maxClockHz) {
+    g_chip.reset();
+    g_chip.loadOperatingPoint();
+    g_chip.maxClockHz = maxClockHz;
+    host::attachSpiDevice(PIN_SPI_CS_ATM90E36, &g_chip);
+
+    CalibrationConfig cal;
+    for (uint8_t ph = 0; ph < 3; ++ph) {
+        cal.measCalRegs[ph * 4]     = 0xCE40;    // UGain
+        cal.measCalRegs[ph * 4 + 1] = 0x7530;    // IGain
+    }
+    return ATM90E36Driver::getInstance().init(cal);
+}
+
+// Addresses of one full readAll() sweep, in bus order
+std::vector<uint16_t> recordSweepAddresses() {
+    std::vector<uint16_t> addrs;
+    g_chip.onAccess = nullptr;
+    const uint32_t before = g_chip.accesses;
+    ATM90E36Driver& drv = ATM90E36Driver::getInstance();
+
+    // Capture the address of each access through a pass-through device
+    struct Recorder : host::SpiDevice {
+        Atm90e36Model& chip;
+        std::vector<uint16_t>& out;
+        bool addrNext = false;
+        Recorder(Atm90e36Model& c, std::vector<uint16_t>& o) : chip(c), out(o) {}
+        void select() override { chip.select(); addrNext = true; }
+        void deselect() override { chip.deselect(); }
+        uint16_t transfer16(uint16_t mosi, uint32_t hz) override {
+            if (addrNext) out.push_back(mosi & 0x03FF);
+            addrNext = false;
+            return chip.transfer16(mosi, hz);
+        }
+    } recorder(g_chip, addrs);
+
+    host::attachSpiDevice(PIN_SPI_CS_ATM90E36, &recorder);
+    MeterData data;
+    drv.readAll(data);
+    host::attachSpiDevice(PIN_SPI_CS_ATM90E36, &g_chip);
+    CHECK_EQ(g_chip.accesses - before, (uint32_t)addrs.size());
+    return addrs;
+}
+
+// ---------------------------------------------------------------------------
+
+void testSweepBatching() {
+    puts("ReadRegisterSweep batching");
+    Atm90e36Model chip;
+    chip.loadOperatingPoint();
+    ModelTransport transport(chip);
+    ATM90E3x ic(PIN_SPI_CS_ATM90E36);
+    ic.SetTransport(&transport);
+
+    const unsigned short addrs[] = { UrmsA, UrmsB, UrmsC, IrmsA, IrmsB, IrmsC, IrmsN, PmeanA, PmeanALSB, Freq, Temp };
+    const unsigned short count = sizeof(addrs) / sizeof(addrs[0]);
+    unsigned short out[count];
+
+    const int64_t t0 = host::nowUs();
+    CHECK_EQ(ic.ReadRegisterSweep(addrs, out, count), count);
+    const int64_t elapsed = host::nowUs() - t0;
+
+    // One bus transaction, one CS frame per register, values in list order
+    CHECK_EQ(transport.begins, 1u);
+    CHECK_EQ(transport.ends, 1u);
+    CHECK_EQ(transport.frames, (uint32_t)count);
+    CHECK_EQ(transport.framesOutsideBatch, 0u);
+    CHECK_EQ(transport.clockHz, (unsigned long)ATM_SPI_DEFAULT_CLOCK);
+    bool match = true;
+    for (unsigned short i = 0; i < count; ++i) match &= (out[i] == chip.regs[addrs[i]]);
+    CHECK(match);
+
+    // Sweep bookkeeping is the measured bus time
+    CHECK_EQ(ic._sweepCount, 1ul);
+    CHECK_EQ((int64_t)ic._lastSweepMicros, elapsed);
+
+    // Invalid arguments do not touch the bus
+    CHECK_EQ(ic.ReadRegisterSweep(nullptr, out, count), 0);
+    CHECK_EQ(ic.ReadRegisterSweep(addrs, out, 0), 0);
+    CHECK_EQ(transport.begins, 1u);
+}
+
+void testSweepBenchmark() {
+    puts("Full sweep benchmark (readAll, 200 kHz link)");
+    CHECK(initDriver(SPI_FREQUENCY_ATM90E36));
+    ATM90E36Driver& drv = ATM90E36Driver::getInstance();
+    CHECK_EQ(drv.getSpiClock(), SPI_FREQUENCY_ATM90E36);
+
+    const std::vector<uint16_t> addrs = recordSweepAddresses();
+    CHECK_EQ(addrs.size(), (size_t)ATM90E36Driver::SWEEP_REG_COUNT);
+
+    MeterData data;
+    auto sweepUs = [&]() {
+        host::resetSpiStats();
+        const int64_t t0 = host::nowUs();
+        drv.readAll(data);
+        return host::nowUs() - t0;
+    };
+    const int64_t sweep200k = sweepUs();
+    const uint32_t sweepTransactions = host::spiStats().transactions;
+    CHECK_EQ(sweepTransactions, 1u);
+
+    // The same registers one CommEnergyIC() at a time (the getter path readAll() replaced)
+    ATM90E3x direct(PIN_SPI_CS_ATM90E36);
+    direct.SetSPIClock(SPI_FREQUENCY_ATM90E36);
+    host::resetSpiStats();
+    int64_t t0 = host::nowUs();
+    for (uint16_t a : addrs) direct.CommEnergyIC(READ, a, 0xFFFF);
+    const int64_t perRegister200k = host::nowUs() - t0;
+    const uint32_t perRegisterTransactions = host::spiStats().transactions;
+    CHECK_EQ(perRegisterTransactions, (uint32_t)addrs.size());
+
+    direct.SetSPIClock(2000000);
+    t0 = host::nowUs();
+    for (uint16_t a : addrs) direct.CommEnergyIC(READ, a, 0xFFFF);
+    const int64_t perRegister2M = host::nowUs() - t0;
+
+    CHECK(initDriver(2000000));
+    CHECK_EQ(drv.getSpiClock(), 2000000u);
+    const int64_t sweep2M = sweepUs();
+
+    CHECK(sweep200k < perRegister200k);
+    CHECK(sweep2M < perRegister2M);
+
+    const double cpuNs = host::nsPerCall(2000, [&] { drv.readAll(data); });
+
+    printf("  %u registers, modelled bus time per sweep:\n", (unsigned)addrs.size());
+    printf("    per-register CommEnergyIC   200 kHz: %6lld us (%u transactions)\n", (long long)perRegister200k, perRegisterTransactions);
+    printf("    batched readAll() sweep     200 kHz: %6lld us (%u transaction)\n", (long long)sweep200k, sweepTransactions);
+    printf("    per-register CommEnergyIC     2 MHz: %6lld us\n", (long long)perRegister2M);
+    printf("    batched readAll() sweep       2 MHz: %6lld us\n", (long long)sweep2M);
+    printf("    host CPU per readAll() incl. float conversion: %.0f ns\n", cpuNs);
+}
+
+void testRead32() {
+    puts("Read32Register tear detection");
+    Atm90e36Model chip;
+    ModelTransport transport(chip);
+    ATM90E3x ic(PIN_SPI_CS_ATM90E36);
+    ic.SetTransport(&transport);
+
+    const int32_t before = 0x0001FFFF;      // One LSB below a HI word carry
+    const int32_t after  = 0x00020000;
+
+    // Stable pair: HI, LO, HI check and nothing else
+    chip.set32(PmeanA, PmeanALSB, before);
+    CHECK_EQ(ic.Read32Register(PmeanA, PmeanALSB), before);
+    CHECK_EQ(transport.frames, 3u);
+    CHECK_EQ(ic._read32Retries, 0ul);
+
+    // The IC updates the pair before access k: the result is always one of
+    // the two values, never the torn 0x00010000 / 0x0002FFFF
+    uint32_t torn = 0;
+    for (uint32_t k = 0; k < 5; ++k) {
+        chip.reset();
+        chip.set32(PmeanA, PmeanALSB, before);
+        chip.onAccess = [&](Atm90e36Model& c, uint32_t index) {
+            if (index == k) c.set32(PmeanA, PmeanALSB, after);
+        };
+        const int32_t v = ic.Read32Register(PmeanA, PmeanALSB);
+        if (v != before && v != after) torn++;
+    }
+    CHECK_EQ(torn, 0u);
+    // Only an update between the first HI read and the HI check costs a retry
+    CHECK_EQ(ic._read32Retries, 2ul);
+
+    // An update on every access: retries stop at ATM_READ32_MAX_RETRIES
+    chip.reset();
+    transport.frames = 0;
+    ic._read32Retries = 0;
+    int32_t moving = before;
+    chip.onAccess = [&](Atm90e36Model& c, uint32_t) {
+        moving += 0x10000;
+        c.set32(PmeanA, PmeanALSB, moving);
+    };
+    ic.Read32Register(PmeanA, PmeanALSB);
+    CHECK_EQ(ic._read32Retries, (unsigned long)ATM_READ32_MAX_RETRIES);
+    CHECK_EQ(transport.frames, 3u + 2u * ATM_READ32_MAX_RETRIES);
+}
+
+void testSweepTearRecheck() {
+    puts("readAll() 32-bit tear re-check");
+    CHECK(initDriver(2000000));
+    ATM90E36Driver& drv = ATM90E36Driver::getInstance();
+    MeterData data;
+
+    const int32_t before = 0x0001FFFF;
+    const int32_t after  = 0x00020000;
+    const float pBefore = rawToFloat(before, RawQuantity::POWER);
+    const float pAfter  = rawToFloat(after, RawQuantity::POWER);
+
+    // Update PmeanA before each access of the sweep in turn
+    uint32_t torn = 0;
+    const uint32_t retries0 = drv.getRead32Retries();
+    for (uint32_t k = 0; k < ATM90E36Driver::SWEEP_REG_COUNT; ++k) {
+        g_chip.set32(PmeanA, PmeanALSB, before);
+        const uint32_t start = g_chip.accesses;
+        g_chip.onAccess = [&](Atm90e36Model& c, uint32_t index) {
+            if (index - start == k) c.set32(PmeanA, PmeanALSB, after);
+        };
+        CHECK(drv.readAll(data));
+        const float p = data.phaseA.activePower;
+        if (p != pBefore && p != pAfter) torn++;
+    }
+    g_chip.onAccess = nullptr;
+    const uint32_t retries = drv.getRead32Retries() - retries0;
+
+    CHECK_EQ(torn, 0u);
+    CHECK(retries > 0);
+    printf("  %u injection points, %u re-read, 0 torn\n", (unsigned)ATM90E36Driver::SWEEP_REG_COUNT, (unsigned)retries);
+}
+
+void testLinkFaultEnergy() {
+    puts("SPI fault during an energy poll");
+    CHECK(initDriver(2000000));
+    ATM90E36Driver& drv = ATM90E36Driver::getInstance();
+    MeterData data;
+    RawMeterFrame frame;
+    uint8_t groups = 0;
+
+    CHECK(drv.readAll(data));
+    const uint64_t base = drv.getEnergyCount(RAW_EN_AP, RAW_T);
+    const uint32_t faults0 = drv.getSpiFaultCount();
+    const uint32_t dropped0 = drv.getEnergyReadsDropped();
+    drv.setPollPeriod(PollGroup::ENERGY, ATM90E36Driver::POLL_FAST_MS);
+
+    // The link degrades under a FAST + ENERGY tick: the energy block read at 2 MHz
+    // is dropped and the fallback sweep at the baseline leaves it on the IC
+    host::advanceUs(100000);
+    g_chip.regs[APenergyT] = 100;
+    g_chip.maxClockHz = SPI_FREQUENCY_ATM90E36;
+    CHECK(drv.readScheduledRaw(frame, &groups));
+    CHECK_EQ(drv.getSpiFaultCount(), faults0 + 1);
+    CHECK_EQ(drv.getSpiClock(), SPI_FREQUENCY_ATM90E36);
+    CHECK_EQ(drv.getEnergyReadsDropped(), dropped0 + 1);
+    CHECK_EQ(groups, pollGroupBit(PollGroup::FAST));
+    CHECK_EQ(frame.energy[RAW_EN_AP][RAW_T], base);
+
+    // Still due, so the next tick reads it at the baseline clock
+    g_chip.regs[APenergyT] = 40;
+    CHECK(drv.readScheduledRaw(frame, &groups));
+    CHECK_EQ(groups, pollGroupBit(PollGroup::ENERGY));
+    CHECK_EQ(frame.energy[RAW_EN_AP][RAW_T], base + 40);
+    CHECK_EQ(drv.getSpiFaultCount(), faults0 + 1);
+    CHECK_EQ(drv.getEnergyReadsDropped(), dropped0 + 1);
+    printf("  fault at 2 MHz: 1 energy read dropped, next tick at %lu Hz read 40 pulses\n",
+           (unsigned long)drv.getSpiClock());
+
+    drv.setPollPeriod(PollGroup::ENERGY, ATM90E36Driver::POLL_ENERGY_MS);
+}
+
+void testBatchNesting() {
+    puts("Batch nesting and bus errors");
+    Atm90e36Model chip;
+    chip.loadOperatingPoint();
+    ModelTransport transport(chip);
+    ATM90E3x ic(PIN_SPI_CS_ATM90E36);
+    ic.SetTransport(&transport);
+
+    // Everything inside an outer batch shares its single Begin/End
+    const unsigned short addrs[] = { UrmsA, UrmsB, UrmsC };
+    unsigned short out[3];
+    CHECK(ic.BeginBatch());
+    ic.CommEnergyIC(READ, IrmsA, 0xFFFF);
+    ic.CommEnergyIC(WRITE, REG_ZX_CONFIG, 0x1234);
+    CHECK_EQ(ic.ReadRegisterSweep(addrs, out, 3), 3);
+    CHECK_EQ(ic.Read32Register(PmeanA, PmeanALSB), 3512345);
+    CHECK_EQ(transport.begins, 1u);
+    ic.EndBatch();
+    CHECK_EQ(transport.ends, 1u);
+    CHECK_EQ(transport.frames, 8u);
+    CHECK_EQ(transport.framesOutsideBatch, 0u);
+    CHECK_EQ(chip.regs[REG_ZX_CONFIG], 0x1234);
+
+    // An unmatched EndBatch() is ignored
+    ic.EndBatch();
+    CHECK_EQ(transport.ends, 1u);
+
+    // A busy bus fails the access without framing anything and is counted
+    transport.refuse = true;
+    CHECK_EQ(ic.CommEnergyIC(READ, UrmsA, 0xFFFF), 0xFFFF);
+    CHECK_EQ(ic.ReadRegisterSweep(addrs, out, 3), 0);
+    CHECK_EQ(ic._busErrors, 2ul);
+    CHECK_EQ(ic._sweepCount, 1ul);
+    CHECK_EQ(transport.frames, 8u);
+
+    // ...and leaves no batch open behind it
+    transport.refuse = false;
+    CHECK_EQ(ic.CommEnergyIC(READ, UrmsA, 0xFFFF), 23012);
+    CHECK_EQ(transport.begins, 2u);
+    CHECK_EQ(transport.ends, 2u);
+}
+
+// Second SPI client on the shared bus (stands in for the W5500)
+class BusClient : public host::SpiDevice {
+public:
+    std::atomic<int>& selected;
+    std::atomic<int>& maxSelected;
+    BusClient(std::atomic<int>& sel, std::atomic<int>& maxSel) : selected(sel), maxSelected(maxSel) {}
+
+    void select() override {
+        const int n = ++selected;
+        int m = maxSelected.load();
+        while (n > m && !maxSelected.compare_exchange_weak(m, n)) {}
+    }
+    void deselect() override { --selected; }
+    uint16_t transfer16(uint16_t mosi, uint32_t) override { return (uint16_t)~mosi; }
+};
+
+// The ATM90E36 model seen through the same selection counter
+class CountedChip : public BusClient {
+public:
+    Atm90e36Model& chip;
+    CountedChip(Atm90e36Model& c, std::atomic<int>& sel, std::atomic<int>& maxSel) : BusClient(sel, maxSel), chip(c) {}
+    void select() override { BusClient::select(); chip.select(); }
+    void deselect() override { chip.deselect(); BusClient::deselect(); }
+    uint16_t transfer16(uint16_t mosi, uint32_t hz) override { return chip.transfer16(mosi, hz); }
+};
+
+void testSharedBus() {
+    puts("SPIBus sharing");
+    CHECK(initDriver(2000000));
+    ATM90E36Driver& drv = ATM90E36Driver::getInstance();
+    SPIBus& bus = SPIBus::getInstance();
+    MeterData data;
+
+    // One readAll() is one bus transaction, and the SPIBus mutex is held on every access
+    uint32_t unlockedAccesses = 0;
+    g_chip.onAccess = [&](Atm90e36Model&, uint32_t) {
+        if (bus.lock(0)) {
+            unlockedAccesses++;
+            bus.unlock();
+        }
+    };
+    host::resetSpiStats();
+    CHECK(drv.readAll(data));
+    g_chip.onAccess = nullptr;
+    CHECK_EQ(host::spiStats().transactions, 1u);
+    CHECK(!host::spiStats().inTransaction);
+    CHECK_EQ(unlockedAccesses, 0u);
+
+    // A second client hammering SPIBus::transfer16() never overlaps an ATM90E36
+    // frame and never corrupts a sweep (real clock: the two threads really race)
+    host::useVirtualClock(false);
+    std::atomic<int> selected{0};
+    std::atomic<int> maxSelected{0};
+    CountedChip chip(g_chip, selected, maxSelected);
+    BusClient eth(selected, maxSelected);
+    host::attachSpiDevice(PIN_SPI_CS_ATM90E36, &chip);
+    host::attachSpiDevice(PIN_ETH_CS, &eth);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> ethOk{0};
+    std::atomic<uint32_t> ethBad{0};
+    std::thread other([&] {
+        while (!stop) {
+            if (bus.transfer16(PIN_ETH_CS, 0x1234, 8000000, SPI_MODE0) == (uint16_t)~0x1234) ethOk++;
+            else ethBad++;
+        }
+    });
+
+    uint32_t sweepsOk = 0;
+    const uint32_t shortFrames0 = g_chip.shortFrames;
+    for (int i = 0; i < 40; ++i) {
+        if (drv.readAll(data) && data.phaseA.voltageRMS == rawToFloat(23012, RawQuantity::VOLTAGE) &&
+            data.phaseB.activePower == rawToFloat(-1200000, RawQuantity::POWER)) {
+            sweepsOk++;
+        }
+    }
+    stop = true;
+    other.join();
+    host::attachSpiDevice(PIN_SPI_CS_ATM90E36, &g_chip);
+    host::useVirtualClock(true);
+
+    CHECK_EQ(sweepsOk, 40u);
+    CHECK_EQ(maxSelected.load(), 1);
+    CHECK_EQ(g_chip.shortFrames, shortFrames0);
+    CHECK(ethOk > 0);
+    CHECK_EQ(ethBad.load(), 0u);
+    printf("  40 sweeps, %u interleaved client transfers, no overlap\n", (unsigned)ethOk.load());
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testSweepBatching();
+    testSweepBenchmark();
+    testRead32();
+    testSweepTearRecheck();
+    testLinkFaultEnergy();
+    testBatchNesting();
+    testSharedBus();
+
+    return host::report("test_atm90e3x");
+}
@@ -0,0 +1,340 @@
+/**
+ * SM-GE3222M V2.0 - Energy accumulator tests
+ *
+ * EnergyAccumulator fed with RawMeterFrame sequences: counters seeded from
+ * the legacy kWh keys, repeated and out-of-order frames (dropped by
+ * captureUs), a driver energyEpoch restart (re-baselined), the counter vs
+ * power-integration cross-check, reload from NVS and from the journal (the
+ * journal wins), and reset() writing a zero journal record. Lifetime counts
+ * are compared exactly after every step.
+ */
+
+#include "host_test.h"
+
+#include "EnergyAccumulator.h"
+
+namespace {
+
+constexpr size_t JOURNAL_SIZE = 32 * ENERGY_JOURNAL_SECTOR_SIZE;
+constexpr uint32_t UTC0 = 1760000000;
+
+typedef uint64_t Counts[RAW_EN_COUNT][4];
+
+// Register weight in the test frames: driver totals are base * weight
+uint64_t weight(uint8_t t, uint8_t ph) {
+    return t * 4 + ph + 1;
+}
+
+RawMeterFrame frameAt(int64_t captureUs, uint32_t epoch, uint64_t base) {
+    RawMeterFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.captureUs = captureUs;
+    frame.energyEpoch = epoch;
+    for (uint8_t t = 0; t < RAW_EN_COUNT; ++t) {
+        for (uint8_t ph = 0; ph < 4; ++ph) frame.energy[t][ph] = base * weight(t, ph);
+    }
+    return frame;
+}
+
+void addPulses(Counts& counts, uint64_t base) {
+    for (uint8_t t = 0; t < RAW_EN_COUNT; ++t) {
+        for (uint8_t ph = 0; ph < 4; ++ph) counts[t][ph] += base * weight(t, ph);
+    }
+}
+
+// Total active (import + export) pulses of one base step: the cross-check input
+uint64_t activeTotal(uint64_t base) {
+    return base * (weight(RAW_EN_AP, RAW_T) + weight(RAW_EN_AN, RAW_T));
+}
+
+// Registers whose lifetime count differs from the expected one
+uint32_t mismatches(const Counts& expect) {
+    EnergyAccumulator& acc = EnergyAccumulator::getInstance();
+    uint32_t n = 0;
+    for (uint8_t t = 0; t < RAW_EN_COUNT; ++t) {
+        for (uint8_t ph = 0; ph < 4; ++ph) {
+            if (acc.getCount((RawEnergy)t, ph) != expect[t][ph]) n++;
+        }
+    }
+    return n;
+}
+
+bool allZero(const Counts& counts) {
+    for (uint8_t t = 0; t < RAW_EN_COUNT; ++t) {
+        for (uint8_t ph = 0; ph < 4; ++ph) {
+            if (counts[t][ph] != 0) return false;
+        }
+    }
+    return true;
+}
+
+// 1000 W on A, 2000 W on B, 500 W exported on C
+MeterData sampleAt(int64_t timestampUs, uint32_t utc) {
+    MeterData data;
+    data.valid = true;
+    data.timestampUs = timestampUs;
+    data.timestamp = utc;
+    data.phaseA.activePower = 1000.0f;
+    data.phaseB.activePower = 2000.0f;
+    data.phaseC.activePower = -500.0f;
+    return data;
+}
+
+// Cross-check kWh of one sample interval, as EnergyAccumulator::update() sums it
+double integratedKWh(int64_t deltaUs) {
+    return (1000.0f + 2000.0f + 500.0f) / 1000.0 * ((double)deltaUs / 3.6e9);
+}
+
+bool nvsCounts(Counts& out) {
+    Preferences prefs;
+    if (!prefs.begin("energy_acc", true)) return false;
+    const bool ok = prefs.getBytes("counts", out, sizeof(out)) == sizeof(out);
+    prefs.end();
+    return ok;
+}
+
+Counts g_expect;
+
+// ---------------------------------------------------------------------------
+
+void testLegacySeed() {
+    puts("Counters seeded from the legacy kWh keys");
+
+    // NVS as written before the pulse counters existed: kWh doubles only
+    Preferences prefs;
+    CHECK(prefs.begin("energy_acc", false));
+    prefs.putDouble("phaseA_AEI", 1.5);
+    prefs.putDouble("phaseB_REE", 0.0000031);       // 0.992 pulses: rounds to 1
+    prefs.putDouble("phaseC_SE", -2.0);             // Negative: not carried over
+    prefs.putDouble("total_AEI", 4.25);
+    prefs.putDouble("total_AEE", 0.125);
+    prefs.putUInt("lastUpdate", UTC0);
+    prefs.end();
+
+    host::addPartition("enjournal", JOURNAL_SIZE);
+    EnergyAccumulator& acc = EnergyAccumulator::getInstance();
+    CHECK(acc.init(0));
+    CHECK(acc.getJournalStats().ready);
+    CHECK_EQ(acc.getJournalStats().sequence, 0U);
+    CHECK_EQ(host::countLogs(LogLevel::INFO, "counters seeded from kWh"), 1U);
+
+    memset(g_expect, 0, sizeof(g_expect));
+    g_expect[RAW_EN_AP][RAW_A] = 480000;
+    g_expect[RAW_EN_RN][RAW_B] = 1;
+    g_expect[RAW_EN_AP][RAW_T] = 1360000;
+    g_expect[RAW_EN_AN][RAW_T] = 40000;
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    const EnergyData energy = acc.getAccumulatedEnergy();
+    CHECK_EQ(energy.phaseA.activeEnergyImport, 1.5);
+    CHECK_EQ(energy.total.activeEnergyImport, 4.25);
+    CHECK_EQ(energy.phaseC.apparentEnergy, 0.0);
+    CHECK_EQ(energy.lastUpdateTime, UTC0);
+
+    CHECK_EQ(acc.getCount(RAW_EN_COUNT, RAW_A), 0U);
+    CHECK_EQ(acc.getCount(RAW_EN_AP, 4), 0U);
+}
+
+void testFrames() {
+    puts("Frame sequences");
+    EnergyAccumulator& acc = EnergyAccumulator::getInstance();
+
+    // No sweep yet
+    acc.updateCounters(frameAt(0, 1, 777));
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    // First epoch: all the driver holds is new; before the first power sample
+    // nothing enters the cross-check
+    acc.updateCounters(frameAt(100000, 1, 10000));
+    addPulses(g_expect, 10000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+    CHECK_EQ(acc.getCrossCheck().counterKWh, 0.0);
+
+    acc.update(sampleAt(100000, UTC0 + 1));
+    uint64_t checkCounts = 0;
+    double checkKWh = 0.0;
+
+    acc.updateCounters(frameAt(200000, 1, 25000));
+    addPulses(g_expect, 15000);
+    checkCounts += activeTotal(15000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    // The same frame again is not stale, just nothing new
+    acc.updateCounters(frameAt(200000, 1, 25000));
+    CHECK_EQ(mismatches(g_expect), 0U);
+    CHECK_EQ(acc.getCrossCheck().staleFrames, 0U);
+
+    // Older captures are dropped whatever they hold
+    acc.updateCounters(frameAt(150000, 1, 20000));
+    acc.updateCounters(frameAt(150000, 1, 90000));
+    CHECK_EQ(mismatches(g_expect), 0U);
+    CHECK_EQ(acc.getCrossCheck().staleFrames, 2U);
+
+    acc.updateCounters(frameAt(300000, 1, 40000));
+    addPulses(g_expect, 15000);
+    checkCounts += activeTotal(15000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    // Driver restart: new epoch, totals from zero again; nothing is subtracted
+    const size_t warnings = host::countLogs(LogLevel::WARN, "re-baselined");
+    acc.updateCounters(frameAt(400000, 2, 3000));
+    addPulses(g_expect, 3000);
+    checkCounts += activeTotal(3000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+    CHECK_EQ(acc.getCrossCheck().counterResets, 1U);
+    CHECK_EQ(host::countLogs(LogLevel::WARN, "re-baselined"), warnings + 1);
+
+    // Within the new epoch, a capture older than the restart frame is stale
+    acc.updateCounters(frameAt(350000, 2, 5000));
+    CHECK_EQ(mismatches(g_expect), 0U);
+    CHECK_EQ(acc.getCrossCheck().staleFrames, 3U);
+
+    acc.updateCounters(frameAt(500000, 2, 10000));
+    addPulses(g_expect, 7000);
+    checkCounts += activeTotal(7000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    // The reported register follows the counters
+    const EnergyData energy = acc.getAccumulatedEnergy();
+    CHECK_EQ(energy.total.activeEnergyImport, energyCountToDouble(g_expect[RAW_EN_AP][RAW_T]));
+    CHECK_EQ(energy.phaseB.reactiveEnergyExport, energyCountToDouble(g_expect[RAW_EN_RN][RAW_B]));
+
+    // Power samples 1 s apart; a repeated timestamp adds nothing
+    for (int i = 1; i <= 3; ++i) {
+        acc.update(sampleAt(100000 + i * 1000000LL, UTC0 + 1 + i));
+        checkKWh += integratedKWh(1000000);
+    }
+    acc.update(sampleAt(3100000, UTC0 + 4));
+
+    const EnergyCrossCheck check = acc.getCrossCheck();
+    const double counterKWh = energyCountToDouble(checkCounts);
+    printf("  %llu active pulses (%.4f kWh) vs %.6f kWh integrated: %.2f %%, %u reset, %u stale\n",
+           (unsigned long long)checkCounts, check.counterKWh, check.integratedKWh, check.divergencePct,
+           check.counterResets, check.staleFrames);
+    CHECK_EQ(check.counterKWh, counterKWh);
+    CHECK_NEAR(check.integratedKWh, checkKWh, 1e-12);
+    CHECK(check.valid);
+    CHECK_NEAR(check.divergencePct, (checkKWh - counterKWh) / counterKWh * 100.0, 1e-4);
+    CHECK_EQ(check.counterResets, 1U);
+    CHECK_EQ(check.staleFrames, 3U);
+}
+
+void testReload() {
+    puts("Reload from NVS and from the journal");
+    EnergyAccumulator& acc = EnergyAccumulator::getInstance();
+    CHECK_EQ(acc.getJournalStats().appends, 0U);
+
+    // NVS only: a save, then pulses that never reach flash
+    CHECK(acc.saveToNVS());
+    Counts saved;
+    CHECK(nvsCounts(saved));
+    CHECK(memcmp(saved, g_expect, sizeof(saved)) == 0);
+    Counts atSave;
+    memcpy(atSave, g_expect, sizeof(atSave));
+
+    acc.updateCounters(frameAt(600000, 2, 20000));
+    addPulses(g_expect, 10000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+    const size_t nvsLoads = host::countLogs(LogLevel::INFO, "Loaded energy data from NVS");
+    CHECK(acc.loadFromNVS());
+    CHECK_EQ(host::countLogs(LogLevel::INFO, "Loaded energy data from NVS"), nvsLoads + 1);
+    memcpy(g_expect, atSave, sizeof(g_expect));
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    // The driver totals already added stay added: the next frame brings only its delta
+    acc.updateCounters(frameAt(700000, 2, 30000));
+    addPulses(g_expect, 10000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    // Journal record after 5 s; an idle meter writes none
+    host::advanceUs(5000000);
+    acc.update(sampleAt(4100000, UTC0 + 100));
+    CHECK_EQ(acc.getJournalStats().appends, 1U);
+    host::advanceUs(5000000);
+    acc.update(sampleAt(5100000, UTC0 + 101));
+    CHECK_EQ(acc.getJournalStats().appends, 1U);
+    Counts journaled;
+    memcpy(journaled, g_expect, sizeof(journaled));
+
+    // Pulses after the record are lost, NVS is older: the journal wins
+    acc.updateCounters(frameAt(800000, 2, 35000));
+    addPulses(g_expect, 5000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+    CHECK(acc.loadFromNVS());
+    CHECK_EQ(mismatches(journaled), 0U);
+    CHECK_EQ(acc.getAccumulatedEnergy().lastUpdateTime, UTC0 + 100);
+    CHECK_EQ(host::countLogs(LogLevel::INFO, "Loaded energy data from journal"), 1U);
+
+    // Even over a later NVS save
+    acc.updateCounters(frameAt(900000, 2, 40000));
+    CHECK(acc.saveToNVS());
+    CHECK(nvsCounts(saved));
+    CHECK(memcmp(saved, journaled, sizeof(saved)) != 0);
+    CHECK(acc.loadFromNVS());
+    CHECK_EQ(mismatches(journaled), 0U);
+    memcpy(g_expect, journaled, sizeof(g_expect));
+}
+
+void testReset() {
+    puts("reset()");
+    EnergyAccumulator& acc = EnergyAccumulator::getInstance();
+    const EnergyJournalStats before = acc.getJournalStats();
+
+    acc.reset();
+    memset(g_expect, 0, sizeof(g_expect));
+    CHECK_EQ(mismatches(g_expect), 0U);
+    const EnergyJournalStats after = acc.getJournalStats();
+    CHECK_EQ(after.appends, before.appends + 1);
+    CHECK_EQ(after.sequence, before.sequence + 1);
+
+    // The newest record on flash is the zero state, and NVS holds it too
+    EnergyJournal probe;
+    CHECK(probe.begin(openJournalPartition("enjournal")));
+    EnergyJournalRecord rec;
+    CHECK(probe.latest(rec));
+    CHECK_EQ(rec.sequence, after.sequence);
+    Counts counts;
+    memcpy(counts, rec.counts, sizeof(counts));
+    CHECK(allZero(counts));
+    CHECK(nvsCounts(counts));
+    CHECK(allZero(counts));
+    CHECK_EQ(acc.getAccumulatedEnergy().total.activeEnergyImport, 0.0);
+
+    // Cross-check energy restarts; the frame statistics are kept
+    EnergyCrossCheck check = acc.getCrossCheck();
+    CHECK_EQ(check.counterKWh, 0.0);
+    CHECK_EQ(check.integratedKWh, 0.0);
+    CHECK(!check.valid);
+    CHECK_EQ(check.counterResets, 1U);
+    CHECK_EQ(check.staleFrames, 3U);
+
+    // Counting resumes from the driver delta; a reload restores the zero record
+    acc.updateCounters(frameAt(1000000, 2, 41000));
+    addPulses(g_expect, 1000);
+    CHECK_EQ(mismatches(g_expect), 0U);
+    check = acc.getCrossCheck();
+    CHECK_EQ(check.counterKWh, energyCountToDouble(activeTotal(1000)));
+    CHECK(acc.loadFromNVS());
+    memset(g_expect, 0, sizeof(g_expect));
+    CHECK_EQ(mismatches(g_expect), 0U);
+
+    // Forced: a reset of zero counters is still recorded
+    acc.reset();
+    CHECK_EQ(acc.getJournalStats().appends, before.appends + 2);
+    printf("  journal: %u appends, sequence %u, %u erases\n", acc.getJournalStats().appends,
+           acc.getJournalStats().sequence, acc.getJournalStats().erases);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testLegacySeed();
+    testFrames();
+    testReload();
+    testReset();
+
+    return host::report("test_energy_accumulator");
+}
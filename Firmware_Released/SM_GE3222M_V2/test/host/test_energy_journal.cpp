@@ -0,0 +1,277 @@
+/**
+ * SM-GE3222M V2.0 - Energy journal tests
+ *
+ * EnergyJournal against a NOR flash model (erase sets 0xFF, writes only clear
+ * bits) with power cuts injected in the middle of writes and erases.
+ */
+
+#include "host_test.h"
+
+#include "EnergyJournal.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// A power cut fires after a budget of byte operations; the interrupted
+// operation leaves a partial, garbled result and the flash stays dead until reboot
+struct SimFlash : JournalFlash {
+    std::vector<uint8_t> mem;
+    std::vector<uint32_t> eraseCount;
+    long budget = -1;       // Byte operations left before the cut, -1 = none
+    bool dead = false;
+    uint32_t writeCuts = 0;
+    uint32_t eraseCuts = 0;
+    std::mt19937 rng;
+
+    SimFlash(size_t sectors, unsigned seed)
+        : mem(sectors * ENERGY_JOURNAL_SECTOR_SIZE, 0xFF), eraseCount(sectors), rng(seed) {}
+
+    size_t size() const override { return mem.size(); }
+
+    bool read(size_t offset, void* dst, size_t len) override {
+        if (dead) return false;
+        memcpy(dst, &mem[offset], len);
+        return true;
+    }
+
+    bool write(size_t offset, const void* src, size_t len) override {
+        if (dead) return false;
+        const uint8_t* p = static_cast<const uint8_t*>(src);
+        for (size_t i = 0; i < len; ++i) {
+            if (budget == 0) {
+                mem[offset + i] &= (uint8_t)rng();
+                dead = true;
+                writeCuts++;
+                return false;
+            }
+            if (budget > 0) budget--;
+            mem[offset + i] &= p[i];
+        }
+        return true;
+    }
+
+    bool eraseSector(size_t offset) override {
+        if (dead) return false;
+        eraseCount[offset / ENERGY_JOURNAL_SECTOR_SIZE]++;
+        for (size_t i = 0; i < ENERGY_JOURNAL_SECTOR_SIZE; ++i) {
+            if (budget == 0) {
+                // The rest of the sector keeps a random mix of old and erased bits
+                for (size_t j = i; j < ENERGY_JOURNAL_SECTOR_SIZE; ++j) mem[offset + j] |= (uint8_t)rng();
+                dead = true;
+                eraseCuts++;
+                return false;
+            }
+            if (budget > 0) budget--;
+            mem[offset + i] = 0xFF;
+        }
+        return true;
+    }
+};
+
+constexpr size_t SECTORS = 32;     // 128 KB, the "enjournal" partition size
+
+// Counter state derived from one value, so a recovered record can be checked whole
+void fillCounts(uint64_t counts[RAW_EN_COUNT][4], uint64_t value) {
+    for (uint8_t t = 0; t < RAW_EN_COUNT; ++t) {
+        for (uint8_t p = 0; p < 4; ++p) counts[t][p] = value * (t * 4 + p + 1);
+    }
+}
+
+bool countsMatch(const EnergyJournalRecord& rec, uint64_t value) {
+    uint64_t expect[RAW_EN_COUNT][4];
+    fillCounts(expect, value);
+    return memcmp(expect, rec.counts, sizeof(expect)) == 0;
+}
+
+// ---------------------------------------------------------------------------
+
+void testBasics() {
+    puts("Append and recover");
+    EnergyJournal journal;
+    CHECK(!journal.begin(nullptr));
+    SimFlash tiny(1, 1);
+    CHECK(!journal.begin(&tiny));
+    CHECK(!journal.isReady());
+    CHECK(openJournalPartition("enjournal") == nullptr);     // No partition table on the host
+
+    SimFlash flash(SECTORS, 1);
+    CHECK(journal.begin(&flash));
+    EnergyJournalRecord rec;
+    CHECK(!journal.latest(rec));
+    const EnergyJournalStats empty = journal.getStats();
+    CHECK_EQ(empty.slots, (uint32_t)(SECTORS * (ENERGY_JOURNAL_SECTOR_SIZE / ENERGY_JOURNAL_RECORD_SIZE)));
+    CHECK_EQ(empty.sequence, 0U);
+
+    uint64_t counts[RAW_EN_COUNT][4];
+    for (uint64_t v = 1; v <= 5; ++v) {
+        fillCounts(counts, v);
+        CHECK(journal.append(counts, 1760000000 + (uint32_t)v, 2));
+    }
+    CHECK(journal.latest(rec));
+    CHECK_EQ(rec.sequence, 5U);
+
+    // Reboot
+    EnergyJournal after;
+    CHECK(after.begin(&flash));
+    CHECK(after.latest(rec));
+    CHECK_EQ(rec.sequence, 5U);
+    CHECK_EQ(rec.utc, 1760000005U);
+    CHECK_EQ(rec.source, 2);
+    CHECK(countsMatch(rec, 5));
+
+    fillCounts(counts, 6);
+    CHECK(after.append(counts, 0, 0));
+    CHECK_EQ(after.getStats().sequence, 6U);
+    CHECK_EQ(after.getStats().erases, 0U);     // Slot 5 was still in the erased sector 0
+}
+
+void testRingWrap() {
+    puts("Ring wrap and wear");
+    SimFlash flash(SECTORS, 2);
+    EnergyJournal journal;
+    CHECK(journal.begin(&flash));
+    const uint32_t slots = journal.getStats().slots;
+    const uint32_t total = slots * 3 + 7;
+
+    uint64_t counts[RAW_EN_COUNT][4];
+    for (uint32_t v = 1; v <= total; ++v) {
+        fillCounts(counts, v);
+        if (!journal.append(counts, 0, 0)) break;
+    }
+    const EnergyJournalStats stats = journal.getStats();
+    CHECK_EQ(stats.appends, total);
+    CHECK_EQ(stats.errors, 0U);
+    CHECK_EQ(stats.skipped, 0U);
+
+    EnergyJournal after;
+    CHECK(after.begin(&flash));
+    EnergyJournalRecord rec;
+    CHECK(after.latest(rec));
+    CHECK_EQ(rec.sequence, total);
+    CHECK(countsMatch(rec, total));
+
+    // Every sector sees one erase per lap
+    uint32_t minErase = UINT32_MAX, maxErase = 0;
+    for (uint32_t e : flash.eraseCount) {
+        minErase = std::min(minErase, e);
+        maxErase = std::max(maxErase, e);
+    }
+    CHECK_EQ(minErase, 3U);
+    CHECK_EQ(maxErase, 4U);
+}
+
+void testTornSlot() {
+    puts("Torn slot");
+    SimFlash flash(SECTORS, 3);
+    EnergyJournal journal;
+    CHECK(journal.begin(&flash));
+    uint64_t counts[RAW_EN_COUNT][4];
+    for (uint64_t v = 1; v <= 3; ++v) {
+        fillCounts(counts, v);
+        CHECK(journal.append(counts, 0, 0));
+    }
+
+    // Half a record in slot 3 (the next one), as a cut during the write leaves it
+    EnergyJournalRecord partial;
+    memset(&partial, 0, sizeof(partial));
+    partial.magic = ENERGY_JOURNAL_MAGIC;
+    partial.version = ENERGY_JOURNAL_VERSION;
+    partial.sequence = 4;
+    CHECK(flash.write(3 * ENERGY_JOURNAL_RECORD_SIZE, &partial, ENERGY_JOURNAL_RECORD_SIZE / 2));
+
+    EnergyJournal after;
+    CHECK(after.begin(&flash));
+    EnergyJournalRecord rec;
+    CHECK(after.latest(rec));
+    CHECK_EQ(rec.sequence, 3U);
+
+    // The writer resumes after the newest valid record and steps over the torn slot
+    fillCounts(counts, 4);
+    CHECK(after.append(counts, 0, 0));
+    CHECK_EQ(after.getStats().skipped, 1U);
+    CHECK_EQ(after.getStats().sequence, 4U);
+
+    EnergyJournal again;
+    CHECK(again.begin(&flash));
+    CHECK(again.latest(rec));
+    CHECK_EQ(rec.sequence, 4U);
+    CHECK(countsMatch(rec, 4));
+}
+
+void testPowerCuts() {
+    puts("Power cuts during writes and erases");
+    SimFlash flash(SECTORS, 1);
+    std::mt19937 rng(7);
+    uint64_t acked = 0;         // Value of the last append that returned true
+    uint64_t next = 1;
+    uint32_t cuts = 0;
+    uint32_t lostAcked = 0;
+    uint32_t corrupt = 0;
+    uint32_t emptyAfterData = 0;
+    uint32_t recoveredUnacked = 0;
+    uint64_t counts[RAW_EN_COUNT][4];
+
+    constexpr int BOOTS = 3000;
+    for (int boot = 0; boot < BOOTS; ++boot) {
+        flash.dead = false;
+        flash.budget = (rng() % 4 == 0) ? -1 : (long)(rng() % 20000);
+
+        EnergyJournal journal;
+        if (!journal.begin(&flash)) {
+            corrupt++;
+            continue;
+        }
+        EnergyJournalRecord rec;
+        if (journal.latest(rec)) {
+            const uint64_t value = rec.counts[0][0];
+            if (!countsMatch(rec, value)) corrupt++;
+            if (value < acked) lostAcked++;
+            if (value > acked) recoveredUnacked++;     // Written in full just before the cut
+            acked = value;
+            next = value + 1;
+        } else if (acked != 0) {
+            emptyAfterData++;
+        }
+
+        for (int k = 0; k < 200; ++k) {
+            fillCounts(counts, next);
+            if (!journal.append(counts, 0, 0)) {
+                cuts++;
+                break;
+            }
+            acked = next++;
+        }
+    }
+
+    uint32_t minErase = UINT32_MAX, maxErase = 0;
+    for (uint32_t e : flash.eraseCount) {
+        minErase = std::min(minErase, e);
+        maxErase = std::max(maxErase, e);
+    }
+    printf("  %d boots, %u cuts (%u mid-write, %u mid-erase), %llu records acknowledged, erases per sector %u-%u\n",
+           BOOTS, cuts, flash.writeCuts, flash.eraseCuts, (unsigned long long)acked, minErase, maxErase);
+    CHECK(cuts > BOOTS / 2);
+    CHECK_EQ(flash.writeCuts + flash.eraseCuts, cuts);
+    CHECK(flash.eraseCuts > 0);
+    CHECK_EQ(lostAcked, 0U);
+    CHECK_EQ(corrupt, 0U);
+    CHECK_EQ(emptyAfterData, 0U);
+    CHECK(recoveredUnacked <= cuts);
+    CHECK(maxErase - minErase <= maxErase / 10 + 2);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testBasics();
+    testRingWrap();
+    testTornSlot();
+    testPowerCuts();
+
+    return host::report("test_energy_journal");
+}
@@ -0,0 +1,452 @@
+/**
+ * SM-GE3222M V2.0 - Event bus tests
+ *
+ * EventBus payload pool and backpressure on the host runtime queues: copy and
+ * zero-copy publishes, pool exhaustion, and a drop-oldest stream flooded
+ * behind a meter topic; the latest-value meter topic under a queue flood;
+ * then the URGENT lane, subscriber changes from inside callbacks and callback
+ * timing. Those sections drain with handle(); the last
+ * one runs a dispatcher task on the real clock against subscribe/unsubscribe
+ * churn from another thread.
+ */
+
+#include "host_test.h"
+
+#include "EventBus.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int g_meterCalls = 0;
+uint32_t g_meterSeq = 0;
+const void* g_meterData = nullptr;
+std::vector<uint32_t> g_pqSeen;     // PowerQualityEvent::timestampMs, in delivery order
+
+void onMeter(EventType, void* data) {
+    g_meterCalls++;
+    g_meterData = data;
+    g_meterSeq = static_cast<const MeterData*>(data)->sequenceNumber;
+}
+
+void onPq(EventType, void* data) {
+    g_pqSeen.push_back(static_cast<const PowerQualityEvent*>(data)->timestampMs);
+}
+
+std::vector<EventType> g_order;
+bool g_raiseError = false;      // The next WIFI_CONNECTED callback publishes an error
+
+void onOrder(EventType type, void*) {
+    g_order.push_back(type);
+    if (type == EventType::WIFI_CONNECTED && g_raiseError) {
+        g_raiseError = false;
+        EventBus::getInstance().publish(EventType::ERROR_OCCURRED);
+    }
+}
+
+int g_selfCalls = 0;
+
+void onSelfUnsubscribe(EventType type, void*) {
+    g_selfCalls++;
+    EventBus::getInstance().unsubscribe(type, onSelfUnsubscribe);
+}
+
+void onSlow(EventType, void*) {
+    delay(7);
+}
+
+void onFast(EventType, void*) {}
+
+std::atomic<uint32_t> g_counted{0};
+
+void onCount(EventType, void*) {
+    g_counted++;
+}
+
+void onChurn(EventType, void*) {}
+
+// ---------------------------------------------------------------------------
+
+void testPool() {
+    puts("Payload pool");
+    EventBus& bus = EventBus::getInstance();
+    CHECK(!bus.publish(EventType::CONFIG_CHANGED));             // Before init()
+    CHECK(!bus.allocate(EventType::CONFIG_CHANGED, 4));
+    CHECK(bus.init());
+
+    EventPoolStats pool = bus.getPoolStats();
+    CHECK_EQ(pool.blocks, EventPayloadPool::BLOCK_COUNT);
+    CHECK_EQ(pool.inUse, 0);
+
+    // Every block claimed, nothing queued to reclaim: the next one is rejected
+    std::vector<EventRef> held;
+    for (uint8_t i = 0; i < EventPayloadPool::BLOCK_COUNT; ++i) {
+        held.push_back(bus.allocate(EventType::CONFIG_CHANGED, 8));
+        CHECK(static_cast<bool>(held.back()));
+    }
+    CHECK_EQ(bus.getPoolStats().inUse, EventPayloadPool::BLOCK_COUNT);
+    CHECK(!bus.allocate(EventType::CONFIG_CHANGED, 8));
+    CHECK(!bus.allocate(EventType::CONFIG_CHANGED, EventPayloadPool::BLOCK_SIZE + 1));
+    CHECK(!bus.allocate(EventType::CONFIG_CHANGED, 0));
+    CHECK_EQ(bus.getStats(EventType::CONFIG_CHANGED).rejected, 2U);
+
+    // Copies share a block; the last reference returns it
+    EventRef copy = held[0];
+    CHECK_EQ(copy.data(), held[0].data());
+    held.clear();
+    CHECK_EQ(bus.getPoolStats().inUse, 1);
+    copy.reset();
+    CHECK(!copy);
+    CHECK_EQ(bus.getPoolStats().inUse, 0);
+    CHECK_EQ(bus.getPoolStats().maxInUse, EventPayloadPool::BLOCK_COUNT);
+}
+
+void testBackpressure() {
+    puts("Meter topic and a drop-oldest stream");
+    EventBus& bus = EventBus::getInstance();
+    CHECK(bus.subscribe(EventType::METER_DATA_UPDATED, onMeter));
+    CHECK(bus.subscribe(EventType::POWER_QUALITY_EVENT, onPq));
+    // On the NORMAL lane the pool, not the queue, bounds the stream
+    CHECK(bus.getPriority(EventType::POWER_QUALITY_EVENT) == EventPriority::URGENT);
+    bus.setPriority(EventType::POWER_QUALITY_EVENT, EventPriority::NORMAL);
+
+    MeterData m;
+    for (uint32_t i = 1; i <= 100; ++i) {
+        m.sequenceNumber = i;
+        CHECK(bus.publish(EventType::METER_DATA_UPDATED, &m, sizeof(m)));
+    }
+    PowerQualityEvent e;
+    for (uint32_t i = 0; i < 50; ++i) {
+        e.timestampMs = i;
+        bus.publish(EventType::POWER_QUALITY_EVENT, &e, sizeof(e));
+    }
+    // The topic holds one block, the queued PQ events the other 15
+    CHECK_EQ(bus.getPoolStats().inUse, EventPayloadPool::BLOCK_COUNT);
+
+    bus.handle();
+    const EventTypeStats meter = bus.getStats(EventType::METER_DATA_UPDATED);
+    const EventTypeStats pq = bus.getStats(EventType::POWER_QUALITY_EVENT);
+    printf("  meter: %u published, %u delivered (seq %u), %u coalesced\n",
+           meter.published, meter.dispatched, g_meterSeq, meter.coalesced);
+    printf("  PQ: %u published, %u delivered, %u dropped; pool %u in use after dispatch\n",
+           pq.published, pq.dispatched, pq.dropped, (unsigned)bus.getPoolStats().inUse);
+
+    CHECK_EQ(g_meterCalls, 1);
+    CHECK_EQ(g_meterSeq, 100U);
+    CHECK_EQ(meter.published, 100U);
+    CHECK_EQ(meter.coalesced, 99U);
+    CHECK_EQ(meter.dispatched, 1U);
+    CHECK_EQ(meter.dropped, 0U);
+
+    // Oldest first: the 15 newest survive, in order
+    const uint32_t kept = EventPayloadPool::BLOCK_COUNT - 1;
+    CHECK_EQ(pq.published, 50U);
+    CHECK_EQ(pq.dropped, 50U - kept);
+    CHECK_EQ(pq.dispatched, kept);
+    CHECK_EQ(pq.rejected, 0U);
+    CHECK_EQ(g_pqSeen.size(), (size_t)kept);
+    bool ordered = !g_pqSeen.empty();
+    for (size_t i = 0; i < g_pqSeen.size(); ++i) {
+        ordered = ordered && g_pqSeen[i] == 50 - kept + i;
+    }
+    CHECK(ordered);
+
+    // Only the topic value stays (readLatest())
+    CHECK_EQ(bus.getPoolStats().inUse, 1);
+    bus.setPriority(EventType::POWER_QUALITY_EVENT, EventPriority::URGENT);
+}
+
+void testZeroCopy() {
+    puts("Zero-copy publish");
+    EventBus& bus = EventBus::getInstance();
+    g_meterCalls = 0;
+
+    EventRef ref = bus.allocate(EventType::METER_DATA_UPDATED, sizeof(MeterData));
+    CHECK(static_cast<bool>(ref));
+    CHECK_EQ(ref.size(), sizeof(MeterData));
+    MeterData* data = new (ref.data()) MeterData();
+    data->sequenceNumber = 777;
+    CHECK(bus.publish(EventType::METER_DATA_UPDATED, ref));
+    ref.reset();
+    bus.handle();
+
+    // The subscriber reads the block the publisher filled
+    CHECK_EQ(g_meterCalls, 1);
+    CHECK_EQ(g_meterSeq, 777U);
+    CHECK(g_meterData == data);
+    CHECK_EQ(bus.getPoolStats().inUse, 1);
+
+    // Payload-free events take no block
+    CHECK(bus.publish(EventType::CONFIG_CHANGED));
+    CHECK_EQ(bus.getPoolStats().inUse, 1);
+    bus.handle();
+    CHECK_EQ(bus.getStats(EventType::CONFIG_CHANGED).dispatched, 1U);
+}
+
+void testLatestValue() {
+    puts("Latest-value topic");
+    EventBus& bus = EventBus::getInstance();
+    CHECK(bus.getPolicy(EventType::METER_DATA_UPDATED) == EventPolicy::LATEST_VALUE);
+    CHECK(bus.getPolicy(EventType::WIFI_DISCONNECTED) == EventPolicy::DROP_OLDEST);
+
+    // The value stays readable after delivery
+    EventRef value;
+    uint32_t generation = bus.readLatest(EventType::METER_DATA_UPDATED, value);
+    CHECK(static_cast<bool>(value));
+    CHECK_EQ(value.size(), sizeof(MeterData));
+    CHECK_EQ(static_cast<const MeterData*>(value.data())->sequenceNumber, 777U);
+    CHECK_EQ(generation, bus.getGeneration(EventType::METER_DATA_UPDATED));
+    CHECK_EQ(bus.readLatest(EventType::CONFIG_CHANGED, value), 0U);   // Not a topic
+    CHECK(!value);
+
+    // 1000 meter publishes interleaved with a flood that overflows the NORMAL lane
+    const EventTypeStats meterBefore = bus.getStats(EventType::METER_DATA_UPDATED);
+    const EventTypeStats floodBefore = bus.getStats(EventType::WIFI_DISCONNECTED);
+    g_meterCalls = 0;
+    MeterData m;
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        m.sequenceNumber = 1000 + i;
+        bus.publish(EventType::METER_DATA_UPDATED, &m, sizeof(m));
+        bus.publish(EventType::WIFI_DISCONNECTED);
+    }
+    CHECK_EQ(bus.getPoolStats().inUse, 1);
+    bus.handle();
+
+    const EventTypeStats meter = bus.getStats(EventType::METER_DATA_UPDATED);
+    const EventTypeStats flood = bus.getStats(EventType::WIFI_DISCONNECTED);
+    const uint32_t floodDropped = flood.dropped - floodBefore.dropped;
+    printf("  1000 meter publishes: %d delivery (seq %u), generation +%u, %u dropped\n", g_meterCalls, g_meterSeq,
+           bus.getGeneration(EventType::METER_DATA_UPDATED) - generation, meter.dropped - meterBefore.dropped);
+    printf("  1000 queued events alongside: %u dropped from the NORMAL lane\n", floodDropped);
+    CHECK_EQ(g_meterCalls, 1);
+    CHECK_EQ(g_meterSeq, 2000U);
+    CHECK_EQ(bus.getGeneration(EventType::METER_DATA_UPDATED), generation + 1000);
+    CHECK_EQ(meter.dropped, meterBefore.dropped);
+    CHECK_EQ(meter.rejected, meterBefore.rejected);
+    CHECK_EQ(floodDropped, 980U);
+    CHECK_EQ(flood.dispatched - floodBefore.dispatched, 20U);
+
+    // Topics go after the URGENT lane and before the NORMAL one
+    g_order.clear();
+    CHECK(bus.subscribe(EventType::METER_DATA_UPDATED, onOrder));
+    CHECK(bus.subscribe(EventType::WIFI_CONNECTED, onOrder));
+    CHECK(bus.subscribe(EventType::ERROR_OCCURRED, onOrder));
+    CHECK(bus.publish(EventType::WIFI_CONNECTED));
+    CHECK(bus.publish(EventType::METER_DATA_UPDATED, &m, sizeof(m)));
+    CHECK(bus.publish(EventType::ERROR_OCCURRED));
+    bus.handle();
+    const std::vector<EventType> expect = {
+        EventType::ERROR_OCCURRED, EventType::METER_DATA_UPDATED, EventType::WIFI_CONNECTED
+    };
+    CHECK(g_order == expect);
+    CHECK(bus.unsubscribe(EventType::METER_DATA_UPDATED, onOrder));
+    CHECK(bus.unsubscribe(EventType::WIFI_CONNECTED, onOrder));
+    CHECK(bus.unsubscribe(EventType::ERROR_OCCURRED, onOrder));
+
+    // No longer a topic: the undelivered value is dropped and its block freed
+    value.reset();
+    CHECK(bus.publish(EventType::METER_DATA_UPDATED, &m, sizeof(m)));
+    const uint32_t dropped = bus.getStats(EventType::METER_DATA_UPDATED).dropped;
+    bus.setPolicy(EventType::METER_DATA_UPDATED, EventPolicy::DROP_OLDEST);
+    CHECK_EQ(bus.getStats(EventType::METER_DATA_UPDATED).dropped, dropped + 1);
+    CHECK_EQ(bus.getPoolStats().inUse, 0);
+    g_meterCalls = 0;
+    bus.handle();
+    CHECK_EQ(g_meterCalls, 0);
+    bus.setPolicy(EventType::METER_DATA_UPDATED, EventPolicy::LATEST_VALUE);
+}
+
+void testLanes() {
+    puts("URGENT lane and subscriber changes from callbacks");
+    EventBus& bus = EventBus::getInstance();
+    CHECK(bus.getPriority(EventType::ERROR_OCCURRED) == EventPriority::URGENT);
+    CHECK(bus.getPriority(EventType::WIFI_CONNECTED) == EventPriority::NORMAL);
+    g_order.clear();
+    CHECK(bus.subscribe(EventType::WIFI_CONNECTED, onOrder));
+    CHECK(bus.subscribe(EventType::ERROR_OCCURRED, onOrder));
+    CHECK(bus.subscribe(EventType::OTA_STARTED, onSelfUnsubscribe));
+
+    for (int i = 0; i < 3; ++i) CHECK(bus.publish(EventType::WIFI_CONNECTED));
+    CHECK(bus.publish(EventType::ERROR_OCCURRED));
+    g_raiseError = true;
+    CHECK(bus.publish(EventType::OTA_STARTED));
+    CHECK(bus.publish(EventType::OTA_STARTED));
+    bus.handle();
+
+    // Queued error first; the one raised by a NORMAL callback overtakes the rest
+    const std::vector<EventType> expect = {
+        EventType::ERROR_OCCURRED, EventType::WIFI_CONNECTED, EventType::ERROR_OCCURRED,
+        EventType::WIFI_CONNECTED, EventType::WIFI_CONNECTED
+    };
+    CHECK(g_order == expect);
+    CHECK_EQ(g_selfCalls, 1);
+    CHECK_EQ(bus.getStats(EventType::OTA_STARTED).dispatched, 2U);
+    CHECK(!bus.unsubscribe(EventType::OTA_STARTED, onSelfUnsubscribe));
+
+    // setPriority() moves a type to the URGENT lane, ahead of queued NORMAL events
+    g_order.clear();
+    CHECK(bus.subscribe(EventType::CONFIG_CHANGED, onOrder));
+    CHECK(bus.publish(EventType::CONFIG_CHANGED));
+    bus.setPriority(EventType::WIFI_CONNECTED, EventPriority::URGENT);
+    CHECK(bus.publish(EventType::ERROR_OCCURRED));
+    CHECK(bus.publish(EventType::WIFI_CONNECTED));
+    CHECK(bus.publish(EventType::ERROR_OCCURRED));
+    bus.handle();
+    const std::vector<EventType> urgent = {
+        EventType::ERROR_OCCURRED, EventType::WIFI_CONNECTED, EventType::ERROR_OCCURRED, EventType::CONFIG_CHANGED
+    };
+    CHECK(g_order == urgent);
+    CHECK(bus.unsubscribe(EventType::CONFIG_CHANGED, onOrder));
+    bus.setPriority(EventType::WIFI_CONNECTED, EventPriority::NORMAL);
+
+    // A power quality event filled in a pool block, as the PowerQualityTask
+    // publishes it, overtakes the NORMAL backlog
+    g_order.clear();
+    g_pqSeen.clear();
+    CHECK(bus.subscribe(EventType::POWER_QUALITY_EVENT, onOrder));
+    for (int i = 0; i < 2; ++i) CHECK(bus.publish(EventType::WIFI_CONNECTED));
+    {
+        PowerQualityEvent evt;
+        evt.timestampMs = 77;
+        EventRef payload = bus.allocate(EventType::POWER_QUALITY_EVENT, sizeof(evt));
+        CHECK(static_cast<bool>(payload));
+        new (payload.data()) PowerQualityEvent(evt);
+        CHECK(bus.publish(EventType::POWER_QUALITY_EVENT, payload));
+    }
+    bus.handle();
+    const std::vector<EventType> pqFirst = {
+        EventType::POWER_QUALITY_EVENT, EventType::WIFI_CONNECTED, EventType::WIFI_CONNECTED
+    };
+    CHECK(g_order == pqFirst);
+    CHECK(g_pqSeen == std::vector<uint32_t>{ 77 });
+    CHECK(bus.unsubscribe(EventType::POWER_QUALITY_EVENT, onOrder));
+    CHECK(bus.unsubscribe(EventType::WIFI_CONNECTED, onOrder));
+    CHECK(bus.unsubscribe(EventType::ERROR_OCCURRED, onOrder));
+
+    // Ten subscribers per type
+    for (uint8_t i = 0; i < EventBus::MAX_SUBSCRIBERS_PER_EVENT; ++i) {
+        CHECK(bus.subscribe(EventType::MQTT_EVT_CONNECTED, onFast));
+    }
+    CHECK(!bus.subscribe(EventType::MQTT_EVT_CONNECTED, onFast));
+    for (uint8_t i = 0; i < EventBus::MAX_SUBSCRIBERS_PER_EVENT; ++i) {
+        CHECK(bus.unsubscribe(EventType::MQTT_EVT_CONNECTED, onFast));
+    }
+}
+
+void testCallbackTiming() {
+    puts("Callback timing");
+    EventBus& bus = EventBus::getInstance();
+    CHECK(bus.subscribe(EventType::CONFIG_CHANGED, onSlow));
+    CHECK(bus.subscribe(EventType::CONFIG_CHANGED, onFast));
+    CHECK(bus.publish(EventType::CONFIG_CHANGED));
+    const uint32_t warnings = host::countLogs(LogLevel::WARN, "Slow subscriber");
+    bus.handle();
+
+    EventSubscriberStats stats[32];
+    const uint8_t n = bus.getSubscriberStats(stats, 32);
+    const EventSubscriberStats* slow = nullptr;
+    const EventSubscriberStats* fast = nullptr;
+    for (uint8_t i = 0; i < n; ++i) {
+        if (stats[i].callback == onSlow) slow = &stats[i];
+        if (stats[i].callback == onFast) fast = &stats[i];
+    }
+    CHECK(slow != nullptr && fast != nullptr);
+    if (slow && fast) {
+        printf("  slow subscriber: %u call, %u over %u us, max %u us\n", slow->calls, slow->slowCalls,
+               (unsigned)EventBus::SLOW_CALLBACK_US, slow->maxUs);
+        CHECK(slow->type == EventType::CONFIG_CHANGED);
+        CHECK_EQ(slow->calls, 1U);
+        CHECK_EQ(slow->slowCalls, 1U);
+        CHECK(slow->maxUs >= 7000);
+        CHECK_EQ(slow->totalUs, (uint64_t)slow->maxUs);
+        CHECK_EQ(fast->calls, 1U);
+        CHECK_EQ(fast->slowCalls, 0U);
+    }
+    CHECK_EQ(host::countLogs(LogLevel::WARN, "Slow subscriber"), warnings + 1);
+    CHECK(bus.unsubscribe(EventType::CONFIG_CHANGED, onSlow));
+    CHECK(bus.unsubscribe(EventType::CONFIG_CHANGED, onFast));
+}
+
+struct DispatcherControl {
+    std::atomic<bool> stop{false};
+    std::atomic<bool> done{false};
+};
+
+// EventTask loop body (TaskManager)
+void dispatcherTask(void* param) {
+    DispatcherControl* ctl = static_cast<DispatcherControl*>(param);
+    EventBus& bus = EventBus::getInstance();
+    while (!ctl->stop) {
+        bus.dispatch(10);
+    }
+    bus.dispatch(0);
+    ctl->done = true;
+    vTaskDelete(nullptr);
+}
+
+void testDispatcherStress() {
+    puts("Stress: dispatcher task vs subscribe churn (real clock)");
+    host::useVirtualClock(false);
+    EventBus& bus = EventBus::getInstance();
+    CHECK(bus.subscribe(EventType::CALIBRATION_APPLIED, onCount));
+    const EventTypeStats before = bus.getStats(EventType::CALIBRATION_APPLIED);
+
+    DispatcherControl ctl;
+    TaskHandle_t task = nullptr;
+    CHECK_EQ(xTaskCreate(dispatcherTask, "EventTask", 4096, &ctl, 3, &task), pdPASS);
+    bus.setDispatcher(task);
+
+    constexpr int CYCLES = 200000;
+    std::atomic<uint32_t> failed{0};
+    std::thread churn([&] {
+        for (int i = 0; i < CYCLES; ++i) {
+            if (!bus.subscribe(EventType::CALIBRATION_APPLIED, onChurn)) failed++;
+            if (!bus.unsubscribe(EventType::CALIBRATION_APPLIED, onChurn)) failed++;
+        }
+    });
+    uint32_t rejected = 0;
+    for (int i = 0; i < CYCLES; ++i) {
+        if (!bus.publish(EventType::CALIBRATION_APPLIED)) rejected++;
+        if (i % 16 == 0) std::this_thread::yield();
+    }
+    churn.join();
+
+    ctl.stop = true;
+    xTaskNotifyGive(task);
+    while (!ctl.done) delay(1);
+    bus.setDispatcher(nullptr);
+
+    const EventTypeStats s = bus.getStats(EventType::CALIBRATION_APPLIED);
+    const uint32_t published = s.published - before.published;
+    const uint32_t dispatched = s.dispatched - before.dispatched;
+    const uint32_t dropped = s.dropped - before.dropped;
+    printf("  %d publishes: %u dispatched, %u dropped from a full NORMAL lane\n", CYCLES, dispatched, dropped);
+    printf("  %d subscribe/unsubscribe cycles alongside: %u failed\n", CYCLES, failed.load());
+    CHECK_EQ(rejected, 0U);
+    CHECK_EQ(published, (uint32_t)CYCLES);
+    CHECK_EQ(dispatched + dropped, published);
+    CHECK_EQ(g_counted.load(), dispatched);
+    CHECK_EQ(failed.load(), 0U);
+    CHECK(bus.unsubscribe(EventType::CALIBRATION_APPLIED, onCount));
+
+    host::useVirtualClock(true);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testPool();
+    testBackpressure();
+    testZeroCopy();
+    testLatestValue();
+    testLanes();
+    testCallbackTiming();
+    testDispatcherStress();
+
+    return host::report("test_event_bus");
+}
@@ -0,0 +1,306 @@
+/**
+ * SM-GE3222M V2.0 - Harmonic analyzer tests
+ *
+ * HarmonicAnalyzer on synthetic captures with known harmonic content, at line
+ * frequencies on and off the nominal 50 Hz. WaveformCapture and the
+ * EnergyMeter frame are replaced by the synthetic source below; the analyzer
+ * itself is the firmware source.
+ */
+
+#include "host_test.h"
+
+#include "EnergyMeter.h"
+#include "HarmonicAnalyzer.h"
+#include "WaveformCapture.h"
+
+#include <vector>
+
+namespace {
+
+struct Component {
+    uint8_t order;
+    double amplitude;   // ADC counts
+    double phaseRad;    // Of sin(h * theta + phase)
+};
+
+struct ChannelSpec {
+    std::vector<Component> parts;
+};
+
+// Capture source: 6 channels, I1 V1 I2 V2 I3 V3 per frame (highest channel bit first)
+struct SyntheticSource {
+    double lineHz = 50.0;
+    double reportedHz = 50.0;   // Frequency in the meter frame
+    ChannelSpec voltage;
+    ChannelSpec current;
+    std::vector<int16_t> samples;
+    WaveformInfo info;
+    bool failReads = false;
+
+    static double value(const ChannelSpec& ch, double theta) {
+        double v = 0.0;
+        for (const Component& c : ch.parts) v += c.amplitude * std::sin(c.order * theta + c.phaseRad);
+        return v;
+    }
+
+    void generate(uint16_t cycles) {
+        const uint32_t frames = (uint32_t)(cycles * (double)WaveformCapture::SAMPLE_RATE_HZ / lineHz + 0.5);
+        samples.assign((size_t)frames * 6, 0);
+        for (uint32_t n = 0; n < frames; ++n) {
+            const double theta = 2.0 * M_PI * lineHz * n / WaveformCapture::SAMPLE_RATE_HZ;
+            for (int ph = 0; ph < 3; ++ph) {
+                const double shifted = theta - ph * 2.0 * M_PI / 3.0;
+                samples[n * 6 + ph * 2]     = (int16_t)std::lround(value(current, shifted));
+                samples[n * 6 + ph * 2 + 1] = (int16_t)std::lround(value(voltage, shifted));
+            }
+        }
+        info.frames = frames;
+    }
+};
+
+SyntheticSource g_source;
+
+constexpr uint16_t METER_URMS = 23000;     // 230.00 V
+constexpr uint16_t METER_IRMS = 10000;     // 10.000 A
+
+} // namespace
+
+// ---- Replacements for the capture hardware and the meter ----
+
+WaveformCapture& WaveformCapture::getInstance() {
+    alignas(WaveformCapture) static uint8_t storage[sizeof(WaveformCapture)];
+    return *reinterpret_cast<WaveformCapture*>(storage);
+}
+
+bool WaveformCapture::capture(uint8_t channelMask, uint16_t cycles) {
+    if (g_source.info.frames == 0) g_source.generate(cycles);
+    g_source.info.sequence++;
+    g_source.info.valid = true;
+    g_source.info.channelMask = channelMask;
+    g_source.info.channelCount = 6;
+    g_source.info.sampleRateHz = SAMPLE_RATE_HZ;
+    return true;
+}
+
+WaveformInfo WaveformCapture::getInfo() {
+    return g_source.info;
+}
+
+size_t WaveformCapture::read(uint32_t sequence, size_t byteOffset, uint8_t* dst, size_t maxBytes) {
+    const size_t total = g_source.info.byteLength();
+    if (g_source.failReads || sequence != g_source.info.sequence || byteOffset >= total) return 0;
+    const size_t n = std::min(maxBytes, total - byteOffset);
+    memcpy(dst, reinterpret_cast<const uint8_t*>(g_source.samples.data()) + byteOffset, n);
+    return n;
+}
+
+EnergyMeter::EnergyMeter() {}
+
+bool EnergyMeter::getRawFrame(RawMeterFrame& frame) {
+    frame = RawMeterFrame();
+    frame.freq = (uint16_t)std::lround(g_source.reportedHz * 100.0);
+    for (uint8_t ph = 0; ph < 3; ++ph) {
+        frame.urms[ph] = METER_URMS;
+        frame.irms[ph] = METER_IRMS;
+    }
+    return true;
+}
+
+namespace {
+
+// ---- Analytical results for a channel spec ----
+
+double sumSquares(const ChannelSpec& ch, bool harmonicsOnly) {
+    double s = 0.0;
+    for (const Component& c : ch.parts) {
+        if (!harmonicsOnly || c.order > 1) s += c.amplitude * c.amplitude;
+    }
+    return s;
+}
+
+double amplitudeOf(const ChannelSpec& ch, uint8_t order) {
+    for (const Component& c : ch.parts) {
+        if (c.order == order) return c.amplitude;
+    }
+    return 0.0;
+}
+
+// RMS of order h once the channel is scaled to the meter RMS
+double expectedMagnitude(const ChannelSpec& ch, uint8_t order, double meterRms) {
+    return meterRms * amplitudeOf(ch, order) / std::sqrt(sumSquares(ch, false));
+}
+
+double expectedThd(const ChannelSpec& ch) {
+    return std::sqrt(sumSquares(ch, true)) / amplitudeOf(ch, 1) * 100.0;
+}
+
+double expectedKFactor(const ChannelSpec& ch) {
+    double k = 0.0;
+    for (const Component& c : ch.parts) k += (double)c.order * c.order * c.amplitude * c.amplitude;
+    return k / sumSquares(ch, false);
+}
+
+double wrapDeg(double deg) {
+    deg = std::fmod(deg, 360.0);
+    if (deg > 180.0) deg -= 360.0;
+    if (deg <= -180.0) deg += 360.0;
+    return deg;
+}
+
+struct Errors {
+    double magnitudePct = 0.0;  // Worst relative error of the non-zero orders
+    double thdPct = 0.0;        // Relative
+    double kFactorPct = 0.0;    // Relative
+    double phaseDeg = 0.0;      // Absolute
+    double leakagePct = 0.0;    // Largest absent order, % of fundamental
+};
+
+void track(double& worst, double value) {
+    worst = std::max(worst, std::fabs(value));
+}
+
+void compare(const ChannelSpec& ch, const HarmonicSpectrum& spec, double meterRms, double phaseShiftRad,
+             Errors& err) {
+    for (uint8_t h = 1; h <= HARMONIC_MAX_ORDER; ++h) {
+        const double expect = expectedMagnitude(ch, h, meterRms);
+        if (expect == 0.0) {
+            track(err.leakagePct, spec.magnitude[h - 1] / spec.magnitude[0] * 100.0);
+            continue;
+        }
+        track(err.magnitudePct, (spec.magnitude[h - 1] - expect) / expect * 100.0);
+        // sin(h * (theta - shift) + phi) as a cosine phase, with the phase A voltage
+        // fundamental sin(theta) moved to 0 degrees
+        double phi = 0.0;
+        for (const Component& c : ch.parts) {
+            if (c.order == h) phi = c.phaseRad;
+        }
+        const double expectDeg = wrapDeg((phi - h * phaseShiftRad) * 180.0 / M_PI + (h - 1) * 90.0);
+        track(err.phaseDeg, wrapDeg(spec.phase[h - 1] - expectDeg));
+    }
+    const double thd = expectedThd(ch);
+    track(err.thdPct, (spec.thd - thd) / thd * 100.0);
+}
+
+// Voltage with mild 3rd/5th, current with strong 3rd/5th/7th, current lagging by 0.3 rad
+void loadTypicalSpectrum() {
+    g_source.voltage.parts = { {1, 10000, 0.0}, {3, 300, 0.5}, {5, 200, 0.0} };
+    g_source.current.parts = { {1, 8000, -0.3}, {3, 2400, -0.9}, {5, 1600, 1.0}, {7, 800, 0.0} };
+}
+
+Errors analyseAt(double lineHz, HarmonicData& data) {
+    g_source.lineHz = lineHz;
+    g_source.reportedHz = lineHz;
+    g_source.info.frames = 0;   // Regenerate at the next capture
+
+    HarmonicAnalyzer& analyzer = HarmonicAnalyzer::getInstance();
+    analyzer.setDemandCurrent(0.0f);
+    CHECK(analyzer.update());
+    CHECK(analyzer.getLatest(data));
+
+    Errors err;
+    for (uint8_t ph = 0; ph < 3; ++ph) {
+        const double shift = ph * 2.0 * M_PI / 3.0;
+        compare(g_source.voltage, data.voltage[ph], METER_URMS * 0.01, shift, err);
+        compare(g_source.current, data.current[ph], METER_IRMS * 0.001, shift, err);
+        const double k = expectedKFactor(g_source.current);
+        track(err.kFactorPct, (data.kFactor[ph] - k) / k * 100.0);
+    }
+    return err;
+}
+
+// ---------------------------------------------------------------------------
+
+void testAccuracy() {
+    puts("Accuracy on synthetic captures (3rd/5th/7th)");
+    HarmonicAnalyzer& analyzer = HarmonicAnalyzer::getInstance();
+    CHECK(analyzer.init());
+    loadTypicalSpectrum();
+
+    for (double hz : { 49.7, 50.0, 60.0 }) {
+        HarmonicData data;
+        const Errors err = analyseAt(hz, data);
+        printf("  %.1f Hz: magnitude %.3f %%, THD %.3f %%, K-factor %.3f %%, phase %.3f deg, leakage %.4f %%\n",
+               hz, err.magnitudePct, err.thdPct, err.kFactorPct, err.phaseDeg, err.leakagePct);
+        CHECK_NEAR(data.lineFrequency, hz, 0.005);
+        CHECK(err.magnitudePct < 0.1);
+        CHECK(err.thdPct < 0.1);
+        CHECK(err.kFactorPct < 0.1);
+        CHECK(err.phaseDeg < 0.1);
+        CHECK(err.leakagePct < 0.01);
+        CHECK(data.valid);
+    }
+}
+
+void testReferencePhase() {
+    puts("Phase reference and TDD");
+    HarmonicAnalyzer& analyzer = HarmonicAnalyzer::getInstance();
+    loadTypicalSpectrum();
+    HarmonicData data;
+    analyseAt(50.0, data);
+
+    // Everything is referenced to the phase A voltage fundamental
+    CHECK_NEAR(data.voltage[0].phase[0], 0.0, 0.05);
+    CHECK_NEAR(data.voltage[1].phase[0], -120.0, 0.3);
+    CHECK_NEAR(data.voltage[2].phase[0], 120.0, 0.3);
+    CHECK_NEAR(data.current[0].phase[0], -0.3 * 180.0 / M_PI, 0.3);
+    // Triplens are in phase on all three phases
+    CHECK_NEAR(wrapDeg(data.current[1].phase[2] - data.current[0].phase[2]), 0.0, 0.3);
+
+    // TDD against a set demand current
+    analyzer.setDemandCurrent(20.0f);
+    CHECK(analyzer.update());
+    CHECK(analyzer.getLatest(data));
+    const double harmonicsA = METER_IRMS * 0.001 * std::sqrt(sumSquares(g_source.current, true) /
+                                                             sumSquares(g_source.current, false));
+    CHECK_NEAR(data.tdd[0], harmonicsA / 20.0 * 100.0, 0.05);
+    analyzer.setDemandCurrent(0.0f);
+}
+
+void testRejects() {
+    puts("Rejected captures");
+    HarmonicAnalyzer& analyzer = HarmonicAnalyzer::getInstance();
+    loadTypicalSpectrum();
+    HarmonicData data;
+    analyseAt(50.0, data);
+    const uint32_t seq = analyzer.getSequence();
+
+    // Capture overwritten while reading: no result, the previous one stays
+    g_source.failReads = true;
+    CHECK(!analyzer.update());
+    g_source.failReads = false;
+    CHECK_EQ(analyzer.getSequence(), seq);
+
+    // Implausible meter frequency: falls back to 50 Hz
+    g_source.reportedHz = 0.0;
+    CHECK(analyzer.update());
+    CHECK(analyzer.getLatest(data));
+    CHECK_EQ(data.lineFrequency, 50.0f);
+    CHECK_EQ(analyzer.getSequence(), seq + 1);
+}
+
+void testThroughput() {
+    puts("Throughput (host CPU)");
+    HarmonicAnalyzer& analyzer = HarmonicAnalyzer::getInstance();
+    loadTypicalSpectrum();
+    HarmonicData data;
+    analyseAt(50.0, data);
+
+    // Capture samples are generated once; each update re-analyses them
+    const double ns = host::nsPerCall(200, [&] { analyzer.update(); });
+    printf("  %.0f us per update (3 phases, 3 x %u-point FFT)\n", ns / 1000.0, (unsigned)HarmonicAnalyzer::FFT_SIZE);
+    CHECK(ns > 0.0);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testAccuracy();
+    testReferencePhase();
+    testRejects();
+    testThroughput();
+
+    return host::report("test_harmonic_analyzer");
+}
@@ -0,0 +1,310 @@
+/**
+ * SM-GE3222M V2.0 - Measurement filter bank tests
+ *
+ * MeterFilterBank against exact references: the SMA running sum over many
+ * window wraps and after a window change, EMA (Q16) convergence and small
+ * steps, median-of-N spike rejection at N = 1 and N = 15, group gating, and
+ * reconfiguration through SystemConfig and the config text form.
+ */
+
+#include "host_test.h"
+
+#include "ATM90E36Driver.h"
+#include "MeterFilterBank.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint8_t FAST = pollGroupBit(PollGroup::FAST);
+const uint8_t MEDIUM = pollGroupBit(PollGroup::MEDIUM);
+
+// Every channel unfiltered but one
+SystemConfig onlyChannel(uint8_t ch, MeterFilterType type, uint8_t window) {
+    SystemConfig config;
+    for (MeterFilterSpec& spec : config.meterFilters) spec = { MeterFilterType::NONE, 1 };
+    config.meterFilters[ch] = { type, window };
+    return config;
+}
+
+// Feeds one PmeanA sample (a FAST, signed 32-bit channel) and returns the output
+int32_t feedPA(MeterFilterBank& bank, int32_t x, uint8_t groups = FAST) {
+    RawMeterFrame frame;
+    frame.pmean[0] = x;
+    bank.apply(frame, groups);
+    return frame.pmean[0];
+}
+
+// |out - sum / n| <= 1/2, i.e. out is the exact mean rounded
+bool isRoundedMean(int32_t out, int64_t sum, int64_t n) {
+    const int64_t err = 2 * n * (int64_t)out - 2 * sum;
+    return (err < 0 ? -err : err) <= n;
+}
+
+int32_t referenceMedian(std::vector<int32_t> v) {
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    if (n & 1) return v[n / 2];
+    const int64_t s = (int64_t)v[n / 2 - 1] + v[n / 2];
+    return (int32_t)((s >= 0 ? s + 1 : s - 1) / 2);
+}
+
+// ---------------------------------------------------------------------------
+
+void testSma() {
+    puts("SMA running sum");
+    MeterFilterBank bank;
+    std::mt19937 rng(12);
+    std::uniform_int_distribution<int32_t> dist(-50000000, 50000000);
+
+    // 10000 samples wrap a 5-sample window 2000 times; the sum must not drift
+    uint32_t wrong = 0;
+    auto run = [&](uint8_t window, int samples) {
+        std::deque<int32_t> ref;
+        int64_t sum = 0;
+        for (int i = 0; i < samples; ++i) {
+            const int32_t x = dist(rng);
+            ref.push_back(x);
+            sum += x;
+            if (ref.size() > window) {
+                sum -= ref.front();
+                ref.pop_front();
+            }
+            if (!isRoundedMean(feedPA(bank, x), sum, (int64_t)ref.size())) wrong++;
+        }
+    };
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::SMA, 5).meterFilters);
+    run(5, 10000);
+    CHECK_EQ(wrong, 0U);
+
+    // A new window restarts the channel: the first output is the first sample
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::SMA, 8).meterFilters);
+    CHECK_EQ(bank.getSpec(MF_P_A).window, 8);
+    CHECK_EQ(feedPA(bank, 1234567), 1234567);
+    CHECK_EQ(feedPA(bank, 1234568), 1234568);   // 1234567.5 rounds away from zero
+    CHECK_EQ(feedPA(bank, -2469135), 0);        // Sum 0 over 3 samples
+    bank.reset();
+    run(8, 10000);
+    CHECK_EQ(wrong, 0U);
+
+    // The full 32-sample window at the int32 extremes: the sum is 64-bit
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::SMA, METER_FILTER_MAX_WINDOW).meterFilters);
+    int32_t out = 0;
+    for (int i = 0; i < 100; ++i) out = feedPA(bank, INT32_MAX);
+    CHECK_EQ(out, INT32_MAX);
+    for (int i = 0; i < 100; ++i) out = feedPA(bank, INT32_MIN);
+    CHECK_EQ(out, INT32_MIN);
+    printf("  window 5 then 8, 10000 random samples each: %u outputs off the exact rounded mean\n", wrong);
+
+    // Not fed when its group was not read: the field gets the last output
+    bank.reset();
+    CHECK_EQ(feedPA(bank, 777, 0), 777);        // Nothing held yet: the field is left as read
+    CHECK_EQ(feedPA(bank, 100), 100);
+    CHECK_EQ(feedPA(bank, 999, MEDIUM), 100);
+    CHECK_EQ(feedPA(bank, 300), 200);
+}
+
+void testEma() {
+    puts("EMA (Q16 state)");
+    MeterFilterBank bank;
+
+    // Step response against the floating-point EMA, alpha = 2 / 9
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::EMA, 8).meterFilters);
+    CHECK_EQ(feedPA(bank, 0), 0);
+    double ref = 0.0;
+    int32_t maxErr = 0;
+    int settled = -1;
+    for (int i = 1; i <= 200; ++i) {
+        ref += (1000000.0 - ref) * 2.0 / 9.0;
+        const int32_t out = feedPA(bank, 1000000);
+        maxErr = std::max(maxErr, (int32_t)std::llabs((long long)out - std::llround(ref)));
+        if (out == 1000000 && settled < 0) settled = i;
+        if (settled > 0 && out != 1000000) settled = 0;    // Left the target again
+    }
+    printf("  0 -> 1000000 step, N = 8: max %d LSB from the float EMA, exact after %d samples\n",
+           maxErr, settled);
+    CHECK(maxErr <= 1);
+    CHECK(settled > 0 && settled <= 100);
+
+    // A one-LSB step with alpha = 2 / 33 is smaller than one LSB per sample;
+    // the Q16 state still carries it to the new value
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::EMA, 32).meterFilters);
+    CHECK_EQ(feedPA(bank, 1000), 1000);
+    int32_t out = 0;
+    int reached = -1;
+    for (int i = 1; i <= 400 && reached < 0; ++i) {
+        out = feedPA(bank, 1001);
+        if (out == 1001) reached = i;
+    }
+    printf("  1000 -> 1001 step, N = 32: reaches 1001 after %d samples\n", reached);
+    CHECK(reached > 0);
+    CHECK(out == 1001);
+
+    // Negative values converge exactly as well
+    for (int i = 0; i < 300; ++i) out = feedPA(bank, -2500000);
+    CHECK_EQ(out, -2500000);
+}
+
+void testMedian() {
+    puts("Median-of-N spike rejection");
+    MeterFilterBank bank;
+
+    // N = 1 is a pass-through: spikes go straight out
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::MEDIAN, 1).meterFilters);
+    CHECK_EQ(feedPA(bank, 1000), 1000);
+    CHECK_EQ(feedPA(bank, 9000000), 9000000);
+    CHECK_EQ(feedPA(bank, 1000), 1000);
+
+    // N = 15: 7 spikes in every 15 consecutive samples never reach the output
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::MEDIAN, METER_FILTER_MAX_MEDIAN).meterFilters);
+    uint32_t leaked = 0;
+    for (int i = 0; i < 300; ++i) {
+        const int phase = i % 15;
+        const int32_t x = (phase < 4) ? 50000000 : (phase < 7) ? -50000000 : 1000;
+        const int32_t out = feedPA(bank, x);
+        if (i >= 14 && out != 1000) leaked++;
+    }
+    printf("  N = 15, 7 of every 15 samples spiked: %u spikes at the output after the first window\n", leaked);
+    CHECK_EQ(leaked, 0U);
+
+    // An eighth spike in the window is a majority
+    bank.reset();
+    int32_t out = 0;
+    for (int i = 0; i < 15; ++i) out = feedPA(bank, i < 8 ? 50000000 : 1000);
+    CHECK_EQ(out, 50000000);
+
+    // Random data, warm-up included (even counts average the middle pair)
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int32_t> dist(-1000000, 1000000);
+    uint32_t wrong = 0;
+    for (uint8_t n : { (uint8_t)4, METER_FILTER_MAX_MEDIAN }) {
+        bank.configure(onlyChannel(MF_P_A, MeterFilterType::MEDIAN, n).meterFilters);
+        std::deque<int32_t> window;
+        for (int i = 0; i < 2000; ++i) {
+            const int32_t x = dist(rng);
+            window.push_back(x);
+            if (window.size() > n) window.pop_front();
+            if (feedPA(bank, x) != referenceMedian(std::vector<int32_t>(window.begin(), window.end()))) wrong++;
+        }
+    }
+    CHECK_EQ(wrong, 0U);
+
+    // Median windows stop at METER_FILTER_MAX_MEDIAN
+    bank.configure(onlyChannel(MF_P_A, MeterFilterType::MEDIAN, 20).meterFilters);
+    CHECK_EQ(bank.getSpec(MF_P_A).window, METER_FILTER_MAX_MEDIAN);
+}
+
+void testConfig() {
+    puts("Reconfiguration through SystemConfig");
+    SystemConfig config;
+
+    // The V/I default keeps the V2.0 smoothing span on the FAST poll
+    for (uint8_t ch = MF_URMS_A; ch <= MF_IRMS_C; ++ch) {
+        CHECK(config.meterFilters[ch].type == MeterFilterType::SMA);
+        CHECK_EQ(config.meterFilters[ch].window * ATM90E36Driver::POLL_FAST_MS, 2500U);
+    }
+    CHECK(config.meterFilters[MF_IRMS_N].type == MeterFilterType::NONE);
+    CHECK(config.meterFilters[MF_P_T].type == MeterFilterType::NONE);
+
+    MeterFilterBank bank;
+    bank.configure(config.meterFilters);
+    RawMeterFrame frame;
+    for (int i = 0; i < 30; ++i) {
+        frame.urms[0] = 23000;
+        frame.irms[0] = 5000;
+        frame.pmean[0] = 1000 + i;
+        bank.apply(frame, FAST);
+    }
+    CHECK_EQ(frame.urms[0], 23000);
+    CHECK_EQ(frame.pmean[0], 1029);             // Unfiltered
+
+    // Only the channels whose spec changed restart
+    config.meterFilters[MF_URMS_A] = { MeterFilterType::MEDIAN, 3 };
+    config.meterFilters[MF_TEMP] = { MeterFilterType::SMA, 4 };
+    bank.configure(config.meterFilters);
+    frame.urms[0] = 23100;
+    frame.irms[0] = 5250;
+    bank.apply(frame, FAST);
+    CHECK_EQ(frame.urms[0], 23100);             // Restarted: one sample held
+    CHECK_EQ(frame.irms[0], 5010);              // Kept its history: (24 * 5000 + 5250) / 25
+
+    // Out-of-range specs are clamped; re-applying the same config changes nothing
+    config.meterFilters[MF_FREQ] = { (MeterFilterType)9, 7 };
+    config.meterFilters[MF_THDU_A] = { MeterFilterType::SMA, 0 };
+    config.meterFilters[MF_THDU_B] = { MeterFilterType::EMA, 200 };
+    bank.configure(config.meterFilters);
+    CHECK(bank.getSpec(MF_FREQ).type == MeterFilterType::NONE);
+    CHECK_EQ(bank.getSpec(MF_FREQ).window, 1);
+    CHECK_EQ(bank.getSpec(MF_THDU_A).window, 1);
+    CHECK_EQ(bank.getSpec(MF_THDU_B).window, METER_FILTER_MAX_WINDOW);
+    bank.configure(config.meterFilters);
+    frame.irms[0] = 5000;
+    bank.apply(frame, FAST);
+    CHECK_EQ(frame.irms[0], 5010);              // A 5000 replaced a 5000: not restarted
+
+    // TEMP is in the SLOW group: not fed on FAST ticks
+    frame.temp = 31;
+    bank.apply(frame, FAST);
+    CHECK_EQ(frame.temp, 31);
+    bank.apply(frame, pollGroupBit(PollGroup::SLOW));
+    frame.temp = 40;
+    bank.apply(frame, FAST);
+    CHECK_EQ(frame.temp, 31);
+
+    // Config text form
+    MeterFilterSpec spec = { MeterFilterType::NONE, 1 };
+    char text[16];
+    const char* const roundTrip[] = { "none", "sma:25", "ema:8", "median:15" };
+    for (const char* t : roundTrip) {
+        CHECK(MeterFilterBank::parseSpec(t, spec));
+        MeterFilterBank::formatSpec(spec, text, sizeof(text));
+        CHECK(strcmp(text, t) == 0);
+    }
+    CHECK(MeterFilterBank::parseSpec("MEDIAN:20", spec));
+    CHECK(spec.type == MeterFilterType::MEDIAN && spec.window == METER_FILTER_MAX_MEDIAN);
+    CHECK(MeterFilterBank::parseSpec("sma", spec));
+    CHECK(spec.type == MeterFilterType::SMA && spec.window == 1);
+    CHECK(!MeterFilterBank::parseSpec("sma:0", spec));
+    CHECK(!MeterFilterBank::parseSpec("smax", spec));
+    CHECK(!MeterFilterBank::parseSpec(nullptr, spec));
+    CHECK(strcmp(MeterFilterBank::channelName(MF_URMS_A), "urmsA") == 0);
+    CHECK(strcmp(MeterFilterBank::channelName(MF_CHANNEL_COUNT), "") == 0);
+}
+
+void testCost() {
+    puts("apply() cost");
+    MeterFilterBank bank;
+    RawMeterFrame frame;
+    frame.urms[0] = 23000;
+    bank.configure(SystemConfig().meterFilters);
+    const double defaults = host::nsPerCall(200000, [&] { bank.apply(frame, FAST); });
+
+    SystemConfig all;
+    for (MeterFilterSpec& s : all.meterFilters) s = { MeterFilterType::SMA, METER_FILTER_MAX_WINDOW };
+    bank.configure(all.meterFilters);
+    const double sma = host::nsPerCall(200000, [&] { bank.apply(frame, POLL_GROUPS_ALL); });
+    for (MeterFilterSpec& s : all.meterFilters) s = { MeterFilterType::MEDIAN, METER_FILTER_MAX_MEDIAN };
+    bank.configure(all.meterFilters);
+    const double med = host::nsPerCall(20000, [&] { bank.apply(frame, POLL_GROUPS_ALL); });
+    printf("  host CPU per apply(): defaults %.0f ns, %u x sma:32 %.0f ns, %u x median:15 %.0f ns\n",
+           defaults, (unsigned)MF_CHANNEL_COUNT, sma, (unsigned)MF_CHANNEL_COUNT, med);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testSma();
+    testEma();
+    testMedian();
+    testConfig();
+    testCost();
+
+    return host::report("test_meter_filter_bank");
+}
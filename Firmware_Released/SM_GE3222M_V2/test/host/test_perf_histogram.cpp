@@ -0,0 +1,234 @@
+/**
+ * SM-GE3222M V2.0 - Perf histogram tests
+ *
+ * PerfHistogram bucket edges (bucket 0 = 0 us, bucket b = [2^(b-1), 2^b), the
+ * last one open-ended), percentile ranks and the maxUs cap, the seqlock reader
+ * against an unthrottled writer thread, and the Modbus input registers
+ * 620..655 as a master reads them after ModbusServer::updatePerfHistogram().
+ */
+
+#include "host_test.h"
+
+#include "ModbusServer.h"
+#include "PerfHistogram.h"
+#include "PerfMonitor.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// Exact sum of the writer pattern 1, 2, .., 64, 1, 2, .. over its first n samples
+uint64_t patternSum(uint32_t n) {
+    const uint64_t full = n / 64;
+    const uint64_t rest = n % 64;
+    return full * (64 * 65 / 2) + rest * (rest + 1) / 2;
+}
+
+PerfHistogramSnapshot snapshotOf(std::initializer_list<uint32_t> samples) {
+    PerfHistogram h;
+    for (uint32_t us : samples) h.record(us);
+    PerfHistogramSnapshot s;
+    h.read(s);
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+
+void testBuckets() {
+    puts("Bucket edges");
+    CHECK_EQ(PerfHistogram::bucketOf(0), 0);
+    CHECK_EQ(PerfHistogramSnapshot::bucketFloorUs(0), 0U);
+
+    // Every value up to 2^20 against the documented edges
+    uint32_t wrong = 0;
+    for (uint32_t us = 1; us <= (1U << 20); ++us) {
+        uint8_t b = 1;
+        while (b < PERF_BUCKET_COUNT - 1 && us >= (1U << b)) b++;
+        if (PerfHistogram::bucketOf(us) != b) wrong++;
+    }
+    CHECK_EQ(wrong, 0U);
+    for (uint8_t b = 1; b < PERF_BUCKET_COUNT; ++b) {
+        CHECK_EQ(PerfHistogramSnapshot::bucketFloorUs(b), 1U << (b - 1));
+        CHECK_EQ(PerfHistogram::bucketOf(1U << (b - 1)), b);
+    }
+    CHECK_EQ(PerfHistogram::bucketOf((1U << 18) - 1), PERF_BUCKET_COUNT - 2);
+
+    // The last bucket starts at 2^18 us (~262 ms) and takes everything above
+    CHECK_EQ(PerfHistogram::bucketOf(1U << 18), PERF_BUCKET_COUNT - 1);
+    CHECK_EQ(PerfHistogram::bucketOf(10000000), PERF_BUCKET_COUNT - 1);
+    CHECK_EQ(PerfHistogram::bucketOf(UINT32_MAX), PERF_BUCKET_COUNT - 1);
+
+    // record() bookkeeping; the sum is 64-bit
+    const PerfHistogramSnapshot s = snapshotOf({ 0, 1, 3, UINT32_MAX, UINT32_MAX });
+    CHECK_EQ(s.count, 5U);
+    CHECK_EQ(s.buckets[0], 1U);
+    CHECK_EQ(s.buckets[1], 1U);
+    CHECK_EQ(s.buckets[2], 1U);
+    CHECK_EQ(s.buckets[PERF_BUCKET_COUNT - 1], 2U);
+    CHECK_EQ(s.maxUs, UINT32_MAX);
+    CHECK_EQ(s.sumUs, 4ULL + 2ULL * UINT32_MAX);
+    printf("  %u values checked against [2^(b-1), 2^b): %u misplaced\n", 1U << 20, wrong);
+}
+
+void testPercentiles() {
+    puts("Percentile ranks");
+    PerfHistogramSnapshot empty;
+    memset(&empty, 0, sizeof(empty));
+    CHECK_EQ(empty.percentileUs(50), 0U);
+    CHECK_EQ(empty.meanUs(), 0U);
+
+    // 50 x 10 us, 49 x 100 us, 1 x 5000 us: rank = ceil(count * pct / 100)
+    PerfHistogram h;
+    for (int i = 0; i < 50; ++i) h.record(10);
+    for (int i = 0; i < 49; ++i) h.record(100);
+    h.record(5000);
+    PerfHistogramSnapshot s;
+    h.read(s);
+    CHECK_EQ(s.percentileUs(1), 15U);       // Upper edge of [8, 16)
+    CHECK_EQ(s.percentileUs(50), 15U);      // Rank 50: the last 10 us sample
+    CHECK_EQ(s.percentileUs(51), 127U);     // Rank 51: the first 100 us sample
+    CHECK_EQ(s.percentileUs(99), 127U);
+    CHECK_EQ(s.percentileUs(100), 5000U);   // Edge 8191 capped at maxUs
+    CHECK_EQ(s.meanUs(), (50U * 10 + 49U * 100 + 5000) / 100);
+
+    // Ranks round up: with 3 samples p33 is the first, p34 the second
+    const PerfHistogramSnapshot three = snapshotOf({ 1, 100, 1000 });
+    CHECK_EQ(three.percentileUs(33), 1U);
+    CHECK_EQ(three.percentileUs(34), 127U);
+    CHECK_EQ(three.percentileUs(66), 127U);
+    CHECK_EQ(three.percentileUs(67), 1000U);   // Edge 1023 capped
+
+    // 0 us samples report 0; the last bucket always reports maxUs
+    CHECK_EQ(snapshotOf({ 0, 0, 7 }).percentileUs(50), 0U);
+    CHECK_EQ(snapshotOf({ 100 }).percentileUs(50), 100U);
+    CHECK_EQ(snapshotOf({ 300000, 2000000 }).percentileUs(50), 2000000U);
+
+    // 1000 samples, 1 per 1000 above the rest: p99 ignores it, p100 does not
+    PerfHistogram tail;
+    for (int i = 0; i < 999; ++i) tail.record(40);
+    tail.record(70000);
+    tail.read(s);
+    CHECK_EQ(s.percentileUs(99), 63U);
+    CHECK_EQ(s.percentileUs(100), 70000U);
+}
+
+void testSeqlock() {
+    puts("Seqlock reader vs an unthrottled writer (real clock)");
+    host::useVirtualClock(false);
+    PerfHistogram h;
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> written{0};
+
+    std::thread writer([&] {
+        uint32_t n = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            h.record(1 + n % 64);
+            written.store(++n, std::memory_order_relaxed);
+        }
+    });
+
+    constexpr int READS = 2000000;
+    uint32_t inconsistent = 0;
+    uint32_t backwards = 0;
+    uint32_t distinct = 0;
+    uint32_t last = 0;
+    PerfHistogramSnapshot s;
+    for (int i = 0; i < READS; ++i) {
+        h.read(s);
+        uint32_t inBuckets = 0;
+        for (uint32_t c : s.buckets) inBuckets += c;
+        const uint32_t expectMax = s.count == 0 ? 0 : (s.count < 64 ? s.count : 64);
+        if (inBuckets != s.count || s.sumUs != patternSum(s.count) || s.maxUs != expectMax) inconsistent++;
+        if (s.count < last) backwards++;
+        if (s.count != last) distinct++;
+        last = s.count;
+        // Hand the core to the writer now and then, so single-core hosts interleave too
+        if (i % 10000 == 0) std::this_thread::yield();
+    }
+    stop = true;
+    writer.join();
+    h.read(s);
+
+    printf("  %d reads over %u records (%u distinct counts seen): %u inconsistent, %u going backwards\n",
+           READS, s.count, distinct, inconsistent, backwards);
+    CHECK_EQ(inconsistent, 0U);
+    CHECK_EQ(backwards, 0U);
+    CHECK_EQ(s.count, written.load());
+    CHECK(distinct > 1);
+    host::useVirtualClock(true);
+}
+
+void testModbusBlock() {
+    puts("Modbus input registers 620..655");
+    CHECK_EQ(MB_PERF_BASE + PERF_METRIC_COUNT * MB_PERF_BLOCK_SIZE - 1, MB_PERF_LAST);
+
+    ModbusServer& server = ModbusServer::getInstance();
+    ModbusConfig config;
+    config.rtuEnabled = true;
+    CHECK(server.begin(config));
+    ModbusRTU* rtu = ModbusRTU::hostInstance();
+    CHECK(rtu != nullptr);
+    if (!rtu) return;
+
+    // Metric m: 70000 + m samples of 20 us, then one of 100 ms (p99 20 -> edge 31,
+    // max saturated); the count needs both words
+    for (uint8_t m = 0; m < PERF_METRIC_COUNT; ++m) {
+        PerfHistogram h;
+        for (uint32_t i = 0; i < 70000U + m; ++i) h.record(20);
+        h.record(100000);
+        PerfHistogramSnapshot s;
+        h.read(s);
+        server.updatePerfHistogram(m, s);
+    }
+
+    uint16_t regs[MB_PERF_LAST - MB_PERF_BASE + 1];
+    CHECK(rtu->readIregs(MB_PERF_BASE, sizeof(regs) / sizeof(regs[0]), regs));
+    uint32_t wrong = 0;
+    for (uint8_t m = 0; m < PERF_METRIC_COUNT; ++m) {
+        const uint16_t* block = &regs[m * MB_PERF_BLOCK_SIZE];
+        const uint32_t count = 70001U + m;
+        const uint32_t mean = (uint32_t)((20ULL * (count - 1) + 100000) / count);
+        if (((uint32_t)block[MB_PERF_COUNT] << 16 | block[MB_PERF_COUNT + 1]) != count) wrong++;
+        if (block[MB_PERF_MEAN] != mean) wrong++;
+        if (block[MB_PERF_P50] != 31) wrong++;
+        if (block[MB_PERF_P99] != 31) wrong++;
+        if (block[MB_PERF_MAX] != 0xFFFF) wrong++;
+    }
+    CHECK_EQ(wrong, 0U);
+    printf("  block 0: count 0x%04X 0x%04X, mean %u, p50 %u, p99 %u, max %u\n",
+           regs[0], regs[1], regs[MB_PERF_MEAN], regs[MB_PERF_P50], regs[MB_PERF_P99], regs[MB_PERF_MAX]);
+
+    // The block ends at 655: nothing mapped around it, a metric past the end is ignored
+    uint16_t outside = 0;
+    CHECK(!rtu->readIregs(MB_PERF_BASE - 1, 1, &outside));
+    CHECK(!rtu->readIregs(MB_PERF_LAST + 1, 1, &outside));
+    PerfHistogramSnapshot big = snapshotOf({ 5 });
+    server.updatePerfHistogram(PERF_METRIC_COUNT, big);
+    uint16_t after[sizeof(regs) / sizeof(regs[0])];
+    CHECK(rtu->readIregs(MB_PERF_BASE, sizeof(after) / sizeof(after[0]), after));
+    CHECK(memcmp(regs, after, sizeof(regs)) == 0);
+
+    // An empty histogram reads as zeros
+    PerfHistogramSnapshot empty;
+    memset(&empty, 0, sizeof(empty));
+    server.updatePerfHistogram(PERF_ENERGY_WAKE, empty);
+    CHECK(rtu->readIregs(MB_PERF_BASE + PERF_ENERGY_WAKE * MB_PERF_BLOCK_SIZE, MB_PERF_BLOCK_SIZE, after));
+    bool zero = true;
+    for (uint16_t i = 0; i < MB_PERF_BLOCK_SIZE; ++i) zero = zero && after[i] == 0;
+    CHECK(zero);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testBuckets();
+    testPercentiles();
+    testSeqlock();
+    testModbusBlock();
+
+    return host::report("test_perf_histogram");
+}
@@ -0,0 +1,249 @@
+/**
+ * SM-GE3222M V2.0 - Snapshot buffer tests
+ *
+ * SnapshotBuffer semantics on one thread (including a reader that runs while
+ * the writer is mid-update and a writer that laps a copy), then a stress run
+ * with one unthrottled writer and four readers on the real clock, against the
+ * mutex-guarded copy getSnapshot() used before.
+ */
+
+#include "host_test.h"
+
+#include "SnapshotBuffer.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// MeterData-sized payload; every word carries the generation that wrote it
+struct Payload {
+    uint32_t words[(sizeof(MeterData) + 3) / 4];
+
+    bool consistent() const {
+        for (uint32_t w : words) {
+            if (w != words[0]) return false;
+        }
+        return true;
+    }
+
+    void fill(uint32_t value) {
+        for (uint32_t& w : words) w = value;
+    }
+};
+
+// Payload whose copy runs a hook halfway through (a writer preempting the reader)
+struct HookedPayload {
+    static std::function<void()> midCopy;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+
+    HookedPayload() = default;
+    HookedPayload(const HookedPayload& other) = default;
+    HookedPayload& operator=(const HookedPayload& other) {
+        head = other.head;
+        if (midCopy) {
+            auto hook = midCopy;
+            midCopy = nullptr;
+            hook();
+        }
+        tail = other.tail;
+        return *this;
+    }
+};
+
+std::function<void()> HookedPayload::midCopy;
+
+struct Percentiles {
+    double p50, p99, p999, max;
+};
+
+Percentiles percentiles(std::vector<double>& ns) {
+    std::sort(ns.begin(), ns.end());
+    return { ns[ns.size() / 2], ns[ns.size() * 99 / 100], ns[ns.size() * 999 / 1000], ns.back() };
+}
+
+// ---------------------------------------------------------------------------
+
+void testSingleThread() {
+    puts("Writer/reader semantics");
+    SnapshotBuffer<Payload> buf;
+    Payload out;
+    out.fill(99);
+    CHECK_EQ(buf.read(out), 0U);
+    CHECK(out.consistent() && out.words[0] == 0);
+    CHECK_EQ(buf.generation(), 0U);
+
+    Payload& next = buf.beginWrite();
+    next.fill(1);
+    buf.commit();
+    CHECK_EQ(buf.generation(), 1U);
+    CHECK_EQ(buf.published().words[0], 1U);
+
+    // beginWrite() starts from the published value
+    Payload& again = buf.beginWrite();
+    CHECK(again.consistent() && again.words[0] == 1);
+    again.words[0] = 2;
+
+    // A reader running while the writer is mid-update sees the last published value
+    CHECK_EQ(buf.read(out), 0U);
+    CHECK(out.consistent() && out.words[0] == 1);
+    again.fill(2);
+    buf.commit();
+    CHECK_EQ(buf.read(out), 0U);
+    CHECK(out.consistent() && out.words[0] == 2);
+
+    const SnapshotStats stats = buf.getStats();
+    CHECK_EQ(stats.reads, 3U);
+    CHECK_EQ(stats.retries, 0U);
+    CHECK_EQ(stats.writes, 2U);
+}
+
+void testLappedReader() {
+    puts("Reader lapped by the writer");
+    SnapshotBuffer<HookedPayload> buf;
+    auto publish = [&](uint32_t v) {
+        HookedPayload& next = buf.beginWrite();
+        next.head = v;
+        next.tail = v;
+        buf.commit();
+    };
+    publish(1);
+
+    HookedPayload out;
+
+    // One publish during the copy goes to the other slot: the copy stands
+    HookedPayload::midCopy = [&] { publish(2); };
+    CHECK_EQ(buf.read(out), 0U);
+    CHECK(out.head == 1 && out.tail == 1);
+
+    // Two publishes reuse the slot being copied: torn, re-read once
+    HookedPayload::midCopy = [&] { publish(3); publish(4); };
+    CHECK_EQ(buf.read(out), 1U);
+    CHECK(out.head == 4 && out.tail == 4);
+
+    const SnapshotStats stats = buf.getStats();
+    CHECK_EQ(stats.retries, 1U);
+    CHECK_EQ(stats.maxRetries, 1U);
+    CHECK_EQ(stats.writes, 4U);
+}
+
+void testStress() {
+    puts("Stress: 1 unthrottled writer, 4 readers (real clock)");
+    host::useVirtualClock(false);
+
+    constexpr int READERS = 4;
+    constexpr int READS = 200000;
+    constexpr int MUTEX_READS = READS / 10;     // Each contended take is a thread hand-off
+
+    // Lock-free snapshot
+    SnapshotBuffer<Payload> buf;
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> torn{0};
+    std::vector<std::vector<double>> latency(READERS);
+
+    std::thread writer([&] {
+        uint32_t n = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            buf.beginWrite().fill(++n);
+            buf.commit();
+        }
+    });
+    std::vector<std::thread> readers;
+    for (int r = 0; r < READERS; ++r) {
+        readers.emplace_back([&, r] {
+            Payload p;
+            latency[r].reserve(READS);
+            for (int i = 0; i < READS; ++i) {
+                const auto t0 = std::chrono::steady_clock::now();
+                buf.read(p);
+                const auto t1 = std::chrono::steady_clock::now();
+                latency[r].push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+                if (!p.consistent()) torn++;
+            }
+        });
+    }
+    for (std::thread& t : readers) t.join();
+    stop = true;
+    writer.join();
+
+    std::vector<double> all;
+    for (auto& l : latency) all.insert(all.end(), l.begin(), l.end());
+    const Percentiles lf = percentiles(all);
+    const SnapshotStats stats = buf.getStats();
+
+    // Previous getSnapshot(): copy under the meter mutex
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    Payload guarded;
+    guarded.fill(0);
+    std::atomic<uint32_t> mutexTorn{0};
+    std::atomic<uint32_t> timeouts{0};
+    stop = false;
+    for (auto& l : latency) l.clear();
+
+    std::thread mutexWriter([&] {
+        uint32_t n = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (xSemaphoreTake(mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+                guarded.fill(++n);
+                xSemaphoreGive(mutex);
+            }
+        }
+    });
+    readers.clear();
+    for (int r = 0; r < READERS; ++r) {
+        readers.emplace_back([&, r] {
+            Payload p;
+            for (int i = 0; i < MUTEX_READS; ++i) {
+                const auto t0 = std::chrono::steady_clock::now();
+                if (xSemaphoreTake(mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+                    p = guarded;
+                    xSemaphoreGive(mutex);
+                } else {
+                    timeouts++;
+                }
+                const auto t1 = std::chrono::steady_clock::now();
+                latency[r].push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+                if (!p.consistent()) mutexTorn++;
+            }
+        });
+    }
+    for (std::thread& t : readers) t.join();
+    stop = true;
+    mutexWriter.join();
+    vSemaphoreDelete(mutex);
+
+    all.clear();
+    for (auto& l : latency) all.insert(all.end(), l.begin(), l.end());
+    const Percentiles mx = percentiles(all);
+
+    printf("  %zu-byte payload, %u reads, %u publishes\n", sizeof(Payload), stats.reads, stats.writes);
+    printf("  SnapshotBuffer  p50 %6.0f  p99 %6.0f  p99.9 %7.0f  max %8.0f ns  (%u retries, worst %u)\n",
+           lf.p50, lf.p99, lf.p999, lf.max, stats.retries, stats.maxRetries);
+    printf("  mutex copy      p50 %6.0f  p99 %6.0f  p99.9 %7.0f  max %8.0f ns  (%u reads)\n",
+           mx.p50, mx.p99, mx.p999, mx.max, (unsigned)(READERS * MUTEX_READS));
+
+    CHECK_EQ(torn.load(), 0U);
+    CHECK_EQ(stats.reads, (uint32_t)(READERS * READS));
+    CHECK(stats.writes > 0);
+    CHECK(stats.maxRetries <= stats.retries);
+    CHECK_EQ(mutexTorn.load(), 0U);
+    CHECK_EQ(timeouts.load(), 0U);
+
+    host::useVirtualClock(true);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testSingleThread();
+    testLappedReader();
+    testStress();
+
+    return host::report("test_snapshot_buffer");
+}
@@ -0,0 +1,240 @@
+/**
+ * SM-GE3222M V2.0 - SPSC ring tests
+ *
+ * SpscRing on one thread: the empty and full boundaries, the 16-bit head/tail
+ * wrapping past 65535 (also while full) and the overrun count; then one
+ * producer and one consumer thread on the real clock, first retrying on a
+ * full ring (nothing lost), then dropping like the FastPowerTask does.
+ */
+
+#include "host_test.h"
+
+#include "SpscRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// PowerSample-sized element; every word carries the sequence that wrote it
+struct Item {
+    uint32_t words[6];
+
+    bool consistent() const {
+        for (uint32_t w : words) {
+            if (w != words[0]) return false;
+        }
+        return true;
+    }
+
+    void fill(uint32_t value) {
+        for (uint32_t& w : words) w = value;
+    }
+};
+
+template <typename Ring>
+void advance(Ring& ring, uint32_t steps) {
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < steps; ++i) {
+        ring.push(i);
+        ring.pop(v);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void testBoundaries() {
+    puts("Empty and full");
+    SpscRing<uint32_t, 8> ring;
+    CHECK_EQ(ring.capacity(), 8);
+    CHECK_EQ(ring.size(), 0);
+
+    uint32_t out = 99;
+    CHECK(!ring.pop(out));
+    CHECK_EQ(out, 99U);                 // Untouched on empty
+
+    for (uint32_t i = 0; i < 8; ++i) CHECK(ring.push(i));
+    CHECK_EQ(ring.size(), 8);
+    CHECK_EQ(ring.overruns(), 0U);
+
+    // Full: the new element is rejected, the oldest is kept
+    CHECK(!ring.push(100));
+    CHECK_EQ(ring.size(), 8);
+    CHECK_EQ(ring.overruns(), 1U);
+
+    bool ordered = true;
+    for (uint32_t i = 0; i < 8; ++i) ordered = ring.pop(out) && out == i && ordered;
+    CHECK(ordered);
+    CHECK(!ring.pop(out));
+    CHECK_EQ(ring.size(), 0);
+
+    // One slot freed is one push accepted
+    for (uint32_t i = 0; i < 8; ++i) ring.push(i);
+    CHECK(ring.pop(out));
+    CHECK(ring.push(8));
+    CHECK(!ring.push(9));
+    CHECK_EQ(ring.overruns(), 2U);
+    CHECK_EQ(ring.size(), 8);
+}
+
+void testIndexWrap() {
+    puts("16-bit index wrap");
+    SpscRing<uint32_t, 8> ring;
+
+    // Head and tail at 65533: filling the ring carries head past 65535
+    advance(ring, 65533);
+    for (uint32_t i = 0; i < 8; ++i) CHECK(ring.push(1000 + i));
+    CHECK_EQ(ring.size(), 8);
+    CHECK(!ring.push(2000));
+    CHECK_EQ(ring.overruns(), 1U);
+
+    uint32_t out = 0;
+    bool ordered = true;
+    for (uint32_t i = 0; i < 8; ++i) ordered = ring.pop(out) && out == 1000 + i && ordered;
+    CHECK(ordered);
+    CHECK(!ring.pop(out));
+    CHECK_EQ(ring.size(), 0);
+
+    // Three more wraps with 1..8 elements in flight
+    uint32_t next = 0;
+    uint32_t expect = 0;
+    uint32_t wrong = 0;
+    uint32_t badSize = 0;
+    uint16_t held = 0;
+    for (uint32_t step = 0; step < 3 * 65536U; ++step) {
+        const uint16_t fill = 1 + step % 8;
+        for (; held < fill; ++held) ring.push(next++);
+        if (ring.size() != held) badSize++;
+        if (!ring.pop(out) || out != expect++) wrong++;
+        held--;
+    }
+    printf("  %u elements through an 8-slot ring (%u index wraps): %u out of order, %u bad sizes\n",
+           next, next / 65536U, wrong, badSize);
+    CHECK_EQ(wrong, 0U);
+    CHECK_EQ(badSize, 0U);
+    CHECK_EQ(ring.overruns(), 1U);
+}
+
+void testOverruns() {
+    puts("Overrun count");
+    SpscRing<Item, 64> ring;
+    Item item;
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < 100; ++i) {
+        item.fill(i);
+        if (ring.push(item)) accepted++;
+    }
+    CHECK_EQ(accepted, 64U);
+    CHECK_EQ(ring.overruns(), 36U);
+
+    // The consumer sees the first 64; the rejected tail is what the sequence gap shows
+    Item out;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t n = 0;
+    while (ring.pop(out)) {
+        if (n++ == 0) first = out.words[0];
+        last = out.words[0];
+    }
+    CHECK_EQ(n, 64U);
+    CHECK_EQ(first, 0U);
+    CHECK_EQ(last, 63U);
+
+    // Draining does not reset the count
+    item.fill(100);
+    CHECK(ring.push(item));
+    CHECK_EQ(ring.overruns(), 36U);
+}
+
+struct StressResult {
+    uint32_t received = 0;
+    uint32_t outOfOrder = 0;
+    uint32_t torn = 0;
+    uint32_t rejected = 0;      // push() calls that returned false
+    double nsPerItem = 0.0;
+};
+
+// retry: the producer spins on a full ring, otherwise it drops the element
+// (1000000 elements carry the 16-bit indices through 15 wraps)
+StressResult runStress(uint32_t items, bool retry) {
+    SpscRing<Item, 64> ring;
+    StressResult r;
+    std::atomic<bool> done{false};
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        Item item;
+        for (uint32_t seq = 1; seq <= items; ++seq) {
+            item.fill(seq);
+            while (!ring.push(item)) {
+                r.rejected++;
+                if (!retry) break;
+                std::this_thread::yield();
+            }
+            // Bursts of 100 against 64 slots, so the consumer also runs on one core
+            if (!retry && seq % 100 == 0) std::this_thread::yield();
+        }
+        done = true;
+    });
+    std::thread consumer([&] {
+        Item out;
+        uint32_t last = 0;
+        while (true) {
+            if (!ring.pop(out)) {
+                if (done.load() && ring.size() == 0) break;
+                std::this_thread::yield();
+                continue;
+            }
+            if (!out.consistent()) r.torn++;
+            const uint32_t seq = out.words[0];
+            if (retry ? seq != last + 1 : seq <= last) r.outOfOrder++;
+            last = seq;
+            r.received++;
+        }
+    });
+    producer.join();
+    consumer.join();
+    const auto t1 = std::chrono::steady_clock::now();
+    r.nsPerItem = std::chrono::duration<double, std::nano>(t1 - t0).count() / items;
+
+    CHECK_EQ(ring.overruns(), r.rejected);
+    return r;
+}
+
+void testStress() {
+    puts("Stress: 1 producer, 1 consumer (real clock)");
+    host::useVirtualClock(false);
+    constexpr uint32_t ITEMS = 1000000;
+
+    const StressResult lossless = runStress(ITEMS, true);
+    printf("  retry on full: %u of %u received, %u full-ring retries, %u out of sequence, %u torn, %.0f ns/item\n",
+           lossless.received, ITEMS, lossless.rejected, lossless.outOfOrder, lossless.torn, lossless.nsPerItem);
+    CHECK_EQ(lossless.received, ITEMS);
+    CHECK_EQ(lossless.outOfOrder, 0U);
+    CHECK_EQ(lossless.torn, 0U);
+
+    const StressResult dropping = runStress(ITEMS, false);
+    printf("  drop on full:  %u received + %u overruns = %u, %u out of order, %u torn, %.0f ns/item\n",
+           dropping.received, dropping.rejected, dropping.received + dropping.rejected,
+           dropping.outOfOrder, dropping.torn, dropping.nsPerItem);
+    CHECK_EQ(dropping.received + dropping.rejected, ITEMS);
+    CHECK_EQ(dropping.outOfOrder, 0U);
+    CHECK_EQ(dropping.torn, 0U);
+
+    host::useVirtualClock(true);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testBoundaries();
+    testIndexWrap();
+    testOverruns();
+    testStress();
+
+    return host::report("test_spsc_ring");
+}
@@ -0,0 +1,230 @@
+/**
+ * SM-GE3222M V2.0 - Task monitor tests
+ *
+ * TaskMonitor registration, stack marks and schedule statistics, and the CPU
+ * share of each sampling path. Built twice: test_task_monitor uses the
+ * TaskScheduler execution times (no run-time counters, as the default Arduino
+ * core), test_task_monitor_rts the FreeRTOS run-time counters set through
+ * host::setSystemState(), including a counter wrap.
+ */
+
+#include "host_test.h"
+
+#include "TaskMonitor.h"
+
+#include <vector>
+
+namespace {
+
+// Task handles are only compared, so any distinct addresses do
+int g_anchors[TaskMonitor::MAX_TASKS + 4];
+
+TaskHandle_t handle(int i) {
+    return &g_anchors[i];
+}
+
+enum : int { ENERGY = 0, WEBUI, DHT, IDLE0, IDLE1 };
+
+const TaskRuntimeStats* find(const TaskRuntimeStats* tasks, uint8_t n, const char* name) {
+    for (uint8_t i = 0; i < n; ++i) {
+        if (strcmp(tasks[i].name, name) == 0) return &tasks[i];
+    }
+    return nullptr;
+}
+
+#ifdef HOST_RUN_TIME_STATS
+uint32_t g_runTime[5];
+uint32_t g_totalRunTime = 0;
+
+// Every task but DHTTask
+void publishSystemState() {
+    std::vector<TaskStatus_t> state;
+    for (int i = ENERGY; i <= IDLE1; ++i) {
+        if (i == DHT) continue;
+        TaskStatus_t s;
+        memset(&s, 0, sizeof(s));
+        s.xHandle = handle(i);
+        s.ulRunTimeCounter = g_runTime[i];
+        state.push_back(s);
+    }
+    host::setSystemState(state, g_totalRunTime);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+
+void testRegistration() {
+    puts("Registration");
+    TaskMonitor& monitor = TaskMonitor::getInstance();
+    TaskRuntimeStats tasks[TaskMonitor::MAX_TASKS];
+    CHECK_EQ(monitor.getTasks(tasks, TaskMonitor::MAX_TASKS), 0);
+
+    monitor.track(handle(ENERGY), "EnergyTask", 8192, 5, 1);
+    monitor.track(handle(WEBUI), "WebUITask", 6144, 2, tskNO_AFFINITY);
+    monitor.track(handle(DHT), "DHTTask", 2048, 1, 0);
+    monitor.track(nullptr, "NoHandle", 1024, 1, 0);
+    host::setStackHighWaterMark(handle(ENERGY), 5120);
+    host::setStackHighWaterMark(handle(WEBUI), 400);
+    host::setStackHighWaterMark(handle(DHT), 1500);
+
+    // Before the first sample the stack marks are the full stack
+    uint8_t n = monitor.getTasks(tasks, TaskMonitor::MAX_TASKS);
+    CHECK_EQ(n, 3);
+    CHECK_EQ(tasks[0].stackFreeMin, 8192U);
+    CHECK_EQ(tasks[0].cpuPct, -1.0f);
+
+    monitor.sample();
+    n = monitor.getTasks(tasks, TaskMonitor::MAX_TASKS);
+    const TaskRuntimeStats* energy = find(tasks, n, "EnergyTask");
+    const TaskRuntimeStats* webui = find(tasks, n, "WebUITask");
+    CHECK(energy != nullptr && webui != nullptr);
+    if (energy && webui) {
+        CHECK_EQ(energy->core, 1);
+        CHECK_EQ(energy->priority, 5);
+        CHECK_EQ(energy->stackSize, 8192U);
+        CHECK_EQ(energy->stackFreeMin, 5120U);
+        CHECK(energy->scheduled);           // Matched to SchedTask::ENERGY by name
+        CHECK_EQ(webui->core, -1);
+        CHECK_EQ(webui->stackFreeMin, 400U);
+        CHECK(webui->stackFreeMin < TaskMonitor::STACK_LOW_BYTES);
+        CHECK(!webui->scheduled);
+    }
+    CHECK_EQ(monitor.getCpuLoad().samples, 1U);
+
+    // Untracked before deletion: gone from the list, the others keep their order
+    monitor.untrack(handle(WEBUI));
+    n = monitor.getTasks(tasks, TaskMonitor::MAX_TASKS);
+    CHECK_EQ(n, 2);
+    CHECK(strcmp(tasks[0].name, "EnergyTask") == 0 && strcmp(tasks[1].name, "DHTTask") == 0);
+    monitor.untrack(handle(WEBUI));
+    CHECK_EQ(monitor.getTasks(tasks, TaskMonitor::MAX_TASKS), 2);
+
+    // Full list
+    const size_t warnings = host::countLogs(LogLevel::WARN, "not tracked");
+    for (int i = 0; i < TaskMonitor::MAX_TASKS; ++i) {
+        monitor.track(handle(i + 3), "Extra", 1024, 1, 0);
+    }
+    CHECK_EQ(monitor.getTasks(tasks, TaskMonitor::MAX_TASKS), TaskMonitor::MAX_TASKS);
+    CHECK_EQ(host::countLogs(LogLevel::WARN, "not tracked"), warnings + 2);
+    CHECK_EQ(monitor.getTasks(tasks, 4), 4);
+
+    monitor.clear();
+    CHECK_EQ(monitor.getTasks(tasks, TaskMonitor::MAX_TASKS), 0);
+}
+
+#ifndef HOST_RUN_TIME_STATS
+
+void testExecTimeShare() {
+    puts("CPU share from TaskScheduler execution time");
+    TaskMonitor& monitor = TaskMonitor::getInstance();
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    sched.registerTask(SchedTask::ENERGY, 100, 0, 50);
+    monitor.track(handle(ENERGY), "EnergyTask", 8192, 5, 1);
+    monitor.track(handle(WEBUI), "WebUITask", 6144, 2, tskNO_AFFINITY);
+
+    monitor.sample();
+    const int64_t t0 = host::nowUs();
+    for (int i = 0; i < 10; ++i) {
+        sched.waitForRelease(SchedTask::ENERGY);
+        host::advanceUs(20000);
+        sched.complete(SchedTask::ENERGY);
+    }
+    monitor.sample();
+    const int64_t windowUs = host::nowUs() - t0;
+
+    TaskRuntimeStats tasks[TaskMonitor::MAX_TASKS];
+    const uint8_t n = monitor.getTasks(tasks, TaskMonitor::MAX_TASKS);
+    const TaskRuntimeStats* energy = find(tasks, n, "EnergyTask");
+    const TaskRuntimeStats* webui = find(tasks, n, "WebUITask");
+    const CpuLoadStats load = monitor.getCpuLoad();
+    CHECK(energy != nullptr && webui != nullptr);
+    if (energy && webui) {
+        printf("  EnergyTask %.1f %% over %u ms (10 x 20 ms), WebUITask %.0f, core load %.0f / %.0f\n",
+               energy->cpuPct, load.windowMs, webui->cpuPct, load.corePct[0], load.corePct[1]);
+        CHECK_NEAR(energy->cpuPct, 200000.0 * 100.0 / windowUs, 0.01);
+        CHECK_EQ(webui->cpuPct, -1.0f);     // Not released by TaskScheduler: unknown
+        CHECK_EQ(energy->schedule.releases, 10U);
+        CHECK_EQ(energy->schedule.maxExecUs, 20000U);
+        CHECK_EQ(energy->schedule.totalExecUs, 200000U);
+    }
+    CHECK(!load.runTimeStats);
+    CHECK_EQ(load.cores, 2);
+    CHECK_EQ(load.corePct[0], -1.0f);
+    CHECK_EQ(load.corePct[1], -1.0f);
+    CHECK_EQ((int64_t)load.windowMs, windowUs / 1000);
+    monitor.clear();
+}
+
+#else
+
+void testRunTimeShare() {
+    puts("CPU share from the FreeRTOS run-time counters");
+    TaskMonitor& monitor = TaskMonitor::getInstance();
+    monitor.track(handle(ENERGY), "EnergyTask", 8192, 5, 1);
+    monitor.track(handle(WEBUI), "WebUITask", 6144, 2, tskNO_AFFINITY);
+    monitor.track(handle(DHT), "DHTTask", 2048, 1, 0);
+    host::setIdleTask(0, handle(IDLE0));
+    host::setIdleTask(1, handle(IDLE1));
+
+    // Baselines just below the 32-bit wrap
+    g_totalRunTime = 0xFFFFFF00U;
+    for (uint32_t& rt : g_runTime) rt = 0xFFFFFF00U;
+    publishSystemState();
+    monitor.sample();
+    host::advanceUs(1000000);
+    g_totalRunTime += 1000000;
+    g_runTime[ENERGY] += 200000;
+    g_runTime[WEBUI] += 50000;
+    g_runTime[IDLE0] += 700000;
+    g_runTime[IDLE1] += 900000;
+    publishSystemState();
+    monitor.sample();
+
+    TaskRuntimeStats tasks[TaskMonitor::MAX_TASKS];
+    const uint8_t n = monitor.getTasks(tasks, TaskMonitor::MAX_TASKS);
+    const TaskRuntimeStats* energy = find(tasks, n, "EnergyTask");
+    const TaskRuntimeStats* webui = find(tasks, n, "WebUITask");
+    const TaskRuntimeStats* dht = find(tasks, n, "DHTTask");
+    const CpuLoadStats load = monitor.getCpuLoad();
+    CHECK(energy != nullptr && webui != nullptr && dht != nullptr);
+    if (energy && webui && dht) {
+        printf("  across the counter wrap: EnergyTask %.1f %%, WebUITask %.1f %%, core load %.1f / %.1f %%\n",
+               energy->cpuPct, webui->cpuPct, load.corePct[0], load.corePct[1]);
+        CHECK_NEAR(energy->cpuPct, 20.0, 0.01);
+        CHECK_NEAR(webui->cpuPct, 5.0, 0.01);
+        CHECK_EQ(dht->cpuPct, -1.0f);
+    }
+    CHECK(load.runTimeStats);
+    CHECK_NEAR(load.corePct[0], 30.0, 0.01);
+    CHECK_NEAR(load.corePct[1], 10.0, 0.01);
+    CHECK_EQ(load.windowMs, 1000U);
+
+    // More tasks than the snapshot holds: no CPU figures, the sample still counts
+    std::vector<TaskStatus_t> crowded(64);
+    host::setSystemState(crowded, g_totalRunTime);
+    const uint32_t samples = load.samples;
+    const size_t warnings = host::countLogs(LogLevel::WARN, "CPU not sampled");
+    monitor.sample();
+    CHECK_EQ(monitor.getCpuLoad().samples, samples + 1);
+    CHECK_EQ(host::countLogs(LogLevel::WARN, "CPU not sampled"), warnings + 1);
+    monitor.clear();
+}
+
+#endif
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+    host::advanceUs(1000);      // Boot time: sample() reads a zero timestamp as "never sampled"
+
+    testRegistration();
+#ifndef HOST_RUN_TIME_STATS
+    testExecTimeShare();
+    return host::report("test_task_monitor");
+#else
+    testRunTimeShare();
+    return host::report("test_task_monitor_rts");
+#endif
+}
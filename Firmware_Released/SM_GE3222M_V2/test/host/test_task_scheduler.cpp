@@ -0,0 +1,216 @@
+/**
+ * SM-GE3222M V2.0 - Task scheduler tests
+ *
+ * TaskScheduler release grids on the virtual clock with the periods, phases
+ * and deadlines TaskManager registers: releases on the grid, the readInterval
+ * cadence, an overrun, config changes and colliding grids. The last section
+ * runs a task on the real clock that is asleep when its period changes.
+ */
+
+#include "host_test.h"
+
+#include "TaskScheduler.h"
+
+#include <atomic>
+
+namespace {
+
+size_t staggerWarnings() {
+    return host::countLogs(LogLevel::WARN, "release on the same tick");
+}
+
+// Release time of the current wake-up, from the lateness waitForRelease() returned
+int64_t releaseUs(uint32_t lateUs) {
+    return host::nowUs() - lateUs;
+}
+
+// ---------------------------------------------------------------------------
+
+void testRegistration() {
+    puts("Registration and config");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    sched.registerTask(SchedTask::ENERGY, 100, 0, 50);
+    sched.registerTask(SchedTask::TCP_SERVER, 20, 10, 20);
+    sched.registerTask(SchedTask::MODBUS, 50, 25, 25);
+    sched.registerTask(SchedTask::ACCUMULATOR, 1000, 60, 500);
+    CHECK_EQ(staggerWarnings(), 0U);
+
+    const TaskScheduleStats modbus = sched.getStats(SchedTask::MODBUS);
+    CHECK_EQ(modbus.periodMs, 50U);
+    CHECK_EQ(modbus.phaseMs, 25U);
+    CHECK_EQ(modbus.deadlineMs, 25U);
+
+    SystemConfig config;
+    sched.applyConfig(config);
+    CHECK_EQ(sched.getReadIntervalMs(), 500U);
+    CHECK_EQ(sched.getPeriod(SchedTask::ACCUMULATOR), 1000U);
+
+    // Clamped to the EnergyTask period, 60 s and 1..3600 s
+    config.readInterval = 10;
+    config.publishInterval = 0;
+    sched.applyConfig(config);
+    CHECK_EQ(sched.getReadIntervalMs(), 100U);
+    CHECK_EQ(sched.getPeriod(SchedTask::ACCUMULATOR), 1000U);
+    config.readInterval = 65000;
+    config.publishInterval = 5000;
+    sched.applyConfig(config);
+    CHECK_EQ(sched.getReadIntervalMs(), TaskScheduler::MAX_READ_INTERVAL_MS);
+    CHECK_EQ(sched.getPeriod(SchedTask::ACCUMULATOR), TaskScheduler::MAX_PUBLISH_INTERVAL_SEC * 1000U);
+
+    // 1010 ms shares a 10 ms grid step with the 60 ms phase difference to EnergyTask
+    const size_t before = staggerWarnings();
+    sched.setPeriod(SchedTask::ACCUMULATOR, 1010);
+    CHECK(staggerWarnings() > before);
+
+    sched.applyConfig(SystemConfig());
+    CHECK_EQ(sched.getPeriod(SchedTask::ACCUMULATOR), 1000U);
+    sched.setPeriod(SchedTask::ENERGY, 1);
+    CHECK_EQ(sched.getPeriod(SchedTask::ENERGY), TaskScheduler::MIN_PERIOD_MS);
+    sched.setPeriod(SchedTask::ENERGY, 100);
+}
+
+void testGrid() {
+    puts("EnergyTask releases");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    host::advanceUs(12345);
+
+    int publishes = 0;
+    int offGrid = 0;
+    uint32_t maxLate = 0;
+    for (int i = 0; i < 30; ++i) {
+        const uint32_t late = sched.waitForRelease(SchedTask::ENERGY);
+        maxLate = std::max(maxLate, late);
+        if (releaseUs(late) % 100000 != 0) offGrid++;
+        if (sched.isDue(SchedTask::ENERGY, sched.getReadIntervalMs())) publishes++;
+        host::advanceUs(3000);
+        sched.complete(SchedTask::ENERGY);
+    }
+    const TaskScheduleStats stats = sched.getStats(SchedTask::ENERGY);
+    printf("  30 releases: %d off the 100 ms grid, %d publishes (readInterval 500 ms), max late %u us\n",
+           offGrid, publishes, maxLate);
+    CHECK_EQ(offGrid, 0);
+    CHECK_EQ(publishes, 6);
+    CHECK_EQ(stats.releases, 30U);
+    CHECK_EQ(stats.skipped, 0U);
+    CHECK_EQ(stats.deadlineMisses, 0U);
+    CHECK_EQ(stats.maxResponseUs, 3000U + maxLate);
+    CHECK_EQ(stats.maxExecUs, 3000U);
+    CHECK_EQ(stats.totalExecUs, 90000U);
+
+    // isDue() rounds to whole periods, at least every release
+    CHECK(sched.isDue(SchedTask::ENERGY, 0));
+    CHECK(sched.isDue(SchedTask::ENERGY, 40));
+}
+
+void testOverrun() {
+    puts("Overrun");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    const int64_t r0 = releaseUs(sched.waitForRelease(SchedTask::ENERGY));
+    host::advanceUs(250000);
+    sched.complete(SchedTask::ENERGY);
+    const int64_t r1 = releaseUs(sched.waitForRelease(SchedTask::ENERGY));
+    sched.complete(SchedTask::ENERGY);
+
+    const TaskScheduleStats stats = sched.getStats(SchedTask::ENERGY);
+    printf("  250 ms run: next release %lld ms later, %u skipped, %u deadline miss\n",
+           (long long)(r1 - r0) / 1000, stats.skipped, stats.deadlineMisses);
+    CHECK_EQ(r1 - r0, 300000);
+    CHECK_EQ(r1 % 100000, 0);
+    CHECK_EQ(stats.skipped, 2U);
+    CHECK_EQ(stats.deadlineMisses, 1U);
+    CHECK(stats.maxResponseUs >= 250000);
+
+    // ModbusTask keeps its 25 ms phase
+    const int64_t modbus = releaseUs(sched.waitForRelease(SchedTask::MODBUS));
+    sched.complete(SchedTask::MODBUS);
+    CHECK_EQ((modbus - 25000) % 50000, 0);
+}
+
+void testConfigChange() {
+    puts("publishInterval change");
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    const int64_t a0 = releaseUs(sched.waitForRelease(SchedTask::ACCUMULATOR));
+    sched.complete(SchedTask::ACCUMULATOR);
+    CHECK_EQ((a0 - 60000) % 1000000, 0);
+
+    // The owner is notified and plans on the 5 s grid at its next wait
+    SystemConfig config;
+    config.publishInterval = 5;
+    sched.applyConfig(config);
+    const int64_t a1 = releaseUs(sched.waitForRelease(SchedTask::ACCUMULATOR));
+    sched.complete(SchedTask::ACCUMULATOR);
+    const int64_t a2 = releaseUs(sched.waitForRelease(SchedTask::ACCUMULATOR));
+    sched.complete(SchedTask::ACCUMULATOR);
+    printf("  first release %lld ms after the change, then every %lld ms\n",
+           (long long)(a1 - a0) / 1000, (long long)(a2 - a1) / 1000);
+    CHECK((a1 - a0) <= 5000000);
+    CHECK_EQ((a1 - 60000) % 5000000, 0);
+    CHECK_EQ(a2 - a1, 5000000);
+    CHECK_EQ(sched.getStats(SchedTask::ACCUMULATOR).skipped, 0U);
+}
+
+struct SleeperState {
+    std::atomic<bool> waiting{false};
+    std::atomic<bool> done{false};
+    int64_t releaseUs = 0;
+};
+
+void sleeperTask(void* param) {
+    SleeperState* state = static_cast<SleeperState*>(param);
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    sched.waitForRelease(SchedTask::TCP_SERVER);
+    sched.complete(SchedTask::TCP_SERVER);
+
+    // Next release on a 2 s grid, then asleep until the period changes back
+    sched.setPeriod(SchedTask::TCP_SERVER, 2000);
+    state->waiting = true;
+    const uint32_t late = sched.waitForRelease(SchedTask::TCP_SERVER);
+    state->releaseUs = releaseUs(late);
+    sched.complete(SchedTask::TCP_SERVER);
+    state->done = true;
+    vTaskDelete(nullptr);
+}
+
+void testSleepingTask() {
+    puts("Period change while asleep (real clock)");
+    host::useVirtualClock(false);
+    TaskScheduler& sched = TaskScheduler::getInstance();
+    // Past the 10 ms phase, so the first 2 s grid point is 2 s away
+    delay(20);
+
+    SleeperState state;
+    TaskHandle_t task = nullptr;
+    CHECK_EQ(xTaskCreate(sleeperTask, "TCPServerTask", 4096, &state, 2, &task), pdPASS);
+    while (!state.waiting) delay(1);
+    delay(50);
+
+    const int64_t changed = host::nowUs();
+    sched.setPeriod(SchedTask::TCP_SERVER, 20);
+    while (!state.done && host::nowUs() - changed < 3000000) delay(1);
+
+    const int64_t afterUs = state.releaseUs - changed;
+    printf("  released %lld us after the change (old period 2000 ms, new 20 ms)\n", (long long)afterUs);
+    CHECK(state.done.load());
+    CHECK(afterUs >= 0);
+    CHECK(afterUs <= 20000 + 100000);       // Scheduling slack on a loaded host
+    // On the 20 ms grid (phase 10 ms), give or take reading the clock after the wake-up
+    const int64_t offset = (state.releaseUs - 10000) % 20000;
+    CHECK(offset < 1000 || offset > 19000);
+
+    host::useVirtualClock(true);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testRegistration();
+    testGrid();
+    testOverrun();
+    testConfigChange();
+    testSleepingTask();
+
+    return host::report("test_task_scheduler");
+}
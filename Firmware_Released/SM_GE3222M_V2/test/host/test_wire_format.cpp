@@ -0,0 +1,269 @@
+/**
+ * SM-GE3222M V2.0 - Meter wire format tests
+ *
+ * Binary MeterData frame round trip, rejection of damaged frames, decoding of
+ * frames from a newer field table, and the encode cost and size against the
+ * text payloads the transports build.
+ */
+
+#include "host_test.h"
+
+#include "MeterWireFormat.h"
+
+#include <random>
+
+namespace {
+
+MeterData sampleData(std::mt19937& rng) {
+    RawMeterFrame raw;
+    uint8_t* p = reinterpret_cast<uint8_t*>(&raw);
+    for (size_t i = 0; i < sizeof(raw); ++i) p[i] = (uint8_t)rng();
+    for (auto& block : raw.energy) {
+        for (uint64_t& count : block) count &= 0xFFFFFFFFULL;
+    }
+
+    MeterData data;
+    rawFrameToMeterData(raw, data);
+    data.phaseA.fundamentalPower = 1210.5f;
+    data.phaseC.harmonicPower = -3.25f;
+    data.ambientTemperature = 24.5f;
+    data.ambientHumidity = 51.0f;
+    data.sequenceNumber = rng();
+    data.timestampUs = ((int64_t)rng() << 20) | rng();
+    data.utcMs = 1760000000123ULL + rng();
+    data.valid = true;
+    return data;
+}
+
+// Tag/value text built with String concatenation, as TCPDataServer::buildV1MeterData
+String buildTagValue(const MeterData& data) {
+    String out = "";
+    for (uint8_t f = 0; f < METER_FIELD_COUNT; ++f) {
+        out += meterFieldName(f) + String(meterFieldValue(data, f), 3) + "\r\n";
+    }
+    return out;
+}
+
+// One flat JSON object of every field, written with snprintf into a stack buffer
+size_t buildFlatJson(const MeterData& data, char* buf, size_t len) {
+    int n = snprintf(buf, len, "{\"seq\":%u,\"ts\":%lld,\"utc\":%llu", (unsigned)data.sequenceNumber,
+                     (long long)data.timestampUs, (unsigned long long)data.utcMs);
+    for (uint8_t f = 0; f < METER_FIELD_COUNT; ++f) {
+        n += snprintf(buf + n, len - n, ",\"%s\":%.3f", meterFieldName(f), meterFieldValue(data, f));
+    }
+    n += snprintf(buf + n, len - n, "}");
+    return (size_t)n;
+}
+
+uint32_t floatBits(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+// ---------------------------------------------------------------------------
+
+void testCrc() {
+    puts("CRC-32");
+    const char* check = "123456789";
+    CHECK_EQ(meterWireCrc32(reinterpret_cast<const uint8_t*>(check), 9), 0xCBF43926UL);
+    CHECK_EQ(meterWireCrc32(nullptr, 0), 0U);
+}
+
+void testRoundTrip() {
+    puts("Round trip");
+    std::mt19937 rng(17);
+    MeterFieldMask all;
+    all.setAll();
+    CHECK_EQ(meterWireFrameSize(all), METER_WIRE_MAX_SIZE);
+
+    uint32_t mismatches = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const MeterData data = sampleData(rng);
+        uint8_t buf[METER_WIRE_MAX_SIZE];
+        const size_t len = encodeMeterWireFrame(data, all, buf, sizeof(buf));
+        if (len != METER_WIRE_MAX_SIZE) {
+            mismatches++;
+            continue;
+        }
+
+        MeterWireHeader header;
+        MeterFieldMask fields;
+        float values[METER_FIELD_COUNT];
+        if (!decodeMeterWireFrame(buf, len, header, fields, values)) {
+            mismatches++;
+            continue;
+        }
+        bool same = header.version == METER_WIRE_VERSION && header.flags == METER_WIRE_FLAG_VALID &&
+                    header.length == len && header.fieldCount == METER_FIELD_COUNT &&
+                    header.sequence == data.sequenceNumber && header.timestampUs == data.timestampUs &&
+                    header.utcMs == data.utcMs && fields.count() == METER_FIELD_COUNT;
+        for (uint8_t f = 0; f < METER_FIELD_COUNT; ++f) {
+            same = same && floatBits(values[f]) == floatBits(meterFieldValue(data, f));
+        }
+        if (!same) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0U);
+    printf("  full frame %zu bytes (%u fields), bit-exact over 1000 frames\n", METER_WIRE_MAX_SIZE,
+           (unsigned)METER_FIELD_COUNT);
+
+    // Partial mask: only the listed values travel, the others are left alone
+    MeterData data = sampleData(rng);
+    data.valid = false;
+    MeterFieldMask some;
+    some.set(FIELD_URMS_B);
+    some.set(FIELD_P_T);
+    some.set(FIELD_STATUS1);
+    uint8_t buf[METER_WIRE_MAX_SIZE];
+    const size_t len = encodeMeterWireFrame(data, some, buf, sizeof(buf));
+    CHECK_EQ(len, METER_WIRE_HEADER_SIZE + METER_WIRE_MASK_SIZE + 3 * 4 + METER_WIRE_CRC_SIZE);
+
+    MeterWireHeader header;
+    MeterFieldMask fields;
+    float values[METER_FIELD_COUNT];
+    for (float& v : values) v = -1.0f;
+    CHECK(decodeMeterWireFrame(buf, len, header, fields, values));
+    CHECK_EQ(header.flags, 0);
+    CHECK_EQ(fields.count(), 3);
+    CHECK(fields.test(FIELD_URMS_B) && fields.test(FIELD_P_T) && fields.test(FIELD_STATUS1));
+    CHECK_EQ(values[FIELD_URMS_B], data.phaseB.voltageRMS);
+    CHECK_EQ(values[FIELD_P_T], data.totalActivePower);
+    CHECK_EQ(values[FIELD_STATUS1], (float)data.meteringStatus1);
+    CHECK_EQ(values[FIELD_URMS_A], -1.0f);
+
+    // Caller buffer too small: nothing written
+    CHECK_EQ(encodeMeterWireFrame(data, some, buf, len - 1), 0U);
+    CHECK_EQ(encodeMeterWireFrame(data, some, nullptr, 0), 0U);
+}
+
+void testRejects() {
+    puts("Damaged frames");
+    std::mt19937 rng(5);
+    const MeterData data = sampleData(rng);
+    MeterFieldMask all;
+    all.setAll();
+    uint8_t buf[METER_WIRE_MAX_SIZE];
+    const size_t len = encodeMeterWireFrame(data, all, buf, sizeof(buf));
+
+    MeterWireHeader header;
+    MeterFieldMask fields;
+    float values[METER_FIELD_COUNT];
+
+    // Every single-bit error is caught
+    uint32_t accepted = 0;
+    for (size_t byte = 0; byte < len; ++byte) {
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            buf[byte] ^= (uint8_t)(1U << bit);
+            if (decodeMeterWireFrame(buf, len, header, fields, values)) accepted++;
+            buf[byte] ^= (uint8_t)(1U << bit);
+        }
+    }
+    CHECK_EQ(accepted, 0U);
+    CHECK(decodeMeterWireFrame(buf, len, header, fields, values));
+
+    // Truncated
+    CHECK(!decodeMeterWireFrame(buf, len - 1, header, fields, values));
+    CHECK(!decodeMeterWireFrame(buf, METER_WIRE_HEADER_SIZE, header, fields, values));
+
+    // Other version, even with a valid CRC
+    uint8_t other[METER_WIRE_MAX_SIZE];
+    memcpy(other, buf, len);
+    other[2] = METER_WIRE_VERSION + 1;
+    const uint32_t crc = meterWireCrc32(other, len - 4);
+    memcpy(other + len - 4, &crc, 4);
+    CHECK(!decodeMeterWireFrame(other, len, header, fields, values));
+}
+
+void testNewerFieldTable() {
+    puts("Frame from a newer field table");
+    std::mt19937 rng(9);
+    const MeterData data = sampleData(rng);
+    MeterFieldMask all;
+    all.setAll();
+    uint8_t buf[METER_WIRE_MAX_SIZE];
+    const size_t len = encodeMeterWireFrame(data, all, buf, sizeof(buf));
+
+    // Re-frame with 12 extra fields appended (two present) behind the known ones
+    constexpr uint8_t EXTRA = 12;
+    const uint8_t newCount = METER_FIELD_COUNT + EXTRA;
+    const size_t newMask = (newCount + 7) / 8;
+    std::vector<uint8_t> frame(METER_WIRE_HEADER_SIZE, 0);
+    memcpy(frame.data(), buf, METER_WIRE_HEADER_SIZE);
+    frame[6] = newCount;
+    std::vector<uint8_t> mask(newMask, 0);
+    memcpy(mask.data(), buf + METER_WIRE_HEADER_SIZE, METER_WIRE_MASK_SIZE);
+    const uint8_t extraA = METER_FIELD_COUNT + 2;
+    const uint8_t extraB = METER_FIELD_COUNT + 11;
+    mask[extraA >> 3] |= (uint8_t)(1U << (extraA & 7));
+    mask[extraB >> 3] |= (uint8_t)(1U << (extraB & 7));
+    frame.insert(frame.end(), mask.begin(), mask.end());
+    const uint8_t* known = buf + METER_WIRE_HEADER_SIZE + METER_WIRE_MASK_SIZE;
+    frame.insert(frame.end(), known, known + METER_FIELD_COUNT * 4);
+    const uint8_t unknown[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    frame.insert(frame.end(), unknown, unknown + sizeof(unknown));
+    const uint16_t newLen = (uint16_t)(frame.size() + 4);
+    memcpy(&frame[4], &newLen, 2);
+    const uint32_t crc = meterWireCrc32(frame.data(), frame.size());
+    frame.insert(frame.end(), reinterpret_cast<const uint8_t*>(&crc), reinterpret_cast<const uint8_t*>(&crc) + 4);
+    CHECK(frame.size() > len);
+
+    MeterWireHeader header;
+    MeterFieldMask fields;
+    float values[METER_FIELD_COUNT];
+    CHECK(decodeMeterWireFrame(frame.data(), frame.size(), header, fields, values));
+    CHECK_EQ(header.fieldCount, newCount);
+    CHECK_EQ(fields.count(), METER_FIELD_COUNT);
+    uint32_t mismatches = 0;
+    for (uint8_t f = 0; f < METER_FIELD_COUNT; ++f) {
+        if (floatBits(values[f]) != floatBits(meterFieldValue(data, f))) mismatches++;
+    }
+    CHECK_EQ(mismatches, 0U);
+}
+
+void testEncodeCost() {
+    puts("Encode cost and size (host CPU)");
+    std::mt19937 rng(1);
+    MeterData data = sampleData(rng);
+    MeterFieldMask all;
+    all.setAll();
+    uint8_t frame[METER_WIRE_MAX_SIZE];
+    char json[4096];
+    volatile size_t sink = 0;
+
+    const double binNs = host::nsPerCall(200000, [&] {
+        data.sequenceNumber++;
+        sink = encodeMeterWireFrame(data, all, frame, sizeof(frame));
+    });
+    const double jsonNs = host::nsPerCall(20000, [&] {
+        data.sequenceNumber++;
+        sink = buildFlatJson(data, json, sizeof(json));
+    });
+    const double textNs = host::nsPerCall(20000, [&] {
+        data.sequenceNumber++;
+        sink = buildTagValue(data).length();
+    });
+    (void)sink;
+
+    const size_t jsonBytes = buildFlatJson(data, json, sizeof(json));
+    const size_t textBytes = buildTagValue(data).length();
+    printf("  binary frame          %6.0f ns  %4zu bytes\n", binNs, METER_WIRE_MAX_SIZE);
+    printf("  flat snprintf JSON    %6.0f ns  %4zu bytes\n", jsonNs, jsonBytes);
+    printf("  String tag/value text %6.0f ns  %4zu bytes\n", textNs, textBytes);
+    CHECK(METER_WIRE_MAX_SIZE < jsonBytes);
+    CHECK(binNs < jsonNs);
+}
+
+} // namespace
+
+int main() {
+    host::useVirtualClock(true);
+    host::initLogger();
+
+    testCrc();
+    testRoundTrip();
+    testRejects();
+    testNewerFieldTable();
+    testEncodeCost();
+
+    return host::report("test_wire_format");
+}
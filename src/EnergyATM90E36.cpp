@@ -17,6 +17,13 @@
 ATM90E3x::ATM90E3x(int pin)
 {
     _energy_CS = pin; 	// SS PIN
+    _lastSweepMicros = 0;
+    _sweepCount = 0;
+    _read32Retries = 0;
+    _spiClockHz = ATM_SPI_DEFAULT_CLOCK;
+    _transport = NULL;
+    _batchDepth = 0;
+    _busErrors = 0;
 
 }
 
@@ -35,82 +42,147 @@ ATM90E3x::~ATM90E3x()
 */
 unsigned short ATM90E3x::CommEnergyIC(unsigned char RW, unsigned short address, unsigned short val)
 {
-    unsigned char* data = (unsigned char*)&val;
-    unsigned char* adata = (unsigned char*)&address;
     unsigned short output;
-    unsigned short address1;
-
-    // **************** SPI Settings ESP32 ****************
-    SPISettings settings(200000, MSBFIRST, SPI_MODE3);
-
-    // Switch MSB and LSB of value
-    output = (val >> 8) | (val << 8);
-    val = output;
 
     // Set R/W flag
     address |= RW << 15;
 
-    // Swap byte address
-    address1 = (address >> 8) | (address << 8);
-    address = address1;
+    // Transmit & Receive Data (bus is only taken here if no batch is open)
+    if (!BeginBatch())
+        return 0xFFFF;
 
-    // Transmit & Receive Data
-    SPI.beginTransaction(settings);
+    // Address and data go out as MSB-first 16-bit words; 10us CS setup/hold
+    output = BusFrame(address, RW ? 0x0000 : val, 10, 10);
 
-    // Chip enable and wait for SPI activation
-    digitalWrite(_energy_CS, LOW);
-    delayMicroseconds(10);
+    EndBatch();
 
-    // Write address byte by byte
-    for (byte i = 0; i < 2; i++)
-    {
-        SPI.transfer(*adata);
-        adata++;
-    }
+    return RW ? output : val;
+} // ATM90E3x::CommEnergyIC
 
-    /* Must wait 4 us for data to become valid */
-    delayMicroseconds(4);
+// **************** ATM90E - Bus Access ****************
+/*
+  - BeginBatch()/EndBatch() nest: only the outermost pair takes and releases the bus
+  - With a transport set (SetTransport) the transport owns locking and the SPI transaction
+  - Without one, the global SPI object is used directly (original V1 behaviour)
+*/
+bool ATM90E3x::BeginBatch()
+{
+    if (_batchDepth++ > 0)
+        return true;
 
-    // READ Data
-    // Do for each byte in transfer
-    if (RW)
+    if (_transport != NULL)
     {
-        for (byte i = 0; i < 2; i++)
+        if (!_transport->Begin(_spiClockHz))
         {
-            *data = SPI.transfer(0x00);
-            data++;
+            _batchDepth = 0;
+            _busErrors++;
+            return false;
         }
+        return true;
     }
+
+    SPI.beginTransaction(SPISettings(_spiClockHz, MSBFIRST, SPI_MODE3));
+    return true;
+} // ATM90E3x::BeginBatch
+
+void ATM90E3x::EndBatch()
+{
+    if (_batchDepth == 0 || --_batchDepth > 0)
+        return;
+
+    if (_transport != NULL)
+        _transport->End();
     else
-    {
-        for (byte i = 0; i < 2; i++)
-        {
-            SPI.transfer(*data);
-            data++;
-        }
-    }
+        SPI.endTransaction();
+} // ATM90E3x::EndBatch
+
+unsigned short ATM90E3x::BusFrame(unsigned short addrWord, unsigned short dataWord, unsigned int csSetupUs, unsigned int csHoldUs)
+{
+    if (_transport != NULL)
+        return _transport->Frame(_energy_CS, addrWord, dataWord, csSetupUs, csHoldUs);
+
+    unsigned short output;
+
+    // Chip enable and wait for SPI activation
+    digitalWrite(_energy_CS, LOW);
+    delayMicroseconds(csSetupUs);
+
+    SPI.transfer16(addrWord);
+
+    /* Must wait 4 us for data to become valid */
+    delayMicroseconds(ATM_SWEEP_ADDR_WAIT_US);
+
+    output = SPI.transfer16(dataWord);
 
     // Chip enable and wait for transaction to end
     digitalWrite(_energy_CS, HIGH);
-    delayMicroseconds(10);
-
-    SPI.endTransaction();
+    delayMicroseconds(csHoldUs);
 
-    output = (val >> 8) | (val << 8); // reverse MSB and LSB
     return output;
-} // ATM90E3x::CommEnergyIC
+} // ATM90E3x::BusFrame
+
+void ATM90E3x::SetTransport(ATM90E3xTransport *transport)
+{
+    _transport = transport;
+} // ATM90E3x::SetTransport
+
+// **************** ATM90E - Batched Register Sweep ****************
+/*
+  - Reads a list of registers while holding the bus once (one lock, one SPI transaction)
+  - Each register is still framed by its own CS pulse (the IC requires it),
+    but the bus settings and per-call setup are done once
+  - Results are stored raw (no scaling) in out[] in the order of addrs[]
+*/
+unsigned short ATM90E3x::ReadRegisterSweep(const unsigned short *addrs, unsigned short *out, unsigned short count)
+{
+    if (addrs == NULL || out == NULL || count == 0)
+        return 0;
+
+    unsigned long start = micros();
+
+    if (!BeginBatch())
+        return 0;
+
+    for (unsigned short i = 0; i < count; i++)
+    {
+        out[i] = BusFrame(addrs[i] | (READ << 15), 0x0000, ATM_SWEEP_CS_SETUP_US, ATM_SWEEP_CS_GAP_US);
+    }
+
+    EndBatch();
+
+    _lastSweepMicros = micros() - start;
+    _sweepCount++;
+
+    return count;
+} // ATM90E3x::ReadRegisterSweep
+
+void ATM90E3x::SetSPIClock(unsigned long hz)
+{
+    _spiClockHz = (hz > 0) ? hz : ATM_SPI_DEFAULT_CLOCK;
+} // ATM90E3x::SetSPIClock
 
 // **************** REGISTER FUNCTIONS ****************
 
 int ATM90E3x::Read32Register(signed short regh_addr, signed short regl_addr)
 {
-    int val, val_h, val_l;
+    // Coherent 32-bit read: HI, LO, then HI again.  If both HI reads agree the
+    // pair belongs to the same measurement update.  If they differ the IC
+    // refreshed the register between the reads, so LO is re-read against the
+    // newer HI until two consecutive HI reads match (bounded retries).
+    unsigned short val_h, val_l, check_h;
     val_h = CommEnergyIC(READ, regh_addr, 0xFFFF);
     val_l = CommEnergyIC(READ, regl_addr, 0xFFFF);
-    val = CommEnergyIC(READ, regh_addr, 0xFFFF);
+    check_h = CommEnergyIC(READ, regh_addr, 0xFFFF);
+
+    for (byte retry = 0; check_h != val_h && retry < ATM_READ32_MAX_RETRIES; retry++)
+    {
+        _read32Retries++;
+        val_h = check_h;
+        val_l = CommEnergyIC(READ, regl_addr, 0xFFFF);
+        check_h = CommEnergyIC(READ, regh_addr, 0xFFFF);
+    }
 
-    val = val_h << 16;
-    val |= val_l; // concatenate the 2 registers to make 1 32 bit number
+    int val = (int)(((uint32_t)val_h << 16) | val_l); // concatenate the 2 registers to make 1 32 bit number
 
     return (val);
 } // ATM90E3x::Read32Register
@@ -120,14 +192,9 @@ double ATM90E3x::CalculateVIOffset(unsigned short regh_addr, unsigned short regl
     // for getting the lower registers of Voltage and Current and calculating the offset
     // should only be run when CT sensors are connected to the meter,
     // but not connected around wires
-    uint32_t val, val_h, val_l;
+    uint32_t val;
     uint16_t offset;
-    val_h = CommEnergyIC(READ, regh_addr, 0xFFFF);
-    val_l = CommEnergyIC(READ, regl_addr, 0xFFFF);
-    val = CommEnergyIC(READ, regh_addr, 0xFFFF);
-
-    val = val_h << 16; // move high register up 16 bits
-    val |= val_l;      // concatenate the 2 registers to make 1 32 bit number
+    val = (uint32_t)Read32Register(regh_addr, regl_addr); // coherent HI/LO pair
     val = val >> 7;    // right shift 7 bits - lowest 7 get ignored - V & I registers need this
     val = (~val) + 1;  // 2s compliment
 
@@ -141,14 +208,9 @@ double ATM90E3x::CalculatePowerOffset(unsigned short regh_addr, unsigned short r
     // for getting the lower registers of energy and calculating the offset
     // should only be run when CT sensors are connected to the meter,
     // but not connected around wires
-    uint32_t val, val_h, val_l;
+    uint32_t val;
     uint16_t offset;
-    val_h = CommEnergyIC(READ, regh_addr, 0xFFFF);
-    val_l = CommEnergyIC(READ, regl_addr, 0xFFFF);
-    val = CommEnergyIC(READ, regh_addr, 0xFFFF);
-
-    val = val_h << 16; // move high register up 16 bits
-    val |= val_l;      // concatenate the 2 registers to make 1 32 bit number
+    val = (uint32_t)Read32Register(regh_addr, regl_addr); // coherent HI/LO pair
     val = (~val) + 1;  // 2s compliment
 
     offset = val; // keep lower 16 bits
@@ -967,8 +1029,9 @@ void ATM90E3x::begin(unsigned short lineFreq, unsigned short pgagain, unsigned s
 
     pinMode(_energy_CS, OUTPUT);
 
-    /* Enable SPI */
-    SPI.begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, _energy_CS);
+    /* Enable SPI (a transport owns bus setup when one is set) */
+    if (_transport == NULL)
+        SPI.begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, _energy_CS);
 
     DBUGS.print("Connecting to the ");
 
@@ -1205,8 +1268,9 @@ void ATM90E3x::InitEnergy()
 
     pinMode(_energy_CS, OUTPUT);
 
-    /* Enable SPI */
-    SPI.begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, _energy_CS);
+    /* Enable SPI (a transport owns bus setup when one is set) */
+    if (_transport == NULL)
+        SPI.begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, _energy_CS);
 
     DBUGS.print("Connecting to the ");
 